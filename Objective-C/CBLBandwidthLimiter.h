@@ -0,0 +1,59 @@
+//
+//  CBLBandwidthLimiter.h
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Limits the bandwidth of replication traffic, so that background replication leaves room for
+ other traffic on the same network link. Set it as a replicator configuration's
+ ``CBLReplicatorConfiguration/sendBandwidthLimiter`` or
+ ``CBLReplicatorConfiguration/receiveBandwidthLimiter``; setting the same limiter on several
+ configurations shares the bandwidth among their replicators.
+ 
+ The rate is enforced with a token bucket, which allows short bursts of up to 50 milliseconds'
+ worth of data.
+ */
+@interface CBLBandwidthLimiter : NSObject
+
+/**
+ Initializes a limiter with the rate in bytes per second; zero is unlimited.
+ */
+- (instancetype) initWithBytesPerSecond: (uint64_t)bytesPerSecond;
+
+/**
+ The rate in bytes per second; zero is unlimited. It can be changed while replicating, and
+ takes effect within a second.
+ */
+@property (atomic) uint64_t bytesPerSecond;
+
+/**
+ The total time in seconds that the replicators' connections waited to send or receive data
+ because of the limit.
+ */
+@property (atomic, readonly) NSTimeInterval shapedTime;
+
+/** Not available */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
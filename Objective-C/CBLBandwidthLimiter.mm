@@ -0,0 +1,51 @@
+//
+//  CBLBandwidthLimiter.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+
+#import "CBLBandwidthLimiter+Internal.h"
+
+@implementation CBLBandwidthLimiter
+
+@synthesize bucket=_bucket;
+
+- (instancetype) initWithBytesPerSecond: (uint64_t)bytesPerSecond {
+    self = [super init];
+    if (self) {
+        _bucket = std::make_shared<cbl::TokenBucket>(bytesPerSecond);
+    }
+    return self;
+}
+
+- (uint64_t) bytesPerSecond {
+    return _bucket->rate();
+}
+
+- (void) setBytesPerSecond: (uint64_t)bytesPerSecond {
+    _bucket->setRate(bytesPerSecond);
+}
+
+- (NSTimeInterval) shapedTime {
+    return _bucket->shapedTime() / 1.0e9;
+}
+
+- (NSString*) description {
+    return [NSString stringWithFormat: @"%@[%llu bytes/s]", self.class, self.bytesPerSecond];
+}
+
+@end
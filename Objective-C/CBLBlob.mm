@@ -31,6 +31,9 @@
 #import "CBLErrorMessage.h"
 #import "CBLJSON.h"
 #import "CBLFleece.hh"
+#import <algorithm>
+#import <atomic>
+#import <vector>
 
 using namespace cbl;
 
@@ -44,6 +47,15 @@ static const size_t kMaxCachedContentLength = 8*1024;
 // Stack buffer size when reading NSInputStream
 static const size_t kReadBufferSize = 8*1024;
 
+// Size of each of the two buffers used to copy a content stream into the blob store, unless
+// the database configuration's blobBufferSize says otherwise
+static const size_t kDefaultBlobBufferSize = 1024*1024;
+
+// Number of blobs created from data or a stream that haven't been installed in a database yet.
+// Lets saving a document skip looking for blobs to install when there can't be any. The count is
+// process-wide: while any unsaved blob is alive, saving any mutable document walks its properties.
+static std::atomic<NSInteger> sPendingBlobCount {0};
+
 NSString* const kCBLBlobType = @kC4ObjectType_Blob;
 NSString* const kCBLTypeProperty = @kC4ObjectTypeProperty;
 NSString* const kCBLBlobDigestProperty = @kC4BlobDigestProperty;
@@ -58,6 +70,7 @@ static NSString* const kCBLBlobDataProperty = @kC4BlobDataProperty;
     CBLDatabase* _db;                       // nil if blob is new and unsaved
     NSData* _content;                       // If new from data, or already loaded from db
     NSInputStream* _initialContentStream;   // If new from stream.
+    BOOL _pending;                          // Counted in sPendingBlobCount
 
     // A newly created unsaved blob will have either _content or _initialContentStream.
     // A new blob saved to the database will have _db and _digest.
@@ -78,6 +91,8 @@ static NSString* const kCBLBlobDataProperty = @kC4BlobDataProperty;
         _contentType = [contentType copy];
         _content = [data copy];
         _length = [data length];
+        _pending = YES;
+        ++sPendingBlobCount;
     }
     
     return self;
@@ -93,6 +108,8 @@ static NSString* const kCBLBlobDataProperty = @kC4BlobDataProperty;
     if(self) {
         _contentType = [contentType copy];
         _initialContentStream = stream;
+        _pending = YES;
+        ++sPendingBlobCount;
     }
     
     return self;
@@ -151,6 +168,8 @@ static NSString* const kCBLBlobDataProperty = @kC4BlobDataProperty;
 }
 
 - (void) dealloc {
+    if (_pending)
+        --sPendingBlobCount;
     if (_initialContentStream)
         [_initialContentStream close];
     _initialContentStream = nil;
@@ -304,6 +323,112 @@ static NSString* const kCBLBlobDataProperty = @kC4BlobDataProperty;
 
 #pragma mark - Internal
 
+static size_t blobBufferSize(CBLDatabase* db) {
+    size_t size = db.config.blobBufferSize;
+    return size == 0 ? kDefaultBlobBufferSize : std::max(size, kReadBufferSize);
+}
+
+// Reads from the stream until the buffer is full or the stream ends. Returns the number of
+// bytes read, or -1 on a stream error.
+static NSInteger readFully(NSInputStream* stream, uint8_t* buffer, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        NSInteger bytesRead = [stream read: buffer + total maxLength: size - total];
+        if (bytesRead < 0)
+            return -1;
+        if (bytesRead == 0)
+            break;
+        total += bytesRead;
+    }
+    return (NSInteger)total;
+}
+
+namespace {
+    // State shared by the two sides of copyStream(). The reader fills a buffer after taking an
+    // `empty` signal and passes it on with a `full` signal; the writer does the reverse.
+    struct StreamCopy {
+        std::vector<uint8_t> buffers[2];
+        NSInteger lengths[2] {0, 0};        // Bytes in each buffer; -1 on stream error
+        bool ended[2] {false, false};       // Whether the buffer is the last one
+        NSError* streamError {nil};
+        std::atomic<bool> cancelled {false};
+        dispatch_semaphore_t empty {dispatch_semaphore_create(0)};
+        dispatch_semaphore_t full {dispatch_semaphore_create(0)};
+    };
+}
+
+// Copies the stream into the blob write stream through two buffers: the stream is read into
+// one buffer on a background queue while the content of the other is written, and digested,
+// by the calling thread. Returns false with either `outError` or `outStreamError` set on failure.
+static bool copyStream(NSInputStream* stream, C4WriteStream* blobOut, size_t bufferSize,
+                       uint64_t* outLength, C4Error* outError, NSError** outStreamError)
+{
+    StreamCopy state;
+    StreamCopy* copy = &state;
+    dispatch_semaphore_signal(copy->empty);
+    dispatch_semaphore_signal(copy->empty);
+
+    dispatch_group_t group = dispatch_group_create();
+    dispatch_group_async(group, dispatch_get_global_queue(qos_class_self(), 0), ^{
+        [stream open];
+        // Start small, so that small content doesn't allocate large buffers, and grow the reads
+        // while the stream keeps filling them:
+        size_t readSize = std::min(bufferSize, kReadBufferSize);
+        for (int i = 0; ; i ^= 1) {
+            dispatch_semaphore_wait(copy->empty, DISPATCH_TIME_FOREVER);
+            if (copy->cancelled)
+                break;
+            std::vector<uint8_t> &buffer = copy->buffers[i];
+            if (buffer.size() < readSize)
+                buffer.resize(readSize);
+            NSInteger bytesRead = readFully(stream, buffer.data(), readSize);
+            if (bytesRead < 0)
+                copy->streamError = stream.streamError;
+            bool ended = bytesRead < (NSInteger)readSize;   // End of stream, or error
+            copy->lengths[i] = bytesRead;
+            copy->ended[i] = ended;
+            dispatch_semaphore_signal(copy->full);
+            if (ended)
+                break;
+            readSize = std::min(4 * readSize, bufferSize);
+        }
+        [stream close];
+    });
+
+    bool success = true, streamFailed = false;
+    uint64_t length = 0;
+    for (int i = 0; ; i ^= 1) {
+        dispatch_semaphore_wait(copy->full, DISPATCH_TIME_FOREVER);
+        NSInteger bytesRead = copy->lengths[i];
+        if (bytesRead < 0) {
+            success = false;
+            streamFailed = true;
+            break;
+        }
+        if (bytesRead > 0) {
+            success = c4stream_write(blobOut, copy->buffers[i].data(), bytesRead, outError);
+            length += bytesRead;
+        }
+        if (!success) {
+            // Wake up the reader if it's waiting for a buffer, so that it stops:
+            copy->cancelled = true;
+            dispatch_semaphore_signal(copy->empty);
+            break;
+        }
+        if (copy->ended[i])
+            break;
+        dispatch_semaphore_signal(copy->empty);
+    }
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+
+    if (streamFailed) {
+        *outStreamError = copy->streamError ?: [NSError errorWithDomain: NSPOSIXErrorDomain
+                                                                   code: EIO userInfo: nil];
+    }
+    *outLength = length;
+    return success;
+}
+
 - (BOOL) installInDatabase: (CBLDatabase*)db error:(NSError**)outError {
     Assert(db);
     
@@ -313,14 +438,27 @@ static NSString* const kCBLBlobDataProperty = @kC4BlobDataProperty;
             return YES;
     }
 
-    C4BlobStore *store = [db getBlobStore: outError];
+    // Keep the database from closing, which frees the blob store, until the blob is installed:
+    C4BlobStore *store = [db beginBlobInstall: outError];
     if (!store)
         return NO;
+    BOOL installed = [self installInDatabase: db blobStore: store error: outError];
+    [db endBlobInstall];
+    return installed;
+}
 
+- (BOOL) installInDatabase: (CBLDatabase*)db
+                 blobStore: (C4BlobStore*)store
+                     error: (NSError**)outError
+{
     C4Error err;
     C4BlobKey key;
     bool success = true;
     CBL_LOCK(self) {
+        // Check again, as the blob may have been installed by another thread meanwhile:
+        if (_db)
+            return YES;
+        
         if (_content) {
             success = c4blob_create(store, data2slice(_content), nullptr, &key, &err);
         } else {
@@ -329,31 +467,21 @@ static NSString* const kCBLBlobDataProperty = @kC4BlobDataProperty;
             if(!blobOut)
                 return convertError(err, outError);
 
-            uint8_t buffer[kReadBufferSize];
-            NSInteger bytesRead = 0;
-            _length = 0;
-            NSInputStream *contentStream = _initialContentStream;
-            [contentStream open];
-            success = true;
-            while(success && (bytesRead = [contentStream read:buffer maxLength: kReadBufferSize]) > 0) {
-                _length += bytesRead;
-                success = c4stream_write(blobOut, buffer, bytesRead, &err);
-            }
-            if (bytesRead < 0) {
-                // NSStream error. Set outError, but don't return until closing things down...
-                success = false;
-                if (outError)
-                    *outError = contentStream.streamError;
-            }
-
-            [contentStream close];
+            NSError* streamError = nil;
+            uint64_t length = 0;
+            success = copyStream(_initialContentStream, blobOut, blobBufferSize(db),
+                                 &length, &err, &streamError);
             if (success) {
+                _length = length;
                 key = c4stream_computeBlobKey(blobOut);
                 success = c4stream_install(blobOut, nullptr, &err);
             }
             c4stream_closeWriter(blobOut);
-            if (bytesRead < 0)
-                return NO;  // NSStream error
+            if (streamError) {
+                if (outError)
+                    *outError = streamError;
+                return NO;
+            }
         }
         
         if (!success)
@@ -361,6 +489,11 @@ static NSString* const kCBLBlobDataProperty = @kC4BlobDataProperty;
 
         _digest = sliceResult2string(c4blob_keyToString(key));
         _db = db;
+        _initialContentStream = nil;        // Consumed; the content is read from the db now
+        if (_pending) {
+            _pending = NO;
+            --sPendingBlobCount;
+        }
     }
 
     return YES;
@@ -374,6 +507,38 @@ static NSString* const kCBLBlobDataProperty = @kC4BlobDataProperty;
     }
 }
 
+// Installs the new blobs found in a dictionary or array, recursively.
+static BOOL installBlobsIn(id container, CBLDatabase* db, NSError** outError) {
+    if ([container conformsToProtocol: @protocol(CBLDictionary)]) {
+        id<CBLDictionary> dict = container;
+        for (NSString* key in dict.keys) {
+            if (!installBlobsIn([dict valueForKey: key], db, outError))
+                return NO;
+        }
+    } else if ([container conformsToProtocol: @protocol(CBLArray)]) {
+        id<CBLArray> array = container;
+        NSUInteger count = array.count;
+        for (NSUInteger i = 0; i < count; ++i) {
+            if (!installBlobsIn([array valueAtIndex: i], db, outError))
+                return NO;
+        }
+    } else if ([container isKindOfClass: [CBLBlob class]]) {
+        CBLBlob* blob = container;
+        [blob checkBlobFromSameDatabase: db];
+        return [blob installInDatabase: db error: outError];
+    }
+    return YES;
+}
+
++ (BOOL) installBlobsInDocument: (CBLDocument*)document
+                     inDatabase: (CBLDatabase*)db
+                          error: (NSError**)outError
+{
+    if (sPendingBlobCount == 0 || ![document isKindOfClass: [CBLMutableDocument class]])
+        return YES;
+    return installBlobsIn(document, db, outError);
+}
+
 #pragma mark FLEECE ENCODABLE
 
 - (id) cbl_toCBLObject {
@@ -22,6 +22,7 @@
 #import <CouchbaseLite/CBLIndexable.h>
 #import <CouchbaseLite/CBLCollectionTypes.h>
 
+@class CBLCollectionChangeCursor;
 @class CBLDatabase;
 @class CBLDocument;
 @class CBLDocumentChange;
@@ -241,6 +242,22 @@ extern NSString* const kCBLDefaultCollectionName;
 - (nullable NSDate*) getDocumentExpirationWithID: (NSString*)documentID
                                            error: (NSError**)error NS_SWIFT_NOTHROW;
 
+#pragma mark - Change feed
+
+/**
+ Creates a cursor for pulling the changes made to the collection after the given sequence, in
+ sequence order. Pass 0 to read all changes, or a persisted CBLCollectionChangeCursor.lastSequence
+ to resume where a previous cursor stopped.
+ 
+ @param sequence The sequence after which the changes are read.
+ @param limit The maximum number of changes returned by each -nextBatch: call. Must be > 0.
+ @param error On return, the error if any.
+ @return The change cursor, or nil if the collection is not valid.
+ */
+- (nullable CBLCollectionChangeCursor*) changesSinceSequence: (uint64_t)sequence
+                                                       limit: (NSUInteger)limit
+                                                       error: (NSError**)error;
+
 #pragma mark - Document change publisher
 
 /**
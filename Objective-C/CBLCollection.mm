@@ -21,6 +21,7 @@
 #import "CBLChangeNotifier.h"
 #import "CBLCollection+Internal.h"
 #import "CBLCollectionChange.h"
+#import "CBLCollectionChangeBatcher.h"
 #import "CBLCollectionChangeObservable.h"
 #import "CBLConflict+Internal.h"
 #import "CBLCoreBridge.h"
@@ -35,6 +36,8 @@
 #import "CBLScope+Internal.h"
 #import "CBLStatus.h"
 #import "CBLStringBytes.h"
+#include <unordered_map>
+#include <vector>
 
 #define msec 1000.0
 
@@ -42,10 +45,21 @@ using namespace fleece;
 
 NSString* const kCBLDefaultCollectionName = @"_default";
 
+namespace {
+    // Document listeners of a collection, keyed by the docID slice owned by the entry itself
+    // so that a changed docID reported by the observer can be looked up without copying it.
+    struct DocListenerEntry {
+        alloc_slice docID;
+        CBLDocumentChangeNotifier* notifier;
+    };
+    typedef std::unordered_map<slice, DocListenerEntry> DocListenerMap;
+}
+
 @implementation CBLCollection {
     C4DatabaseObserver* _colObs;
     CBLChangeNotifier<CBLCollectionChange*>* _colChangeNotifier;
-    NSMutableDictionary<NSString*,CBLDocumentChangeNotifier*>* _docChangeNotifiers;
+    C4CollectionObserver* _docObs;
+    DocListenerMap _docListeners;
     
     // retained database mutex
     id _mutex;
@@ -483,6 +497,12 @@ NSString* const kCBLDefaultCollectionName = @"_default";
 
 - (id<CBLListenerToken>) addChangeListenerWithQueue: (nullable dispatch_queue_t)queue
                                            listener: (void (^)(CBLCollectionChange*))listener {
+    return [self addChangeListenerWithQueue: queue options: nil listener: listener];
+}
+
+- (id<CBLListenerToken>) addChangeListenerWithQueue: (nullable dispatch_queue_t)queue
+                                            options: (nullable CBLCollectionChangeListenerOptions*)options
+                                           listener: (void (^)(CBLCollectionChange*))listener {
     CBLAssertNotNil(listener);
     
     CBL_LOCK(_mutex) {
@@ -492,24 +512,90 @@ NSString* const kCBLDefaultCollectionName = @"_default";
                     @"%@: Cannot add change listener. Database is closed or collection is removed.", self);
         }
         
+        if (options.maxBatchSize > 0 || options.maxDelay > 0) {
+            CBLCollectionChangeBatcher* batcher = [[CBLCollectionChangeBatcher alloc]
+                                                   initWithQueue: queue
+                                                   options: options
+                                                   listener: listener];
+            listener = ^(CBLCollectionChange* change) {
+                [batcher addChange: change];
+            };
+        }
         return [self addCollectionChangeListener: listener queue: queue];
     }
 }
 
+#pragma mark - Change feed
+
+- (nullable CBLCollectionChangeCursor*) changesSinceSequence: (uint64_t)sequence
+                                                       limit: (NSUInteger)limit
+                                                       error: (NSError**)error {
+    if (limit == 0) {
+        [NSException raise: NSInvalidArgumentException format: @"limit must be > 0"];
+    }
+    
+    CBL_LOCK(_mutex) {
+        if (![self checkIsValid: error])
+            return nil;
+    }
+    return [[CBLCollectionChangeCursor alloc] initWithCollection: self sinceSequence: sequence limit: limit];
+}
+
+- (nullable NSArray<CBLChangedDocument*>*) changedDocumentsSinceSequence: (uint64_t)sequence
+                                                                   limit: (NSUInteger)limit
+                                                                   error: (NSError**)error {
+    CBL_LOCK(_mutex) {
+        if (![self checkIsValid: error])
+            return nil;
+        
+        C4EnumeratorOptions options = kC4DefaultEnumeratorOptions;
+        options.flags |= kC4IncludeDeleted;
+        C4Error c4err = {};
+        C4DocEnumerator* e = c4coll_enumerateChanges(_c4col, sequence, &options, &c4err);
+        if (!e) {
+            convertError(c4err, error);
+            return nil;
+        }
+        
+        NSMutableArray<CBLChangedDocument*>* changes = [NSMutableArray array];
+        C4DocumentInfo info;
+        while (changes.count < limit && c4enum_next(e, &c4err)) {
+            c4enum_getDocumentInfo(e, &info);
+            [changes addObject: [[CBLChangedDocument alloc] initWithDocumentInfo: &info]];
+        }
+        c4enum_free(e);
+        
+        if (c4err.code != 0) {
+            convertError(c4err, error);
+            return nil;
+        }
+        return changes;
+    }
+}
+
 #pragma mark - Document listener
 
 - (id<CBLListenerToken>) addDocumentChangeListenerWithDocumentID: documentID
                                                         listener: (void (^)(CBLDocumentChange*))listener
                                                            queue: (dispatch_queue_t)queue {
     CBL_LOCK(_mutex) {
-        if (!_docChangeNotifiers)
-            _docChangeNotifiers = [NSMutableDictionary dictionary];
+        if (!_docObs) {
+            C4Error c4err = {};
+            _docObs = c4dbobs_createOnCollection(_c4col, docObserverCallback, (__bridge void *)self, &c4err);
+            if (!_docObs) {
+                CBLWarn(Database, @"%@ Failed to create document listener obs c4col=%p err=%d/%d",
+                        self, _c4col, c4err.domain, c4err.code);
+            }
+        }
         
-        CBLDocumentChangeNotifier* docNotifier = _docChangeNotifiers[documentID];
-        if (!docNotifier) {
-            docNotifier = [[CBLDocumentChangeNotifier alloc] initWithCollection: self documentID: documentID];
-            _docChangeNotifiers[documentID] = docNotifier;
+        CBLStringBytes docID(documentID);
+        auto i = _docListeners.find(docID.bytes);
+        if (i == _docListeners.end()) {
+            alloc_slice key(docID.bytes);
+            auto notifier = [[CBLDocumentChangeNotifier alloc] initWithCollection: self documentID: documentID];
+            i = _docListeners.emplace(key, DocListenerEntry{key, notifier}).first;
         }
+        CBLDocumentChangeNotifier* docNotifier = i->second.notifier;
         
         CBLChangeListenerToken* token = [docNotifier addChangeListenerWithQueue: queue
                                                                        listener: listener
@@ -530,6 +616,22 @@ NSString* const kCBLDefaultCollectionName = @"_default";
     if (deletion && !document.revisionID)
         return createError(CBLErrorNotFound,
                            kCBLErrorMessageDeleteDocFailedNotSaved, outError);
+    
+    // Copy the content of new blobs into the blob store before taking the database lock for the
+    // save, so that other writers aren't blocked meanwhile:
+    if (!deletion) {
+        CBLDatabase* db;
+        CBL_LOCK(_mutex) {
+            if (![self checkIsValid: outError])
+                return NO;
+            db = self.database;
+            if (![self database: db isValid: outError])
+                return NO;
+        }
+        if (![CBLBlob installBlobsInDocument: document inDatabase: db error: outError])
+            return NO;
+    }
+    
     CBL_LOCK(_mutex) {
         if (![self checkIsValid: outError])
             return NO;
@@ -661,170 +763,248 @@ NSString* const kCBLDefaultCollectionName = @"_default";
 
 #pragma mark - RESOLVING REPLICATED CONFLICTS:
 
+namespace {
+    // A conflicting document being resolved:
+    struct ConflictResolution {
+        NSString* docID;
+        CBLDocument* localDoc;
+        CBLDocument* remoteDoc;
+        CBLDocument* resolvedDoc;
+        NSError* error;
+    };
+}
+
 - (bool) resolveConflictInDocument: (NSString*)docID
               withConflictResolver: (id<CBLConflictResolver>)conflictResolver
                              error: (NSError**)outError {
-    while (true) {
-        CBLDocument* localDoc;
-        CBLDocument* remoteDoc;
+    NSError* error = [self resolveConflictsInDocuments: @[docID]
+                                  withConflictResolver: conflictResolver][docID];
+    if (!error)
+        return YES;
+    
+    if (outError)
+        *outError = error;
+    return NO;
+}
+
+- (NSDictionary<NSString*, NSError*>*) resolveConflictsInDocuments: (NSArray<NSString*>*)docIDs
+                                              withConflictResolver: (id<CBLConflictResolver>)conflictResolver {
+    conflictResolver = conflictResolver ?: [CBLConflictResolver default];
+    
+    NSMutableDictionary<NSString*, NSError*>* errors = [NSMutableDictionary dictionary];
+    NSArray<NSString*>* pending = [NSOrderedSet orderedSetWithArray: docIDs].array;
+    while (pending.count > 0) {
+        std::vector<ConflictResolution> conflicts;
+        conflicts.reserve(pending.count);
         
-        // Get latest local and remote document revisions from DB
+        // Get latest local and remote document revisions of all documents from DB
         CBL_LOCK(_mutex) {
-            // Read local document:
-            localDoc = [[CBLDocument alloc] initWithCollection: self
-                                                    documentID: docID
-                                                includeDeleted: YES
-                                                  contentLevel: kDocGetCurrentRev
-                                                         error: outError];
-            if (!localDoc) {
-                CBLWarn(Sync, @"Unable to find the document %@ during conflict resolution,\
-                        skipping...", docID);
-                return NO;
-            }
-            
-            // Read the conflicting remote revision:
-            remoteDoc = [[CBLDocument alloc] initWithCollection: self
-                                                     documentID: docID
-                                                 includeDeleted: YES
-                                                   contentLevel: kDocGetAll
-                                                          error: outError];
-            if (!remoteDoc || ![remoteDoc selectConflictingRevision]) {
-                CBLWarn(Sync, @"Unable to select conflicting revision for %@, the conflict may "
-                        "have been resolved...", docID);
-                // this means no conflict, so returning success
-                return YES;
+            for (NSString* docID in pending) {
+                // Read local document:
+                NSError* error = nil;
+                CBLDocument* localDoc = [[CBLDocument alloc] initWithCollection: self
+                                                                     documentID: docID
+                                                                 includeDeleted: YES
+                                                                   contentLevel: kDocGetCurrentRev
+                                                                          error: &error];
+                if (!localDoc) {
+                    CBLWarn(Sync, @"Unable to find the document %@ during conflict resolution,\
+                            skipping...", docID);
+                    if (!error)
+                        createError(CBLErrorNotFound, &error);
+                    errors[docID] = error;
+                    continue;
+                }
+                
+                // Read the conflicting remote revision:
+                CBLDocument* remoteDoc = [[CBLDocument alloc] initWithCollection: self
+                                                                      documentID: docID
+                                                                  includeDeleted: YES
+                                                                    contentLevel: kDocGetAll
+                                                                           error: nullptr];
+                if (!remoteDoc || ![remoteDoc selectConflictingRevision]) {
+                    CBLWarn(Sync, @"Unable to select conflicting revision for %@, the conflict may "
+                            "have been resolved...", docID);
+                    // this means no conflict, so it's a success
+                    continue;
+                }
+                
+                conflicts.push_back({docID, localDoc, remoteDoc, nil, nil});
             }
         }
         
-        conflictResolver = conflictResolver ?: [CBLConflictResolver default];
+        // Resolve conflicts outside the lock, in parallel:
+        ConflictResolution* items = conflicts.data();
+        dispatch_apply(conflicts.size(), DISPATCH_APPLY_AUTO, ^(size_t i) {
+            [self resolveConflict: items[i] withConflictResolver: conflictResolver];
+        });
+        
+        // Save the resolved documents in one transaction, and retry the ones that
+        // have been updated since they were read:
+        NSMutableArray<NSString*>* retry = [NSMutableArray array];
+        [self saveResolvedConflicts: conflicts retry: retry];
+        
+        for (auto& c : conflicts) {
+            if (c.error)
+                errors[c.docID] = c.error;
+        }
+        pending = retry;
+    }
+    return errors;
+}
+
+- (void) resolveConflict: (ConflictResolution&)c
+    withConflictResolver: (id<CBLConflictResolver>)conflictResolver {
+    @try {
+        CBLLogInfo(Sync, @"Resolving doc '%@' (localDoc=%@ and remoteDoc=%@)",
+                   c.docID, c.localDoc.revisionID, c.remoteDoc.revisionID);
         
-        // Resolve conflict:
         CBLDocument* resolvedDoc;
-        @try {
-            CBLLogInfo(Sync, @"Resolving doc '%@' (localDoc=%@ and remoteDoc=%@)",
-                       docID, localDoc.revisionID, remoteDoc.revisionID);
-            
-            if (localDoc.isDeleted && remoteDoc.isDeleted) {
-                resolvedDoc = remoteDoc;
-            } else {
-                CBLConflict* conflict = [[CBLConflict alloc] initWithID: docID
-                                                          localDocument: localDoc.isDeleted ? nil : localDoc
-                                                         remoteDocument: remoteDoc.isDeleted ? nil : remoteDoc];
-                
-                resolvedDoc = [conflictResolver resolve: conflict];
-            }
-            
-            if (resolvedDoc && resolvedDoc.id != docID) {
-                CBLWarn(Sync, @"The document ID of the resolved document '%@' is not matching "
-                        "with the document ID of the conflicting document '%@'.",
-                        resolvedDoc.id, docID);
-            }
+        if (c.localDoc.isDeleted && c.remoteDoc.isDeleted) {
+            resolvedDoc = c.remoteDoc;
+        } else {
+            CBLConflict* conflict = [[CBLConflict alloc] initWithID: c.docID
+                                                      localDocument: c.localDoc.isDeleted ? nil : c.localDoc
+                                                     remoteDocument: c.remoteDoc.isDeleted ? nil : c.remoteDoc];
             
-            if (resolvedDoc && resolvedDoc.collection && resolvedDoc.collection != self) {
-                [NSException raise: NSInternalInconsistencyException
-                            format: kCBLErrorMessageResolvedDocWrongDb,
-                 resolvedDoc.collection.name, self.name];
-            }
-        } @catch (NSException *ex) {
-            CBLWarn(Sync, @"Exception in conflict resolver: %@", ex.description);
-            *outError = [NSError errorWithDomain: CBLErrorDomain
-                                            code: CBLErrorConflict
-                                        userInfo: @{NSLocalizedDescriptionKey: ex.description}];
-            return NO;
+            resolvedDoc = [conflictResolver resolve: conflict];
         }
         
-        NSError* err;
-        BOOL success = [self saveResolvedDocument: resolvedDoc withLocalDoc: localDoc
-                                        remoteDoc: remoteDoc error: &err];
-        
-        if ($equal(err.domain, CBLErrorDomain) && err.code == CBLErrorConflict)
-            continue;
-        
-        if (outError)
-            *outError = err;
+        if (resolvedDoc && resolvedDoc.id != c.docID) {
+            CBLWarn(Sync, @"The document ID of the resolved document '%@' is not matching "
+                    "with the document ID of the conflicting document '%@'.",
+                    resolvedDoc.id, c.docID);
+        }
         
-        return success;
+        if (resolvedDoc && resolvedDoc.collection && resolvedDoc.collection != self) {
+            [NSException raise: NSInternalInconsistencyException
+                        format: kCBLErrorMessageResolvedDocWrongDb,
+             resolvedDoc.collection.name, self.name];
+        }
+        c.resolvedDoc = resolvedDoc;
+    } @catch (NSException *ex) {
+        CBLWarn(Sync, @"Exception in conflict resolver: %@", ex.description);
+        c.error = [NSError errorWithDomain: CBLErrorDomain
+                                      code: CBLErrorConflict
+                                  userInfo: @{NSLocalizedDescriptionKey: ex.description}];
     }
 }
 
-- (BOOL) saveResolvedDocument: (CBLDocument*)resolvedDoc
-                 withLocalDoc: (CBLDocument*)localDoc
-                    remoteDoc: (CBLDocument*)remoteDoc
-                        error: (NSError**)outError
+- (void) saveResolvedConflicts: (std::vector<ConflictResolution>&)conflicts
+                         retry: (NSMutableArray<NSString*>*)retry
 {
+    auto failAll = [&](NSError* error) {
+        for (auto& c : conflicts) {
+            if (!c.error)
+                c.error = error;
+        }
+        [retry removeAllObjects];
+    };
+    
     CBL_LOCK(_mutex) {
-        CBLStringBytes winningRevID;
-        CBLStringBytes losingRevID;
-        
+        NSError* error = nil;
         CBLDatabase* db = self.database;
-        if (![self database: db isValid: outError])
-            return NO;
-        
-        C4Transaction t(db.c4db);
-        if (!t.begin())
-            return convertError(t.error(), outError);
-        
-        if (!resolvedDoc) {
-            if (localDoc.isDeleted)
-                resolvedDoc = localDoc;
-            
-            if (remoteDoc.isDeleted)
-                resolvedDoc = remoteDoc;
+        if (![self database: db isValid: &error]) {
+            failAll(error);
+            return;
         }
         
-        if (resolvedDoc == localDoc) {
-            winningRevID = localDoc.revisionID;
-            losingRevID = remoteDoc.revisionID;
-        } else {
-            resolvedDoc.collection = self;
-            winningRevID = remoteDoc.revisionID;
-            losingRevID = localDoc.revisionID;
+        C4Transaction t(db.c4db);
+        if (!t.begin()) {
+            convertError(t.error(), &error);
+            failAll(error);
+            return;
         }
         
-        // mergedRevFlags:
-        C4RevisionFlags mergedFlags = 0;
-        
-        // mergedBody:
-        alloc_slice mergedBody;
-        if (resolvedDoc != localDoc && resolvedDoc != remoteDoc) {
-            if (resolvedDoc) {
-                // Unless the remote revision is being used as-is, we need a new revision:
-                NSError* err = nil;
-                mergedBody = [resolvedDoc encodeWithRevFlags: &mergedFlags error: &err];
-                if (err) {
-                    createError(CBLErrorUnexpectedError, err.localizedDescription, outError);
-                    return NO;
-                }
-                
-                if (!mergedBody) {
-                    createError(CBLErrorUnexpectedError, kCBLErrorMessageResolvedDocContainsNull, outError);
-                    return NO;
-                }
-            } else
-                mergedBody = [self emptyFLSliceResult: db];
+        for (auto& c : conflicts) {
+            if (c.error)
+                continue;
+            
+            NSError* err = nil;
+            if (![self saveResolvedDocument: c.resolvedDoc withLocalDoc: c.localDoc
+                                  remoteDoc: c.remoteDoc error: &err]) {
+                if ($equal(err.domain, CBLErrorDomain) && err.code == CBLErrorConflict)
+                    [retry addObject: c.docID];
+                else
+                    c.error = err;
+            }
         }
         
-        mergedFlags |= resolvedDoc.c4Doc != nil ? resolvedDoc.c4Doc.revFlags : 0;
-        if (!resolvedDoc || resolvedDoc.isDeleted)
-            mergedFlags |= kRevDeleted;
-        
-        // Tell LiteCore to do the resolution:
-        C4Document *c4doc = localDoc.c4Doc.rawDoc;
-        C4Error c4err;
-        if (!c4doc_resolveConflict(c4doc,
-                                   winningRevID,
-                                   losingRevID,
-                                   mergedBody,
-                                   mergedFlags,
-                                   &c4err)
-            || !c4doc_save(c4doc, 0, &c4err)) {
-            return convertError(c4err, outError);
+        if (!t.commit()) {
+            convertError(t.error(), &error);
+            failAll(error);
         }
-        CBLLogInfo(Sync, @"Conflict resolved as doc '%@' rev %.*s",
-                   localDoc.id, (int)c4doc->revID.size, (char*)c4doc->revID.buf);
+    }
+}
+
+// Must be called in a transaction:
+- (BOOL) saveResolvedDocument: (CBLDocument*)resolvedDoc
+                 withLocalDoc: (CBLDocument*)localDoc
+                    remoteDoc: (CBLDocument*)remoteDoc
+                        error: (NSError**)outError
+{
+    CBLStringBytes winningRevID;
+    CBLStringBytes losingRevID;
+    
+    if (!resolvedDoc) {
+        if (localDoc.isDeleted)
+            resolvedDoc = localDoc;
         
-        return t.commit() || convertError(t.error(), outError);
+        if (remoteDoc.isDeleted)
+            resolvedDoc = remoteDoc;
+    }
+    
+    if (resolvedDoc == localDoc) {
+        winningRevID = localDoc.revisionID;
+        losingRevID = remoteDoc.revisionID;
+    } else {
+        resolvedDoc.collection = self;
+        winningRevID = remoteDoc.revisionID;
+        losingRevID = localDoc.revisionID;
+    }
+    
+    // mergedRevFlags:
+    C4RevisionFlags mergedFlags = 0;
+    
+    // mergedBody:
+    alloc_slice mergedBody;
+    if (resolvedDoc != localDoc && resolvedDoc != remoteDoc) {
+        if (resolvedDoc) {
+            // Unless the remote revision is being used as-is, we need a new revision:
+            NSError* err = nil;
+            mergedBody = [resolvedDoc encodeWithRevFlags: &mergedFlags error: &err];
+            if (err) {
+                createError(CBLErrorUnexpectedError, err.localizedDescription, outError);
+                return NO;
+            }
+            
+            if (!mergedBody) {
+                createError(CBLErrorUnexpectedError, kCBLErrorMessageResolvedDocContainsNull, outError);
+                return NO;
+            }
+        } else
+            mergedBody = [self emptyFLSliceResult: self.database];
     }
+    
+    mergedFlags |= resolvedDoc.c4Doc != nil ? resolvedDoc.c4Doc.revFlags : 0;
+    if (!resolvedDoc || resolvedDoc.isDeleted)
+        mergedFlags |= kRevDeleted;
+    
+    // Tell LiteCore to do the resolution:
+    C4Document *c4doc = localDoc.c4Doc.rawDoc;
+    C4Error c4err;
+    if (!c4doc_resolveConflict(c4doc,
+                               winningRevID,
+                               losingRevID,
+                               mergedBody,
+                               mergedFlags,
+                               &c4err)
+        || !c4doc_save(c4doc, 0, &c4err)) {
+        return convertError(c4err, outError);
+    }
+    CBLLogInfo(Sync, @"Conflict resolved as doc '%@' rev %.*s",
+               localDoc.id, (int)c4doc->revID.size, (char*)c4doc->revID.buf);
+    return YES;
 }
 
 - (FLSliceResult) emptyFLSliceResult: (CBLDatabase*)db {
@@ -947,25 +1127,23 @@ static void colObserverCallback(C4CollectionObserver* obs, void* context) {
         C4DatabaseChange changes[kMaxChanges];
         bool external = false;
         C4CollectionObservation obs = {};
-        NSMutableArray* docIDs = [NSMutableArray new];
+        cbl::CollectionChanges pending;
         do {
             // Read changes in batches of kMaxChanges:
             obs = c4dbobs_getChanges(_colObs, changes, kMaxChanges);
-            if (obs.numChanges == 0 || external != obs.external || docIDs.count > 1000) {
-                if(docIDs.count > 0) {
+            if (obs.numChanges == 0 || external != obs.external || pending.count() > 1000) {
+                if (pending.count() > 0) {
                     CBLCollectionChange* change = [[CBLCollectionChange alloc] initWithCollection: self
-                                                                                      documentIDs: docIDs
+                                                                                          changes: std::move(pending)
                                                                                        isExternal: external];
                     [_colChangeNotifier postChange: change];
-                    docIDs = [NSMutableArray new];
+                    pending = cbl::CollectionChanges();
                 }
             }
             
             external = obs.external;
-            for(uint32_t i = 0; i < obs.numChanges; i++) {
-                NSString *docID =slice2string(changes[i].docID);
-                [docIDs addObject: docID];
-            }
+            for(uint32_t i = 0; i < obs.numChanges; i++)
+                pending.add(changes[i].docID, changes[i].sequence);
             c4dbobs_releaseChanges(changes, obs.numChanges);
         } while(obs.numChanges > 0);
     }
@@ -988,22 +1166,56 @@ static void colObserverCallback(C4CollectionObserver* obs, void* context) {
 
 - (void) removeDocumentChangeListenerWithToken: (CBLChangeListenerToken*)token {
     CBL_LOCK(_mutex) {
-        NSString* documentID = (NSString*)token.context;
-        CBLDocumentChangeNotifier* notifier = _docChangeNotifiers[documentID];
-        if (notifier && [notifier removeChangeListenerWithToken: token] == 0) {
-            [notifier stop];
-            [_docChangeNotifiers removeObjectForKey:documentID];
+        CBLStringBytes docID((NSString*)token.context);
+        auto i = _docListeners.find(docID.bytes);
+        if (i != _docListeners.end() && [i->second.notifier removeChangeListenerWithToken: token] == 0) {
+            _docListeners.erase(i);
+            if (_docListeners.empty()) {
+                c4dbobs_free(_docObs);
+                _docObs = nullptr;
+            }
         }
     }
 }
 
+static void docObserverCallback(C4CollectionObserver* obs, void* context) {
+    CBLCollection *c = (__bridge CBLCollection *)context;
+    dispatch_async(c.dispatchQueue, ^{
+        [c postDocumentsChanged];
+    });
+}
+
+// Drains the document listener observer and notifies the listeners of each changed document.
+// Changes are read and posted in commit order on the collection's serial dispatch queue, so
+// the notifications of any one document are delivered in order.
+- (void) postDocumentsChanged {
+    CBL_LOCK(_mutex) {
+        if (!_docObs || !_c4col)
+            return;
+        
+        const uint32_t kMaxChanges = 100u;
+        C4DatabaseChange changes[kMaxChanges];
+        C4CollectionObservation obs = {};
+        do {
+            obs = c4dbobs_getChanges(_docObs, changes, kMaxChanges);
+            for (uint32_t n = 0; n < obs.numChanges; n++) {
+                auto i = _docListeners.find(changes[n].docID);
+                if (i != _docListeners.end())
+                    [i->second.notifier postChange];
+            }
+            c4dbobs_releaseChanges(changes, obs.numChanges);
+        } while (obs.numChanges > 0);
+    }
+}
+
 - (void) freeC4Observer {
     c4dbobs_free(_colObs);
     _colObs = nullptr;
     _colChangeNotifier = nil;
 
-    [_docChangeNotifiers.allValues makeObjectsPerformSelector: @selector(stop)];
-    _docChangeNotifiers = nil;
+    c4dbobs_free(_docObs);
+    _docObs = nullptr;
+    _docListeners.clear();
 }
 
 - (nullable NSArray*) indexesInfo: (NSError**)error {
@@ -26,9 +26,15 @@ NS_ASSUME_NONNULL_BEGIN
 /** The collection change event  */
 @interface CBLCollectionChange : NSObject
 
-/** The IDs of the document that changed. */
+/** The IDs of the document that changed. The IDs are converted to strings when first accessed. */
 @property (readonly, nonatomic) NSArray<NSString*>* documentIDs;
 
+/** The sequence numbers of the changed documents, in the same order as the documentIDs. */
+@property (readonly, nonatomic) NSArray<NSNumber*>* sequences;
+
+/** The number of documents that changed. */
+@property (readonly, nonatomic) NSUInteger count;
+
 /** Collection. */
 @property (readonly, nonatomic) CBLCollection* collection;
 
@@ -0,0 +1,78 @@
+//
+//  CBLCollectionChange.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2022 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CBLCollectionChange.h"
+#import "CBLCollection+Internal.h"
+#import "CBLCoreBridge.h"
+
+@implementation CBLCollectionChange {
+    cbl::CollectionChanges _changes;
+    NSArray<NSString*>* _documentIDs;
+    NSArray<NSNumber*>* _sequences;
+}
+
+@synthesize collection=_collection, isExternal=_isExternal;
+
+- (instancetype) initWithCollection: (CBLCollection *)collection
+                            changes: (cbl::CollectionChanges&&)changes
+                         isExternal: (BOOL)isExternal {
+    self = [super init];
+    if (self) {
+        _collection = collection;
+        _changes = std::move(changes);
+        _isExternal = isExternal;
+    }
+    return self;
+}
+
+- (const cbl::CollectionChanges&) changes {
+    return _changes;
+}
+
+- (NSUInteger) count {
+    return _changes.count();
+}
+
+- (NSArray<NSString*>*) documentIDs {
+    CBL_LOCK(self) {
+        if (!_documentIDs) {
+            NSMutableArray* docIDs = [NSMutableArray arrayWithCapacity: _changes.count()];
+            for (auto& range : _changes.ranges) {
+                NSString* docID = slice2string({_changes.docIDs.data() + range.first, range.second});
+                [docIDs addObject: docID ?: @""];
+            }
+            _documentIDs = docIDs;
+        }
+        return _documentIDs;
+    }
+}
+
+- (NSArray<NSNumber*>*) sequences {
+    CBL_LOCK(self) {
+        if (!_sequences) {
+            NSMutableArray* sequences = [NSMutableArray arrayWithCapacity: _changes.count()];
+            for (uint64_t seq : _changes.sequences)
+                [sequences addObject: @(seq)];
+            _sequences = sequences;
+        }
+        return _sequences;
+    }
+}
+
+@end
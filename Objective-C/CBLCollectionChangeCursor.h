@@ -0,0 +1,82 @@
+//
+//  CBLCollectionChangeCursor.h
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+#import <CouchbaseLite/CBLDocumentFlags.h>
+
+@class CBLCollection;
+@class CBLChangedDocument;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A pull-based cursor over the changes made to a collection, in sequence order. Each call to
+ -nextBatch: reads at most `limit` changes after the cursor's lastSequence, so a consumer can pull
+ at its own rate with bounded memory. Only the latest change of each document is visible.
+ 
+ To resume after a restart, persist lastSequence after processing a batch and pass it to
+ -[CBLCollection changesSinceSequence:limit:error:].
+ */
+@interface CBLCollectionChangeCursor : NSObject
+
+/** The collection. */
+@property (nonatomic, readonly) CBLCollection* collection;
+
+/** The maximum number of changes returned by each -nextBatch: call. */
+@property (nonatomic, readonly) NSUInteger limit;
+
+/** The sequence of the last change returned by -nextBatch:, or the starting sequence if no
+    changes have been returned yet. */
+@property (atomic, readonly) uint64_t lastSequence;
+
+/**
+ Returns the next batch of changes and advances lastSequence past them. Returns an empty array
+ when there are no more changes; calling it again later returns the changes made since then.
+ 
+ @param error On return, the error if any.
+ @return The changed documents, or nil on failure.
+ */
+- (nullable NSArray<CBLChangedDocument*>*) nextBatch: (NSError**)error;
+
+/** Not available */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+/** CBLChangedDocument describes a document change returned by a CBLCollectionChangeCursor. */
+@interface CBLChangedDocument : NSObject
+
+/** The document ID. */
+@property (nonatomic, readonly) NSString* documentID;
+
+/** The sequence of the change. */
+@property (nonatomic, readonly) uint64_t sequence;
+
+/** The revision ID of the document after the change. */
+@property (nonatomic, readonly) NSString* revisionID;
+
+/** The flags describing the document. */
+@property (nonatomic, readonly) CBLDocumentFlags flags;
+
+/** Not available */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
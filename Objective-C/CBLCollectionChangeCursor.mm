@@ -0,0 +1,81 @@
+//
+//  CBLCollectionChangeCursor.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CBLCollectionChangeCursor.h"
+#import "CBLCollection+Internal.h"
+#import "CBLCoreBridge.h"
+
+@implementation CBLCollectionChangeCursor
+
+@synthesize collection=_collection, limit=_limit, lastSequence=_lastSequence;
+
+- (instancetype) initWithCollection: (CBLCollection*)collection
+                      sinceSequence: (uint64_t)sequence
+                              limit: (NSUInteger)limit
+{
+    self = [super init];
+    if (self) {
+        _collection = collection;
+        _lastSequence = sequence;
+        _limit = limit;
+    }
+    return self;
+}
+
+- (nullable NSArray<CBLChangedDocument*>*) nextBatch: (NSError**)error {
+    CBL_LOCK(self) {
+        NSArray<CBLChangedDocument*>* changes = [_collection changedDocumentsSinceSequence: _lastSequence
+                                                                                     limit: _limit
+                                                                                     error: error];
+        if (changes.count > 0)
+            _lastSequence = changes.lastObject.sequence;
+        return changes;
+    }
+}
+
+- (NSString*) description {
+    return [NSString stringWithFormat: @"%@[%@, since=%llu, limit=%lu]", self.class,
+            _collection.fullName, self.lastSequence, (unsigned long)_limit];
+}
+
+@end
+
+@implementation CBLChangedDocument
+
+@synthesize documentID=_documentID, sequence=_sequence, revisionID=_revisionID, flags=_flags;
+
+- (instancetype) initWithDocumentInfo: (const C4DocumentInfo*)info {
+    self = [super init];
+    if (self) {
+        _documentID = slice2string(info->docID);
+        _revisionID = slice2string(info->revID);
+        _sequence = info->sequence;
+        _flags = 0;
+        if ((info->flags & kDocDeleted) == kDocDeleted)
+            _flags |= kCBLDocumentFlagsDeleted;
+    }
+    return self;
+}
+
+- (NSString*) description {
+    return [NSString stringWithFormat: @"%@[%@, seq=%llu, rev=%@%@]", self.class, _documentID,
+            _sequence, _revisionID, ((_flags & kCBLDocumentFlagsDeleted) ? @", deleted" : @"")];
+}
+
+@end
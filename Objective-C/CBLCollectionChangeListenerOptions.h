@@ -0,0 +1,46 @@
+//
+//  CBLCollectionChangeListenerOptions.h
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Options for batching the collection change events delivered to a change listener.
+ By default, each change event is delivered as soon as it is available.
+ */
+@interface CBLCollectionChangeListenerOptions : NSObject <NSCopying>
+
+/**
+ The maximum number of changed documents in a single change event. Larger changes are split
+ into multiple events. The default value is 0, which means no limit.
+ */
+@property (nonatomic) NSUInteger maxBatchSize;
+
+/**
+ The maximum time in seconds that a change may be held back so that it can be delivered together
+ with the following changes in a single event. An event is delivered once the delay has passed
+ or once it reaches the maxBatchSize. The default value is 0, which means the changes are
+ delivered without delay.
+ */
+@property (nonatomic) NSTimeInterval maxDelay;
+
+@end
+
+NS_ASSUME_NONNULL_END
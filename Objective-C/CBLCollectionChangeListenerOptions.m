@@ -0,0 +1,33 @@
+//
+//  CBLCollectionChangeListenerOptions.m
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CBLCollectionChangeListenerOptions.h"
+
+@implementation CBLCollectionChangeListenerOptions
+
+@synthesize maxBatchSize=_maxBatchSize, maxDelay=_maxDelay;
+
+- (id) copyWithZone: (nullable NSZone*)zone {
+    CBLCollectionChangeListenerOptions* o = [[self.class alloc] init];
+    o.maxBatchSize = _maxBatchSize;
+    o.maxDelay = _maxDelay;
+    return o;
+}
+
+@end
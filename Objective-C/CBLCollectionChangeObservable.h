@@ -18,6 +18,7 @@
 //
 
 #import <CouchbaseLite/CBLCollectionChange.h>
+#import <CouchbaseLite/CBLCollectionChangeListenerOptions.h>
 #import <CouchbaseLite/CBLListenerToken.h>
 
 NS_ASSUME_NONNULL_BEGIN
@@ -52,6 +53,23 @@ NS_ASSUME_NONNULL_BEGIN
 - (id<CBLListenerToken>) addChangeListenerWithQueue: (nullable dispatch_queue_t)queue
                                            listener: (void (^)(CBLCollectionChange*))listener;
 
+/**
+ Add a change listener to listen to change events occurring to any documents in the collection,
+ with options for batching the change events delivered to the listener.
+ If a dispatch queue is given, the events will be posted on the dispatch queue.
+ To remove the listener, call remove() function on the returned listener token.
+ 
+ If the collection is deleted or the database is closed, a warning message will be logged.
+ 
+ @param queue The dispatch queue.
+ @param options The batching options, or nil to deliver each change event as soon as it is available.
+ @param listener The listener to post changes.
+ @return An opaque listener token object for removing the listener
+ */
+- (id<CBLListenerToken>) addChangeListenerWithQueue: (nullable dispatch_queue_t)queue
+                                            options: (nullable CBLCollectionChangeListenerOptions*)options
+                                           listener: (void (^)(CBLCollectionChange*))listener;
+
 
 @end
 
@@ -20,7 +20,7 @@
 #import <Foundation/Foundation.h>
 #import <CouchbaseLite/CBLReplicatorTypes.h>
 
-@class CBLCollection;
+@class CBLCollection, CBLQueryExpression, CBLQueryParameters;
 
 @protocol CBLConflictResolver;
 
@@ -48,6 +48,28 @@ NS_ASSUME_NONNULL_BEGIN
  Only documents of which the function returns true are replicated. */
 @property (nonatomic) CBLReplicationFilter pullFilter;
 
+/**
+ Declarative filter for the documents that can be pushed to the remote endpoint: only documents
+ whose properties match the expression are replicated. Unlike the pushFilter function, the expression
+ is evaluated directly on the encoded revision body without creating a CBLDocument.
+ 
+ The expression may use properties, the document ID (CBLQueryMeta.id), parameters, literals,
+ AND/OR/NOT, the comparison operators, IS [NOT] NULL/MISSING, IS VALUED, IN and BETWEEN; the replicator
+ raises an NSInvalidArgumentException if it uses anything else. Deleted documents and documents whose
+ access was removed are not evaluated by the expression. If the pushFilter function is also set,
+ it is called only for the documents that match the expression. */
+@property (nonatomic, nullable) CBLQueryExpression* pushFilterExpression;
+
+/**
+ Declarative filter for the documents that can be pulled from the remote endpoint. See
+ pushFilterExpression for the supported expressions. */
+@property (nonatomic, nullable) CBLQueryExpression* pullFilterExpression;
+
+/**
+ Parameter values for the parameters referenced by pushFilterExpression and pullFilterExpression.
+ The values are read when the replicator is created. */
+@property (nonatomic, nullable) CBLQueryParameters* filterParameters;
+
 /**
  Channels filter for specifying the channels for the pull the replicator will pull from.
  For any collections that do not have the channels filter specified, all accessible
@@ -19,12 +19,15 @@
 #import "CBLCollectionConfiguration.h"
 #import "CBLCollection+Internal.h"
 #import "CBLPrecondition.h"
+#import "CBLQueryParameters.h"
 
 @implementation CBLCollectionConfiguration
 
 @synthesize collection=_collection;
 @synthesize documentIDs=_documentIDs, channels=_channels;
 @synthesize pushFilter=_pushFilter, pullFilter=_pullFilter;
+@synthesize pushFilterExpression=_pushFilterExpression, pullFilterExpression=_pullFilterExpression;
+@synthesize filterParameters=_filterParameters;
 @synthesize conflictResolver=_conflictResolver;
 
 - (instancetype) initWithCollection: (CBLCollection*)collection {
@@ -43,6 +46,10 @@
         _channels = config.channels;
         _pushFilter = config.pushFilter;
         _pullFilter = config.pullFilter;
+        _pushFilterExpression = config.pushFilterExpression;
+        _pullFilterExpression = config.pullFilterExpression;
+        _filterParameters = config.filterParameters ?
+            [[CBLQueryParameters alloc] initWithParameters: config.filterParameters] : nil;
         _conflictResolver = config.conflictResolver;
     }
     return self;
@@ -0,0 +1,62 @@
+//
+//  CBLDNSCache.h
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The process-wide cache of the addresses the replicators resolve for their servers, shared by
+ all the replicators. Reconnecting to a server uses its cached addresses instead of waiting for
+ the resolver again, until the time-to-live of their DNS records expires or connecting to them
+ fails.
+ */
+@interface CBLDNSCache : NSObject
+
+/** The shortest time in seconds addresses are cached, even if their records' TTL is shorter.
+    The default value is 5 seconds. Setting a negative value raises an
+    NSInvalidArgumentException. */
+@property (class, nonatomic) NSTimeInterval minimumTTL;
+
+/** The longest time in seconds addresses are cached, even if their records' TTL is longer; it
+    takes precedence over a larger minimumTTL. The default value is 300 seconds. Zero disables
+    the cache. Setting a negative value raises an NSInvalidArgumentException. */
+@property (class, nonatomic) NSTimeInterval maximumTTL;
+
+/** The number of lookups answered from the cache. */
+@property (class, readonly, nonatomic) uint64_t hitCount;
+
+/** The number of lookups that had to use the resolver. */
+@property (class, readonly, nonatomic) uint64_t missCount;
+
+/** The number of times cached addresses were removed because connecting to them failed. */
+@property (class, readonly, nonatomic) uint64_t invalidationCount;
+
+/** The fraction of lookups answered from the cache, from 0 to 1. */
+@property (class, readonly, nonatomic) double hitRate;
+
+/** Removes all the cached addresses and resets the counts. */
++ (void) clear;
+
+/** Not available */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
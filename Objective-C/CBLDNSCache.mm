@@ -0,0 +1,71 @@
+//
+//  CBLDNSCache.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CBLDNSCache.h"
+#import "CBLErrorMessage.h"
+#import "CBLHostAddressCache.hh"
+
+using namespace cbl;
+
+static uint64_t nanoseconds(NSTimeInterval seconds) {
+    if (seconds < 0)
+        [NSException raise: NSInvalidArgumentException
+                    format: @"%@", kCBLErrorMessageNegativeDNSCacheTTL];
+    return (uint64_t)(seconds * 1.0e9);
+}
+
+@implementation CBLDNSCache
+
++ (NSTimeInterval) minimumTTL {
+    return HostAddressCache::shared().minTTL() / 1.0e9;
+}
+
++ (void) setMinimumTTL: (NSTimeInterval)minimumTTL {
+    HostAddressCache::shared().setMinTTL(nanoseconds(minimumTTL));
+}
+
++ (NSTimeInterval) maximumTTL {
+    return HostAddressCache::shared().maxTTL() / 1.0e9;
+}
+
++ (void) setMaximumTTL: (NSTimeInterval)maximumTTL {
+    HostAddressCache::shared().setMaxTTL(nanoseconds(maximumTTL));
+}
+
++ (uint64_t) hitCount {
+    return HostAddressCache::shared().stats().hits;
+}
+
++ (uint64_t) missCount {
+    return HostAddressCache::shared().stats().misses;
+}
+
++ (uint64_t) invalidationCount {
+    return HostAddressCache::shared().stats().invalidations;
+}
+
++ (double) hitRate {
+    return HostAddressCache::shared().stats().hitRate();
+}
+
++ (void) clear {
+    HostAddressCache::shared().clear();
+}
+
+@end
@@ -19,6 +19,7 @@
 
 #import "CBLChangeListenerToken.h"
 #import "CBLCollection+Internal.h"
+#import "CBLCookieJar.h"
 #import "CBLCoreBridge.h"
 #import "CBLData.h"
 #import "CBLDatabase.h"
@@ -77,6 +78,7 @@ typedef enum {
     dispatch_source_t _docExpiryTimer;
     
     NSMutableSet<id<CBLDatabaseService>>* _activeServices;
+    NSUInteger _blobInstallCount;       // Blobs being copied into the blob store
     
     NSCondition* _closeCondition;
     
@@ -84,6 +86,8 @@ typedef enum {
     
     CBLCollection* _defaultCollection;
     
+    CBLCookieJar* _cookieJar;
+    
     // this object will be retained and used to lock from outside classes.
     id _mutex;
 }
@@ -92,6 +96,7 @@ typedef enum {
 @synthesize dispatchQueue=_dispatchQueue;
 @synthesize queryQueue=_queryQueue;
 @synthesize c4db=_c4db, sharedKeys=_sharedKeys;
+@synthesize cookieJar=_cookieJar;
 
 static const C4DatabaseConfig2 kDBConfig = {
     .flags = (kC4DB_Create | kC4DB_AutoCompact | kC4DB_VersionVectors),
@@ -154,6 +159,8 @@ static const C4DatabaseConfig2 kDBConfig = {
         _state = kCBLDatabaseStateOpened;
         
         _mutex = [NSObject new];
+        
+        _cookieJar = [[CBLCookieJar alloc] initWithStore: self];
     }
     return self;
 }
@@ -342,40 +349,49 @@ static const C4DatabaseConfig2 kDBConfig = {
         [service stop];
     }
     
-    // Wait until all services report they’re done:
-    [_closeCondition lock];
-    while (![self isReadyToClose]) {
-        [_closeCondition wait];
-    }
-    [_closeCondition unlock];
-    
-    CBL_LOCK(_mutex) {
-        // Close database:
-        C4Error err;
-        if (!c4db_close(_c4db, &err)) {
-            NSError* error = nil;
-            convertError(err, &error);
-            if (outError) {
-                *outError = error;
-            }
-            
-            CBLWarnError(Database, @"%@: Failed to close database at path %@, error %@",
-                         self, self.path, error);
+    while (true) {
+        // Wait until all services report they’re done, and no blob is being installed:
+        [_closeCondition lock];
+        while (![self isReadyToClose]) {
+            [_closeCondition wait];
+        }
+        [_closeCondition unlock];
+        
+        // Finish persisting the cookies, which takes the lock:
+        [_cookieJar flush];
+        
+        CBL_LOCK(_mutex) {
+            // A blob install may have started meanwhile, using the blob store:
+            if (_blobInstallCount > 0)
+                continue;
             
-            // Reset state:
-            _state = kCBLDatabaseStateOpened;
-            return NO;
+            // Close database:
+            C4Error err;
+            if (!c4db_close(_c4db, &err)) {
+                NSError* error = nil;
+                convertError(err, &error);
+                if (outError) {
+                    *outError = error;
+                }
+                
+                CBLWarnError(Database, @"%@: Failed to close database at path %@, error %@",
+                             self, self.path, error);
+                
+                // Reset state:
+                _state = kCBLDatabaseStateOpened;
+                return NO;
+            }
+              
+            // Success, free and set closed state
+            [self freeC4DB];
+            return YES;
         }
-          
-        // Success, free and set closed state
-        [self freeC4DB];
-        return YES;
     }
 }
 
 - (BOOL) isReadyToClose {
     CBL_LOCK(_mutex) {
-        return _activeServices.count == 0;
+        return _activeServices.count == 0 && _blobInstallCount == 0;
     }
 }
 
@@ -881,6 +897,29 @@ static C4DatabaseConfig2 c4DatabaseConfig2 (CBLDatabaseConfiguration *config) {
 
 #pragma mark - Database Services
 
+- (nullable C4BlobStore*) beginBlobInstall: (NSError**)outError {
+    CBL_LOCK(_mutex) {
+        C4BlobStore* store = [self getBlobStore: outError];
+        if (store)
+            _blobInstallCount++;
+        return store;
+    }
+}
+
+- (void) endBlobInstall {
+    BOOL shouldSignal = NO;
+    CBL_LOCK(_mutex) {
+        Assert(_blobInstallCount > 0);
+        shouldSignal = (--_blobInstallCount == 0);
+    }
+    // Broadcast after releasing the lock, as in unregisterActiveService:
+    if (shouldSignal) {
+        [_closeCondition lock];
+        [_closeCondition broadcast];
+        [_closeCondition unlock];
+    }
+}
+
 - (void) registerActiveService: (id<CBLDatabaseService>)service {
     CBL_LOCK(_mutex) {
         [self mustBeOpenAndNotClosing];
@@ -43,6 +43,24 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic) BOOL fullSync;
 
+/**
+ The threshold in seconds above which a query execution is reported as a slow query.
+ When a query result set has been fully enumerated and the time from the start of the
+ execution exceeds the threshold, a warning containing the query's N1QL or JSON text and
+ its CBLQueryStats is logged to the Query domain of the log sinks. The default value
+ is zero, which disables the slow query log.
+ */
+@property (nonatomic) NSTimeInterval slowQueryThreshold;
+
+/**
+ The maximum size in bytes of the buffers used to copy a blob's content stream into the
+ database. The stream is read into one buffer while the other is written; the buffers start
+ small and grow up to this size while the stream fills them, so larger buffers speed up
+ copying large blobs at the expense of memory. The default value, zero, means 1 MB; values
+ smaller than 8 KB are raised to 8 KB.
+ */
+@property (nonatomic) NSUInteger blobBufferSize;
+
 /**
  Initializes the CBLDatabaseConfiguration object.
  */
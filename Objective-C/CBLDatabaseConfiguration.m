@@ -25,7 +25,8 @@
     BOOL _readonly;
 }
 
-@synthesize directory=_directory, fullSync=_fullSync;
+@synthesize directory=_directory, fullSync=_fullSync, slowQueryThreshold=_slowQueryThreshold;
+@synthesize blobBufferSize=_blobBufferSize;
 
 #ifdef COUCHBASE_ENTERPRISE
 @synthesize encryptionKey=_encryptionKey;
@@ -49,6 +50,8 @@
         if (config) {
             _directory = config.directory;
             _fullSync = config.fullSync;
+            _slowQueryThreshold = config.slowQueryThreshold;
+            _blobBufferSize = config.blobBufferSize;
 #ifdef COUCHBASE_ENTERPRISE
             _encryptionKey = config.encryptionKey;
 #endif
@@ -68,6 +71,18 @@
     _directory = directory;
 }
 
+- (void) setSlowQueryThreshold: (NSTimeInterval)slowQueryThreshold {
+    [self checkReadonly];
+    
+    _slowQueryThreshold = slowQueryThreshold;
+}
+
+- (void) setBlobBufferSize: (NSUInteger)blobBufferSize {
+    [self checkReadonly];
+    
+    _blobBufferSize = blobBufferSize;
+}
+
 #ifdef COUCHBASE_ENTERPRISE
 - (void) setEncryptionKey: (CBLEncryptionKey*)encryptionKey {
     [self checkReadonly];
@@ -0,0 +1,87 @@
+//
+//  CBLDecoder.h
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** The type of a Fleece value, matching FLValueType. */
+typedef NS_ENUM(int8_t, CBLDecoderValueType) {
+    kCBLDecoderValueUndefined = -1,
+    kCBLDecoderValueNull = 0,
+    kCBLDecoderValueBoolean,
+    kCBLDecoderValueNumber,
+    kCBLDecoderValueString,
+    kCBLDecoderValueData,
+    kCBLDecoderValueArray,
+    kCBLDecoderValueDict
+};
+
+/**
+ A dictionary key for fast repeated lookups with +[CBLDecoder dict:valueForKey:]. The key
+ caches the shared key mapping after the first lookup, so it should be created once and reused.
+ Lookups with the same key object are serialized.
+ */
+@interface CBLDecoderKey : NSObject
+
+@property (nonatomic, readonly) NSString* name;
+
+- (instancetype) initWithName: (NSString*)name;
+
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+/**
+ Reads Fleece values directly, without converting them into Objective-C objects. The values are
+ passed as opaque FLValue pointers which are only valid while the data that contains them (e.g.
+ the current row of a query result set) is alive.
+ */
+@interface CBLDecoder : NSObject
+
++ (CBLDecoderValueType) valueType: (nullable const void*)value;
+
++ (BOOL) isInteger: (const void*)value;
++ (BOOL) isUnsigned: (const void*)value;
+
++ (BOOL) boolValue: (const void*)value;
++ (int64_t) int64Value: (const void*)value;
++ (uint64_t) uint64Value: (const void*)value;
++ (double) doubleValue: (const void*)value;
+
+/** Returns the UTF-8 bytes of a string value, or NULL if the value is not a string. */
++ (nullable const void*) stringBytes: (const void*)value length: (NSUInteger*)outLength;
+
+/** Returns the number of items of an array or a dictionary value. */
++ (NSUInteger) count: (const void*)value;
+
++ (nullable const void*) array: (const void*)array valueAtIndex: (NSUInteger)index
+NS_SWIFT_NAME(array(_:valueAt:));
+
++ (nullable const void*) dict: (const void*)dict valueForKey: (CBLDecoderKey*)key
+NS_SWIFT_NAME(dict(_:valueFor:));
+
++ (NSArray<NSString*>*) keysOfDict: (const void*)dict
+NS_SWIFT_NAME(keys(ofDict:));
+
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
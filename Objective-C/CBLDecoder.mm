@@ -0,0 +1,122 @@
+//
+//  CBLDecoder.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "fleece/Fleece.hh"
+#import "CBLDecoder.h"
+#import "CBLCoreBridge.h"
+#import "CBLStringBytes.h"
+#import <os/lock.h>
+
+using namespace fleece;
+
+@implementation CBLDecoderKey {
+    alloc_slice _nameSlice;     // FLDictKey points into this
+    FLDictKey _key;
+    os_unfair_lock _lock;
+}
+
+@synthesize name=_name;
+
+- (instancetype) initWithName: (NSString*)name {
+    self = [super init];
+    if (self) {
+        _name = [name copy];
+        _nameSlice = alloc_slice(CBLStringBytes(name).bytes);
+        _key = FLDictKey_Init(_nameSlice);
+        _lock = OS_UNFAIR_LOCK_INIT;
+    }
+    return self;
+}
+
+- (FLValue) lookupInDict: (FLDict)dict {
+    // FLDict_GetWithKey updates the cached shared key in the FLDictKey:
+    os_unfair_lock_lock(&_lock);
+    FLValue value = FLDict_GetWithKey(dict, &_key);
+    os_unfair_lock_unlock(&_lock);
+    return value;
+}
+
+@end
+
+@implementation CBLDecoder
+
++ (CBLDecoderValueType) valueType: (nullable const void*)value {
+    return (CBLDecoderValueType)FLValue_GetType((FLValue)value);
+}
+
++ (BOOL) isInteger: (const void*)value {
+    return FLValue_IsInteger((FLValue)value);
+}
+
++ (BOOL) isUnsigned: (const void*)value {
+    return FLValue_IsUnsigned((FLValue)value);
+}
+
++ (BOOL) boolValue: (const void*)value {
+    return FLValue_AsBool((FLValue)value);
+}
+
++ (int64_t) int64Value: (const void*)value {
+    return FLValue_AsInt((FLValue)value);
+}
+
++ (uint64_t) uint64Value: (const void*)value {
+    return FLValue_AsUnsigned((FLValue)value);
+}
+
++ (double) doubleValue: (const void*)value {
+    return FLValue_AsDouble((FLValue)value);
+}
+
++ (nullable const void*) stringBytes: (const void*)value length: (NSUInteger*)outLength {
+    FLString str = FLValue_AsString((FLValue)value);
+    *outLength = str.size;
+    return str.buf;
+}
+
++ (NSUInteger) count: (const void*)value {
+    switch (FLValue_GetType((FLValue)value)) {
+        case kFLArray: return FLArray_Count(FLValue_AsArray((FLValue)value));
+        case kFLDict:  return FLDict_Count(FLValue_AsDict((FLValue)value));
+        default:       return 0;
+    }
+}
+
++ (nullable const void*) array: (const void*)array valueAtIndex: (NSUInteger)index {
+    return FLArray_Get(FLValue_AsArray((FLValue)array), (uint32_t)index);
+}
+
++ (nullable const void*) dict: (const void*)dict valueForKey: (CBLDecoderKey*)key {
+    return [key lookupInDict: FLValue_AsDict((FLValue)dict)];
+}
+
++ (NSArray<NSString*>*) keysOfDict: (const void*)dict {
+    FLDict d = FLValue_AsDict((FLValue)dict);
+    NSMutableArray* keys = [NSMutableArray arrayWithCapacity: FLDict_Count(d)];
+    FLDictIterator i;
+    FLDictIterator_Begin(d, &i);
+    for (; FLDictIterator_GetValue(&i); FLDictIterator_Next(&i)) {
+        NSString* key = slice2string(FLDictIterator_GetKeyString(&i));
+        if (key)
+            [keys addObject: key];
+    }
+    return keys;
+}
+
+@end
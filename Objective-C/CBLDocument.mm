@@ -63,11 +63,14 @@ using namespace fleece;
     NSParameterAssert(documentID != nil);
     NSParameterAssert(revisionID != nil);
     NSParameterAssert(collection != nil);
-    self = [self initWithCollection: collection documentID: documentID c4Doc: nil];
+    self = [super init];
     if (self) {
+        _collection = collection;
+        _id = documentID;
         _fleeceData = body;
         _revID = revisionID;
-        [self updateDictionary];
+        // The dictionary is created on first access (see -dict), so that the replication
+        // filters that don't read the document's properties don't pay for it.
     }
     return self;
 }
@@ -182,7 +185,7 @@ using namespace fleece;
 }
 
 - (NSString*) toJSON {
-    return [_dict toJSON];
+    return [self.dict toJSON];
 }
 
 #pragma mark - Internal
@@ -197,13 +200,23 @@ using namespace fleece;
 }
 
 - (BOOL) isEmpty {
-    return _dict.count == 0;
+    return self.dict.count == 0;
 }
 
 - (void) updateDictionary {
     [self updateDictionaryWithFleeceDoc: nullptr];
 }
 
+- (CBLDictionary*) dict {
+    if (!_dict) {
+        CBL_LOCK(self) {
+            if (!_dict)
+                [self updateDictionary];
+        }
+    }
+    return _dict;
+}
+
 // `fleeceDoc`, if non-null, owns the bytes (and shared-keys Scope) backing _fleeceData;
 // the DocContext retains it so the data stays valid for the lifetime of the dictionary.
 - (void) updateDictionaryWithFleeceDoc: (FLDoc)fleeceDoc {
@@ -286,7 +299,7 @@ using namespace fleece;
     NSError* encodingError = nil;
     FLEncoderContext ctx = { .database = self.collection.database, .outHasAttachment = &hasAttachment, .encodingError = &encodingError };
     FLEncoder_SetExtraInfo(encoder, &ctx);
-    [_dict fl_encodeToFLEncoder: encoder];
+    [self.dict fl_encodeToFLEncoder: encoder];
     if (encodingError != nil) {
         FLEncoder_Reset(encoder);
         if (outError)
@@ -367,78 +380,78 @@ using namespace fleece;
 #pragma mark - CBLDictionary
 
 - (NSUInteger) count {
-    return _dict.count;
+    return self.dict.count;
 }
 
 - (NSArray*) keys {
-    return _dict.keys;
+    return self.dict.keys;
 }
 
 - (nullable id) valueForKey: (nonnull NSString*)key {
-    return [_dict valueForKey: key];
+    return [self.dict valueForKey: key];
 }
 
 - (nullable NSString*) stringForKey: (nonnull NSString*)key {
-    return [_dict stringForKey: key];
+    return [self.dict stringForKey: key];
 }
 
 - (nullable NSNumber*) numberForKey: (nonnull NSString*)key {
-    return [_dict numberForKey: key];
+    return [self.dict numberForKey: key];
 }
 
 - (NSInteger) integerForKey:(nonnull NSString*)key {
-    return [_dict integerForKey: key];
+    return [self.dict integerForKey: key];
 }
 
 - (long long) longLongForKey: (nonnull NSString*)key {
-    return [_dict longLongForKey: key];
+    return [self.dict longLongForKey: key];
 }
 
 - (float) floatForKey: (nonnull NSString*)key {
-    return [_dict floatForKey: key];
+    return [self.dict floatForKey: key];
 }
 
 - (double) doubleForKey: (nonnull NSString*)key {
-    return [_dict doubleForKey: key];
+    return [self.dict doubleForKey: key];
 }
 
 - (BOOL) booleanForKey: (nonnull NSString*)key {
-    return [_dict booleanForKey: key];
+    return [self.dict booleanForKey: key];
 }
 
 - (nullable NSDate*) dateForKey: (nonnull NSString*)key {
-    return [_dict dateForKey: key];
+    return [self.dict dateForKey: key];
 }
 
 - (nullable CBLBlob*) blobForKey: (nonnull NSString*)key {
-    return [_dict blobForKey: key];
+    return [self.dict blobForKey: key];
 }
 
 - (nullable CBLArray*) arrayForKey: (nonnull NSString*)key {
-    return [_dict arrayForKey: key];
+    return [self.dict arrayForKey: key];
 }
 
 - (nullable CBLDictionary*) dictionaryForKey:(nonnull NSString*)key {
-    return [_dict dictionaryForKey: key];
+    return [self.dict dictionaryForKey: key];
 }
 
 - (BOOL) containsValueForKey: (nonnull NSString *)key {
-    return [_dict containsValueForKey: key];
+    return [self.dict containsValueForKey: key];
 }
 
 - (CBLFragment *) objectForKeyedSubscript: (NSString *)key {
-    return [_dict objectForKeyedSubscript: key];
+    return [self.dict objectForKeyedSubscript: key];
 }
 
 - (NSUInteger) countByEnumeratingWithState: (nonnull NSFastEnumerationState*)state
                                    objects: (id  _Nullable __unsafe_unretained* _Nonnull)buffer
                                      count: (NSUInteger)len
 {
-    return [_dict countByEnumeratingWithState: state objects: buffer count: len];
+    return [self.dict countByEnumeratingWithState: state objects: buffer count: len];
 }
 
 - (NSDictionary<NSString *,id>*) toDictionary {
-    return [_dict toDictionary];
+    return [self.dict toDictionary];
 }
 
 #pragma mark - Equality
@@ -457,11 +470,11 @@ using namespace fleece;
     if (![self.id isEqualToString: other.id])
         return NO;
     
-    return [_dict isEqual: other->_dict];
+    return [self.dict isEqual: other.dict];
 }
 
 - (NSUInteger) hash {
-    return [self.collection hash] ^ [self.id hash] ^ [_dict hash];
+    return [self.collection hash] ^ [self.id hash] ^ [self.dict hash];
 }
 
 @end
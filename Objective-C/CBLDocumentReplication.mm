@@ -22,6 +22,10 @@
 #import "CBLCoreBridge.h"
 #import "CBLReplicator.h"
 #import "CBLStatus.h"
+#import "fleece/Fleece.hh"
+#import <vector>
+
+using namespace fleece;
 
 @implementation CBLDocumentReplication
 
@@ -83,3 +87,100 @@
 }
 
 @end
+
+namespace {
+    // An ended document whose strings are in its batch's buffer:
+    struct EndedDocument {
+        slice docID, scope, collection;
+        C4RevisionFlags flags;
+        C4Error error;
+        bool errorIsTransient;
+    };
+
+    bool isConflict(const C4Error &error) {
+        return error.domain == LiteCoreDomain && error.code == kC4ErrorConflict;
+    }
+}
+
+@implementation CBLReplicatedDocumentBatch
+{
+    alloc_slice _strings;                           // Owns the strings of the documents
+    std::vector<EndedDocument> _docs;
+    std::vector<__strong CBLReplicatedDocument*> _objects;   // Created lazily
+}
+
+- (instancetype) initWithDocuments: (const C4DocumentEnded* _Nonnull [_Nonnull])docEnds
+                             count: (size_t)count
+                        errorsOnly: (BOOL)errorsOnly
+{
+    self = [super init];
+    if (self) {
+        // Copy all the strings into one buffer:
+        size_t size = 0;
+        for (size_t i = 0; i < count; ++i) {
+            auto d = docEnds[i];
+            if (!errorsOnly || d->error.code)
+                size += d->docID.size + d->collectionSpec.scope.size + d->collectionSpec.name.size;
+        }
+        _strings = alloc_slice(size);
+        auto dst = (uint8_t*)_strings.buf;
+        auto copy = [&](slice s) {
+            memcpy(dst, s.buf, s.size);
+            slice result(dst, s.size);
+            dst += s.size;
+            return result;
+        };
+        
+        _docs.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto d = docEnds[i];
+            if (errorsOnly && !d->error.code)
+                continue;
+            _docs.push_back({copy(d->docID), copy(d->collectionSpec.scope), copy(d->collectionSpec.name),
+                             d->flags, d->error, d->errorIsTransient});
+        }
+        _objects.resize(_docs.size());
+    }
+    return self;
+}
+
+- (CBLReplicatedDocumentBatch*) batchExcludingConflicts {
+    CBLReplicatedDocumentBatch* batch = [[CBLReplicatedDocumentBatch alloc] init];
+    batch->_strings = _strings;
+    for (auto &doc : _docs) {
+        if (!isConflict(doc.error))
+            batch->_docs.push_back(doc);
+    }
+    batch->_objects.resize(batch->_docs.size());
+    return batch;
+}
+
+- (C4Error) c4ErrorAtIndex: (NSUInteger)index {
+    return _docs.at(index).error;
+}
+
+- (NSUInteger) count {
+    return _docs.size();
+}
+
+- (CBLReplicatedDocument*) objectAtIndex: (NSUInteger)index {
+    // Listeners on different queues may read the same batch:
+    CBL_LOCK(self) {
+        CBLReplicatedDocument* object = _objects.at(index);
+        if (!object) {
+            const EndedDocument &doc = _docs[index];
+            C4DocumentEnded docEnded = {};
+            docEnded.collectionSpec.name = doc.collection;
+            docEnded.collectionSpec.scope = doc.scope;
+            docEnded.docID = doc.docID;
+            docEnded.flags = doc.flags;
+            docEnded.error = doc.error;
+            docEnded.errorIsTransient = doc.errorIsTransient;
+            object = [[CBLReplicatedDocument alloc] initWithC4DocumentEnded: &docEnded];
+            _objects[index] = object;
+        }
+        return object;
+    }
+}
+
+@end
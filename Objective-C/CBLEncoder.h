@@ -39,6 +39,21 @@ NS_ASSUME_NONNULL_BEGIN
 - (bool) writeKey: (NSString*)key;
 - (bool) write: (id)obj;
 
+// Typed writes, which avoid boxing the values into Objective-C objects:
+
+- (bool) writeKeyUTF8: (nullable const void*)bytes length: (NSUInteger)length;
+- (bool) writeNull;
+- (bool) writeBool: (bool)value;
+- (bool) writeInt64: (int64_t)value;
+- (bool) writeUInt64: (uint64_t)value;
+- (bool) writeFloat: (float)value;
+- (bool) writeDouble: (double)value;
+- (bool) writeUTF8: (nullable const void*)bytes length: (NSUInteger)length;
+
+/** Writes a date as an ISO-8601 string in UTC with millisecond precision
+    (e.g. "2025-01-31T12:30:00.000Z"), the same format used by the Swift Codable encoder. */
+- (bool) writeDate: (NSTimeInterval)timeIntervalSince1970;
+
 - (bool) beginArray: (NSUInteger)reserve;
 - (bool) endArray;
 - (bool) beginDict: (NSUInteger)reserve;
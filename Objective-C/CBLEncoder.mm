@@ -105,6 +105,59 @@
     return FLEncoder_WriteKey(_encoder, c4str(key.UTF8String));
 }
 
+- (bool)writeKeyUTF8:(nullable const void*)bytes length:(NSUInteger)length {
+    return FLEncoder_WriteKey(_encoder, {bytes, length});
+}
+
+- (bool)writeNull {
+    return FLEncoder_WriteNull(_encoder);
+}
+
+- (bool)writeBool:(bool)value {
+    return FLEncoder_WriteBool(_encoder, value);
+}
+
+- (bool)writeInt64:(int64_t)value {
+    return FLEncoder_WriteInt(_encoder, value);
+}
+
+- (bool)writeUInt64:(uint64_t)value {
+    return FLEncoder_WriteUInt(_encoder, value);
+}
+
+- (bool)writeFloat:(float)value {
+    return FLEncoder_WriteFloat(_encoder, value);
+}
+
+- (bool)writeDouble:(double)value {
+    return FLEncoder_WriteDouble(_encoder, value);
+}
+
+- (bool)writeUTF8:(nullable const void*)bytes length:(NSUInteger)length {
+    return FLEncoder_WriteString(_encoder, {bytes, length});
+}
+
+- (bool)writeDate:(NSTimeInterval)timeIntervalSince1970 {
+    // Format "YYYY-MM-DDThh:mm:ss.SSSZ" directly instead of using a date formatter:
+    int64_t millis = (int64_t)floor(timeIntervalSince1970 * 1000.0);
+    int64_t secs = millis / 1000, ms = millis % 1000;
+    if (ms < 0) {
+        secs -= 1;
+        ms += 1000;
+    }
+    time_t t = (time_t)secs;
+    struct tm tm;
+    if (!gmtime_r(&t, &tm))
+        return false;
+    char buf[32];
+    int len = snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ",
+                       tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                       tm.tm_hour, tm.tm_min, tm.tm_sec, (int)ms);
+    if (len <= 0 || len >= (int)sizeof(buf))
+        return false;
+    return FLEncoder_WriteString(_encoder, {buf, (size_t)len});
+}
+
 @end
 
 @implementation CBLEncoderContext {
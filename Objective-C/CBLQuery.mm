@@ -22,6 +22,7 @@
 #import "CBLCoreBridge.h"
 #import "CBLDatabase+Internal.h"
 #import "CBLErrorMessage.h"
+#import "CBLMisc.h"
 #import "CBLPropertyExpression.h"
 #import "CBLQuery+Internal.h"
 #import "CBLQuery+JSON.h"
@@ -47,6 +48,8 @@ using namespace fleece;
     C4Query* _c4Query;
     NSDictionary* _columnNames;
     CBLChangeNotifier* _changeNotifier;
+    NSTimeInterval _compileTime;
+    NSNumber* _usesFullScan;
     
     CBLQueryDataSource* _from;
 }
@@ -56,6 +59,7 @@ using namespace fleece;
 @synthesize parameters=_parameters;
 @synthesize expressions=_expressions;
 @synthesize c4query=_c4Query;
+@synthesize compileTime=_compileTime;
 
 #pragma mark - JSON representation
 
@@ -243,6 +247,7 @@ using namespace fleece;
 }
 
 - (nullable CBLQueryResultSet*) execute: (NSError**)outError {
+    NSTimeInterval start = CBLUptime();
     __block C4QueryEnumerator* e;
     __block C4Error c4Err;
     [self.database safeBlock: ^{
@@ -257,7 +262,8 @@ using namespace fleece;
     
     return [[CBLQueryResultSet alloc] initWithQuery: self
                                          enumerator: e
-                                        columnNames: _columnNames];
+                                        columnNames: _columnNames
+                                          startTime: start];
 }
 
 - (id<CBLListenerToken>) addChangeListener: (void (^)(CBLQueryChange*))listener {
@@ -323,6 +329,35 @@ using namespace fleece;
     }
 }
 
+- (BOOL) usesFullScan {
+    CBL_LOCK(self) {
+        if (!_usesFullScan) {
+            NSString* plan = [self explain: nil];
+            _usesFullScan = @([[self class] planHasFullScan: plan]);
+        }
+        return _usesFullScan.boolValue;
+    }
+}
+
+- (NSString*) queryText {
+    if (_language == kC4N1QLQuery)
+        return _expressions;
+    return [[NSString alloc] initWithData: _json encoding: NSUTF8StringEncoding];
+}
+
+// The first line of the explain output is the SQL statement; the rest is the output of
+// SQLite's "EXPLAIN QUERY PLAN". A "SCAN" step without an index is a linear scan of a table.
++ (BOOL) planHasFullScan: (nullable NSString*)plan {
+    NSArray<NSString*>* lines = [plan componentsSeparatedByString: @"\n"];
+    for (NSUInteger i = 1; i < lines.count; i++) {
+        NSString* line = lines[i];
+        if ([line rangeOfString: @"SCAN "].location != NSNotFound &&
+            [line rangeOfString: @"INDEX"].location == NSNotFound)
+            return YES;
+    }
+    return NO;
+}
+
 - (NSUInteger) columnCount {
     CBL_LOCK(self) {
         return c4query_columnCount(_c4Query);
@@ -347,6 +382,7 @@ using namespace fleece;
         __block C4Error c4Err {};
         __block C4Query* query = nil;
         __block NSError* openError = nil;
+        NSTimeInterval start = CBLUptime();
         [self.database safeBlock: ^{
             // Note:
             // The logic to check open is an optional extra safeguard here as LiteCore
@@ -379,6 +415,7 @@ using namespace fleece;
         
         Assert(!_c4Query);
         _c4Query = query;
+        _compileTime = CBLUptime() - start;
 
         // Generate column name dictionary:
         NSMutableDictionary* cols = [NSMutableDictionary dictionary];
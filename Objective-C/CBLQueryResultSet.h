@@ -20,6 +20,7 @@
 #import <Foundation/Foundation.h>
 
 @class CBLQueryResult;
+@class CBLQueryStats;
 
 /** 
  CBLQueryResultSet is a result returned from a query. The CBLQueryResultSet is
@@ -35,6 +36,25 @@
  */
 - (NSArray<CBLQueryResult*>*) allResults;
 
+/**
+ Writes all unenumerated results to the output stream as newline-delimited JSON (NDJSON),
+ one JSON object per row. The rows are encoded directly from the query's Fleece data without
+ creating CBLQueryResult objects, and are written in bounded chunks so that the memory used is
+ independent of the number of rows. The stream must be opened by the caller and is not closed.
+
+ @param stream The opened output stream to write to.
+ @param error On return, the error if any.
+ @return YES on success, NO if the query enumeration or writing to the stream failed.
+ */
+- (BOOL) writeJSONLinesToStream: (NSOutputStream*)stream error: (NSError**)error;
+
+/**
+ The execution statistics of the query result set, including the compile time, the first row
+ latency, the total enumeration time, the number of rows enumerated, and whether the query
+ plan uses a full scan. The stats are final once the result set has been fully enumerated.
+ */
+@property (nonatomic, readonly) CBLQueryStats* stats;
+
 /** Not available */
 - (instancetype) init NS_UNAVAILABLE;
 
@@ -20,18 +20,25 @@
 #import "CBLQueryResultSet.h"
 #import "CBLCoreBridge.h"
 #import "CBLDatabase+Internal.h"
+#import "CBLMisc.h"
 #import "CBLQuery+Internal.h"
 #import "CBLQueryResult.h"
 #import "CBLQueryResultSet+Internal.h"
+#import "CBLQueryResultSet+Swift.h"
 #import "CBLQueryResult+Internal.h"
 #import "CBLQueryResultArray.h"
 #import "CBLStatus.h"
+#import "CBLStringBytes.h"
 #import "c4Query.h"
 #import "CBLFleece.hh"
 #import "MRoot.hh"
+#import <vector>
 
 using namespace fleece;
 
+// Number of bytes of encoded rows buffered before writing them to the output stream:
+static constexpr size_t kJSONLinesChunkSize = 64 * 1024;
+
 namespace cbl {
     // This class is responsible for holding the Fleece data in memory, while objects are using it.
     // The data happens to belong to the C4QueryEnumerator.
@@ -65,6 +72,12 @@ namespace cbl {
     cbl::QueryResultContext* _context;
     C4Error _error;
     BOOL _isAllEnumerated;
+    
+    // Stats:
+    NSTimeInterval _startTime;
+    NSTimeInterval _firstRowTime;
+    NSTimeInterval _endTime;
+    uint64_t _rowCount;
 }
 
 @synthesize columnNames=_columnNames;
@@ -73,12 +86,21 @@ namespace cbl {
 - (instancetype) initWithQuery: (CBLQuery*)query
                     enumerator: (C4QueryEnumerator*)e
                    columnNames: (NSDictionary*)columnNames
+{
+    return [self initWithQuery: query enumerator: e columnNames: columnNames startTime: CBLUptime()];
+}
+
+- (instancetype) initWithQuery: (CBLQuery*)query
+                    enumerator: (C4QueryEnumerator*)e
+                   columnNames: (NSDictionary*)columnNames
+                     startTime: (NSTimeInterval)startTime
 {
     self = [super init];
     if (self) {
         if (!e)
             return nil;
         _query = query;
+        _startTime = startTime;
         _c4enum = e;
         _context = (cbl::QueryResultContext*)(new cbl::QueryResultContext(query.database, e))->retain();
         _columnNames = columnNames;
@@ -94,19 +116,19 @@ namespace cbl {
 
 - (id) nextObject {
     __block id row = nil;
+    __block BOOL ended = NO;
     [self.database safeBlock: ^{
         if (self->_isAllEnumerated)
             return;
         
-        if (c4queryenum_next(self->_c4enum, &self->_error)) {
+        if ([self advanceLocked])
             row = self.currentObject;
-        } else if (self->_error.code) {
-            CBLWarnError(Query, @"%@[%p] error: %d/%d", [self class], self, self->_error.domain, self->_error.code);
-        } else {
-            self->_isAllEnumerated = YES;
-            CBLLogInfo(Query, @"End of query enumeration (%p)", self->_c4enum);
-        }
+        else
+            ended = self->_isAllEnumerated;
     }];
+    
+    if (ended)
+        [self checkSlowQuery];
     return row;
 }
 
@@ -120,8 +142,173 @@ namespace cbl {
     // return [self allObjects];
 }
 
+- (BOOL) writeJSONLinesToStream: (NSOutputStream*)stream error: (NSError**)outError {
+    CBLAssertNotNil(stream);
+    
+    // Precompute the column keys in column order, so that each row is encoded without
+    // converting the column names:
+    std::vector<alloc_slice> keys(_columnNames.count);
+    for (NSString* name in _columnNames) {
+        NSUInteger index = [_columnNames[name] unsignedIntegerValue];
+        if (index < keys.size())
+            keys[index] = alloc_slice(CBLStringBytes(name).bytes);
+    }
+    
+    JSONEncoder enc;
+    FLEncoderContext ctx = { .encodeQueryParameter = false };
+    FLEncoder_SetExtraInfo(enc, &ctx);
+    
+    NSMutableData* buffer = [NSMutableData dataWithCapacity: kJSONLinesChunkSize];
+    __block BOOL ended = NO;
+    while (!ended) {
+        // Encode rows under the database lock until the chunk is full:
+        [self.database safeBlock: ^{
+            if (self->_isAllEnumerated) {
+                ended = YES;
+                return;
+            }
+            while (buffer.length < kJSONLinesChunkSize) {
+                if (![self advanceLocked]) {
+                    ended = YES;
+                    return;
+                }
+                
+                FLArrayIterator columns = self->_c4enum->columns;
+                uint64_t missing = self->_c4enum->missingColumns;
+                enc.beginDict();
+                for (uint32_t i = 0; i < keys.size(); i++) {
+                    if (i < 64 && (missing & (1ULL << i)))
+                        continue;
+                    enc.writeKey(keys[i]);
+                    enc.writeValue(FLArrayIterator_GetValueAt(&columns, i));
+                }
+                enc.endDict();
+                alloc_slice json = enc.finish();
+                enc.reset();
+                [buffer appendBytes: json.buf length: json.size];
+                [buffer appendBytes: "\n" length: 1];
+            }
+        }];
+        
+        // Write the chunk outside of the lock:
+        if (![self writeData: buffer toStream: stream error: outError])
+            return NO;
+        buffer.length = 0;
+    }
+    
+    if (_error.code)
+        return convertError(_error, outError);
+    [self checkSlowQuery];
+    return YES;
+}
+
+- (BOOL) writeData: (NSData*)data toStream: (NSOutputStream*)stream error: (NSError**)outError {
+    const uint8_t* bytes = (const uint8_t*)data.bytes;
+    NSUInteger remaining = data.length;
+    while (remaining > 0) {
+        NSInteger written = [stream write: bytes maxLength: remaining];
+        if (written <= 0) {
+            NSError* error = stream.streamError;
+            if (!error) {
+                return createError(CBLErrorIOError, @"Failed to write query results to the stream",
+                                   outError);
+            }
+            return createError(error, outError);
+        }
+        bytes += written;
+        remaining -= written;
+    }
+    return YES;
+}
+
+- (CBLQueryStats*) stats {
+    __block NSTimeInterval firstRowTime, endTime;
+    __block uint64_t rowCount;
+    __block BOOL complete;
+    [self.database safeBlock: ^{
+        firstRowTime = self->_firstRowTime;
+        rowCount = self->_rowCount;
+        complete = self->_isAllEnumerated;
+        endTime = complete ? self->_endTime : CBLUptime();
+    }];
+    
+    // An empty result has no first row; its latency is the time until the end was reached:
+    NSTimeInterval firstRowLatency = (rowCount > 0 ? firstRowTime : endTime) - _startTime;
+    return [[CBLQueryStats alloc] initWithCompileTime: _query.compileTime
+                                      firstRowLatency: firstRowLatency
+                                      enumerationTime: endTime - _startTime
+                                             rowCount: rowCount
+                                             fullScan: _query.usesFullScan
+                                             complete: complete];
+}
+
+#pragma mark - Swift
+
+- (NSDictionary<NSString*, NSNumber*>*) columnIndexes {
+    return _columnNames;
+}
+
+- (BOOL) advanceRow {
+    __block BOOL hasRow = NO, ended = NO;
+    [self.database safeBlock: ^{
+        if (self->_isAllEnumerated)
+            return;
+        hasRow = [self advanceLocked];
+        ended = self->_isAllEnumerated;
+    }];
+    
+    if (ended)
+        [self checkSlowQuery];
+    return hasRow;
+}
+
+- (nullable const void*) rowValueAtIndex: (NSUInteger)index {
+    if (index >= 64 || (_c4enum->missingColumns & (1ULL << index)))
+        return nullptr;
+    FLArrayIterator columns = _c4enum->columns;
+    return FLArrayIterator_GetValueAt(&columns, (uint32_t)index);
+}
+
+- (nullable id) objectForRowValue: (const void*)value {
+    __block id result;
+    [self.database safeBlock: ^{
+        MRoot<id> root(self->_context, (FLValue)value, false);
+        result = root.asNative();
+    }];
+    return result;
+}
+
 #pragma mark - Internal
 
+// Advances the enumerator to the next row while holding the database lock, and updates the stats.
+// Returns NO at the end of the enumeration or on error.
+- (BOOL) advanceLocked {
+    if (c4queryenum_next(_c4enum, &_error)) {
+        if (_rowCount++ == 0)
+            _firstRowTime = CBLUptime();
+        return YES;
+    }
+    
+    if (_error.code) {
+        CBLWarnError(Query, @"%@[%p] error: %d/%d", [self class], self, _error.domain, _error.code);
+    } else {
+        _isAllEnumerated = YES;
+        _endTime = CBLUptime();
+        CBLLogInfo(Query, @"End of query enumeration (%p)", _c4enum);
+    }
+    return NO;
+}
+
+- (void) checkSlowQuery {
+    NSTimeInterval threshold = self.database.config.slowQueryThreshold;
+    if (threshold <= 0 || _endTime - _startTime < threshold)
+        return;
+    
+    CBLQueryStats* stats = self.stats;
+    CBLWarn(Query, @"Slow query (%.3fms >= %.3fms threshold): %@ %@",
+            stats.enumerationTime * 1000.0, threshold * 1000.0, _query.queryText, stats);
+}
+
 - (CBLDatabase*) database {
     return _query.database;
 }
@@ -170,6 +357,7 @@ namespace cbl {
     __block C4Error c4error;
     __block C4QueryEnumerator *newEnum;
     
+    NSTimeInterval start = CBLUptime();
     CBLDatabase* db = self.database;
     [db safeBlock: ^{
         newEnum = c4queryenum_refresh(self->_c4enum, &c4error);
@@ -181,7 +369,8 @@ namespace cbl {
     }
     return [[CBLQueryResultSet alloc] initWithQuery: _query
                                          enumerator: newEnum
-                                        columnNames: _columnNames];
+                                        columnNames: _columnNames
+                                          startTime: start];
 }
 
 @end
@@ -0,0 +1,54 @@
+//
+//  CBLQueryStats.h
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ CBLQueryStats contains the execution statistics of a query result set.
+ The stats object is a snapshot taken at the time it is requested from the result set;
+ the timings of a result set that has not been fully enumerated are partial.
+ */
+@interface CBLQueryStats : NSObject
+
+/** The time in seconds spent compiling the query. */
+@property (nonatomic, readonly) NSTimeInterval compileTime;
+
+/** The time in seconds from starting the query execution until the first row was available. */
+@property (nonatomic, readonly) NSTimeInterval firstRowLatency;
+
+/** The time in seconds from starting the query execution until the last row was enumerated. */
+@property (nonatomic, readonly) NSTimeInterval enumerationTime;
+
+/** The number of rows enumerated so far. */
+@property (nonatomic, readonly) uint64_t rowCount;
+
+/** YES if the query plan scans a whole collection instead of using an index. */
+@property (nonatomic, readonly) BOOL fullScan;
+
+/** YES if the result set has been fully enumerated. */
+@property (nonatomic, readonly) BOOL complete;
+
+/** Not available */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,56 @@
+//
+//  CBLQueryStats.m
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CBLQueryStats.h"
+#import "CBLQuery+Internal.h"
+
+@implementation CBLQueryStats
+
+@synthesize compileTime=_compileTime, firstRowLatency=_firstRowLatency;
+@synthesize enumerationTime=_enumerationTime, rowCount=_rowCount;
+@synthesize fullScan=_fullScan, complete=_complete;
+
+- (instancetype) initWithCompileTime: (NSTimeInterval)compileTime
+                     firstRowLatency: (NSTimeInterval)firstRowLatency
+                     enumerationTime: (NSTimeInterval)enumerationTime
+                            rowCount: (uint64_t)rowCount
+                            fullScan: (BOOL)fullScan
+                            complete: (BOOL)complete
+{
+    self = [super init];
+    if (self) {
+        _compileTime = compileTime;
+        _firstRowLatency = firstRowLatency;
+        _enumerationTime = enumerationTime;
+        _rowCount = rowCount;
+        _fullScan = fullScan;
+        _complete = complete;
+    }
+    return self;
+}
+
+- (NSString*) description {
+    return [NSString stringWithFormat: @"%@[compile=%.3fms, firstRow=%.3fms, total=%.3fms, "
+                                        "rows=%llu, %@%@]",
+            self.class, _compileTime * 1000.0, _firstRowLatency * 1000.0,
+            _enumerationTime * 1000.0, _rowCount, (_fullScan ? @"full scan" : @"indexed"),
+            (_complete ? @"" : @", incomplete")];
+}
+
+@end
@@ -24,6 +24,7 @@
 @class CBLDocumentReplication;
 @class CBLReplicatorChange;
 @class CBLReplicatorConfiguration;
+@class CBLReplicatorMetrics;
 @class CBLReplicatorStatus;
 @protocol CBLListenerToken;
 
@@ -51,6 +52,12 @@ NS_ASSUME_NONNULL_BEGIN
     for releasing the certificate object when the application code finishes using the certificate. */
 @property (readonly, copy, atomic, nullable) __attribute__((NSObject)) SecCertificateRef serverCertificate;
 
+/** A snapshot of the replicator's throughput and latency metrics. The rates of the snapshot
+    are averaged over the time since the replicator was first started.
+    The per-direction document counts are only collected while a metrics listener or a document
+    replication listener is registered; otherwise they stay zero. */
+@property (readonly, atomic) CBLReplicatorMetrics* metrics;
+
 /** The ID used to correlate the replication session with the remote endpoint.
     This value is intended for logging and diagnostics, and is `nil` until
     the replicator receives a correlation ID from the remote endpoint. */
@@ -135,6 +142,23 @@ the replicator change notification.
 - (id<CBLListenerToken>) addDocumentReplicationListenerWithQueue: (nullable dispatch_queue_t)queue
                                                         listener: (void (^)(CBLDocumentReplication*))listener;
 
+/**
+ Adds a metrics listener that is called periodically with a snapshot of the replicator's metrics,
+ whose rates are measured over the time since the previous call. If the dispatch queue is not
+ specified, the metrics will be posted on the main queue.
+ 
+ The per-direction document counts are collected while a metrics listener is registered; like
+ document replication listeners, the listener needs to be added before starting the replicator.
+ 
+ @param interval The time in seconds between two calls; must be greater than zero.
+ @param queue The dispatch queue.
+ @param listener The listener to post the metrics.
+ @return An opaque listener token object for removing the listener.
+ */
+- (id<CBLListenerToken>) addMetricsListenerWithInterval: (NSTimeInterval)interval
+                                                  queue: (nullable dispatch_queue_t)queue
+                                               listener: (void (^)(CBLReplicatorMetrics*))listener;
+
 /**
  Get pending document ids for the given collection. If the given collection is not part of
  the replication, an Illegal State Exception will be thrown.
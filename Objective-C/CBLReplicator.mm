@@ -24,6 +24,7 @@
 #import "CBLCollection+Internal.h"
 #import "CBLDocumentReplication+Internal.h"
 #import "CBLReplicatorChange+Internal.h"
+#import "CBLReplicatorMetrics+Internal.h"
 #import "CBLReplicatorConfiguration.h"
 #import "CBLReplicatorStatus+Internal.h"
 #import "CBLScope.h"
@@ -36,14 +37,18 @@
 #endif
 
 #import "CBLChangeNotifier.h"
+#import "CBLBandwidthLimiter+Internal.h"
+#import "CBLCookieJar.h"
 #import "CBLCoreBridge.h"
 #import "CBLDatabase+Internal.h"
 #import "CBLDocument+Internal.h"
+#import "CBLDocumentPredicate.hh"
 #import "CBLReachability.h"
 #import "CBLStatus.h"
 #import "CBLStringBytes.h"
 #import "CBLErrorMessage.h"
 #import "CBLLockable.h"
+#import "CBLPOSIXWebSocket.hh"
 #import "CBLScope.h"
 #import "CBLWebSocket.h"
 
@@ -52,11 +57,28 @@
 #import "fleece/Fleece.hh"
 
 #import <algorithm>
+#import <atomic>
 #import <vector>
 
 using namespace std;
 using namespace fleece;
 
+// Maximum number of conflicting documents resolved in one batch:
+static const NSUInteger kMaxConflictBatchSize = 500;
+
+namespace {
+    // A replicated collection, looked up by the collection spec given to the push/pull filters:
+    struct FilteredCollection {
+        alloc_slice scope;
+        alloc_slice name;
+        CBLCollection* collection;
+        CBLReplicationFilter pushFilter;
+        CBLReplicationFilter pullFilter;
+        std::unique_ptr<cbl::DocumentPredicate> pushPredicate;  // Compiled pushFilterExpression
+        std::unique_ptr<cbl::DocumentPredicate> pullPredicate;  // Compiled pullFilterExpression
+    };
+}
+
 
 // Replicator progress level types:
 typedef enum {
@@ -96,9 +118,14 @@ typedef enum {
     BOOL _resetCheckpoint;          // Reset the replicator checkpoint
     BOOL _conflictResolutionSuspended;
     NSMutableArray<dispatch_block_t>* _pendingConflicts;
+    NSMutableArray<CBLReplicatedDocument*>* _openConflictBatch; // Conflicts of the next resolution not started yet
     BOOL _deferChangeNotification;  // Defer change notification until finishing all conflict resolving tasks
     SecCertificateRef _serverCertificate;
     NSDictionary* _collectionMap;   // [scopeName.collectionName : CBLCollection]
+    std::vector<FilteredCollection> _filteredCollections;
+    std::shared_ptr<cbl::ReplicatorCounters> _counters;
+    NSMutableSet<CBLChangeListenerToken*>* _metricsTokens;   // Their contexts are the timer sources
+    std::atomic<bool> _hasDocumentListeners;    // Read by the documents ended callback
 }
 
 @synthesize config=_config;
@@ -124,19 +151,56 @@ typedef enum {
         _docReplicationNotifier = [CBLChangeNotifier new];
         _pendingConflicts = [NSMutableArray array];
         _status = [[CBLReplicatorStatus alloc] initWithStatus: {kC4Stopped, {}, {}}];
+        _counters = std::make_shared<cbl::ReplicatorCounters>();
+        _metricsTokens = [NSMutableSet set];
         
         NSString* qName = self.description;
         _dispatchQueue = dispatch_queue_create(qName.UTF8String, DISPATCH_QUEUE_SERIAL);
         
         NSString* cqName = $sprintf(@"%@ : Conflicts", qName);
         _conflictQueue = dispatch_queue_create(cqName.UTF8String, DISPATCH_QUEUE_CONCURRENT);
+        
+        [self compileFilters];
     }
     return self;
 }
 
+static std::unique_ptr<cbl::DocumentPredicate> compileFilter(CBLQueryExpression* expression,
+                                                             CBLQueryParameters* params)
+{
+    if (!expression)
+        return nullptr;
+    NSString* error;
+    auto predicate = cbl::DocumentPredicate::compile(expression, params, &error);
+    if (!predicate)
+        [NSException raise: NSInvalidArgumentException
+                    format: @"Invalid replication filter expression %@: %@", expression, error];
+    return predicate;
+}
+
+// Collects the collections with push/pull filters, compiling their filter expressions:
+- (void) compileFilters {
+    for (CBLCollection* col in _config.collectionConfigMap) {
+        CBLCollectionConfiguration* colConfig = _config.collectionConfigMap[col];
+        if (!colConfig.pushFilter && !colConfig.pullFilter &&
+            !colConfig.pushFilterExpression && !colConfig.pullFilterExpression)
+            continue;
+        
+        FilteredCollection fc {alloc_slice(CBLStringBytes(col.scope.name).bytes),
+                               alloc_slice(CBLStringBytes(col.name).bytes),
+                               col, colConfig.pushFilter, colConfig.pullFilter};
+        fc.pushPredicate = compileFilter(colConfig.pushFilterExpression, colConfig.filterParameters);
+        fc.pullPredicate = compileFilter(colConfig.pullFilterExpression, colConfig.filterParameters);
+        _filteredCollections.push_back(std::move(fc));
+    }
+}
+
 - (void) dealloc {
     [self stopReachability];
     
+    for (CBLChangeListenerToken* token in _metricsTokens)
+        dispatch_source_cancel(token.context);
+    
     // Free C4Replicator:
     c4repl_free(_repl);
     
@@ -183,6 +247,7 @@ typedef enum {
             _state = kCBLStateStarting;
             [self setConflictResolutionSuspended: NO];
             c4repl_start(_repl, reset);
+            _counters->started();
             status = c4repl_getStatus(_repl);
             [_config.database registerActiveService: self];
             
@@ -240,7 +305,9 @@ typedef enum {
     CBLStringBytes replicatorID(_replicatorID);
 
     // Socket factory:
+    NSDictionary* options = _config.effectiveOptions;
     C4SocketFactory socketFactory = { };
+    BOOL posixWebSocket = NO;
     _reachabilityURL = nil;
 #ifdef COUCHBASE_ENTERPRISE
     auto messageEndpoint = $castIf(CBLMessageEndpoint, endpoint);
@@ -251,7 +318,11 @@ typedef enum {
 #endif
     {
         if (remoteURL) {
-            socketFactory = CBLWebSocket.socketFactory;
+            posixWebSocket = [options[@kCBLReplicatorOptionPOSIXWebSocket] boolValue];
+            if (posixWebSocket)
+                socketFactory = cbl::POSIXWebSocket::socketFactory();
+            else
+                socketFactory = CBLWebSocket.socketFactory;
             NSString* hostname = remoteURL.host;
             if (hostname.length > 0 && ![hostname isEqualToString: @"localhost"]
                                     && ![hostname isEqualToString: @"127.0.0.1"]) {
@@ -259,10 +330,13 @@ typedef enum {
             }
         }
     }
-    socketFactory.context = (__bridge void*)self;
+    if (posixWebSocket)
+        socketFactory.context = &_counters;     // The POSIX sockets can't call back to self
+    else
+        socketFactory.context = (__bridge void*)self;
 
     // Parameters:
-    alloc_slice optionsFleece = [self encodedOptions: _config.effectiveOptions];
+    alloc_slice optionsFleece = [self encodedOptions: options];
     C4ReplicatorParameters params = {
         .optionsDictFleece = optionsFleece,
         .onStatusChanged = &statusChanged,
@@ -286,8 +360,8 @@ typedef enum {
             .push = mkmode(isPush(_config.replicatorType), _config.continuous),
             .pull = mkmode(isPull(_config.replicatorType), _config.continuous),
             .optionsDictFleece  = dict,
-            .pushFilter = filter(colConfig.pushFilter, true),
-            .pullFilter = filter(colConfig.pullFilter, false),
+            .pushFilter = filter(colConfig.pushFilter || colConfig.pushFilterExpression, true),
+            .pullFilter = filter(colConfig.pullFilter || colConfig.pullFilterExpression, false),
             .callbackContext    = (__bridge void*)self
         };
         
@@ -353,8 +427,8 @@ static BOOL isPull(CBLReplicatorType type) {
     return type == kCBLReplicatorTypePushAndPull || type == kCBLReplicatorTypePull;
 }
 
-static C4ReplicatorValidationFunction filter(CBLReplicationFilter filter, bool isPush) {
-    return filter != nil ? (isPush ? &pushFilter : &pullFilter) : NULL;
+static C4ReplicatorValidationFunction filter(BOOL hasFilter, bool isPush) {
+    return hasFilter ? (isPush ? &pushFilter : &pullFilter) : NULL;
 }
 
 - (void) stop {
@@ -408,7 +482,7 @@ static C4ReplicatorValidationFunction filter(CBLReplicationFilter filter, bool i
 #pragma mark - CBLWebSocketContext
 
 - (nullable id<CBLCookieStore>) cookieStoreForWebsocket: (CBLWebSocket*)websocket {
-    return _config.database;
+    return _config.database.cookieJar;
 }
 
 - (nullable NSURL*) cookieURLForWebSocket: (CBLWebSocket*)websocket {
@@ -425,6 +499,18 @@ static C4ReplicatorValidationFunction filter(CBLReplicationFilter filter, bool i
     }
 }
 
+- (std::shared_ptr<cbl::ReplicatorCounters>) countersForWebSocket: (CBLWebSocket*)websocket {
+    return _counters;
+}
+
+- (std::shared_ptr<cbl::TokenBucket>) tokenBucketForWebSocket: (CBLWebSocket*)websocket
+                                                      sending: (bool)sending
+{
+    CBLBandwidthLimiter* limiter = sending ? _config.sendBandwidthLimiter
+                                           : _config.receiveBandwidthLimiter;
+    return limiter ? limiter.bucket : nullptr;
+}
+
 #pragma mark - Server Certificate
 
 - (SecCertificateRef) serverCertificate {
@@ -482,18 +568,69 @@ static C4ReplicatorValidationFunction filter(CBLReplicationFilter filter, bool i
 {
     CBL_LOCK(self) {
         [self setProgressLevel: kCBLProgressLevelPerDocument];
+        _hasDocumentListeners = true;
         return [_docReplicationNotifier addChangeListenerWithQueue: queue listener: listener delegate: self];
     }
 }
 
+#pragma mark - METRICS:
+
+- (CBLReplicatorMetrics*) metrics {
+    return [[CBLReplicatorMetrics alloc] initWithSample: _counters->sample() previous: {}];
+}
+
+- (id<CBLListenerToken>) addMetricsListenerWithInterval: (NSTimeInterval)interval
+                                                  queue: (nullable dispatch_queue_t)queue
+                                               listener: (void (^)(CBLReplicatorMetrics*))listener
+{
+    CBLAssertNotNil(listener);
+    if (interval <= 0)
+        [NSException raise: NSInvalidArgumentException
+                    format: @"The metrics interval must be greater than zero"];
+    
+    CBLChangeListenerToken* token = [[CBLChangeListenerToken alloc] initWithListener: listener
+                                                                               queue: queue
+                                                                            delegate: self];
+    uint64_t nanos = (uint64_t)(interval * NSEC_PER_SEC);
+    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, token.queue);
+    dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, nanos), nanos, nanos / 10);
+    
+    // Each listener measures its rates since its previous call:
+    auto counters = _counters;
+    __block cbl::ReplicatorSample previous = counters->sample();
+    __weak CBLChangeListenerToken* weakToken = token;
+    dispatch_source_set_event_handler(timer, ^{
+        cbl::ReplicatorSample sample = counters->sample();
+        [weakToken deliverChange: [[CBLReplicatorMetrics alloc] initWithSample: sample
+                                                                      previous: previous]];
+        previous = sample;
+    });
+    token.context = timer;
+    
+    CBL_LOCK(self) {
+        // The per-direction document counts are taken from the document ended events:
+        [_metricsTokens addObject: token];
+        [self setProgressLevel: kCBLProgressLevelPerDocument];
+    }
+    dispatch_resume(timer);
+    return token;
+}
+
 #pragma mark delegate(CBLRemovableListenerToken)
 
 - (void) removeToken: (id)token {
     [_changeNotifier removeChangeListenerWithToken: token];
     
     CBL_LOCK(self) {
-        if ([_docReplicationNotifier removeChangeListenerWithToken: token] == 0)
-            [self setProgressLevel: kCBLProgressLevelOverall];
+        if ([_metricsTokens containsObject: token]) {
+            dispatch_source_cancel(((CBLChangeListenerToken*)token).context);
+            [_metricsTokens removeObject: token];
+        }
+        if ([_docReplicationNotifier removeChangeListenerWithToken: token] == 0) {
+            _hasDocumentListeners = false;
+            if (_metricsTokens.count == 0)
+                [self setProgressLevel: kCBLProgressLevelOverall];
+        }
     }
 }
 
@@ -640,6 +777,10 @@ static void statusChanged(C4Replicator *repl, C4ReplicatorStatus status, void *c
         CBLDebug(Sync, @"%@ Received C4ReplicatorStatus Changed, status = %d (state = %d)",
                  self, c4Status.level, _state);
         
+        // Count the retries of an offline replicator:
+        if (c4Status.level == kC4Connecting && _state == kCBLStateOffline)
+            cbl::ReplicatorCounters::add(_counters->reconnects, 1);
+        
         // Record raw status:
         _rawStatus = c4Status;
         
@@ -726,11 +867,27 @@ static void onDocsEnded(C4Replicator* repl,
 {
     auto replicator = (__bridge CBLReplicator*)context;
     
-    NSMutableArray* docs = [NSMutableArray new];
+    uint64_t completed = 0, conflicts = 0;
     for (size_t i = 0; i < nDocs; ++i) {
-        [docs addObject: [[CBLReplicatedDocument alloc] initWithC4DocumentEnded: docEnds[i]]];
+        C4Error c4err = docEnds[i]->error;
+        if (!pushing && c4err.domain == LiteCoreDomain && c4err.code == kC4ErrorConflict)
+            ++conflicts;
+        else if (!c4err.code)
+            ++completed;
     }
-   
+    auto &counters = *replicator->_counters;
+    cbl::ReplicatorCounters::add(pushing ? counters.documentsPushed : counters.documentsPulled, completed);
+    cbl::ReplicatorCounters::add(counters.conflicts, conflicts);
+    
+    // Without document listeners, only the failed documents need handling: the conflicts
+    // are resolved and the other errors are logged.
+    bool listening = replicator->_hasDocumentListeners.load();
+    if (!listening && completed == nDocs)
+        return;
+    
+    auto docs = [[CBLReplicatedDocumentBatch alloc] initWithDocuments: docEnds
+                                                                count: nDocs
+                                                           errorsOnly: !listening];
     dispatch_async(replicator->_dispatchQueue, ^{
         [replicator safeBlock:^{
             if (repl == replicator->_repl) {
@@ -741,22 +898,31 @@ static void onDocsEnded(C4Replicator* repl,
 }
 
 // Called inside the lock
-- (void) onDocsEnded: (NSArray<CBLReplicatedDocument*>*)docs pushing: (BOOL)pushing {
-    NSMutableArray* posts = [NSMutableArray array];
-    for (CBLReplicatedDocument *doc in docs) {
-        C4Error c4err = doc.c4Error;
+- (void) onDocsEnded: (CBLReplicatedDocumentBatch*)docs pushing: (BOOL)pushing {
+    // Only the failed documents are converted here; the rest are converted if a listener reads them:
+    BOOL hasConflicts = NO;
+    NSUInteger count = docs.count;
+    for (NSUInteger i = 0; i < count; ++i) {
+        C4Error c4err = [docs c4ErrorAtIndex: i];
+        if (!c4err.code)
+            continue;
         if (!pushing && c4err.domain == LiteCoreDomain && c4err.code == kC4ErrorConflict) {
-            [self scheduleConflictResolutionForDocument: doc];
+            [self scheduleConflictResolutionForDocument: docs[i]];
+            hasConflicts = YES;
         } else {
-            [posts addObject: doc];
-            [self logErrorOnDocument: doc pushing: pushing];
+            [self logErrorOnDocument: docs[i] pushing: pushing];
         }
     }
+    
+    CBLReplicatedDocumentBatch* posts = hasConflicts ? [docs batchExcludingConflicts] : docs;
     if (posts.count > 0)
         [self postDocumentReplications: posts pushing: pushing];
 }
 
 - (void) postDocumentReplications: (NSArray<CBLReplicatedDocument*>*)docs pushing: (BOOL)pushing {
+    if (!_hasDocumentListeners.load())
+        return;
+    
     id replication = [[CBLDocumentReplication alloc] initWithReplicator: self
                                                                  isPush: pushing
                                                               documents: docs];
@@ -778,8 +944,18 @@ static void onDocsEnded(C4Replicator* repl,
         return;
     }
     
+    // Add the conflict to the scheduled resolution that hasn't started yet, if any:
+    if (_openConflictBatch && _openConflictBatch.count < kMaxConflictBatchSize) {
+        [_openConflictBatch addObject: doc];
+        return;
+    }
+    
+    NSMutableArray<CBLReplicatedDocument*>* batch = [NSMutableArray arrayWithObject: doc];
+    _openConflictBatch = batch;
+    uint64_t scheduledAt = cbl::ReplicatorCounters::now();
+    
     dispatch_block_t resolution = dispatch_block_create(DISPATCH_BLOCK_ASSIGN_CURRENT, ^{
-        [self _resolveConflict: doc];
+        [self _resolveConflicts: batch scheduledAt: scheduledAt];
     });
     
     dispatch_block_notify(resolution, _dispatchQueue, ^{
@@ -793,31 +969,64 @@ static void onDocsEnded(C4Replicator* repl,
 }
 
 // Called inside conflict resolution queue:
-- (void) _resolveConflict: (CBLReplicatedDocument*)doc {
+- (void) _resolveConflicts: (NSMutableArray<CBLReplicatedDocument*>*)batch scheduledAt: (uint64_t)scheduledAt {
+    NSArray<CBLReplicatedDocument*>* docs;
     CBL_LOCK(self) {
+        // Close the batch; the conflicts from now on will be scheduled in a new resolution:
+        if (_openConflictBatch == batch)
+            _openConflictBatch = nil;
+        
         if (_conflictResolutionSuspended) {
             return;
         }
+        docs = [batch copy];
     }
     
-    CBLLogInfo(Sync, @"%@ Resolve conflicting version of '%@'", self, doc.id);
-    
-    CBLCollection* c = [_collectionMap objectForKey: $sprintf(@"%@.%@", doc.scope, doc.collection)];
-    Assert(c, kCBLErrorMessageCollectionNotFoundDuringConflict);
-    
-    CBLCollectionConfiguration* colConfig = _config.collectionConfigMap[c];
-    Assert(colConfig, kCBLErrorMessageConfigNotFoundDuringConflict);
+    // Group the documents by collection:
+    NSMutableDictionary<NSString*, NSMutableArray<CBLReplicatedDocument*>*>* collectionDocs =
+        [NSMutableDictionary dictionary];
+    for (CBLReplicatedDocument* doc in docs) {
+        NSString* key = $sprintf(@"%@.%@", doc.scope, doc.collection);
+        NSMutableArray* list = collectionDocs[key];
+        if (!list)
+            collectionDocs[key] = list = [NSMutableArray array];
+        [list addObject: doc];
+    }
     
-    NSError* error = nil;
-    if (![c resolveConflictInDocument: doc.id
-                 withConflictResolver: colConfig.conflictResolver
-                                error: &error]) {
-        CBLWarn(Sync, @"%@ Conflict resolution of '%@' failed: %@", self, doc.id, error);
+    uint64_t resolved = 0;
+    for (NSString* key in collectionDocs) {
+        CBLCollection* c = [_collectionMap objectForKey: key];
+        Assert(c, kCBLErrorMessageCollectionNotFoundDuringConflict);
+        
+        CBLCollectionConfiguration* colConfig = _config.collectionConfigMap[c];
+        Assert(colConfig, kCBLErrorMessageConfigNotFoundDuringConflict);
+        
+        NSArray<CBLReplicatedDocument*>* list = collectionDocs[key];
+        NSMutableArray<NSString*>* docIDs = [NSMutableArray arrayWithCapacity: list.count];
+        for (CBLReplicatedDocument* doc in list)
+            [docIDs addObject: doc.id];
+        
+        CBLLogInfo(Sync, @"%@ Resolve conflicting versions of %lu docs in '%@'",
+                   self, (unsigned long)docIDs.count, key);
+        
+        NSDictionary<NSString*, NSError*>* errors = [c resolveConflictsInDocuments: docIDs
+                                                              withConflictResolver: colConfig.conflictResolver];
+        for (CBLReplicatedDocument* doc in list) {
+            NSError* error = errors[doc.id];
+            if (error)
+                CBLWarn(Sync, @"%@ Conflict resolution of '%@' failed: %@", self, doc.id, error);
+            else
+                ++resolved;
+            [doc updateError: error];
+            [self logErrorOnDocument: doc pushing: NO];
+        }
     }
     
-    [doc updateError: error];
-    [self logErrorOnDocument: doc pushing: NO];
-    [self postDocumentReplications: @[doc] pushing: NO];
+    // The latency is measured from the first conflict of the batch, the longest waiting one:
+    _counters->resolvedConflicts(docs.count, cbl::ReplicatorCounters::now() - scheduledAt);
+    cbl::ReplicatorCounters::add(_counters->documentsPulled, resolved);
+    
+    [self postDocumentReplications: docs pushing: NO];
 }
 
 - (void) didFinishConflictResolution: (dispatch_block_t)resolution {
@@ -854,6 +1063,7 @@ static void onDocsEnded(C4Replicator* repl,
 - (void) setConflictResolutionSuspended: (BOOL)suspended {
     _conflictResolutionSuspended = suspended;
     if (suspended) {
+        _openConflictBatch = nil;
         // Note: All cancelled resolutions will be notified and queued again when
         // the replicator is resumed or restarted.
         for (dispatch_block_t resolution in _pendingConflicts) {
@@ -894,12 +1104,28 @@ static bool pullFilter(C4CollectionSpec collectionSpec,
                    body: (FLDict)body
                 pushing: (bool)pushing
 {
-    NSString* name = slice2string(c4spec.name);
-    NSString* scopeName = slice2string(c4spec.scope);
-    CBLCollection* c = [_collectionMap objectForKey: $sprintf(@"%@.%@", scopeName, name)];
-    Assert(c, kCBLErrorMessageCollectionNotFoundInFilter);
+    // Linear search; a replicator has a few collections and comparing slices doesn't allocate:
+    const FilteredCollection* fc = nullptr;
+    for (auto& c : _filteredCollections) {
+        if (c.name == slice(c4spec.name) && c.scope == slice(c4spec.scope)) {
+            fc = &c;
+            break;
+        }
+    }
+    Assert(fc, kCBLErrorMessageCollectionNotFoundInFilter);
+    
+    // The filter expression is evaluated on the Fleece body; tombstones and revisions whose
+    // access was removed have no properties to match, so they are left to the filter function:
+    auto predicate = pushing ? fc->pushPredicate.get() : fc->pullPredicate.get();
+    if (predicate && !(flags & (kRevDeleted | kRevPurged)) && !predicate->matches(docID, body))
+        return false;
+    
+    CBLReplicationFilter filter = pushing ? fc->pushFilter : fc->pullFilter;
+    if (!filter)
+        return true;
     
-    auto doc = [[CBLDocument alloc] initWithCollection: c
+    // The document's properties are only decoded if the filter reads them:
+    auto doc = [[CBLDocument alloc] initWithCollection: fc->collection
                                             documentID: slice2string(docID)
                                             revisionID: slice2string(revID)
                                                   body: body];
@@ -910,10 +1136,7 @@ static bool pullFilter(C4CollectionSpec collectionSpec,
     if ((flags & kRevPurged) == kRevPurged)
         docFlags |= kCBLDocumentFlagsAccessRemoved;
     
-    CBLCollectionConfiguration* colConfig = _config.collectionConfigMap[c];
-    Assert(colConfig, @"Collection config is not found in the replicator config when " \
-           "calling the filter function.");
-    return pushing ? colConfig.pushFilter(doc, docFlags) : colConfig.pullFilter(doc, docFlags);
+    return filter(doc, docFlags);
 }
 
 #pragma mark - BACKGROUNDING SUPPORT:
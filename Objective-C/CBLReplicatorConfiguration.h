@@ -23,6 +23,7 @@
 #import <CouchbaseLite/CBLReplicatorTypes.h>
 
 @class CBLAuthenticator;
+@class CBLBandwidthLimiter;
 @class CBLCollection;
 @class CBLCollectionConfiguration;
 @class CBLDatabase;
@@ -158,6 +159,122 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic) BOOL enableAutoPurge;
 
+/**
+ The minimum size in bytes of the receive window: the amount of received data the replicator
+ holds in memory before it has processed it. When the window is full, the replicator stops
+ reading from the connection, which slows down the remote peer.
+ 
+ The window adapts to the rate at which the replicator processes the received data and to
+ the round-trip time of the connection, between ``minReceiveWindow`` and ``maxReceiveWindow``.
+ The default value, zero, means 16KB.
+ */
+@property (nonatomic) NSUInteger minReceiveWindow;
+
+/**
+ The maximum size in bytes of the receive window. Lower it on memory-constrained devices;
+ raise it for high-bandwidth connections with a long round-trip time.
+ 
+ The default value, zero, means 4MB. A value less than ``minReceiveWindow`` fixes the window
+ at ``minReceiveWindow``.
+ */
+@property (nonatomic) NSUInteger maxReceiveWindow;
+
+/**
+ Compresses the replication messages with the WebSocket permessage-deflate extension, if the
+ server supports it. Compression reduces the data sent over slow or metered connections, at
+ the cost of CPU time on both sides.
+ 
+ The default value is NO.
+ */
+@property (nonatomic) BOOL enableCompression;
+
+/**
+ The compression level, from 1 (fastest) to 9 (smallest). The default value, zero, means 6.
+ 
+ @Note: Setting the compressionLevel to a value larger than 9 will result in
+ InvalidArgumentException being thrown.
+ */
+@property (nonatomic) NSUInteger compressionLevel;
+
+/**
+ The size of the compression window, as a power of two, from 9 (512 bytes) to 15 (32KB).
+ A smaller window uses less memory on both sides of the connection but compresses less.
+ The server is asked to use the same window. The default value, zero, means 15.
+ 
+ @Note: Setting the compressionWindowBits to a non-zero value outside 9-15 will result in
+ InvalidArgumentException being thrown.
+ */
+@property (nonatomic) NSUInteger compressionWindowBits;
+
+/**
+ Disables Nagle's algorithm on the connection, so that small messages such as acknowledgements
+ are sent at once instead of being held back to be combined with later data.
+ 
+ The default value is NO.
+ */
+@property (nonatomic) BOOL tcpNoDelay;
+
+/**
+ Enables TCP keepalive on the connection: after this many seconds without data, the connection
+ is probed, so that a dead connection is detected even while the replicator is idle.
+ 
+ The default value, zero, leaves keepalive disabled.
+ */
+@property (nonatomic) NSUInteger tcpKeepAliveIdle;
+
+/**
+ The time in seconds between TCP keepalive probes, when ``tcpKeepAliveIdle`` is set.
+ The default value, zero, uses the system's default.
+ */
+@property (nonatomic) NSUInteger tcpKeepAliveInterval;
+
+/**
+ The number of unanswered TCP keepalive probes after which the connection is dropped, when
+ ``tcpKeepAliveIdle`` is set. The default value, zero, uses the system's default.
+ */
+@property (nonatomic) NSUInteger tcpKeepAliveCount;
+
+/**
+ The size in bytes of the socket's send buffer. The default value, zero, uses the system's
+ default.
+ */
+@property (nonatomic) NSUInteger socketSendBufferSize;
+
+/**
+ The size in bytes of the socket's receive buffer. Raise it for high-bandwidth connections with
+ a long round-trip time. The default value, zero, uses the system's default.
+ */
+@property (nonatomic) NSUInteger socketReceiveBufferSize;
+
+/**
+ Connects by resolving the host and racing the connection attempts to its IPv6 and IPv4
+ addresses (RFC 8305, "Happy Eyeballs"), instead of letting the system connect to the host.
+ This avoids long stalls when one address family is broken on the network.
+ 
+ The connection is made with BSD sockets, which unlike the system's host connections don't
+ turn on the cellular radio or connect an on-demand VPN. It isn't used through a SOCKS proxy.
+ 
+ The default value is NO.
+ */
+@property (nonatomic) BOOL raceConnectionAttempts;
+
+/**
+ Limits the rate at which the replicator sends data. Set the same limiter on several
+ configurations to share the bandwidth among their replicators.
+ 
+ The default value is nil, meaning no limit.
+ */
+@property (nonatomic, nullable) CBLBandwidthLimiter* sendBandwidthLimiter;
+
+/**
+ Limits the rate at which the replicator reads data from the connection; once the limit is
+ reached the server is held back by TCP flow control. Set the same limiter on several
+ configurations to share the bandwidth among their replicators.
+ 
+ The default value is nil, meaning no limit.
+ */
+@property (nonatomic, nullable) CBLBandwidthLimiter* receiveBandwidthLimiter;
+
 /** Not available */
 - (instancetype) init NS_UNAVAILABLE;
 
@@ -47,8 +47,19 @@
 @synthesize networkInterface=_networkInterface;
 @synthesize acceptParentDomainCookies=_acceptParentDomainCookies;
 @synthesize checkpointInterval=_checkpointInterval, heartbeat=_heartbeat;
+@synthesize usePOSIXWebSocket=_usePOSIXWebSocket;
 @synthesize maxAttempts=_maxAttempts, maxAttemptWaitTime=_maxAttemptWaitTime;
 @synthesize enableAutoPurge=_enableAutoPurge;
+@synthesize minReceiveWindow=_minReceiveWindow, maxReceiveWindow=_maxReceiveWindow;
+@synthesize enableCompression=_enableCompression, compressionLevel=_compressionLevel;
+@synthesize compressionWindowBits=_compressionWindowBits;
+@synthesize tcpNoDelay=_tcpNoDelay, tcpKeepAliveIdle=_tcpKeepAliveIdle;
+@synthesize tcpKeepAliveInterval=_tcpKeepAliveInterval, tcpKeepAliveCount=_tcpKeepAliveCount;
+@synthesize socketSendBufferSize=_socketSendBufferSize;
+@synthesize socketReceiveBufferSize=_socketReceiveBufferSize;
+@synthesize raceConnectionAttempts=_raceConnectionAttempts;
+@synthesize sendBandwidthLimiter=_sendBandwidthLimiter;
+@synthesize receiveBandwidthLimiter=_receiveBandwidthLimiter;
 @synthesize collectionConfigMap=_collectionConfigMap;
 
 #ifdef COUCHBASE_ENTERPRISE
@@ -202,6 +213,86 @@
     _enableAutoPurge = enableAutoPurge;
 }
 
+- (void) setMinReceiveWindow: (NSUInteger)minReceiveWindow {
+    [self checkReadonly];
+    _minReceiveWindow = minReceiveWindow;
+}
+
+- (void) setMaxReceiveWindow: (NSUInteger)maxReceiveWindow {
+    [self checkReadonly];
+    _maxReceiveWindow = maxReceiveWindow;
+}
+
+- (void) setEnableCompression: (BOOL)enableCompression {
+    [self checkReadonly];
+    _enableCompression = enableCompression;
+}
+
+- (void) setCompressionLevel: (NSUInteger)compressionLevel {
+    [self checkReadonly];
+    
+    if (compressionLevel > 9)
+        [NSException raise: NSInvalidArgumentException
+                    format: @"%@", kCBLErrorMessageInvalidCompressionLevel];
+    
+    _compressionLevel = compressionLevel;
+}
+
+- (void) setCompressionWindowBits: (NSUInteger)compressionWindowBits {
+    [self checkReadonly];
+    
+    if (compressionWindowBits != 0 && (compressionWindowBits < 9 || compressionWindowBits > 15))
+        [NSException raise: NSInvalidArgumentException
+                    format: @"%@", kCBLErrorMessageInvalidCompressionWindowBits];
+    
+    _compressionWindowBits = compressionWindowBits;
+}
+
+- (void) setTcpNoDelay: (BOOL)tcpNoDelay {
+    [self checkReadonly];
+    _tcpNoDelay = tcpNoDelay;
+}
+
+- (void) setTcpKeepAliveIdle: (NSUInteger)tcpKeepAliveIdle {
+    [self checkReadonly];
+    _tcpKeepAliveIdle = tcpKeepAliveIdle;
+}
+
+- (void) setTcpKeepAliveInterval: (NSUInteger)tcpKeepAliveInterval {
+    [self checkReadonly];
+    _tcpKeepAliveInterval = tcpKeepAliveInterval;
+}
+
+- (void) setTcpKeepAliveCount: (NSUInteger)tcpKeepAliveCount {
+    [self checkReadonly];
+    _tcpKeepAliveCount = tcpKeepAliveCount;
+}
+
+- (void) setSocketSendBufferSize: (NSUInteger)socketSendBufferSize {
+    [self checkReadonly];
+    _socketSendBufferSize = socketSendBufferSize;
+}
+
+- (void) setSocketReceiveBufferSize: (NSUInteger)socketReceiveBufferSize {
+    [self checkReadonly];
+    _socketReceiveBufferSize = socketReceiveBufferSize;
+}
+
+- (void) setRaceConnectionAttempts: (BOOL)raceConnectionAttempts {
+    [self checkReadonly];
+    _raceConnectionAttempts = raceConnectionAttempts;
+}
+
+- (void) setSendBandwidthLimiter: (CBLBandwidthLimiter*)sendBandwidthLimiter {
+    [self checkReadonly];
+    _sendBandwidthLimiter = sendBandwidthLimiter;
+}
+
+- (void) setReceiveBandwidthLimiter: (CBLBandwidthLimiter*)receiveBandwidthLimiter {
+    [self checkReadonly];
+    _receiveBandwidthLimiter = receiveBandwidthLimiter;
+}
+
 - (NSArray<CBLCollectionConfiguration*>*) collections {
     return [_collectionConfigMap allValues];
 }
@@ -228,9 +319,24 @@
         _headers = config.headers;
         _heartbeat = config.heartbeat;
         _checkpointInterval = config.checkpointInterval;
+        _usePOSIXWebSocket = config.usePOSIXWebSocket;
         _maxAttempts = config.maxAttempts;
         _maxAttemptWaitTime = config.maxAttemptWaitTime;
         _enableAutoPurge = config.enableAutoPurge;
+        _minReceiveWindow = config.minReceiveWindow;
+        _maxReceiveWindow = config.maxReceiveWindow;
+        _enableCompression = config.enableCompression;
+        _compressionLevel = config.compressionLevel;
+        _compressionWindowBits = config.compressionWindowBits;
+        _tcpNoDelay = config.tcpNoDelay;
+        _tcpKeepAliveIdle = config.tcpKeepAliveIdle;
+        _tcpKeepAliveInterval = config.tcpKeepAliveInterval;
+        _tcpKeepAliveCount = config.tcpKeepAliveCount;
+        _socketSendBufferSize = config.socketSendBufferSize;
+        _socketReceiveBufferSize = config.socketReceiveBufferSize;
+        _raceConnectionAttempts = config.raceConnectionAttempts;
+        _sendBandwidthLimiter = config.sendBandwidthLimiter;
+        _receiveBandwidthLimiter = config.receiveBandwidthLimiter;
 #if TARGET_OS_IPHONE
         _allowReplicatingInBackground = config.allowReplicatingInBackground;
 #endif
@@ -290,6 +396,44 @@
     if (!_enableAutoPurge)
         options[@kC4ReplicatorOptionAutoPurge] = @(NO);
     
+    // Socket transport (no public api now):
+    if (_usePOSIXWebSocket)
+        options[@kCBLReplicatorOptionPOSIXWebSocket] = @YES;
+    
+    // Receive window bounds, used by CBLWebSocket:
+    if (_minReceiveWindow > 0)
+        options[@kCBLReplicatorOptionMinReceiveWindow] = @(_minReceiveWindow);
+    if (_maxReceiveWindow > 0)
+        options[@kCBLReplicatorOptionMaxReceiveWindow] = @(_maxReceiveWindow);
+    
+    // permessage-deflate compression, used by CBLWebSocket:
+    if (_enableCompression) {
+        options[@kCBLReplicatorOptionCompression] = @YES;
+        if (_compressionLevel > 0)
+            options[@kCBLReplicatorOptionCompressionLevel] = @(_compressionLevel);
+        if (_compressionWindowBits > 0)
+            options[@kCBLReplicatorOptionCompressionWindowBits] = @(_compressionWindowBits);
+    }
+    
+    // TCP options of the socket:
+    if (_tcpNoDelay)
+        options[@kCBLReplicatorOptionTCPNoDelay] = @YES;
+    if (_tcpKeepAliveIdle > 0) {
+        options[@kCBLReplicatorOptionKeepAliveIdle] = @(_tcpKeepAliveIdle);
+        if (_tcpKeepAliveInterval > 0)
+            options[@kCBLReplicatorOptionKeepAliveInterval] = @(_tcpKeepAliveInterval);
+        if (_tcpKeepAliveCount > 0)
+            options[@kCBLReplicatorOptionKeepAliveCount] = @(_tcpKeepAliveCount);
+    }
+    if (_socketSendBufferSize > 0)
+        options[@kCBLReplicatorOptionSendBufferSize] = @(_socketSendBufferSize);
+    if (_socketReceiveBufferSize > 0)
+        options[@kCBLReplicatorOptionReceiveBufferSize] = @(_socketReceiveBufferSize);
+    
+    // Resolve the host and race the connections to its addresses:
+    if (_raceConnectionAttempts)
+        options[@kCBLReplicatorOptionRaceConnections] = @YES;
+    
 #ifdef COUCHBASE_ENTERPRISE
     NSString* uniqueID = $castIf(CBLMessageEndpoint, _target).uid;
     if (uniqueID)
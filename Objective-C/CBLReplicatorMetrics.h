@@ -0,0 +1,107 @@
+//
+//  CBLReplicatorMetrics.h
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ CBLReplicatorMetrics is a snapshot of a replicator's throughput and latency counters.
+ The counters accumulate from the first time the replicator is started. The rates are averaged
+ over the `interval` of the snapshot: the replicator's whole run for a snapshot read from the
+ replicator's metrics property, or the time since the previous callback for a snapshot posted
+ to a metrics listener.
+ 
+ The document counts are only collected while a metrics listener or a document replication
+ listener is registered. The byte counts are only collected by replicators with a URL endpoint.
+ */
+@interface CBLReplicatorMetrics : NSObject
+
+/** The time in seconds since the replicator was first started. */
+@property (nonatomic, readonly) NSTimeInterval elapsedTime;
+
+/** The time in seconds over which the rates of this snapshot are measured. */
+@property (nonatomic, readonly) NSTimeInterval interval;
+
+/** The number of documents pushed. */
+@property (nonatomic, readonly) uint64_t documentsPushed;
+
+/** The number of documents pulled, including the documents whose conflicts were resolved. */
+@property (nonatomic, readonly) uint64_t documentsPulled;
+
+/** The number of documents pushed per second. */
+@property (nonatomic, readonly) double documentsPushedPerSecond;
+
+/** The number of documents pulled per second. */
+@property (nonatomic, readonly) double documentsPulledPerSecond;
+
+/** The number of bytes written to the WebSocket connection. */
+@property (nonatomic, readonly) uint64_t bytesSent;
+
+/** The number of bytes read from the WebSocket connection. */
+@property (nonatomic, readonly) uint64_t bytesReceived;
+
+/** The number of bytes written to the WebSocket connection per second. */
+@property (nonatomic, readonly) double bytesSentPerSecond;
+
+/** The number of bytes read from the WebSocket connection per second. */
+@property (nonatomic, readonly) double bytesReceivedPerSecond;
+
+/** The number of pulled documents that were in conflict. */
+@property (nonatomic, readonly) uint64_t conflictCount;
+
+/** The number of conflicts resolved. */
+@property (nonatomic, readonly) uint64_t resolvedConflictCount;
+
+/** The average time in seconds from pulling a conflict until it was resolved. */
+@property (nonatomic, readonly) NSTimeInterval averageConflictResolutionLatency;
+
+/** The longest time in seconds from pulling a conflict until it was resolved. */
+@property (nonatomic, readonly) NSTimeInterval maxConflictResolutionLatency;
+
+/** The time in seconds the WebSocket stopped reading because too much received data was pending. */
+@property (nonatomic, readonly) NSTimeInterval throttledTime;
+
+/** The number of times the WebSocket stopped reading because its receive window was full. */
+@property (nonatomic, readonly) uint64_t throttleCount;
+
+/** The number of times the replicator reconnected after going offline. */
+@property (nonatomic, readonly) uint64_t reconnectCount;
+
+/** The number of TCP connections the WebSocket made to the server. */
+@property (nonatomic, readonly) uint64_t connectCount;
+
+/** The number of TCP connection attempts. It's only above connectCount with
+    raceConnectionAttempts, when the first address tried, or the first address family, was slow
+    or unreachable. */
+@property (nonatomic, readonly) uint64_t connectAttemptCount;
+
+/** The average time in seconds to resolve the server's address and connect to it. */
+@property (nonatomic, readonly) NSTimeInterval averageConnectTime;
+
+/** The time in seconds the WebSocket waited to send or read data because of the configured
+    bandwidth limiters. */
+@property (nonatomic, readonly) NSTimeInterval shapedTime;
+
+/** Not available */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
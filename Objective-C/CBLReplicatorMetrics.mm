@@ -0,0 +1,94 @@
+//
+//  CBLReplicatorMetrics.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CBLReplicatorMetrics+Internal.h"
+
+static NSTimeInterval seconds(uint64_t nanos) {
+    return nanos / 1.0e9;
+}
+
+@implementation CBLReplicatorMetrics
+
+@synthesize elapsedTime=_elapsedTime, interval=_interval;
+@synthesize documentsPushed=_documentsPushed, documentsPulled=_documentsPulled;
+@synthesize documentsPushedPerSecond=_documentsPushedPerSecond;
+@synthesize documentsPulledPerSecond=_documentsPulledPerSecond;
+@synthesize bytesSent=_bytesSent, bytesReceived=_bytesReceived;
+@synthesize bytesSentPerSecond=_bytesSentPerSecond, bytesReceivedPerSecond=_bytesReceivedPerSecond;
+@synthesize conflictCount=_conflictCount, resolvedConflictCount=_resolvedConflictCount;
+@synthesize averageConflictResolutionLatency=_averageConflictResolutionLatency;
+@synthesize maxConflictResolutionLatency=_maxConflictResolutionLatency;
+@synthesize throttledTime=_throttledTime, throttleCount=_throttleCount;
+@synthesize reconnectCount=_reconnectCount;
+@synthesize connectCount=_connectCount, connectAttemptCount=_connectAttemptCount;
+@synthesize averageConnectTime=_averageConnectTime;
+@synthesize shapedTime=_shapedTime;
+
+- (instancetype) initWithSample: (const cbl::ReplicatorSample&)sample
+                       previous: (const cbl::ReplicatorSample&)previous
+{
+    self = [super init];
+    if (self) {
+        _elapsedTime = seconds(sample.time);
+        _interval = seconds(sample.time - previous.time);
+        
+        _documentsPushed = sample.documentsPushed;
+        _documentsPulled = sample.documentsPulled;
+        _bytesSent = sample.bytesSent;
+        _bytesReceived = sample.bytesReceived;
+        if (_interval > 0) {
+            _documentsPushedPerSecond = (sample.documentsPushed - previous.documentsPushed) / _interval;
+            _documentsPulledPerSecond = (sample.documentsPulled - previous.documentsPulled) / _interval;
+            _bytesSentPerSecond = (sample.bytesSent - previous.bytesSent) / _interval;
+            _bytesReceivedPerSecond = (sample.bytesReceived - previous.bytesReceived) / _interval;
+        }
+        
+        _conflictCount = sample.conflicts;
+        _resolvedConflictCount = sample.conflictsResolved;
+        if (sample.conflictsResolved > 0)
+            _averageConflictResolutionLatency = seconds(sample.conflictLatency / sample.conflictsResolved);
+        _maxConflictResolutionLatency = seconds(sample.maxConflictLatency);
+        
+        _throttledTime = seconds(sample.throttledTime);
+        _throttleCount = sample.throttles;
+        _reconnectCount = sample.reconnects;
+        _connectCount = sample.connects;
+        _connectAttemptCount = sample.connectAttempts;
+        if (sample.connects > 0)
+            _averageConnectTime = seconds(sample.connectTime / sample.connects);
+        _shapedTime = seconds(sample.shapedTime);
+    }
+    return self;
+}
+
+- (NSString*) description {
+    return [NSString stringWithFormat: @"%@[elapsed=%.3fs, push=%llu docs (%.1f/s), "
+                                        "pull=%llu docs (%.1f/s), sent=%llu bytes (%.0f/s), "
+                                        "received=%llu bytes (%.0f/s), conflicts=%llu/%llu (avg %.3fms), "
+                                        "throttled=%.3fs (%llu times), reconnects=%llu, "
+                                        "connects=%llu (%llu attempts, avg %.3fms), shaped=%.3fs]",
+            self.class, _elapsedTime, _documentsPushed, _documentsPushedPerSecond,
+            _documentsPulled, _documentsPulledPerSecond, _bytesSent, _bytesSentPerSecond,
+            _bytesReceived, _bytesReceivedPerSecond, _resolvedConflictCount, _conflictCount,
+            _averageConflictResolutionLatency * 1000.0, _throttledTime, _throttleCount,
+            _reconnectCount, _connectCount, _connectAttemptCount, _averageConnectTime * 1000.0,
+            _shapedTime];
+}
+
+@end
@@ -29,10 +29,13 @@ FOUNDATION_EXPORT const unsigned char CouchbaseLiteVersionString[];
 #import <CouchbaseLite/CBLArrayFragment.h>
 #import <CouchbaseLite/CBLArrayIndexConfiguration.h>
 #import <CouchbaseLite/CBLAuthenticator.h>
+#import <CouchbaseLite/CBLBandwidthLimiter.h>
 #import <CouchbaseLite/CBLBasicAuthenticator.h>
 #import <CouchbaseLite/CBLBlob.h>
 #import <CouchbaseLite/CBLCollection.h>
 #import <CouchbaseLite/CBLCollectionChange.h>
+#import <CouchbaseLite/CBLCollectionChangeListenerOptions.h>
+#import <CouchbaseLite/CBLCollectionChangeCursor.h>
 #import <CouchbaseLite/CBLCollectionChangeObservable.h>
 #import <CouchbaseLite/CBLCollectionConfiguration.h>
 #import <CouchbaseLite/CBLConflict.h>
@@ -85,11 +88,14 @@ FOUNDATION_EXPORT const unsigned char CouchbaseLiteVersionString[];
 #import <CouchbaseLite/CBLQueryParameters.h>
 #import <CouchbaseLite/CBLQueryResult.h>
 #import <CouchbaseLite/CBLQueryResultSet.h>
+#import <CouchbaseLite/CBLQueryStats.h>
 #import <CouchbaseLite/CBLQuerySelectResult.h>
 #import <CouchbaseLite/CBLQueryVariableExpression.h>
 #import <CouchbaseLite/CBLReplicator.h>
 #import <CouchbaseLite/CBLReplicatorChange.h>
 #import <CouchbaseLite/CBLReplicatorConfiguration.h>
+#import <CouchbaseLite/CBLReplicatorMetrics.h>
+#import <CouchbaseLite/CBLDNSCache.h>
 #import <CouchbaseLite/CBLReplicatorStatus.h>
 #import <CouchbaseLite/CBLReplicatorTypes.h>
 #import <CouchbaseLite/CBLScope.h>
@@ -49,11 +49,20 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (nonatomic, weak, nullable) id<CBLRemovableListenerToken> delegate;
 
+/** The dispatch queue on which the changes are posted. */
+@property (nonatomic, readonly) dispatch_queue_t queue;
+
 /**
  Posts an asynchronous change notification to the listener block on its dispatch queue.
  */
 - (void) postChange: (ChangeType)change;
 
+/**
+ Calls the listener block synchronously on the current thread. The caller is responsible for
+ being on the token's dispatch queue.
+ */
+- (void) deliverChange: (ChangeType)change;
+
 @end
 
 NS_ASSUME_NONNULL_END
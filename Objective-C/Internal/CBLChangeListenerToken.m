@@ -25,7 +25,7 @@
     dispatch_queue_t _queue;
 }
 
-@synthesize context=_context, delegate=_delegate;
+@synthesize context=_context, delegate=_delegate, queue=_queue;
 
 - (instancetype) initWithListener: (void (^)(id))listener
                             queue: (nullable dispatch_queue_t)queue
@@ -47,6 +47,10 @@
     });
 }
 
+- (void) deliverChange: (id)change {
+    _listener(change);
+}
+
 - (void) remove {
     id delegate = self.delegate;
     if (delegate != nil && [delegate respondsToSelector:@selector(removeToken:)]) {
@@ -52,7 +52,9 @@ NS_ASSUME_NONNULL_BEGIN
 /** Check whether this notifier has the token or not. */
 - (BOOL) containsToken: (id<CBLListenerToken>)token;
 
-/** Posts a change notification object to all listeners, asynchronously. */
+/** Posts a change notification object to all listeners, asynchronously. Posting doesn't block on
+    adding or removing listeners. Listeners sharing a dispatch queue are called in one dispatch,
+    in the order they were added. */
 - (void) postChange: (ChangeType)change;
 
 @end
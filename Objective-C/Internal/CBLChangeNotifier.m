@@ -20,11 +20,22 @@
 #import "CBLChangeNotifier.h"
 #import "CBLChangeListenerToken.h"
 
+@interface CBLChangeNotifier ()
+
+// The listener tokens grouped by dispatch queue, in the order the listeners were added.
+// The arrays are immutable and the property is replaced as a whole (copy-on-write) when a listener
+// is added or removed, so -postChange: only needs to read the current snapshot.
+@property (atomic, copy, nullable) NSArray<NSArray<CBLChangeListenerToken*>*>* listenerBatches;
+
+@end
+
 @implementation CBLChangeNotifier
 {
-    NSMutableSet<CBLChangeListenerToken*>* _listenerTokens;
+    NSArray<CBLChangeListenerToken*>* _listenerTokens;   // Guarded by CBL_LOCK(self)
 }
 
+@synthesize listenerBatches=_listenerBatches;
+
 - (CBLChangeListenerToken*) addChangeListenerWithQueue: (dispatch_queue_t)queue
                                               listener: (void (^)(id))listener
                                               delegate: (nullable id<CBLRemovableListenerToken>)delegate
@@ -32,12 +43,10 @@
     CBLAssertNotNil(listener);
 
     CBL_LOCK(self) {
-        if (!_listenerTokens)
-            _listenerTokens = [NSMutableSet set];
         id token = [[CBLChangeListenerToken alloc] initWithListener: listener
                                                               queue: queue
                                                            delegate: delegate];
-        [_listenerTokens addObject: token];
+        [self updateListenerTokens: [(_listenerTokens ?: @[]) arrayByAddingObject: token]];
         return token;
     }
 }
@@ -46,23 +55,55 @@
     CBLAssertNotNil(token);
 
     CBL_LOCK(self) {
-        [_listenerTokens removeObject: token];
+        NSUInteger index = [_listenerTokens indexOfObjectIdenticalTo: token];
+        if (index != NSNotFound) {
+            NSMutableArray* tokens = [_listenerTokens mutableCopy];
+            [tokens removeObjectAtIndex: index];
+            [self updateListenerTokens: tokens];
+        }
         return _listenerTokens.count;
     }
 }
 
 - (BOOL) containsToken: (id<CBLListenerToken>)token {
     CBL_LOCK(self) {
-        return [_listenerTokens containsObject: token];
+        return [_listenerTokens indexOfObjectIdenticalTo: token] != NSNotFound;
     }
 }
 
 - (void) postChange: (id)change {
     CBLAssertNotNil(change);
 
-    CBL_LOCK(self) {
-        [_listenerTokens makeObjectsPerformSelector: @selector(postChange:) withObject: change];
+    // One dispatch per queue; the listeners of a batch are called in the order they were added:
+    for (NSArray<CBLChangeListenerToken*>* batch in self.listenerBatches) {
+        dispatch_async(batch[0].queue, ^{
+            for (CBLChangeListenerToken* token in batch)
+                [token deliverChange: change];
+        });
+    }
+}
+
+#pragma mark - Internal
+
+// Must be called under CBL_LOCK(self).
+- (void) updateListenerTokens: (NSArray<CBLChangeListenerToken*>*)tokens {
+    _listenerTokens = [tokens copy];
+    
+    NSMutableArray<NSMutableArray<CBLChangeListenerToken*>*>* batches = [NSMutableArray array];
+    for (CBLChangeListenerToken* token in _listenerTokens) {
+        NSMutableArray* batch = nil;
+        for (NSMutableArray<CBLChangeListenerToken*>* b in batches) {
+            if (b[0].queue == token.queue) {
+                batch = b;
+                break;
+            }
+        }
+        if (batch)
+            [batch addObject: token];
+        else
+            [batches addObject: [NSMutableArray arrayWithObject: token]];
     }
+    self.listenerBatches = batches.count > 0 ? batches : nil;
 }
 
 @end
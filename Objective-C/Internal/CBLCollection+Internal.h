@@ -20,9 +20,15 @@
 #pragma once
 #import "CBLCollection.h"
 #import "CBLChangeListenerToken.h"
+#import "CBLCollectionChangeCursor.h"
 #import "CBLDatabase.h"
 #import "c4.h"
 
+#ifdef __cplusplus
+#include <string>
+#include <vector>
+#endif
+
 #define CBLCollectionErrorNotOpen [NSError errorWithDomain: CBLErrorDomain \
                                     code: CBLErrorNotOpen \
                                     userInfo: @{ NSLocalizedDescriptionKey: kCBLErrorMessageDBClosedOrCollectionDeleted }]
@@ -61,21 +67,79 @@ NS_ASSUME_NONNULL_BEGIN
               withConflictResolver: (nullable id<CBLConflictResolver>)conflictResolver
                              error: (NSError**)outError;
 
+/** Resolves the conflicts of the given documents in a batch: the documents are read under one lock,
+    the resolver is run on them in parallel outside the lock, and the resolved documents are saved in
+    one transaction. Returns the errors of the documents that couldn't be resolved, keyed by docID. */
+- (NSDictionary<NSString*, NSError*>*) resolveConflictsInDocuments: (NSArray<NSString*>*)docIDs
+                                              withConflictResolver: (nullable id<CBLConflictResolver>)conflictResolver;
+
 - (BOOL) checkIsValid: (NSError**)error;
 
 - (nullable NSArray*) indexesInfo: (NSError**)error;
 
+/** Reads at most `limit` document changes after the given sequence, in sequence order. */
+- (nullable NSArray<CBLChangedDocument*>*) changedDocumentsSinceSequence: (uint64_t)sequence
+                                                                   limit: (NSUInteger)limit
+                                                                   error: (NSError**)error;
+
 @end
 
+#ifdef __cplusplus
+namespace cbl {
+    /** The changed documents of a CBLCollectionChange. The document IDs are kept as UTF-8 bytes,
+        and are only converted to NSStrings when CBLCollectionChange.documentIDs is accessed. */
+    struct CollectionChanges {
+        std::string docIDs;                                 // The document IDs, concatenated
+        std::vector<std::pair<uint32_t, uint32_t>> ranges;  // Offset and size of each document ID
+        std::vector<uint64_t> sequences;
+
+        size_t count() const                    {return ranges.size();}
+
+        void add(C4Slice docID, uint64_t sequence) {
+            ranges.emplace_back((uint32_t)docIDs.size(), (uint32_t)docID.size);
+            docIDs.append((const char*)docID.buf, docID.size);
+            sequences.push_back(sequence);
+        }
+
+        /** Appends the changes [start, start+n) of the other changes. */
+        void append(const CollectionChanges& other, size_t start, size_t n) {
+            for (size_t i = start; i < start + n; i++) {
+                auto& range = other.ranges[i];
+                add({other.docIDs.data() + range.first, range.second}, other.sequences[i]);
+            }
+        }
+    };
+}
+#endif
+
 @interface CBLCollectionChange ()
 
 /** check whether the changes are from the current collection or not. */
 @property (readonly, nonatomic) BOOL isExternal;
 
+#ifdef __cplusplus
 - (instancetype) initWithCollection: (CBLCollection*)collection
-                        documentIDs: (NSArray*)documentIDs
+                            changes: (cbl::CollectionChanges&&)changes
                          isExternal: (BOOL)isExternal;
 
+/** The raw changes, for merging or splitting the change. */
+- (const cbl::CollectionChanges&) changes;
+#endif
+
+@end
+
+@interface CBLCollectionChangeCursor ()
+
+- (instancetype) initWithCollection: (CBLCollection*)collection
+                      sinceSequence: (uint64_t)sequence
+                              limit: (NSUInteger)limit;
+
+@end
+
+@interface CBLChangedDocument ()
+
+- (instancetype) initWithDocumentInfo: (const C4DocumentInfo*)info;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,43 @@
+//
+//  CBLCollectionChangeBatcher.h
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+@class CBLCollectionChange;
+@class CBLCollectionChangeListenerOptions;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Merges and splits the collection changes posted to a change listener according to the
+ listener's CBLCollectionChangeListenerOptions.
+ */
+@interface CBLCollectionChangeBatcher : NSObject
+
+- (instancetype) initWithQueue: (nullable dispatch_queue_t)queue
+                       options: (CBLCollectionChangeListenerOptions*)options
+                      listener: (void (^)(CBLCollectionChange*))listener;
+
+/** Adds a change. Must be called on the listener's dispatch queue. */
+- (void) addChange: (CBLCollectionChange*)change;
+
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
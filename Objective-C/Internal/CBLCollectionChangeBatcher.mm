@@ -0,0 +1,114 @@
+//
+//  CBLCollectionChangeBatcher.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CBLCollectionChangeBatcher.h"
+#import "CBLCollection+Internal.h"
+#import "CBLCollectionChange.h"
+#import "CBLCollectionChangeListenerOptions.h"
+
+@implementation CBLCollectionChangeBatcher {
+    dispatch_queue_t _queue;
+    NSUInteger _maxBatchSize;
+    NSTimeInterval _maxDelay;
+    void (^_listener)(CBLCollectionChange*);
+    
+    // Guarded by CBL_LOCK(self):
+    CBLCollection* _collection;
+    cbl::CollectionChanges _pending;
+    BOOL _pendingExternal;
+    BOOL _flushScheduled;
+}
+
+- (instancetype) initWithQueue: (nullable dispatch_queue_t)queue
+                       options: (CBLCollectionChangeListenerOptions*)options
+                      listener: (void (^)(CBLCollectionChange*))listener
+{
+    self = [super init];
+    if (self) {
+        _queue = queue ?: dispatch_get_main_queue();
+        _maxBatchSize = options.maxBatchSize;
+        _maxDelay = options.maxDelay;
+        _listener = listener;
+    }
+    return self;
+}
+
+- (void) addChange: (CBLCollectionChange*)change {
+    NSMutableArray<CBLCollectionChange*>* ready = [NSMutableArray array];
+    CBL_LOCK(self) {
+        // Local and external changes are never merged:
+        if (_pending.count() > 0 && change.isExternal != _pendingExternal)
+            [ready addObject: [self takePending: _pending.count()]];
+        
+        const cbl::CollectionChanges& changes = change.changes;
+        _pending.append(changes, 0, changes.count());
+        _pendingExternal = change.isExternal;
+        _collection = change.collection;
+        
+        while (_maxBatchSize > 0 && _pending.count() >= _maxBatchSize)
+            [ready addObject: [self takePending: _maxBatchSize]];
+        
+        if (_pending.count() > 0) {
+            if (_maxDelay <= 0) {
+                [ready addObject: [self takePending: _pending.count()]];
+            } else if (!_flushScheduled) {
+                _flushScheduled = YES;
+                __weak CBLCollectionChangeBatcher* weakSelf = self;
+                dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(_maxDelay * NSEC_PER_SEC)),
+                               _queue, ^{
+                    [weakSelf flush];
+                });
+            }
+        }
+    }
+    
+    for (CBLCollectionChange* c in ready)
+        _listener(c);
+}
+
+- (void) flush {
+    CBLCollectionChange* change = nil;
+    CBL_LOCK(self) {
+        _flushScheduled = NO;
+        if (_pending.count() > 0)
+            change = [self takePending: _pending.count()];
+    }
+    
+    if (change)
+        _listener(change);
+}
+
+// Removes the first n pending changes and returns them as a change. Must be called under the lock.
+- (CBLCollectionChange*) takePending: (size_t)n {
+    cbl::CollectionChanges taken;
+    if (n == _pending.count()) {
+        taken = std::move(_pending);
+        _pending = cbl::CollectionChanges();
+    } else {
+        cbl::CollectionChanges rest;
+        taken.append(_pending, 0, n);
+        rest.append(_pending, n, _pending.count() - n);
+        _pending = std::move(rest);
+    }
+    return [[CBLCollectionChange alloc] initWithCollection: _collection
+                                                   changes: std::move(taken)
+                                                isExternal: _pendingExternal];
+}
+
+@end
@@ -22,28 +22,26 @@
 NS_ASSUME_NONNULL_BEGIN
 
 /**
- Thread-safe context manager for retaining and mapping the object with its pointer value which can be used as 
- the context for LiteCore's callbacks (e.g. use when creating c4queryobserver objects). The implementation
- simply stores the object in a map by using its memory address as the key and returns the memory address
- as the pointer value.
+ Thread-safe context manager for retaining objects and mapping them to opaque context pointers which can be
+ used as the context for LiteCore's callbacks (e.g. use when creating c4queryobserver objects).
  
- @note
- There is a chance that a new registered objects may have the same memory address as the ones previously
- unregistered. This implementation can be improved to reduce a chance of reusing the same memory address
- by generating integer keys with reuseable integer number + cycle count as inspired by the implementation of
- C# GCHandle. For now, the context object MUST BE validated for its originality before use.
+ The context pointer is an integer handle, not the object's address. The handle encodes a slot in a sharded
+ handle table together with the slot's generation, which is bumped when the slot is unregistered, so a stale
+ handle never resolves to an object registered later in the same slot. Each shard has its own lock that is
+ only held to read or write one slot; register, lookup and unregister are O(1), and don't allocate once
+ the slot has been used before.
  */
 @interface CBLContextManager : NSObject
 
 + (instancetype) shared;
 
-/** Register and retain the object. The context pointer of the registered object will be returned.  */
+/** Register and retain the object. The context pointer of the registered object will be returned. */
 - (void*) registerObject: (id)object;
 
 /** Unregister the object of the given context pointer. */
 - (void) unregisterObjectForPointer: (void*)ptr;
 
-/** Get the object of the given context pointer. */
+/** Get the object of the given context pointer, or nil if it has been unregistered. */
 - (nullable id) objectForPointer: (void*)ptr;
 
 /** Count number of registered objects. */
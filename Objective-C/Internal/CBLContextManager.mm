@@ -0,0 +1,130 @@
+//
+//  CBLContextManager.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2024 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CBLContextManager.h"
+#import <os/lock.h>
+#include <atomic>
+#include <vector>
+
+// A handle is (generation << 32) | (index << kShardBits) | shard. The generation of a slot starts at 1
+// and is never 0, so a valid handle is never NULL.
+static constexpr unsigned kShardBits = 4;
+static constexpr unsigned kNumShards = 1u << kShardBits;
+
+namespace {
+    struct Slot {
+        uint32_t generation {1};
+        __strong id object {nil};
+    };
+
+    struct Shard {
+        os_unfair_lock lock = OS_UNFAIR_LOCK_INIT;
+        std::vector<Slot> slots;
+        std::vector<uint32_t> freeSlots;
+    };
+}
+
+@implementation CBLContextManager {
+    Shard _shards[kNumShards];
+    std::atomic<uint32_t> _nextShard;
+    std::atomic<NSUInteger> _count;
+}
+
++ (CBLContextManager*) shared {
+    static CBLContextManager* shared = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        shared = [[self alloc] init];
+    });
+    return shared;
+}
+
+static inline void* makeHandle(uint32_t shard, uint32_t index, uint32_t generation) {
+    return (void*)(((uint64_t)generation << 32) | ((uint64_t)index << kShardBits) | shard);
+}
+
+static inline void decodeHandle(void* ptr, uint32_t& shard, uint32_t& index, uint32_t& generation) {
+    uint64_t handle = (uint64_t)ptr;
+    generation = (uint32_t)(handle >> 32);
+    index = (uint32_t)(handle & 0xFFFFFFFF) >> kShardBits;
+    shard = (uint32_t)handle & (kNumShards - 1);
+}
+
+- (void*) registerObject: (id)object {
+    uint32_t s = _nextShard.fetch_add(1, std::memory_order_relaxed) & (kNumShards - 1);
+    Shard& shard = _shards[s];
+    
+    uint32_t index, generation;
+    os_unfair_lock_lock(&shard.lock);
+    if (shard.freeSlots.empty()) {
+        index = (uint32_t)shard.slots.size();
+        shard.slots.emplace_back();
+    } else {
+        index = shard.freeSlots.back();
+        shard.freeSlots.pop_back();
+    }
+    Slot& slot = shard.slots[index];
+    slot.object = object;
+    generation = slot.generation;
+    os_unfair_lock_unlock(&shard.lock);
+    
+    _count.fetch_add(1, std::memory_order_relaxed);
+    return makeHandle(s, index, generation);
+}
+
+- (void) unregisterObjectForPointer: (void*)ptr {
+    uint32_t s, index, generation;
+    decodeHandle(ptr, s, index, generation);
+    Shard& shard = _shards[s];
+    
+    id object = nil;
+    os_unfair_lock_lock(&shard.lock);
+    if (index < shard.slots.size() && shard.slots[index].generation == generation) {
+        Slot& slot = shard.slots[index];
+        object = slot.object;
+        slot.object = nil;
+        if (++slot.generation == 0)
+            slot.generation = 1;
+        shard.freeSlots.push_back(index);
+    }
+    os_unfair_lock_unlock(&shard.lock);
+    
+    // The object is released here, outside the lock, in case its dealloc calls back into the manager.
+    if (object)
+        _count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+- (id) objectForPointer: (void*)ptr {
+    uint32_t s, index, generation;
+    decodeHandle(ptr, s, index, generation);
+    Shard& shard = _shards[s];
+    
+    id object = nil;
+    os_unfair_lock_lock(&shard.lock);
+    if (index < shard.slots.size() && shard.slots[index].generation == generation)
+        object = shard.slots[index].object;
+    os_unfair_lock_unlock(&shard.lock);
+    return object;
+}
+
+- (NSUInteger) count {
+    return _count.load(std::memory_order_relaxed);
+}
+
+@end
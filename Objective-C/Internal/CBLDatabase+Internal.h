@@ -40,6 +40,7 @@
 struct c4BlobStore;
 
 @class CBLBlobStream;
+@class CBLCookieJar;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -53,6 +54,9 @@ NS_ASSUME_NONNULL_BEGIN
 @property (readonly, nonatomic) dispatch_queue_t queryQueue;
 @property (readonly, nonatomic) FLSharedKeys sharedKeys;
 
+/** Caches the database's cookies in memory, for the replicators' WebSockets. */
+@property (readonly, nonatomic) CBLCookieJar* cookieJar;
+
 - (BOOL) mustBeOpen: (NSError**)outError;
 - (void) mustBeOpenLocked;
 
@@ -60,6 +64,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (nullable C4BlobStore*) getBlobStore: (NSError**)outError;
 
+// Returns the blob store for installing a blob outside the lock; the database doesn't close
+// until endBlobInstall is called.
+- (nullable C4BlobStore*) beginBlobInstall: (NSError**)outError;
+- (void) endBlobInstall;
+
 - (void) registerActiveService: (id<CBLDatabaseService>)service;
 - (void) unregisterActiveService: (id<CBLDatabaseService>)service;
 
@@ -105,6 +114,12 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (BOOL)installInDatabase: (CBLDatabase *)db error:(NSError **)error;
 
+/** Installs the blobs of the document that aren't in the database yet, so that saving the
+    document only has to reference them. Call it without holding the database lock. */
++ (BOOL) installBlobsInDocument: (CBLDocument*)document
+                     inDatabase: (CBLDatabase*)db
+                          error: (NSError**)error;
+
 @end
 
 
@@ -66,6 +66,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (nonatomic, readonly, nullable) FLDict fleeceData;
 
+// The document's properties. Created on first access for the documents passed to replication filters.
+@property (nonatomic, readonly) CBLDictionary* dict;
+
 // Sets and retains the fleece document which owns the backing data.
 // Returns NO if the document's root value is not a dictionary.
 - (BOOL) setFleeceDoc: (FLDoc)doc;
@@ -24,8 +24,9 @@
 NS_ASSUME_NONNULL_BEGIN
 
 /**
- A subclass of CBLChangeNotifier that manages document change notifications.
- It manages the underlying C4DocumentObserver and posts the CBLDocumentChange notifications itself.
+ A subclass of CBLChangeNotifier that manages the listeners of a single document.
+ It doesn't observe the document itself; the collection owns one C4CollectionObserver for all of
+ its document listeners and calls -postChange on the notifier of each changed document.
 */
 @interface CBLDocumentChangeNotifier : CBLChangeNotifier<CBLDocumentChange*>
 
@@ -33,8 +34,10 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (instancetype) initWithCollection: (CBLCollection*)collection documentID: (NSString*)documentID;
 
-/** Immediately stops the C4DocumentObserver. No more notifications will be sent. */
-- (void) stop;
+@property (nonatomic, readonly) NSString* documentID;
+
+/** Creates a CBLDocumentChange and posts it to all listeners. */
+- (void) postChange;
 
 @end
 
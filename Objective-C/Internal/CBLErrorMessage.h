@@ -77,6 +77,9 @@ extern NSString* const kCBLErrorMessageEncodeFailureInvalidQuery;
 extern NSString* const kCBLErrorMessageNoDefaultCollectionInConfig;
 extern NSString* const kCBLErrorMessageNegativeHeartBeat;
 extern NSString* const kCBLErrorMessageNegativeMaxAttemptWaitTime;
+extern NSString* const kCBLErrorMessageInvalidCompressionLevel;
+extern NSString* const kCBLErrorMessageInvalidCompressionWindowBits;
+extern NSString* const kCBLErrorMessageNegativeDNSCacheTTL;
 extern NSString* const kCBLErrorMessageAccessDBWithoutCollection;
 
 @end
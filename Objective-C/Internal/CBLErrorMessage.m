@@ -75,6 +75,9 @@ NSString* const kCBLErrorMessageEncodeFailureInvalidQuery = @"Invalid query para
 NSString* const kCBLErrorMessageNoDefaultCollectionInConfig = @"No default collection added to the configuration.";
 NSString* const kCBLErrorMessageNegativeHeartBeat = @"Attempt to store negative value in heartbeat.";
 NSString* const kCBLErrorMessageNegativeMaxAttemptWaitTime = @"Attempt to store negative value in maxAttemptWaitTime.";
+NSString* const kCBLErrorMessageInvalidCompressionLevel = @"Attempt to store a value larger than 9 in compressionLevel.";
+NSString* const kCBLErrorMessageInvalidCompressionWindowBits = @"Attempt to store a value outside 9-15 in compressionWindowBits.";
+NSString* const kCBLErrorMessageNegativeDNSCacheTTL = @"Attempt to store a negative value in the DNS cache's minimumTTL or maximumTTL.";
 NSString* const kCBLErrorMessageAccessDBWithoutCollection = @"Attempt to access database property but no collections added.";
 
 @end
@@ -28,6 +28,9 @@ NS_ASSUME_NONNULL_BEGIN
 /** Returns YES if this error appears to be due to a creating a file/dir that already exists. */
 BOOL CBLIsFileExistsError( NSError* error );
 
+/** Returns a monotonic timestamp in seconds, suitable for measuring elapsed time. */
+NSTimeInterval CBLUptime(void);
+
 NS_ASSUME_NONNULL_END
 
 #ifdef __cplusplus
@@ -18,6 +18,7 @@
 //
 
 #import "CBLMisc.h"
+#import <time.h>
 
 BOOL CBLIsFileExistsError(NSError* error) {
     NSString* domain = error.domain;
@@ -25,3 +26,7 @@ BOOL CBLIsFileExistsError(NSError* error) {
     return ($equal(domain, NSPOSIXErrorDomain) && code == EEXIST)
         || ($equal(domain, NSCocoaErrorDomain) && code == NSFileWriteFileExistsError);
 }
+
+NSTimeInterval CBLUptime(void) {
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW) / (double)NSEC_PER_SEC;
+}
@@ -30,6 +30,7 @@
 #import "CBLQuerySelectResult.h"
 #import "CBLQueryExpression.h"
 #import "CBLQueryOrdering.h"
+#import "CBLQueryStats.h"
 
 
 NS_ASSUME_NONNULL_BEGIN
@@ -40,6 +41,15 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, readonly) C4Query* c4query;
 @property (nonatomic, readonly) NSUInteger columnCount;
 
+/** The time in seconds spent compiling the query. */
+@property (nonatomic, readonly) NSTimeInterval compileTime;
+
+/** YES if the query plan contains a full collection scan. Computed once from -explain: and cached. */
+@property (nonatomic, readonly) BOOL usesFullScan;
+
+/** The N1QL or JSON text of the query, used for logging. */
+@property (nonatomic, readonly) NSString* queryText;
+
 - (instancetype) initWithSelect: (NSArray<CBLQuerySelectResult*>*)select
                        distinct: (BOOL)distinct
                            from: (CBLQueryDataSource*)from
@@ -118,6 +128,17 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+@interface CBLQueryStats ()
+
+- (instancetype) initWithCompileTime: (NSTimeInterval)compileTime
+                     firstRowLatency: (NSTimeInterval)firstRowLatency
+                     enumerationTime: (NSTimeInterval)enumerationTime
+                            rowCount: (uint64_t)rowCount
+                            fullScan: (BOOL)fullScan
+                            complete: (BOOL)complete;
+
+@end
+
 @interface CBLQueryCollation () <CBLQueryJSONEncoding>
 
 - (instancetype) initWithUnicode: (BOOL)unicode
@@ -29,6 +29,12 @@ NS_ASSUME_NONNULL_BEGIN
                     enumerator: (C4QueryEnumerator*)e
                    columnNames: (NSDictionary*)columnNames;
 
+// The start time is the CBLUptime() when the query execution began, used for the stats.
+- (instancetype) initWithQuery: (CBLQuery*)query
+                    enumerator: (C4QueryEnumerator*)e
+                   columnNames: (NSDictionary*)columnNames
+                     startTime: (NSTimeInterval)startTime;
+
 @property (nonatomic, readonly) CBLDatabase* database;
 @property (nonatomic, readonly) CBLQuery* query;
 @property (nonatomic, readonly) NSDictionary* columnNames;
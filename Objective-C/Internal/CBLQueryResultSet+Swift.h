@@ -0,0 +1,43 @@
+//
+//  CBLQueryResultSet+Swift.h
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CBLQueryResultSet.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Row access without CBLQueryResult objects, used by the Swift Codable decoder.
+// The row values are opaque FLValue pointers, readable with CBLDecoder, which are only
+// valid until the next call to -advanceRow.
+@interface CBLQueryResultSet ()
+
+/** The column name to column index map. */
+- (NSDictionary<NSString*, NSNumber*>*) columnIndexes;
+
+/** Advances to the next row. Returns NO at the end of the enumeration or on error. */
+- (BOOL) advanceRow;
+
+/** Returns the value of the column in the current row, or NULL if the column is missing. */
+- (nullable const void*) rowValueAtIndex: (NSUInteger)index;
+
+/** Converts a value of the current row into an object (CBLDictionary, CBLArray, CBLBlob, ...). */
+- (nullable id) objectForRowValue: (const void*)value;
+
+@end
+
+NS_ASSUME_NONNULL_END
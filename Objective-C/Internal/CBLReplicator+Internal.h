@@ -21,6 +21,7 @@
 #import "CBLReplicatorConfiguration.h"
 #import "c4.h"
 #import "CBLDatabaseService.h"
+#import "CBLReplicatorOptions.h"
 
 #ifdef COUCHBASE_ENTERPRISE
 #import "CBLReplicatorConfiguration+ServerCert.h"
@@ -35,6 +36,7 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic) CBLDatabase* database;
 @property (readonly, nonatomic) NSDictionary* effectiveOptions;
 @property (nonatomic) NSTimeInterval checkpointInterval;
+@property (nonatomic) BOOL usePOSIXWebSocket;   // Use the POSIX socket transport (no public api)
 @property (nonatomic) NSMutableDictionary<CBLCollection*, CBLCollectionConfiguration*>* collectionConfigMap;
 
 #ifdef COUCHBASE_ENTERPRISE
@@ -0,0 +1,34 @@
+//
+//  CBLBandwidthLimiter+Internal.h
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#pragma once
+#import "CBLBandwidthLimiter.h"
+#import "CBLTokenBucket.hh"
+#import <memory>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface CBLBandwidthLimiter ()
+
+/** The token bucket, shared with the WebSockets, which may outlive the limiter. */
+@property (readonly, nonatomic) std::shared_ptr<cbl::TokenBucket> bucket;
+
+@end
+
+NS_ASSUME_NONNULL_END
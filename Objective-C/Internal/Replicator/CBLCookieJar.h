@@ -0,0 +1,52 @@
+//
+//  CBLCookieJar.h
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+
+#import "CBLCookieStore.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** An in-memory, write-through cache in front of a persistent cookie store (the database), so
+    that WebSocket handshakes don't take the database lock.
+    The persisted cookies of a URL are read from the store the first time they're needed, and
+    again after a while to pick up the ones the store expired. Saved cookies take effect in memory
+    at once, including their expiration, and are written to the store asynchronously.
+    Each CBLDatabase instance has its own jar, even when several are open on the same file: a
+    cookie saved through one instance may be missed by another for up to 5 minutes, until that
+    one reads the store again.
+    Thread-safe. */
+@interface CBLCookieJar : NSObject <CBLCookieStore>
+
+/** The store isn't retained. */
+- (instancetype) initWithStore: (id<CBLCookieStore>)store;
+
+/** Waits until the saved cookies have been written to the store. */
+- (void) flush;
+
+/** The number of the getCookies: calls answered without reading the store. */
+@property (readonly, atomic) NSUInteger hitCount;
+
+/** The number of the getCookies: calls that read the store. */
+@property (readonly, atomic) NSUInteger missCount;
+
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
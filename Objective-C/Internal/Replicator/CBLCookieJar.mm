@@ -0,0 +1,333 @@
+//
+//  CBLCookieJar.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+
+#import "CBLCookieJar.h"
+#import "CBLStatus.h"
+
+#define kReloadInterval 300.0       // Seconds before reading a URL's persisted cookies again
+
+// A cookie received in a Set-Cookie header:
+@interface CBLJarCookie : NSObject
+@property (nonatomic, copy) NSString* name;
+@property (nonatomic, copy) NSString* value;
+@property (nonatomic, copy) NSString* domain;
+@property (nonatomic) BOOL hostOnly;
+@property (nonatomic, copy) NSString* path;
+@property (nonatomic, nullable) NSDate* expires;    // nil for a session cookie
+@property (nonatomic) BOOL secure;
+@property (nonatomic, nullable) NSDate* persistedAt;    // When the store saved it, or nil
+@end
+
+@implementation CBLJarCookie
+@synthesize name=_name, value=_value, domain=_domain, hostOnly=_hostOnly, path=_path;
+@synthesize expires=_expires, secure=_secure, persistedAt=_persistedAt;
+@end
+
+// The persisted cookies read from the store for a URL:
+@interface CBLLoadedCookies : NSObject
+@property (nonatomic) NSArray<NSArray<NSString*>*>* pairs;     // [name, value]
+@property (nonatomic) NSDate* loadedAt;    // When reading them started
+@end
+
+@implementation CBLLoadedCookies
+@synthesize pairs=_pairs, loadedAt=_loadedAt;
+@end
+
+// The key that the store looks up a URL's cookies by:
+static NSString* urlKey(NSURL* url) {
+    return [NSString stringWithFormat: @"%@://%@:%@%@", url.scheme.lowercaseString,
+            url.host.lowercaseString, url.port ?: @0, url.path.stringByDeletingLastPathComponent];
+}
+
+// RFC 6265 5.1.4: the path a cookie applies to when it doesn't have a Path attribute.
+static NSString* defaultPath(NSURL* url) {
+    NSString* path = url.path;
+    NSRange slash = [path rangeOfString: @"/" options: NSBackwardsSearch];
+    if (![path hasPrefix: @"/"] || slash.location == 0)
+        return @"/";
+    return [path substringToIndex: slash.location];
+}
+
+// RFC 6265 5.1.4: whether a request path is within a cookie's path.
+static BOOL pathMatches(NSString* path, NSString* cookiePath) {
+    if (path.length == 0)
+        path = @"/";
+    if (![path hasPrefix: cookiePath])
+        return NO;
+    return path.length == cookiePath.length || [cookiePath hasSuffix: @"/"]
+        || [path characterAtIndex: cookiePath.length] == '/';
+}
+
+static BOOL domainMatches(NSString* host, NSString* domain) {
+    return [host isEqualToString: domain] || [host hasSuffix: [@"." stringByAppendingString: domain]];
+}
+
+// Parses an Expires attribute in any of the date formats allowed by RFC 2616 3.3.1.
+static NSDate* __nullable parseExpires(NSString* str) {
+    static NSArray<NSDateFormatter*>* sFormatters;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        NSMutableArray* formatters = [NSMutableArray array];
+        for (NSString* format in @[@"EEE, dd MMM yyyy HH:mm:ss zzz",        // RFC 1123
+                                   @"EEEE, dd-MMM-yy HH:mm:ss zzz",         // RFC 850
+                                   @"EEE, dd-MMM-yyyy HH:mm:ss zzz",
+                                   @"EEE MMM d HH:mm:ss yyyy"]) {           // asctime()
+            NSDateFormatter* formatter = [[NSDateFormatter alloc] init];
+            formatter.locale = [NSLocale localeWithLocaleIdentifier: @"en_US_POSIX"];
+            formatter.timeZone = [NSTimeZone timeZoneForSecondsFromGMT: 0];
+            formatter.dateFormat = format;
+            [formatters addObject: formatter];
+        }
+        sFormatters = formatters;
+    });
+    for (NSDateFormatter* formatter in sFormatters) {
+        NSDate* date = [formatter dateFromString: str];
+        if (date)
+            return date;
+    }
+    return nil;
+}
+
+// Parses a Set-Cookie header value received from the URL. Returns nil if it's invalid or if
+// its domain isn't allowed.
+static CBLJarCookie* __nullable parseCookie(NSString* header, NSURL* url, BOOL acceptParentDomain) {
+    NSCharacterSet* ws = [NSCharacterSet whitespaceCharacterSet];
+    NSArray<NSString*>* parts = [header componentsSeparatedByString: @";"];
+    NSString* pair = parts[0];
+    NSRange eq = [pair rangeOfString: @"="];
+    if (eq.location == NSNotFound)
+        return nil;
+
+    CBLJarCookie* cookie = [CBLJarCookie new];
+    cookie.name = [[pair substringToIndex: eq.location] stringByTrimmingCharactersInSet: ws];
+    cookie.value = [[pair substringFromIndex: NSMaxRange(eq)] stringByTrimmingCharactersInSet: ws];
+    if (cookie.name.length == 0)
+        return nil;
+
+    NSString* host = url.host.lowercaseString;
+    cookie.domain = host;
+    cookie.hostOnly = YES;
+    cookie.path = defaultPath(url);
+
+    NSDate* maxAgeExpires = nil;
+    for (NSUInteger i = 1; i < parts.count; i++) {
+        NSString* attr = [parts[i] stringByTrimmingCharactersInSet: ws];
+        NSRange aeq = [attr rangeOfString: @"="];
+        NSString* key = (aeq.location == NSNotFound) ? attr : [attr substringToIndex: aeq.location];
+        NSString* value = (aeq.location == NSNotFound) ? @""
+            : [[attr substringFromIndex: NSMaxRange(aeq)] stringByTrimmingCharactersInSet: ws];
+        key = [key stringByTrimmingCharactersInSet: ws].lowercaseString;
+
+        if ([key isEqualToString: @"domain"]) {
+            NSString* domain = value.lowercaseString;
+            if ([domain hasPrefix: @"."])
+                domain = [domain substringFromIndex: 1];
+            if (domain.length == 0)
+                continue;
+            if (!domainMatches(host, domain))
+                return nil;
+            if (![domain isEqualToString: host] && !acceptParentDomain)
+                return nil;
+            cookie.domain = domain;
+            cookie.hostOnly = NO;
+        } else if ([key isEqualToString: @"path"]) {
+            if ([value hasPrefix: @"/"])
+                cookie.path = value;
+        } else if ([key isEqualToString: @"expires"]) {
+            cookie.expires = parseExpires(value);
+        } else if ([key isEqualToString: @"max-age"]) {
+            NSInteger seconds = value.integerValue;
+            maxAgeExpires = (seconds <= 0) ? [NSDate distantPast]
+                                           : [NSDate dateWithTimeIntervalSinceNow: seconds];
+        } else if ([key isEqualToString: @"secure"]) {
+            cookie.secure = YES;
+        }
+    }
+    if (maxAgeExpires)
+        cookie.expires = maxAgeExpires;     // Max-Age takes precedence (RFC 6265 5.3)
+    return cookie;
+}
+
+@implementation CBLCookieJar {
+    __weak id<CBLCookieStore> _store;
+    dispatch_queue_t _persistQueue;
+    NSMutableArray<CBLJarCookie*>* _cookies;
+    NSMutableDictionary<NSString*, CBLLoadedCookies*>* _loaded;
+}
+
+@synthesize hitCount=_hitCount, missCount=_missCount;
+
+- (instancetype) initWithStore: (id<CBLCookieStore>)store {
+    self = [super init];
+    if (self) {
+        _store = store;
+        _persistQueue = dispatch_queue_create("CookieJar", DISPATCH_QUEUE_SERIAL);
+        _cookies = [NSMutableArray array];
+        _loaded = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+- (nullable NSString*) getCookies: (NSURL*)url error: (NSError**)outError {
+    NSString* key = urlKey(url);
+    CBLLoadedCookies* loaded;
+    @synchronized (self) {
+        loaded = _loaded[key];
+        if (loaded && -loaded.loadedAt.timeIntervalSinceNow >= kReloadInterval)
+            loaded = nil;
+        if (loaded)
+            _hitCount++;
+        else
+            _missCount++;
+    }
+
+    if (!loaded) {
+        // Read the persisted cookies outside the jar's lock, as the store takes its own:
+        id<CBLCookieStore> store = _store;
+        NSDate* readAt = [NSDate date];
+        NSError* error = nil;
+        NSString* persisted = [store getCookies: url error: &error];
+        if (error) {
+            if (outError)
+                *outError = error;
+            return nil;
+        }
+
+        NSMutableArray* pairs = [NSMutableArray array];
+        for (NSString* part in [persisted componentsSeparatedByString: @";"]) {
+            NSString* pair = [part stringByTrimmingCharactersInSet: [NSCharacterSet whitespaceCharacterSet]];
+            NSRange eq = [pair rangeOfString: @"="];
+            if (eq.location != NSNotFound && eq.location > 0)
+                [pairs addObject: @[[pair substringToIndex: eq.location],
+                                    [pair substringFromIndex: NSMaxRange(eq)]]];
+        }
+        loaded = [CBLLoadedCookies new];
+        loaded.pairs = pairs;
+        loaded.loadedAt = readAt;
+    }
+
+    @synchronized (self) {
+        _loaded[key] = loaded;
+
+        NSDate* now = [NSDate date];
+        NSString* host = url.host.lowercaseString;
+        NSString* scheme = url.scheme.lowercaseString;
+        BOOL secure = [scheme isEqualToString: @"https"] || [scheme isEqualToString: @"wss"];
+
+        NSMutableArray<NSString*>* names = [NSMutableArray array];
+        NSMutableDictionary<NSString*, NSString*>* values = [NSMutableDictionary dictionary];
+        for (NSArray<NSString*>* pair in loaded.pairs) {
+            if (!values[pair[0]])
+                [names addObject: pair[0]];
+            values[pair[0]] = pair[1];
+        }
+
+        // Saved cookies override the persisted ones, and expired ones remove them. An expired
+        // cookie is kept until no URL's persisted cookies were read before the store deleted it:
+        NSMutableIndexSet* stale = [NSMutableIndexSet indexSet];
+        [_cookies enumerateObjectsUsingBlock: ^(CBLJarCookie* cookie, NSUInteger i, BOOL* stop) {
+            BOOL expired = cookie.expires && [cookie.expires compare: now] != NSOrderedDescending;
+            if (expired && [self loadedSince: cookie.persistedAt]) {
+                [stale addIndex: i];
+                return;
+            }
+            BOOL matches = (cookie.hostOnly ? [host isEqualToString: cookie.domain]
+                                            : domainMatches(host, cookie.domain))
+                && pathMatches(url.path, cookie.path) && (secure || !cookie.secure);
+            if (!matches)
+                return;
+            if (expired) {
+                [values removeObjectForKey: cookie.name];
+                [names removeObject: cookie.name];
+            } else {
+                if (!values[cookie.name])
+                    [names addObject: cookie.name];
+                values[cookie.name] = cookie.value;
+            }
+        }];
+        [_cookies removeObjectsAtIndexes: stale];
+
+        if (names.count == 0)
+            return nil;
+        NSMutableArray<NSString*>* pairs = [NSMutableArray arrayWithCapacity: names.count];
+        for (NSString* name in names)
+            [pairs addObject: [NSString stringWithFormat: @"%@=%@", name, values[name]]];
+        return [pairs componentsJoinedByString: @"; "];
+    }
+}
+
+- (BOOL) saveCookie: (NSString*)header
+                url: (NSURL*)url
+ acceptParentDomain: (BOOL)acceptParentDomain
+              error: (NSError**)outError
+{
+    CBLJarCookie* cookie = parseCookie(header, url, acceptParentDomain);
+    if (!cookie)
+        return createError(CBLErrorInvalidParameter,
+                           [NSString stringWithFormat: @"Invalid cookie for %@", url.host],
+                           outError);
+
+    @synchronized (self) {
+        NSUInteger i = [_cookies indexOfObjectPassingTest: ^BOOL(CBLJarCookie* c, NSUInteger idx, BOOL* stop) {
+            return [c.name isEqualToString: cookie.name] && [c.domain isEqualToString: cookie.domain]
+                && [c.path isEqualToString: cookie.path];
+        }];
+        if (i != NSNotFound)
+            _cookies[i] = cookie;
+        else
+            [_cookies addObject: cookie];
+    }
+
+    // Write through to the store in the background:
+    __weak id<CBLCookieStore> weakStore = _store;
+    dispatch_async(_persistQueue, ^{
+        id<CBLCookieStore> store = weakStore;
+        NSError* error;
+        if (store && ![store saveCookie: header url: url acceptParentDomain: acceptParentDomain
+                                  error: &error]) {
+            CBLWarn(WebSocket, @"Cannot persist cookie for URL %@ : %@",
+                    url.absoluteString, error.localizedDescription);
+            return;
+        }
+        @synchronized (self) {
+            cookie.persistedAt = [NSDate date];
+        }
+    });
+    return YES;
+}
+
+// Whether every URL's persisted cookies in memory were read after `date`, or are due to be read
+// again. Must be called while locked.
+- (BOOL) loadedSince: (nullable NSDate*)date {
+    if (!date)
+        return NO;
+    for (CBLLoadedCookies* loaded in _loaded.objectEnumerator) {
+        if ([loaded.loadedAt compare: date] != NSOrderedDescending
+                && -loaded.loadedAt.timeIntervalSinceNow < kReloadInterval)
+            return NO;
+    }
+    return YES;
+}
+
+- (void) flush {
+    dispatch_sync(_persistQueue, ^{ });
+}
+
+@end
@@ -28,6 +28,14 @@ typedef NS_ENUM(NSUInteger, IPType) {
 
 @interface AddressInfo : NSObject
 
+/** The address is copied, with the port set. */
+- (instancetype) initWithAddress: (const struct sockaddr*)addr
+                         addrstr: (NSString*)addrstr
+                            type: (IPType)type
+                            host: (NSString*)host
+                            port: (UInt16)port
+                       interface: (UInt32)interface;
+
 @property (nonatomic, readonly) const struct sockaddr* addr;
 @property (nonatomic, readonly) const struct sockaddr_in* addrIn;
 @property (nonatomic, readonly) const struct sockaddr_in6* addrIn6;
@@ -43,12 +51,16 @@ typedef NS_ENUM(NSUInteger, IPType) {
 @end
 
 @protocol DNSServiceDelegate <NSObject>
-- (void) didResolveSuccessWithAddress: (AddressInfo*)info;
+/** Called with all the addresses found, in the order they should be tried: IPv6 and IPv4
+    addresses interleaved, IPv6 first (RFC 8305 section 4). */
+- (void) didResolveSuccessWithAddresses: (NSArray<AddressInfo*>*)addresses;
 - (void) didResolveFailWithError: (NSError*)error;
 @end
 
 @interface CBLDNSService : NSObject
 
+/** Resolves the host's IPv4 and IPv6 addresses. An interface index of 0 looks up on any
+    interface. */
 - (instancetype) initWithHost: (NSString*)host
                     interface: (UInt32)interface
                          port: (UInt16)port
@@ -56,6 +68,10 @@ typedef NS_ENUM(NSUInteger, IPType) {
 - (void) start;
 - (void) stop;
 
+/** The order to try the addresses in: the families interleaved, IPv6 first. */
++ (NSArray<AddressInfo*>*) interleaveIPv6: (NSArray<AddressInfo*>*)ipv6
+                                     IPv4: (NSArray<AddressInfo*>*)ipv4;
+
 @end
 
 NS_ASSUME_NONNULL_END
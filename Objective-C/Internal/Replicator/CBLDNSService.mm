@@ -18,19 +18,12 @@
 //
 
 #import "CBLDNSService.h"
+#import "CBLHostAddressCache.hh"
+#import "CBLReplicatorMetrics+Internal.h"
 #import <arpa/inet.h>
 #import <dns_sd.h>
 #import <netdb.h>
 
-@interface AddressInfo ()
-- (instancetype) initWithAddress: (const struct sockaddr*)addr
-                         addrstr: (NSString*)addrstr
-                            type: (IPType)type
-                            host: (NSString*)host
-                            port: (UInt16)port
-                       interface: (UInt32)interface;
-@end
-
 @implementation AddressInfo {
     NSData* _addr;
 }
@@ -50,23 +43,20 @@
                        interface: (UInt32)interface {
     self = [super init];
     if (self) {
-        if (self) {
-            struct sockaddr* mAddr = const_cast<struct sockaddr*>(addr);
-            if (type == kIPv4) {
-                struct sockaddr_in* addrIn = reinterpret_cast<struct sockaddr_in*>(mAddr);
-                addrIn->sin_port = htons(port);
-                _addr = [NSMutableData dataWithBytes: addrIn length: sizeof(struct sockaddr_in)];
-            } else {
-                struct sockaddr_in6* addrIn = reinterpret_cast<struct sockaddr_in6*>(mAddr);
-                addrIn->sin6_port = htons(port);
-                _addr = [NSMutableData dataWithBytes: addrIn length: sizeof(struct sockaddr_in6)];
-            }
-            _addrstr = addrstr;
-            _type = type;
-            _host = host;
-            _port = port;
-            _interface = interface;
+        if (type == kIPv4) {
+            struct sockaddr_in addrIn = *reinterpret_cast<const struct sockaddr_in*>(addr);
+            addrIn.sin_port = htons(port);
+            _addr = [NSData dataWithBytes: &addrIn length: sizeof(addrIn)];
+        } else {
+            struct sockaddr_in6 addrIn = *reinterpret_cast<const struct sockaddr_in6*>(addr);
+            addrIn.sin6_port = htons(port);
+            _addr = [NSData dataWithBytes: &addrIn length: sizeof(addrIn)];
         }
+        _addrstr = addrstr;
+        _type = type;
+        _host = host;
+        _port = port;
+        _interface = interface;
     }
     return self;
 }
@@ -95,7 +85,7 @@
 @end
 
 #define kTimeoutInterval 10.0
-#define kWaitingInterval 2.0
+#define kResolutionDelay 0.05   // Wait for the other family after the first answer (RFC 8305)
 
 @implementation CBLDNSService {
     NSString* _host;
@@ -105,12 +95,16 @@
     DNSServiceRef _dnsServiceRef;
     dispatch_queue_t _dnsQueue;
     
-    AddressInfo* _ipV4;
+    NSMutableArray<AddressInfo*>* _ipV4;
     DNSServiceErrorType _ipV4err;
     
-    AddressInfo* _ipV6;
+    NSMutableArray<AddressInfo*>* _ipV6;
     DNSServiceErrorType _ipV6err;
     
+    uint32_t _ttl;                      // Smallest TTL of the records found, in seconds
+    BOOL _moreComing;                   // More answers are about to be delivered
+    BOOL _resolutionDelayPassed;        // Don't wait any longer for the other family
+    
     dispatch_block_t _timeoutBlock;
     dispatch_block_t _waitingBlock;
     
@@ -146,10 +140,17 @@
         if ([self checkAlreadyIPAddress])
             return;
         
-        _ipV4 = nil;
+        if ([self checkCachedAddresses])
+            return;
+        
+        _ttl = UINT32_MAX;
+        _moreComing = NO;
+        _resolutionDelayPassed = NO;
+        
+        _ipV4 = [NSMutableArray array];
         _ipV4err = kDNSServiceErr_NoError;
         
-        _ipV6 = nil;
+        _ipV6 = [NSMutableArray array];
         _ipV6err = kDNSServiceErr_NoError;
         
         CBLLogVerbose(WebSocket, @"%@: Looking up '%@' on interface index '%d'", self, _host, (unsigned int)_interface);
@@ -184,42 +185,61 @@
     }
 }
 
+// Numeric hosts, including IPv6 addresses with a scope, are parsed instead of being looked up.
 - (BOOL) checkAlreadyIPAddress {
-    AddressInfo* info;
+    NSString* host = _host;
+    if ([host hasPrefix: @"["] && [host hasSuffix: @"]"])
+        host = [host substringWithRange: NSMakeRange(1, host.length - 2)];
     
-    const char* cHost = [_host cStringUsingEncoding: NSUTF8StringEncoding];
+    struct addrinfo hints = {};
+    hints.ai_flags = AI_NUMERICHOST;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* result = nullptr;
+    if (getaddrinfo(host.UTF8String, nullptr, &hints, &result) != 0 || !result)
+        return false;
     
-    struct sockaddr_in addrV4;
-    if (inet_pton(AF_INET, cHost, &addrV4.sin_addr) == 1) {
-        addrV4.sin_family = AF_INET;
-        info = [[AddressInfo alloc] initWithAddress: (const struct sockaddr*)&addrV4
-                                            addrstr: _host
-                                               type: kIPv4
+    AddressInfo* info = nil;
+    if (result->ai_family == AF_INET || result->ai_family == AF_INET6) {
+        info = [[AddressInfo alloc] initWithAddress: result->ai_addr
+                                            addrstr: host
+                                               type: (result->ai_family == AF_INET ? kIPv4 : kIPv6)
                                                host: _host
                                                port: _port
                                           interface: _interface];
     }
+    freeaddrinfo(result);
+    if (!info)
+        return false;
+    
+    dispatch_async(_dnsQueue, ^{
+        [self->_delegate didResolveSuccessWithAddresses: @[info]];
+    });
+    return true;
+}
 
-    if (!info) {
-        struct sockaddr_in6 addrV6;
-        if (inet_pton(AF_INET6, cHost, &addrV6.sin6_addr) == 1) {
-            addrV6.sin6_family = AF_INET6;
-            info = [[AddressInfo alloc] initWithAddress: (const struct sockaddr*)&addrV6
-                                                addrstr: _host
-                                                   type: kIPv6
-                                                   host: _host
-                                                   port: _port
-                                              interface: _interface];
-        }
-    }
+- (BOOL) checkCachedAddresses {
+    std::vector<cbl::HostAddressCache::Address> cached;
+    if (!cbl::HostAddressCache::shared().lookup(_host.UTF8String, _interface,
+                                                cbl::ReplicatorCounters::now(), cached))
+        return false;
     
-    if (info) {
-        dispatch_async(_dnsQueue, ^{
-            [self->_delegate didResolveSuccessWithAddress: info];
-        });
-        return true;
+    NSMutableArray<AddressInfo*>* addresses = [NSMutableArray arrayWithCapacity: cached.size()];
+    for (auto &address : cached) {
+        IPType type = address.addr()->sa_family == AF_INET ? kIPv4 : kIPv6;
+        [addresses addObject: [[AddressInfo alloc] initWithAddress: address.addr()
+                                                           addrstr: [self addrstr: address.addr()]
+                                                              type: type
+                                                              host: _host
+                                                              port: _port
+                                                         interface: _interface]];
     }
-    return false;
+    CBLLogVerbose(WebSocket, @"%@: Found %lu cached addresses of '%@'",
+                  self, (unsigned long)addresses.count, _host);
+    dispatch_async(_dnsQueue, ^{
+        [self->_delegate didResolveSuccessWithAddresses: addresses];
+    });
+    return true;
 }
 
 static void getAddrInfoCallback(DNSServiceRef sdref,
@@ -232,12 +252,14 @@ static void getAddrInfoCallback(DNSServiceRef sdref,
                                 void *context)
 {
     CBLDNSService* resolver = (__bridge CBLDNSService*)context;
-    [resolver didResolveAddressWithDNSService: sdref address: address flags: flags error: errorCode];
+    [resolver didResolveAddressWithDNSService: sdref address: address flags: flags ttl: ttl
+                                        error: errorCode];
 }
 
 - (void) didResolveAddressWithDNSService: (DNSServiceRef)ref
                                  address: (const struct sockaddr *)address
                                    flags: (const DNSServiceFlags)flags
+                                     ttl: (uint32_t)ttl
                                    error: (DNSServiceErrorType)errorCode {
     @synchronized (self) {
         if (ref != _dnsServiceRef) {
@@ -245,6 +267,7 @@ static void getAddrInfoCallback(DNSServiceRef sdref,
         }
         
         BOOL moreComing = (flags & kDNSServiceFlagsMoreComing) == kDNSServiceFlagsMoreComing;
+        _moreComing = moreComing;
         
         if (errorCode != kDNSServiceErr_NoError) {
             if (address->sa_family != AF_INET && address->sa_family != AF_INET6 && !moreComing) {
@@ -253,11 +276,13 @@ static void getAddrInfoCallback(DNSServiceRef sdref,
                 return;
             }
             
-            if (address->sa_family == AF_INET && !_ipV4) {
-                _ipV4err = errorCode;
-                CBLLogVerbose(WebSocket, @"%@: Received error %@ from querying IPv4 record",
-                              self, [self errorInfo: errorCode]);
-            } else if (!_ipV6) {
+            if (address->sa_family == AF_INET) {
+                if (_ipV4.count == 0) {
+                    _ipV4err = errorCode;
+                    CBLLogVerbose(WebSocket, @"%@: Received error %@ from querying IPv4 record",
+                                  self, [self errorInfo: errorCode]);
+                }
+            } else if (_ipV6.count == 0) {
                 _ipV6err = errorCode;
                 CBLLogVerbose(WebSocket, @"%@: Received error %@ from querying IPv6 record",
                               self, [self errorInfo: errorCode]);
@@ -280,22 +305,27 @@ static void getAddrInfoCallback(DNSServiceRef sdref,
         
         NSString* addrstr = [self addrstr: address];
         IPType type = address->sa_family == AF_INET ? kIPv4 : kIPv6;
+        NSMutableArray<AddressInfo*>* found = type == kIPv4 ? _ipV4 : _ipV6;
+        for (AddressInfo* existing in found) {
+            if ([existing.addrstr isEqualToString: addrstr])
+                return;
+        }
+        
         AddressInfo* info = [[AddressInfo alloc] initWithAddress: address
                                                          addrstr: addrstr
                                                             type: type
                                                             host: _host
                                                             port: _port
                                                        interface: _interface];
-        if (type == kIPv4) {
-            _ipV4 = info;
+        [found addObject: info];
+        _ttl = MIN(_ttl, ttl);
+        if (type == kIPv4)
             _ipV4err = kDNSServiceErr_NoError;
-        } else {
-            _ipV6 = info;
+        else
             _ipV6err = kDNSServiceErr_NoError;
-        }
         
         CBLLogVerbose(WebSocket, @"%@: Found address : %@", self, addrstr);
-        CBLLogVerbose(WebSocket, @"%@:   Type : %@", self, type == kIPv4 ? @"IPv4" : @"IPv6");
+        CBLLogVerbose(WebSocket, @"%@:   Type : %@, TTL : %u", self, type == kIPv4 ? @"IPv4" : @"IPv6", ttl);
         CBLLogVerbose(WebSocket, @"%@:   More Coming? : %@", self, moreComing ? @"YES" : @"NO");
         
         if (!moreComing) {
@@ -304,28 +334,36 @@ static void getAddrInfoCallback(DNSServiceRef sdref,
     }
 }
 
+- (BOOL) bothFamiliesAnswered {
+    return (_ipV4.count > 0 || _ipV4err != kDNSServiceErr_NoError) &&
+           (_ipV6.count > 0 || _ipV6err != kDNSServiceErr_NoError);
+}
+
 - (void) checkResult {
-    if (_ipV4) {
-        // Prefer IPv4
-        [self notifyResult];
-    } else if (_ipV6) {
-        if (_ipV4err == kDNSServiceErr_NoSuchRecord) {
+    // Don't report the addresses until the answers delivered together have all arrived:
+    if (_moreComing)
+        return;
+    
+    if ([self bothFamiliesAnswered]) {
+        if (_ipV4.count > 0 || _ipV6.count > 0)
             [self notifyResult];
-        } else {
-            // Wait to see if there is ipv4 address coming:
-            if (!_waitingBlock) {
-                _waitingBlock = dispatch_block_create(DISPATCH_BLOCK_ASSIGN_CURRENT, ^{
-                    @synchronized (self) {
-                        [self notifyResult];
-                    }
-                });
-                dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kWaitingInterval * NSEC_PER_SEC)),
-                               _dnsQueue, _waitingBlock);
-            }
-        }
-    } else {
-        if (_ipV4err != kDNSServiceErr_NoError && _ipV6err != kDNSServiceErr_NoError) {
+        else
             [self notifyError: _ipV4err];
+    } else if (_ipV4.count > 0 || _ipV6.count > 0) {
+        // Give the other family a short time to answer, instead of waiting for it, so that a
+        // slow or broken resolver for one family doesn't delay connecting (RFC 8305 section 3):
+        if (_resolutionDelayPassed) {
+            [self notifyResult];
+        } else if (!_waitingBlock) {
+            _waitingBlock = dispatch_block_create(DISPATCH_BLOCK_ASSIGN_CURRENT, ^{
+                @synchronized (self) {
+                    self->_waitingBlock = nil;
+                    self->_resolutionDelayPassed = YES;
+                    [self checkResult];
+                }
+            });
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kResolutionDelay * NSEC_PER_SEC)),
+                           _dnsQueue, _waitingBlock);
         }
     }
 }
@@ -381,23 +419,56 @@ static void getAddrInfoCallback(DNSServiceRef sdref,
         return;
     }
     
-    AddressInfo* info = _ipV4 ? _ipV4 : _ipV6;
-    if (!info) {
+    if (_ipV4.count == 0 && _ipV6.count == 0) {
         [self notifyError: kDNSServiceErr_NoSuchRecord];
         return;
     }
     
-    [_delegate didResolveSuccessWithAddress: info];
+    NSArray<AddressInfo*>* addresses = [[self class] interleaveIPv6: _ipV6 IPv4: _ipV4];
+    CBLLogVerbose(WebSocket, @"%@: Resolved '%@' to %lu IPv6 and %lu IPv4 addresses", self, _host,
+                  (unsigned long)_ipV6.count, (unsigned long)_ipV4.count);
+    
+    // Cache the addresses, unless a family didn't answer in time and may be missing:
+    if ([self bothFamiliesAnswered]) {
+        std::vector<cbl::HostAddressCache::Address> cached;
+        for (AddressInfo* info in addresses) {
+            cbl::HostAddressCache::Address address {};
+            memcpy(&address.storage, info.addr, info.length);
+            address.length = info.length;
+            cached.push_back(address);
+        }
+        cbl::HostAddressCache::shared().insert(_host.UTF8String, _interface, std::move(cached),
+                                               _ttl, cbl::ReplicatorCounters::now());
+    }
+    
+    [_delegate didResolveSuccessWithAddresses: addresses];
     [self stop];
 }
 
++ (NSArray<AddressInfo*>*) interleaveIPv6: (NSArray<AddressInfo*>*)ipv6
+                                     IPv4: (NSArray<AddressInfo*>*)ipv4
+{
+    NSMutableArray<AddressInfo*>* addresses = [NSMutableArray arrayWithCapacity: ipv6.count + ipv4.count];
+    for (NSUInteger i = 0; i < MAX(ipv4.count, ipv6.count); i++) {
+        if (i < ipv6.count)
+            [addresses addObject: ipv6[i]];
+        if (i < ipv4.count)
+            [addresses addObject: ipv4[i]];
+    }
+    return addresses;
+}
+
 - (void) notifyError: (DNSServiceErrorType)errorCode {
     if (!_dnsServiceRef) {
         return;
     }
     
-    NSString* msg = [NSString stringWithFormat: @"Failed to resolve address for %@ via interface %d",
-                     _host, (unsigned int)_interface];
+    NSString* msg;
+    if (_interface > 0)
+        msg = [NSString stringWithFormat: @"Failed to resolve address for %@ via interface %d",
+               _host, (unsigned int)_interface];
+    else
+        msg = [NSString stringWithFormat: @"Failed to resolve address for %@", _host];
     NSError* error;
     if (errorCode == kDNSServiceErr_NoSuchRecord) {
         error = addrInfoError(EAI_NONAME, msg);
@@ -0,0 +1,64 @@
+//
+//  CBLDocumentPredicate.hh
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#pragma once
+#import <Foundation/Foundation.h>
+#import "fleece/Fleece.hh"
+#import <memory>
+#import <vector>
+
+@class CBLQueryExpression, CBLQueryParameters;
+
+NS_ASSUME_NONNULL_BEGIN
+
+namespace cbl {
+
+    /** A query expression compiled into a tree that is evaluated directly on a revision's
+        Fleece body, used by the declarative replication filters. The evaluation doesn't
+        create any Objective-C objects and doesn't allocate.
+        Supported are property and document ID paths, parameters, literals, AND/OR/NOT,
+        the comparison operators, IS [NOT] (incl. NULL and MISSING), IS VALUED, IN and BETWEEN.
+        As in N1QL, comparing NULL or MISSING is false, and values of different types
+        are never equal. */
+    class DocumentPredicate {
+    public:
+        /** Compiles the expression. Parameters referenced by the expression are looked up
+            in `params` once; a missing parameter evaluates as MISSING. Returns null and sets
+            `outError` to a message if the expression uses an unsupported operation. */
+        static std::unique_ptr<DocumentPredicate> compile(CBLQueryExpression* expression,
+                                                          CBLQueryParameters* __nullable params,
+                                                          NSString* _Nullable * _Nullable outError);
+
+        /** Returns true if the revision with the given document ID and body matches. */
+        bool matches(fleece::slice docID, FLDict __nullable body) const;
+
+        struct Node;
+
+        DocumentPredicate(fleece::alloc_slice expression, fleece::alloc_slice params);
+        ~DocumentPredicate();
+
+    private:
+        fleece::Doc _expression;            // Owns the string and literal values of the tree
+        fleece::Doc _params;                // Owns the parameter values
+        std::unique_ptr<Node> _root;
+    };
+
+}
+
+NS_ASSUME_NONNULL_END
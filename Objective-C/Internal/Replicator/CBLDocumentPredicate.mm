@@ -0,0 +1,392 @@
+//
+//  CBLDocumentPredicate.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CBLDocumentPredicate.hh"
+#import "CBLQuery+Internal.h"
+#import "CBLQueryExpression+Internal.h"
+#import "CBLQueryParameters.h"
+#import "fleece/Fleece.hh"
+
+using namespace std;
+using namespace fleece;
+
+namespace cbl {
+
+    enum class Op : uint8_t {
+        // Operands:
+        kLiteral, kProperty, kDocumentID, kArray,
+        // Predicates:
+        kAnd, kOr, kNot,
+        kEqual, kNotEqual, kLess, kLessOrEqual, kGreater, kGreaterOrEqual,
+        kIs, kIsNot, kIsValued, kIn, kBetween,
+    };
+
+    struct DocumentPredicate::Node {
+        Op op;
+        FLValue value {nullptr};        // kLiteral; null is MISSING
+        vector<slice> path;             // kProperty; slices of the compiled expression
+        vector<Node> operands;
+
+        bool isOperand() const          {return op <= Op::kArray;}
+    };
+
+    using Node = DocumentPredicate::Node;
+
+    namespace {
+
+        // An evaluated operand. The document ID isn't in the body, so it's kept as a slice.
+        struct Operand {
+            FLValue value {nullptr};
+            slice docID;
+
+            FLValueType type() const {
+                return docID ? kFLString : FLValue_GetType(value);  // kFLUndefined if MISSING
+            }
+            slice asString() const {
+                return docID ? docID : slice(FLValue_AsString(value));
+            }
+        };
+
+        enum class Comparison {kLess, kEqual, kGreater, kUnequal, kIncomparable};
+
+        Comparison compare(const Operand &a, const Operand &b) {
+            FLValueType type = a.type();
+            if (type == kFLUndefined || type == kFLNull || b.type() == kFLUndefined || b.type() == kFLNull)
+                return Comparison::kIncomparable;
+            if (type != b.type())
+                return Comparison::kUnequal;
+
+            int cmp;
+            switch (type) {
+                case kFLBoolean:
+                    cmp = int(FLValue_AsBool(a.value)) - int(FLValue_AsBool(b.value));
+                    break;
+                case kFLNumber:
+                    if (FLValue_IsInteger(a.value) && FLValue_IsInteger(b.value)
+                            && !FLValue_IsUnsigned(a.value) && !FLValue_IsUnsigned(b.value)) {
+                        int64_t ia = FLValue_AsInt(a.value), ib = FLValue_AsInt(b.value);
+                        cmp = (ia > ib) - (ia < ib);
+                    } else {
+                        double da = FLValue_AsDouble(a.value), db = FLValue_AsDouble(b.value);
+                        cmp = (da > db) - (da < db);
+                    }
+                    break;
+                case kFLString:
+                    cmp = a.asString().compare(b.asString());
+                    break;
+                default:
+                    // Arrays and dictionaries can only be tested for equality:
+                    return FLValue_IsEqual(a.value, b.value) ? Comparison::kEqual : Comparison::kUnequal;
+            }
+            return cmp < 0 ? Comparison::kLess : (cmp > 0 ? Comparison::kGreater : Comparison::kEqual);
+        }
+
+        // N1QL's IS: like `=`, except that NULL IS NULL and MISSING IS MISSING.
+        bool isSame(const Operand &a, const Operand &b) {
+            FLValueType ta = a.type(), tb = b.type();
+            if (ta == kFLUndefined || tb == kFLUndefined || ta == kFLNull || tb == kFLNull)
+                return ta == tb;
+            return compare(a, b) == Comparison::kEqual;
+        }
+
+        bool isTruthy(const Operand &a) {
+            switch (a.type()) {
+                case kFLBoolean: return FLValue_AsBool(a.value);
+                case kFLNumber:  return FLValue_AsDouble(a.value) != 0.0;
+                case kFLString:  return a.asString().size > 0;
+                case kFLArray:   return FLArray_Count(FLValue_AsArray(a.value)) > 0;
+                case kFLDict:    return FLDict_Count(FLValue_AsDict(a.value)) > 0;
+                default:         return false;
+            }
+        }
+
+        Operand evaluateOperand(const Node &node, slice docID, FLDict body) {
+            switch (node.op) {
+                case Op::kLiteral:
+                    return {node.value};
+                case Op::kDocumentID:
+                    return {nullptr, docID};
+                case Op::kProperty: {
+                    FLValue value = nullptr;
+                    FLDict dict = body;
+                    for (slice key : node.path) {
+                        value = FLDict_Get(dict, key);
+                        if (!value)
+                            break;
+                        dict = FLValue_AsDict(value);
+                    }
+                    return {value};
+                }
+                default:
+                    return {};
+            }
+        }
+
+        bool evaluate(const Node &node, slice docID, FLDict body) {
+            auto operand = [&](size_t i) {
+                return evaluateOperand(node.operands[i], docID, body);
+            };
+            switch (node.op) {
+                case Op::kAnd:
+                    for (auto &child : node.operands)
+                        if (!evaluate(child, docID, body))
+                            return false;
+                    return true;
+                case Op::kOr:
+                    for (auto &child : node.operands)
+                        if (evaluate(child, docID, body))
+                            return true;
+                    return false;
+                case Op::kNot:
+                    return !evaluate(node.operands[0], docID, body);
+                case Op::kEqual:
+                    return compare(operand(0), operand(1)) == Comparison::kEqual;
+                case Op::kNotEqual: {
+                    auto cmp = compare(operand(0), operand(1));
+                    return cmp != Comparison::kEqual && cmp != Comparison::kIncomparable;
+                }
+                case Op::kLess:
+                    return compare(operand(0), operand(1)) == Comparison::kLess;
+                case Op::kLessOrEqual: {
+                    auto cmp = compare(operand(0), operand(1));
+                    return cmp == Comparison::kLess || cmp == Comparison::kEqual;
+                }
+                case Op::kGreater:
+                    return compare(operand(0), operand(1)) == Comparison::kGreater;
+                case Op::kGreaterOrEqual: {
+                    auto cmp = compare(operand(0), operand(1));
+                    return cmp == Comparison::kGreater || cmp == Comparison::kEqual;
+                }
+                case Op::kIs:
+                    return isSame(operand(0), operand(1));
+                case Op::kIsNot:
+                    return !isSame(operand(0), operand(1));
+                case Op::kIsValued: {
+                    FLValueType type = operand(0).type();
+                    return type != kFLUndefined && type != kFLNull;
+                }
+                case Op::kBetween: {
+                    Operand value = operand(0);
+                    auto lower = compare(value, operand(1)), upper = compare(value, operand(2));
+                    return (lower == Comparison::kGreater || lower == Comparison::kEqual)
+                        && (upper == Comparison::kLess || upper == Comparison::kEqual);
+                }
+                case Op::kIn: {
+                    Operand value = operand(0);
+                    const Node &list = node.operands[1];
+                    if (list.op == Op::kArray) {
+                        for (auto &item : list.operands)
+                            if (compare(value, evaluateOperand(item, docID, body)) == Comparison::kEqual)
+                                return true;
+                    } else {
+                        // A parameter or a property holding an array:
+                        FLArray array = FLValue_AsArray(evaluateOperand(list, docID, body).value);
+                        for (uint32_t i = 0, n = FLArray_Count(array); i < n; ++i)
+                            if (compare(value, {FLArray_Get(array, i)}) == Comparison::kEqual)
+                                return true;
+                    }
+                    return false;
+                }
+                default:
+                    // A bare operand used as a condition:
+                    return isTruthy(evaluateOperand(node, docID, body));
+            }
+        }
+
+
+#pragma mark - COMPILING:
+
+        struct Compiler {
+            Dict params;
+            NSString* error {nil};
+
+            bool fail(NSString* message) {
+                if (!error)
+                    error = message;
+                return false;
+            }
+
+            bool compileOperand(Value json, Node &node) {
+                if (!compile(json, node))
+                    return false;
+                if (!node.isOperand() || node.op == Op::kArray)
+                    return fail(@"Only properties, parameters and literals can be compared");
+                return true;
+            }
+
+            bool compile(Value json, Node &node) {
+                Array array = json.asArray();
+                if (!array) {
+                    if (json.type() == kFLDict)
+                        return fail(@"Dictionary literals are not supported");
+                    node.op = Op::kLiteral;
+                    node.value = json;
+                    return true;
+                }
+
+                slice op = array[0].asString();
+                uint32_t argc = array.count() - 1;
+                if (!op)
+                    return fail(@"Invalid expression");
+
+                if (op[0] == '.')
+                    return compilePath(op, node);
+
+                if (op[0] == '$') {
+                    slice name = op;
+                    name.moveStart(1);
+                    node.op = Op::kLiteral;
+                    node.value = params ? params[name] : nullptr;
+                    return true;
+                }
+
+                if (op == "MISSING"_sl && argc == 0) {
+                    node.op = Op::kLiteral;
+                    node.value = nullptr;
+                    return true;
+                }
+
+                if (op == "[]"_sl) {
+                    node.op = Op::kArray;
+                    node.operands.resize(argc);
+                    for (uint32_t i = 0; i < argc; ++i)
+                        if (!compileOperand(array[i + 1], node.operands[i]))
+                            return false;
+                    return true;
+                }
+
+                if (op == "AND"_sl || op == "OR"_sl || op == "NOT"_sl) {
+                    node.op = (op == "AND"_sl) ? Op::kAnd : (op == "OR"_sl ? Op::kOr : Op::kNot);
+                    if (argc == 0 || (node.op == Op::kNot && argc != 1))
+                        return fail(@"Invalid expression");
+                    node.operands.resize(argc);
+                    for (uint32_t i = 0; i < argc; ++i)
+                        if (!compile(array[i + 1], node.operands[i]))
+                            return false;
+                    return true;
+                }
+
+                static const struct {slice name; Op op; uint32_t argc;} kOperators[] = {
+                    {"="_sl,         Op::kEqual,          2},
+                    {"!="_sl,        Op::kNotEqual,       2},
+                    {"<"_sl,         Op::kLess,           2},
+                    {"<="_sl,        Op::kLessOrEqual,    2},
+                    {">"_sl,         Op::kGreater,        2},
+                    {">="_sl,        Op::kGreaterOrEqual, 2},
+                    {"IS"_sl,        Op::kIs,             2},
+                    {"IS NOT"_sl,    Op::kIsNot,          2},
+                    {"IS VALUED"_sl, Op::kIsValued,       1},
+                    {"BETWEEN"_sl,   Op::kBetween,        3},
+                    {"IN"_sl,        Op::kIn,             2},
+                };
+                for (auto &entry : kOperators) {
+                    if (op != entry.name)
+                        continue;
+                    if (argc != entry.argc)
+                        return fail(@"Invalid expression");
+                    node.op = entry.op;
+                    node.operands.resize(argc);
+                    for (uint32_t i = 0; i < argc; ++i) {
+                        if (entry.op == Op::kIn && i == 1) {
+                            if (!compile(array[i + 1], node.operands[i]))
+                                return false;
+                            if (!node.operands[i].isOperand())
+                                return fail(@"IN requires an array of values");
+                        } else if (!compileOperand(array[i + 1], node.operands[i])) {
+                            return false;
+                        }
+                    }
+                    return true;
+                }
+
+                return fail([NSString stringWithFormat: @"Unsupported operation in filter "
+                             "expression: %.*s", (int)op.size, (const char*)op.buf]);
+            }
+
+            bool compilePath(slice path, Node &node) {
+                path.moveStart(1);
+                if (path == "_id"_sl) {
+                    node.op = Op::kDocumentID;
+                    return true;
+                }
+                if (path.size == 0 || path[0] == '_' || path.findByte('[') || path.findByte('\\'))
+                    return fail(@"Unsupported property path in filter expression");
+                node.op = Op::kProperty;
+                while (path.size > 0) {
+                    const uint8_t* dot = path.findByteOrEnd('.');
+                    slice key(path.buf, dot);
+                    if (key.size == 0)
+                        return fail(@"Invalid property path in filter expression");
+                    node.path.push_back(key);
+                    path.setStart(dot);
+                    if (path.size > 0)
+                        path.moveStart(1);
+                }
+                return true;
+            }
+        };
+
+    }
+
+
+#pragma mark - DOCUMENT PREDICATE:
+
+    DocumentPredicate::DocumentPredicate(alloc_slice expression, alloc_slice params)
+    :_expression(expression, kFLTrusted)
+    ,_root(new Node())
+    {
+        if (params)
+            _params = Doc(params, kFLTrusted);
+    }
+
+    DocumentPredicate::~DocumentPredicate() = default;
+
+    unique_ptr<DocumentPredicate> DocumentPredicate::compile(CBLQueryExpression* expression,
+                                                             CBLQueryParameters* params,
+                                                             NSString** outError)
+    {
+        Encoder enc;
+        enc.writeNSObject([expression asJSON]);
+        alloc_slice expressionData = enc.finish();
+
+        alloc_slice paramsData;
+        if (params) {
+            NSError* error;
+            NSData* data = [params encode: &error];
+            if (!data) {
+                if (outError) *outError = error.localizedDescription;
+                return nullptr;
+            }
+            paramsData = alloc_slice(slice(data));
+        }
+
+        unique_ptr<DocumentPredicate> predicate(new DocumentPredicate(expressionData, paramsData));
+        Compiler compiler {predicate->_params.root().asDict()};
+        if (!compiler.compile(predicate->_expression.root(), *predicate->_root)) {
+            if (outError) *outError = compiler.error;
+            return nullptr;
+        }
+        return predicate;
+    }
+
+    bool DocumentPredicate::matches(slice docID, FLDict body) const {
+        return evaluate(*_root, docID, body);
+    }
+
+}
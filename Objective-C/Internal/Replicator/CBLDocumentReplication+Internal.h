@@ -43,5 +43,25 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/**
+ A batch of ended documents copied from the C4DocumentEnded array given to the replicator's
+ documents ended callback. The array creates its CBLReplicatedDocuments lazily, when they are
+ first accessed.
+ */
+@interface CBLReplicatedDocumentBatch : NSArray<CBLReplicatedDocument*>
+
+/** Copies the documents; if errorsOnly is YES, only the documents that failed are copied. */
+- (instancetype) initWithDocuments: (const C4DocumentEnded* _Nonnull [_Nonnull])docEnds
+                             count: (size_t)count
+                        errorsOnly: (BOOL)errorsOnly;
+
+/** Returns a batch of the documents of the receiver that didn't fail with a conflict error. */
+- (CBLReplicatedDocumentBatch*) batchExcludingConflicts;
+
+/** The error of the document at the index, without creating its CBLReplicatedDocument. */
+- (C4Error) c4ErrorAtIndex: (NSUInteger)index;
+
+@end
+
 NS_ASSUME_NONNULL_END
 
@@ -0,0 +1,153 @@
+//
+//  CBLHostAddressCache.cc
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CBLHostAddressCache.hh"
+#include <ctype.h>
+
+namespace cbl {
+
+    static constexpr uint64_t kNanosPerSecond = 1000000000;
+
+
+    HostAddressCache& HostAddressCache::shared() {
+        static HostAddressCache* sCache = new HostAddressCache;     // Never destructed
+        return *sCache;
+    }
+
+
+    uint64_t HostAddressCache::minTTL() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _minTTL;
+    }
+
+
+    uint64_t HostAddressCache::maxTTL() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _maxTTL;
+    }
+
+
+    void HostAddressCache::setMinTTL(uint64_t ttl) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _minTTL = ttl;
+    }
+
+
+    void HostAddressCache::setMaxTTL(uint64_t ttl) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _maxTTL = ttl;
+        if (ttl == 0)
+            _entries.clear();
+    }
+
+
+    // Host names are case-insensitive.
+    std::string HostAddressCache::key(const std::string &host, unsigned interface) {
+        std::string key;
+        key.reserve(host.size() + 8);
+        for (char c : host)
+            key += (char)tolower((unsigned char)c);
+        key += '%';
+        key += std::to_string(interface);
+        return key;
+    }
+
+
+    bool HostAddressCache::lookup(const std::string &host, unsigned interface, uint64_t now,
+                          std::vector<Address> &out)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto i = _entries.find(key(host, interface));
+        if (i != _entries.end() && i->second.expiration <= now) {
+            _entries.erase(i);
+            i = _entries.end();
+        }
+        if (i == _entries.end()) {
+            ++_stats.misses;
+            return false;
+        }
+        ++_stats.hits;
+        out = i->second.addresses;
+        return true;
+    }
+
+
+    void HostAddressCache::insert(const std::string &host, unsigned interface,
+                          std::vector<Address> addresses, uint32_t ttlSeconds, uint64_t now)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (addresses.empty() || _maxTTL == 0)
+            return;
+        uint64_t ttl = ttlSeconds * kNanosPerSecond;
+        if (ttl < _minTTL)
+            ttl = _minTTL;
+        if (ttl > _maxTTL)
+            ttl = _maxTTL;
+
+        std::string k = key(host, interface);
+        if (_entries.size() >= kMaxEntries && _entries.find(k) == _entries.end())
+            removeExpired(now);
+        _entries[k] = {std::move(addresses), now + ttl};
+    }
+
+
+    void HostAddressCache::invalidate(const std::string &host, unsigned interface) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_entries.erase(key(host, interface)) > 0)
+            ++_stats.invalidations;
+    }
+
+
+    void HostAddressCache::clear() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.clear();
+        _stats = {};
+    }
+
+
+    HostAddressCache::Stats HostAddressCache::stats() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _stats;
+    }
+
+
+    size_t HostAddressCache::count() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _entries.size();
+    }
+
+
+    // Makes room for an entry: removes the expired entries, or if there are none, the entry
+    // that would expire first.
+    void HostAddressCache::removeExpired(uint64_t now) {
+        auto first = _entries.end();
+        for (auto i = _entries.begin(); i != _entries.end(); ) {
+            if (i->second.expiration <= now) {
+                i = _entries.erase(i);
+            } else {
+                if (first == _entries.end() || i->second.expiration < first->second.expiration)
+                    first = i;
+                ++i;
+            }
+        }
+        if (_entries.size() >= kMaxEntries && first != _entries.end())
+            _entries.erase(first);
+    }
+
+}
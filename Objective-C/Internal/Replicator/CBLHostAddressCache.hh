@@ -0,0 +1,107 @@
+//
+//  CBLHostAddressCache.hh
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cbl {
+
+    /** A process-wide cache of resolved host addresses, so that reconnecting doesn't wait for
+        the resolver again. Entries expire after their records' TTL, limited to a minimum and a
+        maximum, and are removed when connecting to their addresses fails.
+        Times are in nanoseconds, from ReplicatorCounters::now(). Thread-safe. */
+    class HostAddressCache {
+    public:
+        /** A resolved address. Its port is not significant. */
+        struct Address {
+            sockaddr_storage storage;
+            socklen_t length;
+
+            const sockaddr* addr() const    {return (const sockaddr*)&storage;}
+        };
+
+        struct Stats {
+            uint64_t hits {0}, misses {0};
+            uint64_t invalidations {0};     // Entries removed because connecting failed
+
+            /** The fraction of lookups answered from the cache. */
+            double hitRate() const {
+                return hits + misses > 0 ? (double)hits / (hits + misses) : 0.0;
+            }
+        };
+
+        static constexpr uint64_t kDefaultMinTTL = 5000000000;      // Nanoseconds
+        static constexpr uint64_t kDefaultMaxTTL = 300000000000;    // Nanoseconds
+        static constexpr size_t kMaxEntries = 256;
+
+        /** The cache shared by all the WebSockets. */
+        static HostAddressCache& shared();
+
+        HostAddressCache() = default;
+
+        /** The limits applied to the records' TTL. A maximum of 0 disables the cache; if the
+            maximum is less than the minimum, the maximum is used. */
+        uint64_t minTTL() const;
+        uint64_t maxTTL() const;
+        void setMinTTL(uint64_t ttl);
+        void setMaxTTL(uint64_t ttl);
+
+        /** Copies the unexpired addresses of the host, resolved on the network interface (0 for
+            any), to `out`. Returns false if there are none. */
+        bool lookup(const std::string &host, unsigned interface, uint64_t now,
+                    std::vector<Address> &out);
+
+        /** Adds the addresses of the host, whose records have the given TTL in seconds. */
+        void insert(const std::string &host, unsigned interface, std::vector<Address> addresses,
+                    uint32_t ttlSeconds, uint64_t now);
+
+        /** Removes the host's addresses, because connecting to them failed. */
+        void invalidate(const std::string &host, unsigned interface);
+
+        /** Removes all entries and resets the stats. */
+        void clear();
+
+        Stats stats() const;
+        size_t count() const;
+
+        HostAddressCache(const HostAddressCache&) = delete;
+        HostAddressCache& operator=(const HostAddressCache&) = delete;
+
+    private:
+        struct Entry {
+            std::vector<Address> addresses;
+            uint64_t expiration;
+        };
+
+        static std::string key(const std::string &host, unsigned interface);
+        void removeExpired(uint64_t now);
+
+        mutable std::mutex _mutex;
+        std::unordered_map<std::string, Entry> _entries;
+        uint64_t _minTTL {kDefaultMinTTL}, _maxTTL {kDefaultMaxTTL};
+        Stats _stats;
+    };
+
+}
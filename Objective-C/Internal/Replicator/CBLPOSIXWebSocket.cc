@@ -0,0 +1,816 @@
+//
+//  CBLPOSIXWebSocket.cc
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CBLPOSIXWebSocket.hh"
+#include "CBLWebSocketHandshake.hh"
+#include "CBLReceiveWindow.hh"
+#include "CBLSocketOptions.hh"
+#include "CBLReplicatorMetrics+Internal.h"
+#include "CBLReplicatorOptions.h"
+#include "c4.h"
+#include "fleece/Expert.hh"             // for AllocedDict
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <errno.h>
+#include <fcntl.h>
+#include <functional>
+#include <mutex>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <random>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+using namespace fleece;
+
+namespace cbl {
+
+    // Time allowed for connecting, including DNS, TLS and the HTTP handshake:
+    static constexpr auto kConnectTimeout = std::chrono::seconds(15);
+
+    // Max number of frames written by one sendmsg() call:
+    static constexpr int kMaxIOVecs = 64;
+
+    #ifdef MSG_NOSIGNAL
+    static constexpr int kSendFlags = MSG_NOSIGNAL;     // Linux: no SIGPIPE on a closed socket
+    #else
+    static constexpr int kSendFlags = 0;                // Darwin uses SO_NOSIGPIPE instead
+    #endif
+
+    static std::mutex sTLSProviderMutex;
+    static std::shared_ptr<TLSProvider> sTLSProvider;
+
+    class Connection;
+
+
+#pragma mark - EVENT LOOP:
+
+    /** The thread that runs all POSIXWebSocket connections. Other threads hand it work
+        through `perform`, which wakes up its poll() call through a pipe. */
+    class EventLoop {
+    public:
+        static EventLoop& instance() {
+            static EventLoop* sInstance = new EventLoop;    // Never destructed
+            return *sInstance;
+        }
+
+        /** Calls `task` on the event loop thread. */
+        void perform(std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _tasks.push_back(std::move(task));
+                if (_tasks.size() > 1)
+                    return;                                 // The loop has already been woken
+            }
+            char c = 0;
+            (void)::write(_wakeFDs[1], &c, 1);
+        }
+
+        // These are only called on the event loop thread:
+        void add(int fd, std::shared_ptr<Connection> connection) {_connections[fd] = connection;}
+        void remove(int fd)                                 {_connections.erase(fd);}
+        void addResolving(std::shared_ptr<Connection> connection) {
+            _resolving.push_back(std::move(connection));
+        }
+
+    private:
+        EventLoop() {
+            if (::pipe(_wakeFDs) != 0)
+                abort();
+            for (int fd : _wakeFDs)
+                ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+            std::thread([this] {run();}).detach();
+        }
+
+        void run();
+
+        std::mutex _mutex;
+        std::vector<std::function<void()>> _tasks;
+        int _wakeFDs[2];
+        std::unordered_map<int, std::shared_ptr<Connection>> _connections;
+        std::vector<std::shared_ptr<Connection>> _resolving;    // Have no socket yet
+    };
+
+
+#pragma mark - CONNECTION:
+
+    /** One WebSocket connection: the implementation behind a C4Socket. Apart from its creation,
+        everything happens on the event loop thread. */
+    class Connection : public std::enable_shared_from_this<Connection> {
+    public:
+        Connection(C4Socket* c4socket, const C4Address &address, slice options, void* context)
+        :_c4socket(c4socket)
+        ,_options(options)
+        ,_host(slice(address.hostname).asString())
+        ,_port(address.port)
+        ,_path(slice(address.path).asString())
+        ,_tls(slice(address.scheme) == "wss"_sl || slice(address.scheme) == "blips"_sl)
+        ,_socketOptions(_options)
+        ,_window(_options[kCBLReplicatorOptionMinReceiveWindow].asUnsigned(),
+                 _options[kCBLReplicatorOptionMaxReceiveWindow].asUnsigned())
+        {
+            // Balanced by the c4socket_release in closed()
+            c4socket_retain(c4socket);
+            if (context)
+                _counters = *(std::shared_ptr<ReplicatorCounters>*)context;
+            _deadline = std::chrono::steady_clock::now() + kConnectTimeout;
+        }
+
+        ~Connection() {
+            for (auto &frame : _frames)
+                c4slice_free(frame.data);
+        }
+
+        // Keeps the connection alive until the C4Socket is disposed:
+        void retainSelf()                   {_self = shared_from_this();}
+
+        static Connection* get(C4Socket* s) {return (Connection*)c4Socket_getNativeHandle(s);}
+
+        int fd() const                      {return _fd;}
+
+        bool resolving() const              {return _state == kResolving;}
+
+        /** The poll() events the connection is waiting for. */
+        short events() const {
+            switch (_state) {
+                case kConnecting:       return POLLOUT;
+                case kTLSHandshake:     return _tlsWantsWrite ? POLLOUT : POLLIN;
+                case kHTTPHandshake:    return _httpOut.empty() ? POLLIN : POLLOUT;
+                case kOpen:             return (_window.throttled() ? 0 : POLLIN)
+                                             | (_frames.empty() ? 0 : POLLOUT);
+                default:                return 0;
+            }
+        }
+
+        bool timedOut(std::chrono::steady_clock::time_point now) const {
+            return _state < kOpen && now > _deadline;
+        }
+
+
+        // Called on a LiteCore thread, from the socket factory's `open`:
+        void start() {
+            c4log(kC4WebSocketLog, kC4LogInfo, "POSIXWebSocket %p: Connecting to %s:%u...",
+                  this, _host.c_str(), _port);
+            if (_tls) {
+                std::lock_guard<std::mutex> lock(sTLSProviderMutex);
+                _tlsProvider = sTLSProvider;
+            }
+            _connectStart = ReplicatorCounters::now();
+            // getaddrinfo() blocks, so resolve the host on a separate thread. The event loop
+            // watches the connection meanwhile, so that the connect deadline covers resolving:
+            auto self = shared_from_this();
+            EventLoop::instance().perform([self] {
+                EventLoop::instance().addResolving(self);
+            });
+            std::thread([self] {
+                addrinfo hints = {}, *result = nullptr;
+                hints.ai_family = AF_UNSPEC;
+                hints.ai_socktype = SOCK_STREAM;
+                std::string port = std::to_string(self->_port);
+                int err = ::getaddrinfo(self->_host.c_str(), port.c_str(), &hints, &result);
+                EventLoop::instance().perform([self, err, result] {
+                    self->resolved(err, result);
+                });
+            }).detach();
+        }
+
+
+        void resolved(int err, addrinfo* addresses) {
+            if (_state != kResolving) {
+                if (addresses)
+                    ::freeaddrinfo(addresses);
+                return;
+            }
+            if (err) {
+                c4log(kC4WebSocketLog, kC4LogInfo, "POSIXWebSocket %p: Can't resolve %s: %s",
+                      this, _host.c_str(), gai_strerror(err));
+                closeWithError(c4error_make(NetworkDomain, kC4NetErrUnknownHost, nullslice));
+                return;
+            }
+            _addresses = addresses;
+            _nextAddress = addresses;
+            connectNext(0);
+        }
+
+
+        // Connects to the next resolved address; `err` is the errno of the last attempt.
+        void connectNext(int err) {
+            closeFD();
+            while (_nextAddress) {
+                addrinfo* addr = _nextAddress;
+                _nextAddress = addr->ai_next;
+                _fd = ::socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+                if (_fd < 0) {
+                    err = errno;
+                    continue;
+                }
+                ++_connectAttempts;
+                ::fcntl(_fd, F_SETFL, ::fcntl(_fd, F_GETFL) | O_NONBLOCK);
+                int on = 1;
+                ::setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+                if (int optErr = _socketOptions.apply(_fd))
+                    c4log(kC4WebSocketLog, kC4LogWarning,
+                          "POSIXWebSocket %p: Failed to set socket options: errno %d", this, optErr);
+    #ifdef SO_NOSIGPIPE
+                ::setsockopt(_fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+    #endif
+                EventLoop::instance().add(_fd, shared_from_this());
+                if (::connect(_fd, addr->ai_addr, addr->ai_addrlen) == 0) {
+                    connected();
+                    return;
+                } else if (errno == EINPROGRESS) {
+                    _state = kConnecting;
+                    return;
+                }
+                err = errno;
+                closeFD();
+            }
+            closeWithError(c4error_make(POSIXDomain, err ? err : ECONNREFUSED, nullslice));
+        }
+
+
+        void connected() {
+            ::freeaddrinfo(_addresses);
+            _addresses = _nextAddress = nullptr;
+            if (_counters)
+                _counters->connected(_connectAttempts, ReplicatorCounters::now() - _connectStart);
+            if (_tls) {
+                if (_tlsProvider)
+                    _tlsSession = _tlsProvider->newClientSession(_fd, _host, _options);
+                if (!_tlsSession) {
+                    closeWithError(c4error_make(NetworkDomain, kC4NetErrTLSHandshakeFailed,
+                                                "No TLS provider for POSIXWebSocket"_sl));
+                    return;
+                }
+                _state = kTLSHandshake;
+                handshakeTLS();
+            } else {
+                sendHTTPRequest();
+            }
+        }
+
+
+        void handshakeTLS() {
+            switch (_tlsSession->handshake()) {
+                case TLSSession::kDone:
+                    sendHTTPRequest();
+                    break;
+                case TLSSession::kWantRead:
+                    _tlsWantsWrite = false;
+                    break;
+                case TLSSession::kWantWrite:
+                    _tlsWantsWrite = true;
+                    break;
+                case TLSSession::kFailed: {
+                    std::string message = _tlsSession->errorMessage();
+                    closeWithError(c4error_make(NetworkDomain, kC4NetErrTLSHandshakeFailed,
+                                                slice(message)));
+                    break;
+                }
+            }
+        }
+
+
+        void sendHTTPRequest() {
+            uint8_t nonce[16];
+            std::random_device random;
+            for (auto &b : nonce)
+                b = (uint8_t)random();
+            std::string nonceKey = base64Encode(nonce, sizeof(nonce));
+            _expectedAccept = webSocketAcceptKey(nonceKey);
+
+            HTTPHeaders headers;
+            std::string cookies;
+            for (Dict::iterator header(_options[kC4ReplicatorOptionExtraHeaders].asDict());
+                    header; ++header) {
+                std::string name = header.keyString().asString();
+                std::string value = header.value().asString().asString();
+                if (name == "Cookie")
+                    cookies = value;
+                else
+                    headers.emplace_back(name, value);
+            }
+            slice sessionCookie = _options[kC4ReplicatorOptionCookies].asString();
+            if (sessionCookie) {
+                if (!cookies.empty())
+                    cookies += "; ";
+                cookies += sessionCookie.asString();
+            }
+            if (!cookies.empty())
+                headers.emplace_back("Cookie", cookies);
+
+            Dict auth = _options[kC4ReplicatorOptionAuthentication].asDict();
+            slice authType = auth[kC4ReplicatorAuthType].asString();
+            if (auth && (!authType || authType == slice(kC4AuthTypeBasic))) {
+                std::string credentials = auth[kC4ReplicatorAuthUserName].asString().asString()
+                                        + ":" + auth[kC4ReplicatorAuthPassword].asString().asString();
+                headers.emplace_back("Authorization",
+                                     "Basic " + base64Encode(credentials.data(), credentials.size()));
+            } else if (auth) {
+                c4log(kC4WebSocketLog, kC4LogWarning,
+                      "POSIXWebSocket %p: Unsupported auth type '%.*s'",
+                      this, (int)authType.size, (const char*)authType.buf);
+            }
+
+            slice protocols = _options[kC4SocketOptionWSProtocols].asString();
+            if (protocols)
+                headers.emplace_back("Sec-WebSocket-Protocol", protocols.asString());
+
+            _httpOut = webSocketUpgradeRequest(_host, _port, _tls, _path, nonceKey, headers);
+            _state = kHTTPHandshake;
+            _requestSentAt = ReplicatorCounters::now();
+            writeHTTPRequest();
+        }
+
+
+        void writeHTTPRequest() {
+            ssize_t n = send(_httpOut.data(), _httpOut.size());
+            if (n > 0)
+                _httpOut.erase(0, n);
+            else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+                closeWithErrno(errno);
+        }
+
+
+        void receivedHTTPResponse(const uint8_t* bytes, size_t size) {
+            size_t used;
+            switch (_response.parse(bytes, size, used)) {
+                case HTTPResponseParser::kIncomplete:
+                    return;
+                case HTTPResponseParser::kInvalid:
+                    closeWithCode(kWebSocketCloseProtocolError, "Unparseable HTTP response");
+                    return;
+                case HTTPResponseParser::kComplete:
+                    break;
+            }
+            _window.setRTT(ReplicatorCounters::now() - _requestSentAt);
+
+            // Post the response headers to LiteCore; repeated headers become arrays:
+            Encoder enc;
+            enc.beginDict();
+            auto &headers = _response.headers();
+            for (size_t i = 0; i < headers.size(); ++i) {
+                auto &name = headers[i].first;
+                bool seen = false;
+                for (size_t j = 0; j < i && !seen; ++j)
+                    seen = (headers[j].first == name);
+                if (seen)
+                    continue;
+                enc.writeKey(slice(name));
+                if (name == "Set-Cookie") {
+                    enc.beginArray();
+                    for (size_t j = i; j < headers.size(); ++j) {
+                        if (headers[j].first == name)
+                            enc.writeString(slice(headers[j].second));
+                    }
+                    enc.endArray();
+                } else {
+                    enc.writeString(slice(headers[i].second));
+                }
+            }
+            enc.endDict();
+            alloc_slice headersFleece = enc.finish();
+            int status = _response.status();
+            c4socket_gotHTTPResponse(_c4socket, status, {headersFleece.buf, headersFleece.size});
+
+            if (status != 101) {
+                C4WebSocketCloseCode code = kWebSocketClosePolicyError;
+                if (status >= 300 && status < 1000)
+                    code = (C4WebSocketCloseCode)status;
+                closeWithCode(code, _response.statusMessage().c_str());
+            } else if (!_response.headerIs("Connection", "Upgrade")) {
+                closeWithCode(kWebSocketCloseProtocolError, "Invalid 'Connection' header");
+            } else if (!_response.headerIs("Upgrade", "websocket")) {
+                closeWithCode(kWebSocketCloseProtocolError, "Invalid 'Upgrade' header");
+            } else if (!_response.headerIs("Sec-WebSocket-Accept", _expectedAccept, true)) {
+                closeWithCode(kWebSocketCloseProtocolError, "Invalid 'Sec-WebSocket-Accept' header");
+            } else {
+                c4log(kC4WebSocketLog, kC4LogInfo, "POSIXWebSocket %p: CONNECTED!", this);
+                _state = kOpen;
+                c4socket_opened(_c4socket);
+                if (used < size)
+                    received(bytes + used, size - used);     // The first WebSocket frames
+            }
+        }
+
+
+        // Handles poll() events on the socket:
+        void handleEvents(short revents) {
+            switch (_state) {
+                case kConnecting: {
+                    int err = 0;
+                    socklen_t len = sizeof(err);
+                    ::getsockopt(_fd, SOL_SOCKET, SO_ERROR, &err, &len);
+                    if (err)
+                        connectNext(err);
+                    else
+                        connected();
+                    break;
+                }
+                case kTLSHandshake:
+                    handshakeTLS();
+                    break;
+                case kHTTPHandshake:
+                    if (!_httpOut.empty())
+                        writeHTTPRequest();
+                    else if (revents & (POLLIN | POLLHUP | POLLERR))
+                        readAvailable();
+                    break;
+                case kOpen:
+                    if (revents & POLLOUT)
+                        writeFrames();
+                    if (_state == kOpen && (revents & (POLLIN | POLLHUP | POLLERR)))
+                        readAvailable();
+                    break;
+                default:
+                    break;
+            }
+        }
+
+
+        // Reads until the socket would block, so that no data is left behind in a TLS session,
+        // which poll() wouldn't report.
+        void readAvailable() {
+            while (_state == kHTTPHandshake || (_state == kOpen && !_window.throttled())) {
+                size_t readSize = _window.readSize();
+                if (_readBuffer.size() != readSize)
+                    _readBuffer.resize(readSize);
+                ssize_t n = recv(_readBuffer.data(), _readBuffer.size());
+                if (n > 0) {
+                    if (_state == kHTTPHandshake)
+                        receivedHTTPResponse(_readBuffer.data(), n);
+                    else
+                        received(_readBuffer.data(), n);
+                    continue;
+                } else if (n == 0) {
+                    if (_state == kOpen)
+                        closeWithError({});                 // The peer closed the connection
+                    else
+                        closeWithCode(kWebSocketCloseProtocolError,
+                                      "Connection closed during handshake");
+                } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    closeWithErrno(errno);
+                }
+                break;
+            }
+        }
+
+
+        void received(const uint8_t* bytes, size_t size) {
+            bool wasThrottled = _window.throttled();
+            _window.received(size);
+            if (_counters)
+                ReplicatorCounters::add(_counters->bytesReceived, size);
+            if (!wasThrottled && _window.throttled())
+                startThrottle();
+            c4socket_received(_c4socket, {bytes, size});
+        }
+
+
+        // Called on a LiteCore thread:
+        void completedReceive(size_t byteCount) {
+            auto self = shared_from_this();
+            EventLoop::instance().perform([self, byteCount] {
+                bool wasThrottled = self->_window.throttled();
+                self->_window.consumed(byteCount, ReplicatorCounters::now());
+                if (wasThrottled && !self->_window.throttled()) {
+                    self->endThrottle();
+                    self->readAvailable();
+                } else if (!wasThrottled && self->_window.throttled())
+                    self->startThrottle();
+            });
+        }
+
+
+        // Called on a LiteCore thread. The frame is written when poll() reports the socket is
+        // writeable, together with the other frames queued by then.
+        void write(C4SliceResult data) {
+            auto self = shared_from_this();
+            EventLoop::instance().perform([self, data] {
+                if (self->_state == kOpen)
+                    self->_frames.push_back({data, 0});
+                else
+                    c4slice_free(data);
+            });
+        }
+
+
+        // Writes the queued frames with one sendmsg(), or one at a time through TLS, and tells
+        // LiteCore about all the frames completed at once.
+        void writeFrames() {
+            size_t completed = 0;
+            while (!_frames.empty()) {
+                ssize_t n;
+                if (_tlsSession) {
+                    auto &frame = _frames.front();
+                    n = _tlsSession->write((const uint8_t*)frame.data.buf + frame.written,
+                                           frame.data.size - frame.written);
+                } else {
+                    iovec iov[kMaxIOVecs];
+                    int count = 0;
+                    for (auto i = _frames.begin(); i != _frames.end() && count < kMaxIOVecs; ++i) {
+                        iov[count].iov_base = (uint8_t*)i->data.buf + i->written;
+                        iov[count].iov_len = i->data.size - i->written;
+                        ++count;
+                    }
+                    msghdr msg = {};
+                    msg.msg_iov = iov;
+                    msg.msg_iovlen = count;
+                    n = ::sendmsg(_fd, &msg, kSendFlags);
+                }
+                if (n < 0) {
+                    if (errno != EAGAIN && errno != EWOULDBLOCK)
+                        closeWithErrno(errno);
+                    break;
+                }
+                size_t remaining = n;
+                while (remaining > 0) {
+                    auto &frame = _frames.front();
+                    size_t used = std::min(remaining, frame.data.size - frame.written);
+                    frame.written += used;
+                    remaining -= used;
+                    if (frame.written == frame.data.size) {
+                        completed += frame.data.size;
+                        c4slice_free(frame.data);
+                        _frames.pop_front();
+                    }
+                }
+            }
+            if (completed > 0 && _c4socket) {
+                if (_counters)
+                    ReplicatorCounters::add(_counters->bytesSent, completed);
+                c4socket_completedWrite(_c4socket, completed);
+            }
+            if (_frames.empty() && _closeRequested)
+                closeWithError({});
+        }
+
+
+        // Called on a LiteCore thread; closes once the queued frames have been written:
+        void requestClose() {
+            auto self = shared_from_this();
+            EventLoop::instance().perform([self] {
+                self->_closeRequested = true;
+                if (self->_frames.empty() || self->_state != kOpen)
+                    self->closeWithError({});
+            });
+        }
+
+
+        // Called on a LiteCore thread:
+        void dispose() {
+            auto self = shared_from_this();
+            EventLoop::instance().perform([self] {
+                self->_self.reset();
+            });
+        }
+
+
+        void closeWithErrno(int err) {
+            closeWithError(c4error_make(POSIXDomain, err, nullslice));
+        }
+
+        void closeWithCode(C4WebSocketCloseCode code, const char* reason) {
+            c4log(kC4WebSocketLog, kC4LogInfo, "POSIXWebSocket %p: CLOSING WITH STATUS %d \"%s\"",
+                  this, (int)code, reason);
+            closeWithError(c4error_make(WebSocketDomain, code, slice(reason)));
+        }
+
+        void closeWithError(C4Error error) {
+            if (_state == kClosed)
+                return;
+            if (error.code)
+                c4log(kC4WebSocketLog, kC4LogInfo, "POSIXWebSocket %p: CLOSED WITH ERROR %d/%d",
+                      this, (int)error.domain, (int)error.code);
+            else
+                c4log(kC4WebSocketLog, kC4LogInfo, "POSIXWebSocket %p: CLOSED", this);
+            _state = kClosed;
+            endThrottle();
+            closeFD();
+            if (_addresses) {
+                ::freeaddrinfo(_addresses);
+                _addresses = _nextAddress = nullptr;
+            }
+            for (auto &frame : _frames)
+                c4slice_free(frame.data);
+            _frames.clear();
+            if (_c4socket) {
+                C4Socket* socket = _c4socket;
+                _c4socket = nullptr;
+                c4socket_closed(socket, error);
+                c4socket_release(socket);
+            }
+        }
+
+    private:
+        enum State {
+            kResolving,
+            kConnecting,
+            kTLSHandshake,
+            kHTTPHandshake,
+            kOpen,
+            kClosed,
+        };
+
+        struct Frame {
+            C4SliceResult data;
+            size_t written;
+        };
+
+        ssize_t send(const void* src, size_t size) {
+            if (_tlsSession)
+                return _tlsSession->write(src, size);
+            return ::send(_fd, src, size, kSendFlags);
+        }
+
+        ssize_t recv(void* dst, size_t size) {
+            if (_tlsSession)
+                return _tlsSession->read(dst, size);
+            return ::recv(_fd, dst, size, 0);
+        }
+
+        void closeFD() {
+            if (_fd >= 0) {
+                _tlsSession.reset();
+                EventLoop::instance().remove(_fd);  // May release the last reference but _self
+                ::close(_fd);
+                _fd = -1;
+            }
+        }
+
+        void startThrottle() {
+            if (_counters) {
+                ReplicatorCounters::add(_counters->throttles, 1);
+                _throttledSince = ReplicatorCounters::now();
+            }
+        }
+
+        void endThrottle() {
+            if (_throttledSince) {
+                ReplicatorCounters::add(_counters->throttledTime,
+                                        ReplicatorCounters::now() - _throttledSince);
+                _throttledSince = 0;
+            }
+        }
+
+        C4Socket* _c4socket;
+        AllocedDict _options;
+        std::string const _host;
+        uint16_t const _port;
+        std::string const _path;
+        bool const _tls;
+        SocketOptions const _socketOptions;
+        std::shared_ptr<Connection> _self;
+        std::shared_ptr<ReplicatorCounters> _counters;
+
+        State _state {kResolving};
+        std::chrono::steady_clock::time_point _deadline;
+        addrinfo* _addresses {nullptr};
+        addrinfo* _nextAddress {nullptr};
+        int _fd {-1};
+        uint64_t _connectStart {0};         // When resolving the host started
+        unsigned _connectAttempts {0};
+
+        std::shared_ptr<TLSProvider> _tlsProvider;
+        std::unique_ptr<TLSSession> _tlsSession;
+        bool _tlsWantsWrite {false};
+
+        std::string _httpOut;               // Unwritten part of the HTTP request
+        std::string _expectedAccept;
+        uint64_t _requestSentAt {0};
+        HTTPResponseParser _response;
+
+        std::deque<Frame> _frames;
+        bool _closeRequested {false};
+        ReceiveWindow _window;
+        std::vector<uint8_t> _readBuffer;
+        uint64_t _throttledSince {0};
+    };
+
+
+    void EventLoop::run() {
+        std::vector<pollfd> fds;
+        std::vector<std::shared_ptr<Connection>> polled;
+        while (true) {
+            // Collect the sockets that are waiting for something:
+            fds.clear();
+            polled.clear();
+            fds.push_back({_wakeFDs[0], POLLIN, 0});
+            for (auto &entry : _connections) {
+                if (short events = entry.second->events()) {
+                    fds.push_back({entry.first, events, 0});
+                    polled.push_back(entry.second);
+                }
+            }
+
+            int n = ::poll(fds.data(), (nfds_t)fds.size(), 1000);
+            if (n < 0 && errno != EINTR) {
+                c4log(kC4WebSocketLog, kC4LogError, "POSIXWebSocket: poll() failed, errno %d", errno);
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+
+            // Run the tasks posted by other threads:
+            if (fds[0].revents) {
+                char buf[64];
+                while (::read(_wakeFDs[0], buf, sizeof(buf)) > 0) { }
+            }
+            std::vector<std::function<void()>> tasks;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                tasks.swap(_tasks);
+            }
+            for (auto &task : tasks)
+                task();
+
+            // Handle the socket events; a connection may have been closed by a task:
+            for (size_t i = 1; i < fds.size(); ++i) {
+                auto &connection = polled[i - 1];
+                if (fds[i].revents && connection->fd() == fds[i].fd)
+                    connection->handleEvents(fds[i].revents);
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            for (auto &connection : polled) {
+                if (connection->timedOut(now))
+                    connection->closeWithError(c4error_make(NetworkDomain, kC4NetErrTimeout,
+                                                            nullslice));
+            }
+            for (auto &connection : _resolving) {
+                if (connection->timedOut(now))
+                    connection->closeWithError(c4error_make(NetworkDomain, kC4NetErrTimeout,
+                                                            nullslice));
+            }
+            _resolving.erase(std::remove_if(_resolving.begin(), _resolving.end(),
+                                            [](auto &connection) {return !connection->resolving();}),
+                             _resolving.end());
+        }
+    }
+
+
+#pragma mark - SOCKET FACTORY:
+
+    static void doOpen(C4Socket* s, const C4Address* addr, C4Slice options, void *context) {
+        auto connection = std::make_shared<Connection>(s, *addr, options, context);
+        connection->retainSelf();
+        c4Socket_setNativeHandle(s, connection.get());
+        connection->start();
+    }
+
+    static void doWrite(C4Socket* s, C4SliceResult allocatedData) {
+        Connection::get(s)->write(allocatedData);
+    }
+
+    static void doCompletedReceive(C4Socket* s, size_t byteCount) {
+        Connection::get(s)->completedReceive(byteCount);
+    }
+
+    static void doClose(C4Socket* s) {
+        Connection::get(s)->requestClose();
+    }
+
+    static void doDispose(C4Socket* s) {
+        Connection::get(s)->dispose();
+    }
+
+
+    C4SocketFactory POSIXWebSocket::socketFactory() {
+        return {
+            .framing = kC4WebSocketClientFraming,
+            .open = &doOpen,
+            .write = &doWrite,
+            .completedReceive = &doCompletedReceive,
+            .close = &doClose,
+            .dispose = &doDispose,
+        };
+    }
+
+
+    void POSIXWebSocket::setTLSProvider(std::shared_ptr<TLSProvider> provider) {
+        std::lock_guard<std::mutex> lock(sTLSProviderMutex);
+        sTLSProvider = std::move(provider);
+    }
+
+}
@@ -0,0 +1,87 @@
+//
+//  CBLPOSIXWebSocket.hh
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#pragma once
+#include "c4Socket.h"
+#include "fleece/Fleece.hh"
+#include <memory>
+#include <string>
+#include <sys/types.h>
+
+namespace cbl {
+
+    /** A TLS client session on a connected, non-blocking socket. */
+    class TLSSession {
+    public:
+        enum Status {
+            kDone,
+            kWantRead,                      // Call again when the socket is readable
+            kWantWrite,                     // Call again when the socket is writeable
+            kFailed,
+        };
+
+        virtual ~TLSSession() = default;
+
+        /** Advances the handshake, including the verification of the server's certificate. */
+        virtual Status handshake() =0;
+
+        /** Like recv() and send() on a non-blocking socket: return the number of bytes
+            transferred, 0 at the end of the stream, or -1 with errno set (EAGAIN if the
+            call would block). */
+        virtual ssize_t read(void* dst, size_t size) =0;
+        virtual ssize_t write(const void* src, size_t size) =0;
+
+        /** Describes the reason the handshake or an I/O call failed. */
+        virtual std::string errorMessage() const =0;
+    };
+
+
+    /** Creates TLS sessions for POSIXWebSocket, e.g. with OpenSSL. */
+    class TLSProvider {
+    public:
+        virtual ~TLSProvider() = default;
+
+        /** Creates a client session for the connected socket `fd`. The replicator `options`
+            contain the TLS settings, like the pinned server certificate. Returns null if
+            the options aren't supported. */
+        virtual std::unique_ptr<TLSSession> newClientSession(int fd,
+                                                             const std::string &hostname,
+                                                             fleece::Dict options) =0;
+    };
+
+
+    /** A WebSocket transport for LiteCore built only on POSIX APIs: non-blocking BSD sockets
+        served by a single poll() event loop thread, and its own HTTP upgrade handshake.
+        Unlike CBLWebSocket it doesn't depend on NSStream, CFNetwork or the Security framework,
+        so it builds on Linux too, and hundreds of connections share one thread.
+        TLS is provided by the TLSProvider given to `setTLSProvider`; without one, only
+        `ws:` and `blip:` URLs can be opened. HTTP proxies, redirects and client certificates
+        aren't supported. */
+    class POSIXWebSocket {
+    public:
+        /** The socket factory. Its `context` may point to a
+            `std::shared_ptr<cbl::ReplicatorCounters>` that outlives the replicator's sockets,
+            which the sockets add their transferred bytes and throttled time to. */
+        static C4SocketFactory socketFactory();
+
+        /** Sets the TLS implementation used by sockets opened afterwards. */
+        static void setTLSProvider(std::shared_ptr<TLSProvider> provider);
+    };
+
+}
@@ -0,0 +1,115 @@
+//
+//  CBLReceiveWindow.hh
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace cbl {
+
+    /** Decides how much received data a WebSocket may hold before LiteCore has processed it,
+        and how much to read from the socket at a time.
+        The window follows the bandwidth-delay product of the connection: the rate at which
+        LiteCore consumes the data, measured every sample interval, times the round-trip time.
+        When the window is full, the socket isn't read, which sends backpressure to the peer.
+        Not thread-safe; used on the WebSocket's queue. */
+    class ReceiveWindow {
+        template <typename T>
+        static T clamp(T n, T min, T max)  {return n < min ? min : (n > max ? max : n);}
+
+    public:
+        static constexpr size_t kDefaultMinSize = 16 * 1024;
+        static constexpr size_t kDefaultMaxSize = 4 * 1024 * 1024;
+        static constexpr size_t kInitialSize    = 100 * 1024;
+        static constexpr size_t kMinReadSize    = 4 * 1024;
+        static constexpr size_t kMaxReadSize    = 256 * 1024;
+        static constexpr uint64_t kMinSampleInterval = 50000000;     // Nanoseconds
+        static constexpr uint64_t kDefaultRTT        = 100000000;    // Nanoseconds
+
+        /** A bound of 0 uses the default. If `maxSize` is less than `minSize`, the window
+            has the fixed size `minSize`. */
+        ReceiveWindow(size_t minSize = 0, size_t maxSize = 0)
+        :_minSize(minSize ? minSize : kDefaultMinSize)
+        ,_maxSize(clamp<size_t>(maxSize ? maxSize : kDefaultMaxSize, _minSize, SIZE_MAX))
+        ,_size(clamp(kInitialSize, _minSize, _maxSize))
+        { }
+
+        size_t size() const                 {return _size;}
+        size_t minSize() const              {return _minSize;}
+        size_t maxSize() const              {return _maxSize;}
+        size_t pending() const              {return _pending;}
+        uint64_t rtt() const                {return _rtt;}
+        double rate() const                 {return _rate;}
+
+        /** True if the window is full and the socket shouldn't be read. */
+        bool throttled() const              {return _pending >= _size;}
+
+        /** The number of bytes to read from the socket at a time: a quarter of the window,
+            in whole pages. */
+        size_t readSize() const {
+            size_t size = (_size / 4) & ~(kMinReadSize - 1);
+            return clamp(size, kMinReadSize, kMaxReadSize);
+        }
+
+        /** Sets the smoothed round-trip time of the connection, in nanoseconds. */
+        void setRTT(uint64_t rtt) {
+            if (rtt > 0)
+                _rtt = rtt;
+        }
+
+        /** Call when `n` bytes have been read from the socket. */
+        void received(size_t n)             {_pending += n;}
+
+        /** Call when LiteCore has processed `n` bytes, at time `now` (nanoseconds). Returns true
+            if a sample interval ended, and the window may have been resized. */
+        bool consumed(size_t n, uint64_t now) {
+            _pending = (n < _pending) ? _pending - n : 0;
+            if (_sampleStart == 0) {
+                _sampleStart = now;
+                return false;
+            }
+            _consumed += n;
+            uint64_t elapsed = now - _sampleStart;
+            if (elapsed < clamp<uint64_t>(_rtt, kMinSampleInterval, UINT64_MAX))
+                return false;
+
+            double rate = _consumed * 1.0e9 / elapsed;              // bytes per second
+            _rate = (_rate > 0) ? (3 * _rate + rate) / 4 : rate;
+            _consumed = 0;
+            _sampleStart = now;
+
+            // Hold twice the bandwidth-delay product, so that the peer can keep sending while
+            // the window it sees is opened again. Change by at most a factor of 2 per sample:
+            double target = 2.0 * _rate * (_rtt / 1.0e9);
+            target = clamp(target, _size / 2.0, _size * 2.0);
+            _size = clamp((size_t)target, _minSize, _maxSize);
+            return true;
+        }
+
+    private:
+        size_t _minSize, _maxSize;
+        size_t _size;
+        size_t _pending {0};                // Bytes received but not yet consumed by LiteCore
+        size_t _consumed {0};               // Bytes consumed since _sampleStart
+        uint64_t _sampleStart {0};
+        uint64_t _rtt {kDefaultRTT};
+        double _rate {0};                   // Smoothed consumption rate, bytes per second
+    };
+
+}
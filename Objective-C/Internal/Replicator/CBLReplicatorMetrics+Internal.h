@@ -0,0 +1,124 @@
+//
+//  CBLReplicatorMetrics+Internal.h
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+
+// The counters are plain C++, so that the POSIX WebSocket can use them:
+namespace cbl {
+
+    /** A copy of the replicator's counters at one point in time. */
+    struct ReplicatorSample {
+        uint64_t time {0};                      // Nanoseconds since the replicator was first started
+        uint64_t documentsPushed {0}, documentsPulled {0};
+        uint64_t bytesSent {0}, bytesReceived {0};
+        uint64_t conflicts {0}, conflictsResolved {0};
+        uint64_t conflictLatency {0}, maxConflictLatency {0};  // Nanoseconds
+        uint64_t throttledTime {0};             // Nanoseconds
+        uint64_t throttles {0};
+        uint64_t reconnects {0};
+        uint64_t connects {0}, connectAttempts {0};
+        uint64_t connectTime {0};               // Nanoseconds, resolving and connecting
+        uint64_t shapedTime {0};                // Nanoseconds
+    };
+
+    /** The replicator's counters. They are updated with relaxed atomics from the replicator's
+        and the WebSocket's queues, and shared with the WebSocket which may outlive the replicator. */
+    struct ReplicatorCounters {
+        std::atomic<uint64_t> documentsPushed {0}, documentsPulled {0};
+        std::atomic<uint64_t> bytesSent {0}, bytesReceived {0};
+        std::atomic<uint64_t> conflicts {0}, conflictsResolved {0};
+        std::atomic<uint64_t> conflictLatency {0}, maxConflictLatency {0};
+        std::atomic<uint64_t> throttledTime {0}, throttles {0};
+        std::atomic<uint64_t> reconnects {0};
+        std::atomic<uint64_t> connects {0}, connectAttempts {0}, connectTime {0};
+        std::atomic<uint64_t> shapedTime {0};
+        std::atomic<uint64_t> startTime {0};    // Set when the replicator is first started
+
+        static uint64_t now() {
+            using namespace std::chrono;
+            return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+        }
+
+        static void add(std::atomic<uint64_t> &counter, uint64_t n) {
+            counter.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        void started() {
+            uint64_t unset = 0;
+            startTime.compare_exchange_strong(unset, now(), std::memory_order_relaxed);
+        }
+
+        /** Records a TCP connection made with `attempts` connection attempts, `time` nanoseconds
+            after starting to resolve the host. */
+        void connected(uint64_t attempts, uint64_t time) {
+            add(connects, 1);
+            add(connectAttempts, attempts);
+            add(connectTime, time);
+        }
+
+        /** Records `count` conflicts resolved `latency` nanoseconds after they were pulled. */
+        void resolvedConflicts(uint64_t count, uint64_t latency) {
+            add(conflictsResolved, count);
+            add(conflictLatency, count * latency);
+            uint64_t max = maxConflictLatency.load(std::memory_order_relaxed);
+            while (latency > max && !maxConflictLatency.compare_exchange_weak(max, latency,
+                                                                              std::memory_order_relaxed)) { }
+        }
+
+        ReplicatorSample sample() const {
+            auto get = [](const std::atomic<uint64_t> &counter) {
+                return counter.load(std::memory_order_relaxed);
+            };
+            uint64_t start = get(startTime);
+            return {
+                start ? now() - start : 0,
+                get(documentsPushed), get(documentsPulled),
+                get(bytesSent), get(bytesReceived),
+                get(conflicts), get(conflictsResolved),
+                get(conflictLatency), get(maxConflictLatency),
+                get(throttledTime), get(throttles),
+                get(reconnects),
+                get(connects), get(connectAttempts),
+                get(connectTime),
+                get(shapedTime),
+            };
+        }
+    };
+
+}
+
+#ifdef __OBJC__
+#import "CBLReplicatorMetrics.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface CBLReplicatorMetrics ()
+
+/** Initializes the metrics from the current sample; the rates are measured since `previous`. */
+- (instancetype) initWithSample: (const cbl::ReplicatorSample&)sample
+                       previous: (const cbl::ReplicatorSample&)previous;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+#endif // __OBJC__
@@ -0,0 +1,49 @@
+//
+//  CBLReplicatorOptions.h
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#pragma once
+
+// Replicator options added by Couchbase Lite, besides LiteCore's in c4ReplicatorTypes.h.
+// They're read by the socket implementations, so this header is plain C.
+
+// Bounds of the WebSocket receive window, in bytes (int):
+#define kCBLReplicatorOptionMinReceiveWindow    "minReceiveWindow"
+#define kCBLReplicatorOptionMaxReceiveWindow    "maxReceiveWindow"
+
+// Use the POSIX socket transport instead of CBLWebSocket (bool):
+#define kCBLReplicatorOptionPOSIXWebSocket      "posixWebSocket"
+
+// Compress the WebSocket messages with permessage-deflate, if the server supports it (bool),
+// with a compression level (int, 1-9) and window size in bits (int, 9-15):
+#define kCBLReplicatorOptionCompression             "compression"
+#define kCBLReplicatorOptionCompressionLevel        "compressionLevel"
+#define kCBLReplicatorOptionCompressionWindowBits   "compressionWindowBits"
+
+// TCP options of the socket (int); 0 leaves the OS default. Keepalive is enabled by a non-zero
+// idle time:
+#define kCBLReplicatorOptionTCPNoDelay              "tcpNoDelay"            // bool
+#define kCBLReplicatorOptionKeepAliveIdle           "keepAliveIdle"         // seconds
+#define kCBLReplicatorOptionKeepAliveInterval       "keepAliveInterval"     // seconds
+#define kCBLReplicatorOptionKeepAliveCount          "keepAliveCount"
+#define kCBLReplicatorOptionSendBufferSize          "sendBufferSize"        // bytes
+#define kCBLReplicatorOptionReceiveBufferSize       "receiveBufferSize"     // bytes
+
+// Resolve the host and race the connections to its addresses (RFC 8305), instead of connecting
+// with the system's host streams (bool):
+#define kCBLReplicatorOptionRaceConnections         "raceConnections"
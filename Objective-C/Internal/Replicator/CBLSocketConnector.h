@@ -0,0 +1,62 @@
+//
+//  CBLSocketConnector.h
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+@class AddressInfo;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** Called with the connected, non-blocking socket, which the caller then owns, and the address
+    it's connected to; or with a negative socket and the error of the last attempt. */
+typedef void (^CBLSocketConnectorCompletion)(int sockfd, AddressInfo* __nullable address,
+                                             NSError* __nullable error);
+
+/** Opens a TCP connection to one of a host's addresses, racing the connection attempts as in
+    RFC 8305 ("Happy Eyeballs"): the addresses are tried in order, each attempt starting when
+    the previous one fails or after a short delay, while the earlier attempts keep going. The
+    first socket to connect is kept and the other attempts are cancelled.
+    All the methods must be called on the queue the connector was created with. */
+@interface CBLSocketConnector : NSObject
+
+- (instancetype) initWithAddresses: (NSArray<AddressInfo*>*)addresses
+                             queue: (dispatch_queue_t)queue;
+
+/** How long to wait for any attempt to connect before failing with ETIMEDOUT. Defaults to 15 sec. */
+@property (nonatomic) NSTimeInterval timeout;
+
+/** How long an attempt has before the next one starts alongside it. Defaults to 250 ms. */
+@property (nonatomic) NSTimeInterval attemptDelay;
+
+/** Called with each new socket before it starts connecting, to set its options. */
+@property (nonatomic, copy, nullable) void (^socketConfigurator)(int sockfd);
+
+/** Starts connecting. The completion is called once, on the queue. */
+- (void) connect: (CBLSocketConnectorCompletion)completion;
+
+/** Stops connecting and closes the sockets; the completion won't be called. */
+- (void) cancel;
+
+/** The number of connection attempts started so far. */
+@property (nonatomic, readonly) NSUInteger attempts;
+
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,277 @@
+//
+//  CBLSocketConnector.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CBLSocketConnector.h"
+#import "CBLDNSService.h"
+#import <fcntl.h>
+#import <netinet/in.h>
+#import <sys/socket.h>
+#import <unistd.h>
+#import <algorithm>
+#import <vector>
+
+#define kConnectionAttemptDelay 0.25    // Before starting the next attempt (RFC 8305 section 5)
+#define kTimeoutInterval 15.0
+
+namespace {
+    // A connection attempt in progress:
+    struct Attempt {
+        int sockfd;
+        AddressInfo* address;
+        dispatch_source_t source;       // Fires when the socket is writable, i.e. connected or failed
+    };
+}
+
+// Cancels the attempt's source, closing the socket when the source no longer uses it.
+static void closeAttempt(const Attempt &attempt) {
+    int sockfd = attempt.sockfd;
+    dispatch_source_set_cancel_handler(attempt.source, ^{
+        close(sockfd);
+    });
+    dispatch_source_cancel(attempt.source);
+}
+
+static inline NSError* posixError(int errNo, NSString* msg) {
+    return [NSError errorWithDomain: NSPOSIXErrorDomain
+                               code: errNo
+                           userInfo: @{NSLocalizedDescriptionKey : msg}];
+}
+
+@implementation CBLSocketConnector {
+    NSArray<AddressInfo*>* _addresses;
+    dispatch_queue_t _queue;
+    CBLSocketConnectorCompletion _completion;
+
+    NSUInteger _next;                   // Index of the next address to try
+    std::vector<Attempt> _pending;
+    NSError* _lastError;
+
+    dispatch_block_t _nextAttemptBlock;
+    dispatch_block_t _timeoutBlock;
+}
+
+@synthesize attempts=_attempts, timeout=_timeout, attemptDelay=_attemptDelay;
+
+- (instancetype) initWithAddresses: (NSArray<AddressInfo*>*)addresses
+                             queue: (dispatch_queue_t)queue
+{
+    self = [super init];
+    if (self) {
+        _addresses = addresses;
+        _queue = queue;
+        _timeout = kTimeoutInterval;
+        _attemptDelay = kConnectionAttemptDelay;
+    }
+    return self;
+}
+
+- (void) dealloc {
+    [self cancel];
+}
+
+- (void) connect: (CBLSocketConnectorCompletion)completion {
+    Assert(!_completion && _attempts == 0, @"Already connecting");
+    _completion = completion;
+
+    _timeoutBlock = dispatch_block_create(DISPATCH_BLOCK_ASSIGN_CURRENT, ^{
+        CBLWarnError(WebSocket, @"%@: Connecting timeout after %lu attempts",
+                     self, (unsigned long)self->_attempts);
+        [self finishWithError: posixError(ETIMEDOUT, @"Connecting timeout")];
+    });
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(_timeout * NSEC_PER_SEC)),
+                   _queue, _timeoutBlock);
+
+    [self startNextAttempt];
+}
+
+- (void) cancel {
+    [self cancelTimers];
+    for (auto &attempt : _pending)
+        closeAttempt(attempt);
+    _pending.clear();
+    _completion = nil;
+}
+
+#pragma mark - Attempts
+
+// Starts connecting to the next address that a socket can be opened for, and schedules the
+// attempt after it.
+- (void) startNextAttempt {
+    if (_nextAttemptBlock) {
+        dispatch_cancel(_nextAttemptBlock);
+        _nextAttemptBlock = nil;
+    }
+
+    while (_next < _addresses.count) {
+        AddressInfo* info = _addresses[_next++];
+        ++_attempts;
+
+        NSError* error;
+        int sockfd = [self openSocketToAddress: info error: &error];
+        if (sockfd < 0) {
+            CBLLogVerbose(WebSocket, @"%@: %@", self, error.localizedDescription);
+            _lastError = error;
+            continue;
+        }
+
+        CBLLogVerbose(WebSocket, @"%@: Connecting to IP address %@ (attempt %lu)",
+                      self, info.addrstr, (unsigned long)_attempts);
+        dispatch_source_t source = dispatch_source_create(DISPATCH_SOURCE_TYPE_WRITE,
+                                                          sockfd, 0, _queue);
+        dispatch_source_set_event_handler(source, ^{
+            [self attemptFinished: sockfd];
+        });
+        dispatch_resume(source);
+        _pending.push_back({sockfd, info, source});
+
+        if (_next < _addresses.count) {
+            _nextAttemptBlock = dispatch_block_create(DISPATCH_BLOCK_ASSIGN_CURRENT, ^{
+                self->_nextAttemptBlock = nil;
+                [self startNextAttempt];
+            });
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW,
+                                         (int64_t)(_attemptDelay * NSEC_PER_SEC)),
+                           _queue, _nextAttemptBlock);
+        }
+        return;
+    }
+
+    if (_pending.empty())
+        [self finishWithError: _lastError];
+}
+
+// Opens a non-blocking socket and starts connecting it. Returns -1 on failure.
+- (int) openSocketToAddress: (AddressInfo*)info error: (NSError**)outError {
+    int sockfd = socket(info.addr->sa_family, SOCK_STREAM, 0);
+    if (sockfd < 0) {
+        int errNo = errno;
+        *outError = posixError(errNo, $sprintf(@"Failed to create socket with errno %d (%@)",
+                                               errNo, info));
+        return -1;
+    }
+
+    // Set network interface:
+    if (info.interface > 0) {
+        UInt32 index = info.interface;
+        int result = -1;
+        if (info.addr->sa_family == AF_INET) {
+            result = setsockopt(sockfd, IPPROTO_IP, IP_BOUND_IF, &index, sizeof(index));
+        } else if (info.addr->sa_family == AF_INET6) {
+            result = setsockopt(sockfd, IPPROTO_IPV6, IPV6_BOUND_IF, &index, sizeof(index));
+        }
+        if (result < 0) {
+            int errNo = errno;
+            *outError = posixError(errNo, $sprintf(@"Failed to set network interface %u with errno %d (%@)",
+                                                   (unsigned int)index, errNo, info));
+            close(sockfd);
+            return -1;
+        }
+    }
+
+    if (_socketConfigurator)
+        _socketConfigurator(sockfd);
+
+    // Enable non-blocking mode on the socket, and start connecting:
+    int flags = fcntl(sockfd, F_GETFL);
+    if (fcntl(sockfd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        int errNo = errno;
+        *outError = posixError(errNo, $sprintf(@"Failed to enable non-blocking mode with errno %d",
+                                               errNo));
+        close(sockfd);
+        return -1;
+    }
+
+    if (connect(sockfd, info.addr, info.length) < 0 && errno != EINPROGRESS) {
+        int errNo = errno;
+        *outError = posixError(errNo, $sprintf(@"Failed to connect to %@ with errno %d",
+                                               info.addrstr, errNo));
+        close(sockfd);
+        return -1;
+    }
+    return sockfd;
+}
+
+// Called when a socket became writable: its connection either succeeded or failed.
+- (void) attemptFinished: (int)sockfd {
+    auto i = std::find_if(_pending.begin(), _pending.end(),
+                          [&](const Attempt &a) {return a.sockfd == sockfd;});
+    if (i == _pending.end())
+        return;
+    Attempt attempt = *i;
+    _pending.erase(i);
+
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (getsockopt(sockfd, SOL_SOCKET, SO_ERROR, &err, &len) < 0)
+        err = errno;
+
+    if (err == 0) {
+        CBLLogInfo(WebSocket, @"%@: Connected to %@ after %lu attempts",
+                   self, attempt.address.addrstr, (unsigned long)_attempts);
+        [self cancelTimers];
+        for (auto &other : _pending)
+            closeAttempt(other);
+        _pending.clear();
+
+        // Hand the socket over once its source is cancelled, after which it's safe to close:
+        CBLSocketConnectorCompletion completion = _completion;
+        _completion = nil;
+        AddressInfo* address = attempt.address;
+        dispatch_source_set_cancel_handler(attempt.source, ^{
+            if (completion)
+                completion(sockfd, address, nil);
+        });
+        dispatch_source_cancel(attempt.source);
+        return;
+    }
+
+    _lastError = posixError(err, $sprintf(@"Failed to connect to %@ with errno %d",
+                                          attempt.address.addrstr, err));
+    CBLLogVerbose(WebSocket, @"%@: %@", self, _lastError.localizedDescription);
+    closeAttempt(attempt);
+
+    // Don't wait for the delay to try the next address:
+    if (_next < _addresses.count)
+        [self startNextAttempt];
+    else if (_pending.empty())
+        [self finishWithError: _lastError];
+}
+
+- (void) finishWithError: (nullable NSError*)error {
+    CBLSocketConnectorCompletion completion = _completion;
+    [self cancel];
+    if (completion) {
+        if (!error)
+            error = posixError(EHOSTUNREACH, @"No address to connect to");
+        completion(-1, nil, error);
+    }
+}
+
+- (void) cancelTimers {
+    if (_nextAttemptBlock) {
+        dispatch_cancel(_nextAttemptBlock);
+        _nextAttemptBlock = nil;
+    }
+    if (_timeoutBlock) {
+        dispatch_cancel(_timeoutBlock);
+        _timeoutBlock = nil;
+    }
+}
+
+@end
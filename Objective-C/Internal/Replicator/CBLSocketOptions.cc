@@ -0,0 +1,81 @@
+//
+//  CBLSocketOptions.cc
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CBLSocketOptions.hh"
+#include "CBLReplicatorOptions.h"
+#include <errno.h>
+#include <limits.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+// Darwin names the keepalive idle time TCP_KEEPALIVE:
+#if !defined(TCP_KEEPIDLE) && defined(TCP_KEEPALIVE)
+#define TCP_KEEPIDLE TCP_KEEPALIVE
+#endif
+
+namespace cbl {
+    using namespace fleece;
+
+    static int intOption(Dict options, const char* key) {
+        uint64_t value = options[key].asUnsigned();
+        return value > INT_MAX ? INT_MAX : (int)value;
+    }
+
+
+    SocketOptions::SocketOptions(Dict options)
+    :noDelay(options[kCBLReplicatorOptionTCPNoDelay].asBool())
+    ,keepAliveIdle(intOption(options, kCBLReplicatorOptionKeepAliveIdle))
+    ,keepAliveInterval(intOption(options, kCBLReplicatorOptionKeepAliveInterval))
+    ,keepAliveCount(intOption(options, kCBLReplicatorOptionKeepAliveCount))
+    ,sendBufferSize(intOption(options, kCBLReplicatorOptionSendBufferSize))
+    ,receiveBufferSize(intOption(options, kCBLReplicatorOptionReceiveBufferSize))
+    { }
+
+
+    bool SocketOptions::empty() const {
+        return !noDelay && keepAliveIdle == 0 && sendBufferSize == 0 && receiveBufferSize == 0;
+    }
+
+
+    int SocketOptions::apply(int sockfd) const {
+        int error = 0;
+        auto set = [&](int level, int name, int value) {
+            if (::setsockopt(sockfd, level, name, &value, sizeof(value)) < 0 && !error)
+                error = errno;
+        };
+
+        if (noDelay)
+            set(IPPROTO_TCP, TCP_NODELAY, 1);
+        if (keepAliveIdle > 0) {
+            set(SOL_SOCKET, SO_KEEPALIVE, 1);
+            set(IPPROTO_TCP, TCP_KEEPIDLE, keepAliveIdle);
+            if (keepAliveInterval > 0)
+                set(IPPROTO_TCP, TCP_KEEPINTVL, keepAliveInterval);
+            if (keepAliveCount > 0)
+                set(IPPROTO_TCP, TCP_KEEPCNT, keepAliveCount);
+        }
+        if (sendBufferSize > 0)
+            set(SOL_SOCKET, SO_SNDBUF, sendBufferSize);
+        if (receiveBufferSize > 0)
+            set(SOL_SOCKET, SO_RCVBUF, receiveBufferSize);
+        return error;
+    }
+
+}
@@ -0,0 +1,48 @@
+//
+//  CBLSocketOptions.hh
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#pragma once
+#include "fleece/Fleece.hh"
+
+namespace cbl {
+
+    /** TCP options of a replicator's socket. A value of 0 leaves the OS default. */
+    struct SocketOptions {
+        bool noDelay {false};               // Disables Nagle's algorithm
+        int keepAliveIdle {0};              // Seconds; enables keepalive if non-zero
+        int keepAliveInterval {0};          // Seconds between keepalive probes
+        int keepAliveCount {0};             // Unanswered probes before the connection drops
+        int sendBufferSize {0};             // Bytes
+        int receiveBufferSize {0};          // Bytes
+
+        SocketOptions() = default;
+
+        /** Reads the options from the replicator options. */
+        explicit SocketOptions(fleece::Dict options);
+
+        /** True if no option is set. */
+        bool empty() const;
+
+        /** Sets the options on a socket. The buffer sizes should be set before connecting, so
+            that the TCP window scale is negotiated for them. Returns 0, or the errno of the
+            first option that couldn't be set; the options after it are still set. */
+        int apply(int sockfd) const;
+    };
+
+}
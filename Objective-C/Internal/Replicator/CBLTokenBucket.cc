@@ -0,0 +1,101 @@
+//
+//  CBLTokenBucket.cc
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+
+#include "CBLTokenBucket.hh"
+#include <algorithm>
+#include <cmath>
+
+namespace cbl {
+
+    static constexpr double kNanosPerSecond = 1.0e9;
+    static constexpr double kMaxBurst = 1 << 30;
+
+
+    TokenBucket::TokenBucket(uint64_t bytesPerSecond)
+    :_rate(bytesPerSecond)
+    { }
+
+
+    uint64_t TokenBucket::rate() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _rate;
+    }
+
+
+    void TokenBucket::setRate(uint64_t bytesPerSecond) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _rate = bytesPerSecond;
+        _tokens = std::min(_tokens, (double)_burst());
+    }
+
+
+    size_t TokenBucket::burst() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _burst();
+    }
+
+
+    size_t TokenBucket::_burst() const {
+        double burst = _rate * (kBurstInterval / kNanosPerSecond);
+        return std::max((size_t)kMinBurst, (size_t)std::min(burst, kMaxBurst));
+    }
+
+
+    void TokenBucket::refill(uint64_t now) {
+        if (!_started) {
+            _tokens = (double)_burst();
+            _lastRefill = now;
+            _started = true;
+        } else if (now > _lastRefill) {
+            _tokens = std::min(_tokens + (double)_rate * (now - _lastRefill) / kNanosPerSecond,
+                               (double)_burst());
+            _lastRefill = now;
+        }
+    }
+
+
+    size_t TokenBucket::available(uint64_t now) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_rate == 0)
+            return SIZE_MAX;
+        refill(now);
+        return _tokens >= 1.0 ? (size_t)_tokens : 0;
+    }
+
+
+    void TokenBucket::consume(size_t bytes) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_rate > 0)
+            _tokens -= (double)bytes;
+    }
+
+
+    uint64_t TokenBucket::delay(size_t bytes, uint64_t now) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_rate == 0)
+            return 0;
+        refill(now);
+        double needed = (double)std::min(std::max(bytes, (size_t)1), _burst());
+        if (_tokens >= needed)
+            return 0;
+        return (uint64_t)std::ceil((needed - _tokens) * kNanosPerSecond / _rate);
+    }
+
+}
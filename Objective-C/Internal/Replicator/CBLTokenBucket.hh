@@ -0,0 +1,76 @@
+//
+//  CBLTokenBucket.hh
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+
+namespace cbl {
+
+    /** A token bucket limiting the rate of transferred bytes: tokens accumulate at the rate, up
+        to the burst size, and each byte transferred takes one. Several connections may share a
+        bucket; one that takes more than is available goes into debt, which delays the others.
+        A rate of 0 is unlimited. Times are in nanoseconds, from ReplicatorCounters::now().
+        Thread-safe. */
+    class TokenBucket {
+    public:
+        static constexpr size_t kMinBurst = 16 * 1024;
+        static constexpr uint64_t kBurstInterval = 50000000;    // Nanoseconds of the rate
+
+        explicit TokenBucket(uint64_t bytesPerSecond = 0);
+
+        /** The rate in bytes per second; it can be changed while transferring. */
+        uint64_t rate() const;
+        void setRate(uint64_t bytesPerSecond);
+
+        /** The most bytes that can be transferred at once. */
+        size_t burst() const;
+
+        /** The number of bytes that can be transferred now; SIZE_MAX if unlimited. */
+        size_t available(uint64_t now);
+
+        /** Takes the tokens of transferred bytes. */
+        void consume(size_t bytes);
+
+        /** The time until `bytes`, limited to the burst size, can be transferred. */
+        uint64_t delay(size_t bytes, uint64_t now);
+
+        /** The total time transfers waited for tokens, as reported by their connections. */
+        uint64_t shapedTime() const         {return _shapedTime.load(std::memory_order_relaxed);}
+        void addShapedTime(uint64_t time)   {_shapedTime.fetch_add(time, std::memory_order_relaxed);}
+
+        TokenBucket(const TokenBucket&) = delete;
+        TokenBucket& operator=(const TokenBucket&) = delete;
+
+    private:
+        size_t _burst() const;
+        void refill(uint64_t now);
+
+        mutable std::mutex _mutex;
+        uint64_t _rate;
+        double _tokens {0};                 // Negative when in debt
+        uint64_t _lastRefill {0};
+        bool _started {false};              // The bucket starts full when first used
+        std::atomic<uint64_t> _shapedTime {0};
+    };
+
+}
@@ -0,0 +1,63 @@
+//
+//  CBLTrustCache.h
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+#import <Security/Security.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** A bounded cache of the server certificates that passed trust validation, so that
+    reconnecting to a server with the same certificate doesn't evaluate its chain again.
+    A decision is keyed by the host and port, the SHA-256 digest of the leaf certificate, and the
+    validation policy (e.g. the pinned certificate); it's forgotten after a fixed lifetime.
+    Thread-safe. */
+@interface CBLTrustCache : NSObject
+
+/** The cache shared by all the WebSockets. */
++ (instancetype) sharedCache;
+
+- (instancetype) initWithCapacity: (NSUInteger)capacity lifetime: (NSTimeInterval)lifetime;
+
+/** Returns the key of a trust decision. */
++ (NSString*) keyForHost: (NSString*)host
+                    port: (NSInteger)port
+             certificate: (SecCertificateRef)cert
+                  policy: (nullable NSString*)policy;
+
+/** True if the key was added within the lifetime. */
+- (BOOL) containsKey: (NSString*)key;
+
+/** Records a successful validation. */
+- (void) addKey: (NSString*)key;
+
+/** Forgets all the decisions, e.g. when the trusted anchor certificates change. */
+- (void) removeAllKeys;
+
+@property (readonly, atomic) NSUInteger count;
+@property (readonly, atomic) NSUInteger hitCount;
+@property (readonly, atomic) NSUInteger missCount;
+
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+/** Returns the lowercase hex SHA-256 digest of the data. */
+NSString* CBLSHA256HexDigest(NSData* data);
+
+NS_ASSUME_NONNULL_END
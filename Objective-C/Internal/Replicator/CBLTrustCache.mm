@@ -0,0 +1,112 @@
+//
+//  CBLTrustCache.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CBLTrustCache.h"
+#import <CommonCrypto/CommonDigest.h>
+
+#define kDefaultCapacity 64
+#define kDefaultLifetime 600.0      // Seconds; bounds how long a revoked certificate is trusted
+
+NSString* CBLSHA256HexDigest(NSData* data) {
+    uint8_t digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256(data.bytes, (CC_LONG)data.length, digest);
+    char hex[2 * CC_SHA256_DIGEST_LENGTH + 1];
+    for (int i = 0; i < CC_SHA256_DIGEST_LENGTH; i++)
+        snprintf(&hex[2 * i], 3, "%02x", digest[i]);
+    return [NSString stringWithUTF8String: hex];
+}
+
+@implementation CBLTrustCache {
+    NSUInteger _capacity;
+    NSTimeInterval _lifetime;
+    NSMutableDictionary<NSString*, NSDate*>* _added;     // When each key was added
+}
+
+@synthesize hitCount=_hitCount, missCount=_missCount;
+
++ (instancetype) sharedCache {
+    static CBLTrustCache* sCache;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        sCache = [[self alloc] initWithCapacity: kDefaultCapacity lifetime: kDefaultLifetime];
+    });
+    return sCache;
+}
+
+- (instancetype) initWithCapacity: (NSUInteger)capacity lifetime: (NSTimeInterval)lifetime {
+    self = [super init];
+    if (self) {
+        _capacity = capacity;
+        _lifetime = lifetime;
+        _added = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
++ (NSString*) keyForHost: (NSString*)host
+                    port: (NSInteger)port
+             certificate: (SecCertificateRef)cert
+                  policy: (nullable NSString*)policy
+{
+    NSData* certData = CFBridgingRelease(SecCertificateCopyData(cert));
+    return [NSString stringWithFormat: @"%@:%ld|%@|%@", host.lowercaseString, (long)port,
+            CBLSHA256HexDigest(certData), policy ?: @""];
+}
+
+- (BOOL) containsKey: (NSString*)key {
+    @synchronized (self) {
+        NSDate* added = _added[key];
+        if (added && -added.timeIntervalSinceNow >= _lifetime) {
+            [_added removeObjectForKey: key];
+            added = nil;
+        }
+        if (added)
+            _hitCount++;
+        else
+            _missCount++;
+        return added != nil;
+    }
+}
+
+- (void) addKey: (NSString*)key {
+    @synchronized (self) {
+        if (_capacity == 0)
+            return;
+        if (_added.count >= _capacity && !_added[key]) {
+            // Make room by removing the oldest decision:
+            NSString* oldest = [_added keysSortedByValueUsingSelector: @selector(compare:)].firstObject;
+            [_added removeObjectForKey: oldest];
+        }
+        _added[key] = [NSDate date];
+    }
+}
+
+- (void) removeAllKeys {
+    @synchronized (self) {
+        [_added removeAllObjects];
+    }
+}
+
+- (NSUInteger) count {
+    @synchronized (self) {
+        return _added.count;
+    }
+}
+
+@end
@@ -18,6 +18,7 @@
 //
 
 #import "CBLTrustCheck.h"
+#import "CBLTrustCache.h"
 #import "c4.h"
 
 #ifdef COUCHBASE_ENTERPRISE
@@ -49,6 +50,8 @@ static BOOL sOnlyTrustAnchorCerts;
         sAnchorCerts = certs.copy;
         sOnlyTrustAnchorCerts = onlyThese;
     }
+    // Decisions made with the previous anchors may no longer hold:
+    [[CBLTrustCache sharedCache] removeAllKeys];
 }
 
 - (instancetype) initWithTrust: (SecTrustRef)trust host: (nullable NSString*)host port: (uint16_t)port {
@@ -22,6 +22,11 @@
 
 @class CBLWebSocket;
 
+#ifdef __cplusplus
+#import <memory>
+namespace cbl { struct ReplicatorCounters; class TokenBucket; }
+#endif
+
 NS_ASSUME_NONNULL_BEGIN
 
 @protocol CBLWebSocketContext <NSObject>
@@ -34,6 +39,15 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void) webSocket: (CBLWebSocket*)websocket didReceiveServerCert: (SecCertificateRef)cert;
 
+#ifdef __cplusplus
+/** The replicator counters that the WebSocket adds its transferred bytes and throttled time to. */
+- (std::shared_ptr<cbl::ReplicatorCounters>) countersForWebSocket: (CBLWebSocket*)websocket;
+
+/** The token bucket limiting the rate the WebSocket sends or reads data at, or null. */
+- (std::shared_ptr<cbl::TokenBucket>) tokenBucketForWebSocket: (CBLWebSocket*)websocket
+                                                      sending: (bool)sending;
+#endif
+
 @end
 
 @interface CBLWebSocket : NSObject <NSURLSessionStreamDelegate>
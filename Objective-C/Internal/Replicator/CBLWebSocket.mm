@@ -20,6 +20,7 @@
 #import "CBLWebSocket.h"
 #import "CBLHTTPLogic.h"
 #import "CBLTrustCheck.h"
+#import "CBLTrustCache.h"
 #import "CBLCoreBridge.h"
 #import "CBLStatus.h"
 #import "CBLReplicatorConfiguration.h"  // for the options constants
@@ -30,9 +31,12 @@
 #import "fleece/Fleece.hh"
 #import "fleece/Expert.hh"              // for AllocedDict
 #import <CommonCrypto/CommonDigest.h>
+#import <Security/SecureTransport.h>
+#import <algorithm>
 #import <dispatch/dispatch.h>
 #import <memory>
 #import <net/if.h>
+#import <netinet/tcp.h>
 #import <arpa/inet.h>
 #import <vector>
 #import "CollectionUtils.h"
@@ -40,6 +44,14 @@
 #import "CBLStringBytes.h"
 #import <ifaddrs.h>
 #import "CBLDNSService.h"
+#import "CBLSocketConnector.h"
+#import "CBLHostAddressCache.hh"
+#import "CBLSocketOptions.hh"
+#import "CBLTokenBucket.hh"
+#import "CBLReplicatorMetrics+Internal.h"
+#import "CBLWebSocketWriteQueue.hh"
+#import "CBLReceiveWindow.hh"
+#import "CBLWebSocketDeflate.hh"
 
 #ifdef COUCHBASE_ENTERPRISE
 #import "CBLCert.h"
@@ -51,29 +63,15 @@ extern "C" {
 
 using namespace fleece;
 
-// Number of bytes to read from the socket at a time
-static constexpr size_t kReadBufferSize = 32 * 1024;
-
-// Max number of bytes read that haven't been processed by LiteCore yet.
-// Beyond this point, I will stop reading from the socket, sending backpressure to the peer.
-static constexpr size_t kMaxReceivedBytesPending = 100 * 1024;
-
-struct PendingWrite {
-    PendingWrite(NSData *d, void (^h)())
-    :data(d)
-    ,completionHandler(h)
-    { }
-    
-    NSData *data;
-    size_t bytesWritten {0};
-    void (^completionHandler)();
-};
-
 NSString * const kCBLWebSocketUseTLSServerAuthCallback = @"serverAuthCallback";
 
+// Bounds of the wait for a bandwidth limiter's tokens, in nanoseconds:
+static constexpr uint64_t kMinShapingDelay = 1000000;
+static constexpr uint64_t kMaxShapingDelay = 1000000000;
+
 @interface CBLWebSocket () <NSStreamDelegate, DNSServiceDelegate>
 
-// Socket descriptor for openning connection when a network interface is specified
+// Socket descriptor of the connection opened by the socket connector
 @property (atomic) int sockfd;
 
 @end
@@ -91,12 +89,21 @@ NSString * const kCBLWebSocketUseTLSServerAuthCallback = @"serverAuthCallback";
     NSInputStream* _in;
     NSOutputStream* _out;
     uint8_t* _readBuffer;
-    std::vector<PendingWrite> _pendingWrites;
+    size_t _readBufferSize;
+    cbl::WebSocketWriteQueue _pendingWrites;
     
     bool _shouldCheckSSLCert;
     
     bool _hasBytes, _hasSpace;
-    size_t _receivedBytesPending;
+    cbl::ReceiveWindow _window;         // Limits the received data LiteCore hasn't processed
+    uint64_t _requestSentAt;            // When the last HTTP request was sent
+    uint64_t _throttledSince;           // When reading was throttled, or 0
+    std::shared_ptr<cbl::ReplicatorCounters> _counters;
+    std::shared_ptr<cbl::TokenBucket> _sendBucket, _readBucket;     // Bandwidth limiters, or null
+    uint64_t _sendShapedSince, _readShapedSince;    // When waiting for a limiter began, or 0
+    std::unique_ptr<cbl::WebSocketDeflate> _deflate;    // If permessage-deflate was negotiated
+    std::vector<uint8_t> _inflated;     // Decompressed frames being passed to LiteCore
+    size_t _partialFrameSize;           // Size of written data that isn't a whole frame yet
     bool _gotResponseHeaders;
     BOOL _connectingToProxy;
     BOOL _connectedThruProxy;
@@ -111,9 +118,13 @@ NSString * const kCBLWebSocketUseTLSServerAuthCallback = @"serverAuthCallback";
     
     NSString* _networkInterface;
     BOOL _useNetworkInterface;
-    dispatch_queue_t _socketConnectQueue;
+    BOOL _raceConnections;              // Resolve the host and race the connection attempts
     
     CBLDNSService* _dnsService;
+    CBLSocketConnector* _connector;
+    BOOL _connectedWithSocket;          // The streams were created from a connected socket
+    uint64_t _connectStartedAt;         // When resolving the host started
+    cbl::SocketOptions _socketOptions;
 }
 
 @synthesize sockfd=_sockfd;
@@ -196,8 +207,17 @@ static void doDispose(C4Socket* s) {
         _cookieStore = [context cookieStoreForWebsocket: self];
         _cookieURL = [context cookieURLForWebSocket: self];
         if (!_cookieURL) { _cookieURL = url; }
+        _counters = context ? [context countersForWebSocket: self] : nullptr;
+        if (context) {
+            _sendBucket = [context tokenBucketForWebSocket: self sending: true];
+            _readBucket = [context tokenBucketForWebSocket: self sending: false];
+        }
         
-        _readBuffer = (uint8_t*)malloc(kReadBufferSize);
+        _socketOptions = cbl::SocketOptions(_options);
+        _window = cbl::ReceiveWindow(_options[kCBLReplicatorOptionMinReceiveWindow].asUnsigned(),
+                                     _options[kCBLReplicatorOptionMaxReceiveWindow].asUnsigned());
+        _readBufferSize = _window.readSize();
+        _readBuffer = (uint8_t*)malloc(_readBufferSize);
         
         NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL: url];
         request.HTTPShouldHandleCookies = NO;
@@ -221,11 +241,9 @@ static void doDispose(C4Socket* s) {
         
         _sockfd = -1;
         _networkInterface = [context networkInterfaceForWebsocket: self];
-        if (_networkInterface.length > 0) {
-            queueName = [NSString stringWithFormat: @"%@-SocketConnect", queueName];
-            _socketConnectQueue = dispatch_queue_create(queueName.UTF8String, DISPATCH_QUEUE_SERIAL);
+        if (_networkInterface.length > 0)
             _useNetworkInterface = YES;
-        }
+        _raceConnections = _options[kCBLReplicatorOptionRaceConnections].asBool();
     }
     return self;
 }
@@ -326,13 +344,18 @@ static void doDispose(C4Socket* s) {
     
     _connectingToProxy = (_logic.proxyType == kCBLHTTPProxy);
     _connectedThruProxy = NO;
+    _connectedWithSocket = NO;
+    _connectStartedAt = cbl::ReplicatorCounters::now();
     
-    if (_useNetworkInterface) {
+    if (_useNetworkInterface || (_raceConnections && _logic.proxyType != kCBLSOCKSProxy)) {
+        // Resolve the host and race the connections to its addresses:
         [self connectToHostWithName: _logic.directHost
                                port: _logic.directPort
-                   networkInterface: _networkInterface];
+                   networkInterface: (_useNetworkInterface ? _networkInterface : nil)];
         
     } else {
+        // Let the streams connect, so that the system can bring up the cellular radio or an
+        // on-demand VPN; a SOCKS proxy is a stream property, so it needs them too:
         NSInputStream *inStream;
         NSOutputStream *outStream;
         [NSStream getStreamsToHostWithName: _logic.directHost
@@ -357,34 +380,39 @@ static void doDispose(C4Socket* s) {
     
     [_in open];
     [_out open];
+    [self configureTLSSessionResumption];
     
     if (_connectingToProxy) {
         CBLLogInfo(WebSocket, @"%@: Connecting to HTTP proxy %@:%d...",
                    self, _logic.directHost, _logic.directPort);
         _logic.useProxyCONNECT = YES;
-        [self writeData: _logic.HTTPRequestData completionHandler: nil];
+        [self writeHTTPRequest];
     } else {
         CBLLogInfo(WebSocket, @"%@: Sending WebSocket request to %@:%d...", self, _logic.URL.host, _logic.port);
         [self _sendWebSocketRequest];
     }
 }
 
+// Resolves the host, on the given network interface if it's not nil, then connects a socket to it.
 - (void) connectToHostWithName: (NSString*)hostname
                           port: (NSInteger)port
-              networkInterface: (NSString*)interface
+              networkInterface: (nullable NSString*)interface
 {
     CBLLogInfo(WebSocket, @"%@: Connect to host '%@' port '%ld' interface '%@'",
-               self, hostname, (long)port, interface);
+               self, hostname, (long)port, (interface ?: @"any"));
     
-    unsigned int index = if_nametoindex([interface cStringUsingEncoding: NSUTF8StringEncoding]);
-    if (index == 0) {
-        int errNo = errno;
-        NSString* msg = $sprintf(@"Failed to find network interface %@ with errno %d", interface, errNo);
-        CBLWarnError(WebSocket, @"%@: %@", self, msg);
-        [self closeWithError: posixError(errNo, msg)];
-        return;
+    unsigned int index = 0;
+    if (interface) {
+        index = if_nametoindex([interface cStringUsingEncoding: NSUTF8StringEncoding]);
+        if (index == 0) {
+            int errNo = errno;
+            NSString* msg = $sprintf(@"Failed to find network interface %@ with errno %d", interface, errNo);
+            CBLWarnError(WebSocket, @"%@: %@", self, msg);
+            [self closeWithError: posixError(errNo, msg)];
+            return;
+        }
+        CBLLogVerbose(WebSocket, @"%@: Interface '%@' is mapped to index '%u'", self, interface, index);
     }
-    CBLLogVerbose(WebSocket, @"%@: Interface '%@' is mapped to index '%u'", self, _networkInterface, index);
     
     _dnsService = [[CBLDNSService alloc] initWithHost: hostname
                                             interface: index
@@ -395,12 +423,14 @@ static void doDispose(C4Socket* s) {
 
 #pragma mark DNSServiceDelegate
 
-- (void) didResolveSuccessWithAddress: (AddressInfo*)info {
+- (void) didResolveSuccessWithAddresses: (NSArray<AddressInfo*>*)addresses {
     dispatch_async(_queue, ^{
         if (self->_dnsService) {
-            CBLLogVerbose(WebSocket, @"%@: Host '%@' was resolved as ip=%@, family=%d",
-                          self, info.host, info.addrstr, info.addr->sa_family);
-            [self _socketConnect: info];
+            CBLLogVerbose(WebSocket, @"%@: Host '%@' was resolved as %@",
+                          self, addresses.firstObject.host,
+                          [[addresses valueForKey: @"addrstr"] componentsJoinedByString: @", "]);
+            self->_dnsService = nil;
+            [self _socketConnect: addresses];
         }
     });
 }
@@ -417,89 +447,75 @@ static void doDispose(C4Socket* s) {
 
 #pragma mark - Socket connect
 
-- (void) _socketConnect: (AddressInfo*)info {
-    Assert(_sockfd < 0);
-    _sockfd = socket(info.addr->sa_family, SOCK_STREAM, 0);
-    if (_sockfd < 0) {
-        int errNo = errno;
-        NSString* msg = $sprintf(@"Failed to create socket with errno %d (%@)", errNo, info);
-        CBLWarnError(WebSocket, @"%@: %@", self, msg);
-        [self closeWithError: posixError(errNo, msg)];
-        return;
+- (void) _socketConnect: (NSArray<AddressInfo*>*)addresses {
+    Assert(_sockfd < 0 && !_connector);
+    CBLSocketConnector* connector = [[CBLSocketConnector alloc] initWithAddresses: addresses
+                                                                            queue: _queue];
+    _connector = connector;
+    if (!_socketOptions.empty()) {
+        cbl::SocketOptions options = _socketOptions;
+        connector.socketConfigurator = ^(int sockfd) {
+            [self applySocketOptions: options toSocket: sockfd];
+        };
     }
-    
-    // Set network interface:
-    Assert(info.interface > 0);
-    
-    UInt32 index = info.interface;
-    int result = -1;
-    if (info.addr->sa_family == AF_INET) {
-        result = setsockopt(_sockfd, IPPROTO_IP, IP_BOUND_IF, &index, sizeof(index));
-    } else if (info.addr->sa_family == AF_INET6 ){
-        result = setsockopt(_sockfd, IPPROTO_IPV6, IPV6_BOUND_IF, &index, sizeof(index));
-    }
-    
-    if (result < 0) {
-        int errNo = errno;
-        NSString* msg = $sprintf(@"Failed to set network interface %u with errno %d (%@)",
-                                 (unsigned int)info.interface, errNo, info);
-        CBLWarnError(WebSocket, @"%@: %@", self, msg);
-        [self closeWithError: posixError(errNo, msg)];
-        return;
-    }
-    
-    CBLLogVerbose(WebSocket, @"%@: Successfully set network interface %u to socket option",
-                  self, info.interface);
-    
-    // Connect:
-    dispatch_async(_socketConnectQueue, ^{
-        int sockfd = self.sockfd;
-        if (sockfd < 0) {
-            return; // Already disconnected
+    [connector connect: ^(int sockfd, AddressInfo* address, NSError* error) {
+        if (self->_connector != connector) {
+            // Disconnected meanwhile:
+            if (sockfd >= 0)
+                close(sockfd);
+            return;
         }
+        self->_connector = nil;
         
-        CBLLogVerbose(WebSocket, @"%@: Connect to IP address %@", self, info.addrstr);
-        int status = connect(sockfd, info.addr, info.length);
-        if (status == 0) {
-            dispatch_async(self->_queue, ^{
-                if (self->_sockfd < 0)
-                    return; // Already disconnected
-                
-                // Enable non-blocking mode on the socket:
-                int flags = fcntl(self->_sockfd, F_GETFL);
-                if (fcntl(self->_sockfd, F_SETFL, flags | O_NONBLOCK) < 0) {
-                    int errNo = errno;
-                    NSString* msg = $sprintf(@"Failed to enable non-blocking mode with errno %d", errNo);
-                    CBLWarnError(WebSocket, @"%@: %@", self, msg);
-                    [self closeWithError: posixError(errNo, msg)];
-                    return;
-                }
-                
-                // Create a pair stream with the socket:
-                CFReadStreamRef readStream;
-                CFWriteStreamRef writeStream;
-                CFStreamCreatePairWithSocket(kCFAllocatorDefault, self->_sockfd, &readStream, &writeStream);
-                
-                CFReadStreamSetProperty(readStream, kCFStreamPropertyShouldCloseNativeSocket, kCFBooleanTrue);
-                CFWriteStreamSetProperty(writeStream, kCFStreamPropertyShouldCloseNativeSocket, kCFBooleanTrue);
-                
-                NSInputStream* input = CFBridgingRelease(readStream);
-                NSOutputStream* output = CFBridgingRelease(writeStream);
-                
-                // Connect with the streams:
-                [self _connectWithInputStream: input outputStream: output];
-            });
-        } else {
-            int errNo = errno;
-            NSString* msg = $sprintf(@"Failed to connect via the specified network interface %u with errno %d",
-                                     info.interface, errNo);
-            CBLWarnError(WebSocket, @"%@: %@", self, msg);
-            NSError* error = posixError(errNo, msg);
-            dispatch_async(self->_queue, ^{
-                [self closeWithError: error];
-            });
+        if (sockfd < 0) {
+            AddressInfo* first = addresses.firstObject;
+            CBLWarnError(WebSocket, @"%@: Failed to connect to '%@' after %lu attempts: %@",
+                         self, first.host, (unsigned long)connector.attempts,
+                         error.my_compactDescription);
+            // The addresses may be stale; resolve the host again next time:
+            cbl::HostAddressCache::shared().invalidate(first.host.UTF8String, first.interface);
+            [self closeWithError: error];
+            return;
         }
-    });
+        
+        if (self->_counters)
+            self->_counters->connected(connector.attempts,
+                                       cbl::ReplicatorCounters::now() - self->_connectStartedAt);
+        self.sockfd = sockfd;
+        
+        // Create a pair stream with the socket:
+        CFReadStreamRef readStream;
+        CFWriteStreamRef writeStream;
+        CFStreamCreatePairWithSocket(kCFAllocatorDefault, sockfd, &readStream, &writeStream);
+        
+        CFReadStreamSetProperty(readStream, kCFStreamPropertyShouldCloseNativeSocket, kCFBooleanTrue);
+        CFWriteStreamSetProperty(writeStream, kCFStreamPropertyShouldCloseNativeSocket, kCFBooleanTrue);
+        
+        NSInputStream* input = CFBridgingRelease(readStream);
+        NSOutputStream* output = CFBridgingRelease(writeStream);
+        
+        // Connect with the streams:
+        self->_connectedWithSocket = YES;
+        [self _connectWithInputStream: input outputStream: output];
+    }];
+}
+
+- (void) applySocketOptions: (const cbl::SocketOptions&)options toSocket: (int)sockfd {
+    int err = options.apply(sockfd);
+    if (err)
+        CBLWarn(WebSocket, @"%@: Failed to set socket options with errno %d", self, err);
+    else
+        CBLLogVerbose(WebSocket, @"%@: Set socket options (nodelay=%d, keepalive=%d/%d/%d, "
+                      "sndbuf=%d, rcvbuf=%d)", self, options.noDelay, options.keepAliveIdle,
+                      options.keepAliveInterval, options.keepAliveCount, options.sendBufferSize,
+                      options.receiveBufferSize);
+}
+
+// Sets the socket options on the socket the streams opened, when they made the connection.
+- (void) applySocketOptionsToStream {
+    int sockfd = [self nativeSocket];
+    if (sockfd >= 0)
+        [self applySocketOptions: _socketOptions toSocket: sockfd];
 }
 
 + (nullable NSString*) getNetworkInterfaceName: (NSString*)name error: (NSError**)outError {
@@ -601,9 +617,10 @@ static inline NSError* posixError(int errNo, NSString* msg) {
         NSMutableDictionary* settings = [NSMutableDictionary dictionary];
         
         // Set the actual hostname used for certificate verification during the TLS handshake
-        // when connecting through a proxy or a specified network interface. The hostname will
-        // appear in the Server Name Indication (SNI) field of the TLS ClientHello message.
-        if (_connectedThruProxy || _useNetworkInterface) {
+        // when connecting through a proxy or with a socket connected to a resolved address. The
+        // hostname will appear in the Server Name Indication (SNI) field of the TLS ClientHello
+        // message.
+        if (_connectedThruProxy || _connectedWithSocket) {
             NSString* hostName = _logic.directHost;
             CBLLogVerbose(WebSocket, @"%@ Setting TLS peer (SNI) hostname: %@", self, hostName);
             [settings setObject: hostName forKey: (__bridge id)kCFStreamSSLPeerName];
@@ -629,6 +646,58 @@ static inline NSError* posixError(int errNo, NSString* msg) {
     }
 }
 
+// Lets the TLS session be resumed when reconnecting to the same server, saving a round trip and
+// the server's certificate chain. CFNetwork identifies sessions by the host and port it opened,
+// which it doesn't know when the streams wrap a connected socket, so the peer ID is set here.
+- (void) configureTLSSessionResumption {
+    if (!_logic.useTLS)
+        return;
+    CFTypeRef context = CFReadStreamCopyProperty((__bridge CFReadStreamRef)_in,
+                                                 kCFStreamPropertySSLContext);
+    if (!context)
+        return;
+    
+    // Sessions authenticated with a client certificate are only resumed with the same one:
+    NSMutableString* peerID = [NSMutableString stringWithFormat: @"%@:%u",
+                               _logic.URL.host.lowercaseString, _logic.port];
+    if (_clientIdentity) {
+        SecCertificateRef cert;
+        if (SecIdentityCopyCertificate((__bridge SecIdentityRef)_clientIdentity[0], &cert) == errSecSuccess) {
+            NSData* certData = CFBridgingRelease(SecCertificateCopyData(cert));
+            CFRelease(cert);
+            [peerID appendFormat: @"|%@", CBLSHA256HexDigest(certData)];
+        }
+    }
+    NSData* peerIDData = [peerID dataUsingEncoding: NSUTF8StringEncoding];
+    
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+    SSLContextRef ssl = (SSLContextRef)context;
+    OSStatus status = SSLSetPeerID(ssl, peerIDData.bytes, peerIDData.length);
+    if (status == noErr)
+        status = SSLSetSessionTicketsEnabled(ssl, true);
+#pragma clang diagnostic pop
+    CFRelease(context);
+    
+    if (status == noErr)
+        CBLLogVerbose(WebSocket, @"%@: Enabled TLS session resumption for %@", self, peerID);
+    else
+        CBLLogVerbose(WebSocket, @"%@: Couldn't enable TLS session resumption (%d)", self, (int)status);
+}
+
+// Describes the custom validation of the server certificate, for the trust cache.
+- (NSString*) trustPolicy {
+    Value pinnedCert = _options[kC4ReplicatorOptionPinnedServerCert];
+    if (pinnedCert)
+        return [@"pinned:" stringByAppendingString:
+                CBLSHA256HexDigest(slice(pinnedCert.asData()).uncopiedNSData())];
+#ifdef COUCHBASE_ENTERPRISE
+    if (_options[kC4ReplicatorOptionOnlySelfSignedServerCert].asBool())
+        return @"selfSigned";
+#endif
+    return @"default";
+}
+
 - (BOOL) usesCustomTLSCertValidation {
     return (
             !!_options[kC4ReplicatorOptionPinnedServerCert]
@@ -692,7 +761,17 @@ static inline NSError* posixError(int errNo, NSString* msg) {
     if (protocols)
         _logic[@"Sec-WebSocket-Protocol"] = protocols.asNSString();
     
-    [self writeData: _logic.HTTPRequestData completionHandler: nil];
+    if (_options[kCBLReplicatorOptionCompression].asBool()) {
+        std::string offer = cbl::deflateExtensionOffer(self.compressionWindowBits);
+        _logic[@"Sec-WebSocket-Extensions"] = @(offer.c_str());
+    }
+    
+    [self writeHTTPRequest];
+}
+
+- (void) writeHTTPRequest {
+    _requestSentAt = cbl::ReplicatorCounters::now();
+    [self writeData: _logic.HTTPRequestData];
 }
 
 // Parses the HTTP response.
@@ -707,6 +786,8 @@ static inline NSError* posixError(int errNo, NSString* msg) {
     }
     if (CFHTTPMessageIsHeaderComplete(_httpResponse)) {
         _gotResponseHeaders = YES;
+        // The request's round trip is the first estimate of the RTT, until TCP measures it:
+        _window.setRTT(cbl::ReplicatorCounters::now() - _requestSentAt);
         auto httpResponse = _httpResponse;
         _httpResponse = nullptr;
         [_logic receivedResponse: httpResponse];
@@ -739,6 +820,7 @@ static inline NSError* posixError(int errNo, NSString* msg) {
     _logic.useProxyCONNECT = NO;
     [self clearHTTPState];
     [self configureTLS];
+    [self configureTLSSessionResumption];
     
     CBLLogInfo(WebSocket, @"%@: Proxy CONNECT to %@:%d...", self, _logic.URL.host, _logic.port);
     [self _sendWebSocketRequest];
@@ -799,13 +881,43 @@ static inline NSError* posixError(int errNo, NSString* msg) {
     } else if (!checkHeader(headers, @"Sec-WebSocket-Accept", _expectedAcceptHeader, YES)) {
         [self closeWithCode: kWebSocketCloseProtocolError
                      reason: @"Invalid 'Sec-WebSocket-Accept' header"];
+    } else if (![self acceptExtensions: headers[@"Sec-WebSocket-Extensions"]]) {
+        [self closeWithCode: kWebSocketCloseProtocolError
+                     reason: @"Invalid 'Sec-WebSocket-Extensions' header"];
     } else {
-        // TODO: Check Sec-WebSocket-Extensions for unknown extensions
         // Now I can start the WebSocket protocol:
         [self connected: headers];
     }
 }
 
+- (int) compressionWindowBits {
+    int64_t bits = _options[kCBLReplicatorOptionCompressionWindowBits].asInt();
+    return bits > 0 ? (int)bits : cbl::DeflateParams::kMaxWindowBits;
+}
+
+// Sets up permessage-deflate if the server accepted it. Returns NO if the server responded
+// with an extension that wasn't offered, or with invalid parameters.
+- (BOOL) acceptExtensions: (nullable NSString*)extensions {
+    _deflate.reset();
+    if (!extensions)
+        return YES;
+    if (!_options[kCBLReplicatorOptionCompression].asBool())
+        return NO;
+    
+    cbl::DeflateParams params;
+    int64_t level = _options[kCBLReplicatorOptionCompressionLevel].asInt();
+    if (level > 0)
+        params.level = (int)level;
+    if (!cbl::parseDeflateExtensionResponse(extensions.UTF8String, self.compressionWindowBits,
+                                            params))
+        return NO;
+    
+    CBLLogInfo(WebSocket, @"%@: Using permessage-deflate [level %d, window bits %d sent, %d received]",
+               self, params.level, params.clientMaxWindowBits, params.serverMaxWindowBits);
+    _deflate = std::make_unique<cbl::WebSocketDeflate>(params);
+    return YES;
+}
+
 // Notifies LiteCore that the WebSocket is connected.
 - (void) connected: (NSDictionary*)responseHeaders {
     CBLLogInfo(WebSocket, @"%@: CBLWebSocket CONNECTED!", self);
@@ -840,32 +952,73 @@ static BOOL checkHeader(NSDictionary* headers, NSString* header, NSString* expec
 // Returns true if there is too much unhandled WebSocket data in memory
 // and we should stop reading from the socket.
 - (bool) readThrottled {
-    return _receivedBytesPending >= kMaxReceivedBytesPending;
+    return _window.throttled();
 }
 
 // callback from C4Socket
 - (void) writeAndFree: (C4SliceResult) allocatedData {
-    NSData* data = [NSData dataWithBytesNoCopy: (void*)allocatedData.buf
-                                        length: allocatedData.size
-                                  freeWhenDone: NO];
+    // The data is freed when it's been written, or when the queue is cleared:
+    NSData* data = [[NSData alloc] initWithBytesNoCopy: (void*)allocatedData.buf
+                                                length: allocatedData.size
+                                           deallocator: ^(void* bytes, NSUInteger length) {
+        c4slice_free({bytes, length});
+    }];
     CBLLogVerbose(WebSocket, @"%@: >>> sending %zu bytes...", self, allocatedData.size);
     dispatch_async(_queue, ^{
-        [self writeData: data completionHandler: ^() {
-            size_t size = allocatedData.size;
-            c4slice_free(allocatedData);
-            CBLLogVerbose(WebSocket, @"%@:    (...sent %zu bytes)", self, size);
-            [self callC4Socket:^(C4Socket *socket) {
-                c4socket_completedWrite(socket, size);
-            }];
-        }];
+        NSData* frames = data;
+        size_t size = data.length;
+        if (self->_deflate) {
+            frames = [self compressFrames: data];
+            if (!frames)
+                return;
+            // Until a frame is complete nothing is sent; its size is reported with the frame's:
+            size += self->_partialFrameSize;
+            self->_partialFrameSize = frames.length > 0 ? 0 : size;
+            if (frames.length == 0)
+                return;
+        }
+        self->_pendingWrites.push(frames, size);
+        if (self->_hasSpace)
+            [self doWrite];
     });
 }
 
+// Compresses the messages in frames from LiteCore, returning the frames to send instead.
+- (nullable NSData*) compressFrames: (NSData*)data {
+    std::vector<uint8_t> frames;
+    if (!_deflate->compress(data.bytes, data.length, frames)) {
+        CBLWarn(WebSocket, @"%@: %s", self, _deflate->errorMessage().c_str());
+        [self closeWithCode: kWebSocketCloseCantFulfill
+                     reason: @(_deflate->errorMessage().c_str())];
+        return nil;
+    }
+    return [NSData dataWithBytes: frames.data() length: frames.size()];
+}
+
 // Called when WebSocket data is received (NOT necessarily an entire message.)
 - (void) receivedBytes: (const void*)bytes length: (size_t)length {
-    self->_receivedBytesPending += length;
+    if (_counters)
+        cbl::ReplicatorCounters::add(_counters->bytesReceived, length);
+    if (_deflate) {
+        // The window limits the decompressed data, which is what LiteCore holds in memory:
+        _inflated.clear();
+        if (!_deflate->decompress(bytes, length, _inflated)) {
+            [self closeWithCode: kWebSocketCloseProtocolError
+                         reason: @(_deflate->errorMessage().c_str())];
+            return;
+        }
+        if (_inflated.empty())
+            return;             // Only part of a frame
+        bytes = _inflated.data();
+        length = _inflated.size();
+    }
+    
+    bool wasThrottled = self.readThrottled;
+    _window.received(length);
+    if (!wasThrottled && self.readThrottled)
+        [self startThrottle];
     CBLLogVerbose(WebSocket, @"%@: <<< received %zu bytes [now %zu pending]",
-                  self, (size_t)length, self->_receivedBytesPending);
+                  self, (size_t)length, _window.pending());
     [self callC4Socket:^(C4Socket *socket) {
         c4socket_received(socket, {bytes, length});
     }];
@@ -875,12 +1028,109 @@ static BOOL checkHeader(NSDictionary* headers, NSString* header, NSString* expec
 - (void) completedReceive: (size_t)byteCount {
     dispatch_async(_queue, ^{
         bool wasThrottled = self.readThrottled;
-        self->_receivedBytesPending -= byteCount;
-        if (self->_hasBytes && wasThrottled && !self.readThrottled)
-            [self doRead];
+        if (self->_window.consumed(byteCount, cbl::ReplicatorCounters::now()))
+            [self windowSampled];
+        if (wasThrottled && !self.readThrottled) {
+            [self endThrottle];
+            if (self->_hasBytes)
+                [self doRead];
+        } else if (!wasThrottled && self.readThrottled) {
+            [self startThrottle];       // The window shrank
+        }
     });
 }
 
+// Called after the receive window measured LiteCore's consumption rate and may have resized.
+// Updates the RTT from the TCP connection, for the next sample.
+- (void) windowSampled {
+    CBLLogVerbose(WebSocket, @"%@: Receive window is %zu bytes [%.0f bytes/sec, rtt %.1fms]",
+                  self, _window.size(), _window.rate(), _window.rtt() / 1.0e6);
+#ifdef TCP_CONNECTION_INFO
+    int fd = [self nativeSocket];
+    if (fd >= 0) {
+        struct tcp_connection_info info;
+        socklen_t size = sizeof(info);
+        if (getsockopt(fd, IPPROTO_TCP, TCP_CONNECTION_INFO, &info, &size) == 0)
+            _window.setRTT((uint64_t)info.tcpi_srtt * 1000000);
+    }
+#endif
+}
+
+// The socket descriptor of the connection, or -1 if it's not available.
+- (int) nativeSocket {
+    if (_sockfd >= 0)
+        return _sockfd;
+    else if (!_in)
+        return -1;
+    int fd = -1;
+    NSData* handle = CFBridgingRelease(CFReadStreamCopyProperty((__bridge CFReadStreamRef)_in,
+                                                                kCFStreamPropertySocketNativeHandle));
+    if (handle.length == sizeof(CFSocketNativeHandle))
+        fd = *(const CFSocketNativeHandle*)handle.bytes;
+    return fd;
+}
+
+// Counts the time and times reading was throttled in the replicator's metrics:
+- (void) startThrottle {
+    if (_counters) {
+        cbl::ReplicatorCounters::add(_counters->throttles, 1);
+        _throttledSince = cbl::ReplicatorCounters::now();
+    }
+}
+
+- (void) endThrottle {
+    if (_throttledSince) {
+        cbl::ReplicatorCounters::add(_counters->throttledTime,
+                                     cbl::ReplicatorCounters::now() - _throttledSince);
+        _throttledSince = 0;
+    }
+}
+
+#pragma mark - BANDWIDTH SHAPING:
+
+// Stops sending until the send limiter has tokens for the pending data again.
+- (void) shapeSending {
+    uint64_t now = cbl::ReplicatorCounters::now();
+    _sendShapedSince = now;
+    [self afterDelay: _sendBucket->delay(_pendingWrites.bytesQueued(), now) do: ^{
+        if (!self->_sendShapedSince)
+            return;
+        [self endShaping: self->_sendShapedSince bucket: *self->_sendBucket];
+        self->_sendShapedSince = 0;
+        if (self->_out && self->_hasSpace)
+            [self doWrite];
+    }];
+}
+
+// Stops reading until the read limiter has tokens for a read again.
+- (void) shapeReading {
+    uint64_t now = cbl::ReplicatorCounters::now();
+    _readShapedSince = now;
+    [self afterDelay: _readBucket->delay(_window.readSize(), now) do: ^{
+        if (!self->_readShapedSince)
+            return;
+        [self endShaping: self->_readShapedSince bucket: *self->_readBucket];
+        self->_readShapedSince = 0;
+        if (self->_in && self->_hasBytes && !self.readThrottled)
+            [self doRead];
+    }];
+}
+
+// Runs the block on the queue after the delay in nanoseconds. The delay is bounded, so that a
+// limiter's new rate takes effect soon.
+- (void) afterDelay: (uint64_t)delay do: (dispatch_block_t)block {
+    delay = std::max(std::min(delay, kMaxShapingDelay), kMinShapingDelay);
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)delay), _queue, block);
+}
+
+// Counts the time spent waiting for a limiter in the replicator's metrics and the limiter's:
+- (void) endShaping: (uint64_t)since bucket: (cbl::TokenBucket&)bucket {
+    uint64_t time = cbl::ReplicatorCounters::now() - since;
+    if (_counters)
+        cbl::ReplicatorCounters::add(_counters->shapedTime, time);
+    bucket.addShapedTime(time);
+}
+
 // callback from C4Socket
 - (void) closeSocket {
     CBLLogInfo(WebSocket, @"%@: CBLWebSocket closeSocket requested", self);
@@ -958,14 +1208,20 @@ static BOOL checkHeader(NSDictionary* headers, NSString* header, NSString* expec
 - (BOOL) checkSSLCert {
     _shouldCheckSSLCert = NO;
     
+    NSError* error = nil;
     SecTrustRef trust = [self getTrustFromReadStream];
-    Assert(trust);
+    if (!trust) {
+        // A resumed session still has the server's chain, so this means the server sent none:
+        NSString* mesg = @"TLS handshake failed: no server certificate";
+        CBLWarn(WebSocket, @"%@: %@", self, mesg);
+        MYReturnError(&error, NSURLErrorServerCertificateUntrusted, NSURLErrorDomain, @"%@", mesg);
+        [self closeWithError: error];
+        return NO;
+    }
     
     SecCertificateRef cert = [self certificateFromTrust: trust];
     [self notifyServerCertificateReceived: cert];
     
-    NSError* error = nil;
-    
     // Validate trust only when using custom certificate validation
     // (kCFStreamSSLValidatesCertificateChain is disabled).
     // If system validation is enabled, the certificates have already been verified,
@@ -1002,7 +1258,17 @@ static BOOL checkHeader(NSDictionary* headers, NSString* header, NSString* expec
         return true;
 #endif
     
+    // Skip the evaluation if this certificate was trusted recently:
     NSURL* url = _logic.URL;
+    SecCertificateRef cert = [self certificateFromTrust: trust];
+    NSString* cacheKey = [CBLTrustCache keyForHost: url.host port: _logic.port certificate: cert
+                                            policy: [self trustPolicy]];
+    CFRelease(cert);
+    if ([[CBLTrustCache sharedCache] containsKey: cacheKey]) {
+        CBLLogVerbose(WebSocket, @"%@: Server certificate was trusted recently", self);
+        return true;
+    }
+    
     CBLTrustCheck* check = [[CBLTrustCheck alloc] initWithTrust: trust host: url.host port: url.port.shortValue];
     
     Value pinnedCert = _options[kC4ReplicatorOptionPinnedServerCert];
@@ -1020,6 +1286,7 @@ static BOOL checkHeader(NSDictionary* headers, NSString* header, NSString* expec
         CBLWarn(WebSocket, @"%@: TLS handshake failed: certificate verification error: %@", self, (*error).localizedDescription);
         return false;
     }
+    [[CBLTrustCache sharedCache] addKey: cacheKey];
     return true;
 }
 
@@ -1046,34 +1313,50 @@ static BOOL checkHeader(NSDictionary* headers, NSString* header, NSString* expec
 
 #pragma mark - NSStream
 
-// Asynchronously sends data over the socket, and calls the completion handler block afterwards.
-- (void) writeData: (NSData*)data completionHandler: (void (^)())completionHandler {
-    _pendingWrites.emplace_back(data, completionHandler);
+// Asynchronously sends data over the socket.
+- (void) writeData: (NSData*)data {
+    _pendingWrites.push(data, 0);
     if (_hasSpace)
         [self doWrite];
 }
 
+// Writes as much of the pending data as the stream accepts, and the send limiter allows; small
+// WebSocket frames are gathered into a single write. LiteCore is told about all the completed
+// frames at once.
 - (void) doWrite {
     if (_shouldCheckSSLCert && ![self checkSSLCert])
         return;
     
-    while (!_pendingWrites.empty()) {
-        auto &w = _pendingWrites.front();
-        auto nBytes = [_out write: (const uint8_t*)w.data.bytes + w.bytesWritten
-                        maxLength: w.data.length - w.bytesWritten];
-        if (nBytes <= 0) {
-            _hasSpace = false;
+    size_t maxBytes = SIZE_MAX;
+    if (_sendBucket) {
+        if (_sendShapedSince)
             return;
-        }
-        w.bytesWritten += nBytes;
-        if (w.bytesWritten < w.data.length) {
-            _hasSpace = false;
+        maxBytes = _sendBucket->available(cbl::ReplicatorCounters::now());
+        if (maxBytes == 0) {
+            if (!_pendingWrites.empty())
+                [self shapeSending];
             return;
         }
-        w.data = nil;
-        if (w.completionHandler)
-            w.completionHandler();
-        _pendingWrites.erase(_pendingWrites.begin());
+    }
+    
+    bool blocked;
+    size_t frameBytes;
+    size_t queued = _pendingWrites.bytesQueued();
+    size_t completed = _pendingWrites.write(_out, blocked, frameBytes, maxBytes);
+    if (blocked)
+        _hasSpace = false;
+    if (_sendBucket) {
+        _sendBucket->consume(queued - _pendingWrites.bytesQueued());
+        if (!blocked && !_pendingWrites.empty())
+            [self shapeSending];
+    }
+    if (completed > 0) {
+        if (_counters)
+            cbl::ReplicatorCounters::add(_counters->bytesSent, frameBytes);
+        CBLLogVerbose(WebSocket, @"%@:    (...sent %zu bytes)", self, completed);
+        [self callC4Socket:^(C4Socket *socket) {
+            c4socket_completedWrite(socket, completed);
+        }];
     }
 }
 
@@ -1082,14 +1365,31 @@ static BOOL checkHeader(NSDictionary* headers, NSString* header, NSString* expec
     Assert(_hasBytes);
     _hasBytes = false;
     while (_in.hasBytesAvailable) {
-        if (self.readThrottled) {
+        if (self.readThrottled || _readShapedSince) {
             _hasBytes = true;
             break;
         }
-        NSInteger nBytes = [_in read: _readBuffer maxLength: kReadBufferSize];
+        size_t readSize = _window.readSize();
+        if (readSize != _readBufferSize) {
+            _readBuffer = (uint8_t*)reallocf(_readBuffer, readSize);
+            _readBufferSize = readSize;
+        }
+        // The read limiter applies to the WebSocket frames, not the handshake:
+        bool shaped = _readBucket && _gotResponseHeaders;
+        if (shaped) {
+            readSize = std::min(readSize, _readBucket->available(cbl::ReplicatorCounters::now()));
+            if (readSize == 0) {
+                _hasBytes = true;
+                [self shapeReading];
+                break;
+            }
+        }
+        NSInteger nBytes = [_in read: _readBuffer maxLength: readSize];
         CBLLogVerbose(WebSocket, @"%@: DoRead read %zu bytes", self, nBytes);
         if (nBytes <= 0)
             break;
+        if (shaped)
+            _readBucket->consume(nBytes);
         if (!_gotResponseHeaders)
             [self receivedHTTPResponseBytes: _readBuffer length: nBytes];
         else
@@ -1101,6 +1401,12 @@ static BOOL checkHeader(NSDictionary* headers, NSString* header, NSString* expec
     switch (eventCode) {
         case NSStreamEventOpenCompleted:
             CBLLogVerbose(WebSocket, @"%@: Open Completed on %@", self, stream);
+            if (stream == _out && !_connectedWithSocket) {
+                if (_counters)
+                    _counters->connected(1, cbl::ReplicatorCounters::now() - _connectStartedAt);
+                if (!_socketOptions.empty())
+                    [self applySocketOptionsToStream];
+            }
             break;
         case NSStreamEventHasBytesAvailable:
             Assert(stream == _in);
@@ -1135,6 +1441,22 @@ static BOOL checkHeader(NSDictionary* headers, NSString* header, NSString* expec
 
 - (void) disconnect {
     CBLLogVerbose(WebSocket, @"%@: Disconnect", self);
+    [self endThrottle];
+    if (_sendShapedSince) {
+        [self endShaping: _sendShapedSince bucket: *_sendBucket];
+        _sendShapedSince = 0;
+    }
+    if (_readShapedSince) {
+        [self endShaping: _readShapedSince bucket: *_readBucket];
+        _readShapedSince = 0;
+    }
+    if (_deflate) {
+        CBLLogInfo(WebSocket, @"%@: permessage-deflate sent %llu bytes as %llu, received %llu as %llu",
+                   self, _deflate->bytesCompressedIn(), _deflate->bytesCompressedOut(),
+                   _deflate->bytesDecompressedOut(), _deflate->bytesDecompressedIn());
+        _deflate.reset();
+        _partialFrameSize = 0;
+    }
     if (_in || _out) {
         NSInputStream* inStream = _in;
         NSOutputStream* outStream = _out;
@@ -1160,10 +1482,15 @@ static BOOL checkHeader(NSDictionary* headers, NSString* header, NSString* expec
         [_dnsService stop];
         _dnsService = nil;
     }
+    
+    if (_connector) {
+        [_connector cancel];
+        _connector = nil;
+    }
 }
 
 - (BOOL) isConnected {
-    return (_in || _out || _sockfd >= 0 || _dnsService);
+    return (_in || _out || _sockfd >= 0 || _dnsService || _connector);
 }
 
 #pragma mark - Helper
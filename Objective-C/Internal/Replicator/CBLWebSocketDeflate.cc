@@ -0,0 +1,444 @@
+//
+//  CBLWebSocketDeflate.cc
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CBLWebSocketDeflate.hh"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+namespace cbl {
+
+    // Frames or decompressed payloads larger than this are rejected:
+    static constexpr size_t kMaxPayloadSize = 64 * 1024 * 1024;
+
+    // Every compressed message ends with this, from the final sync flush. It's removed before
+    // sending, and added back before decompressing (RFC 7692, section 7.2.1):
+    static const uint8_t kMessageTail[4] = {0x00, 0x00, 0xFF, 0xFF};
+
+    static constexpr uint8_t kFinBit = 0x80;
+    static constexpr uint8_t kCompressedBit = 0x40;     // RSV1
+    static constexpr uint8_t kReservedBits = 0x70;
+    static constexpr uint8_t kMaskBit = 0x80;
+
+    static int windowBitsInRange(int bits) {
+        if (bits < DeflateParams::kMinWindowBits)
+            return DeflateParams::kMinWindowBits;
+        if (bits > DeflateParams::kMaxWindowBits)
+            return DeflateParams::kMaxWindowBits;
+        return bits;
+    }
+
+
+#pragma mark - NEGOTIATION:
+
+
+    std::string deflateExtensionOffer(int windowBits) {
+        windowBits = windowBitsInRange(windowBits);
+        if (windowBits == DeflateParams::kMaxWindowBits)
+            return "permessage-deflate; client_max_window_bits";
+        // A server that doesn't support server_max_window_bits declines the first offer:
+        std::string bits = std::to_string(windowBits);
+        return "permessage-deflate; client_max_window_bits=" + bits
+             + "; server_max_window_bits=" + bits
+             + ", permessage-deflate; client_max_window_bits=" + bits;
+    }
+
+
+    static std::string trim(const std::string &str) {
+        size_t start = str.find_first_not_of(" \t");
+        if (start == std::string::npos)
+            return "";
+        size_t end = str.find_last_not_of(" \t");
+        return str.substr(start, end - start + 1);
+    }
+
+    // Splits the string at a separator, trimming the parts.
+    static std::vector<std::string> split(const std::string &str, char separator) {
+        std::vector<std::string> parts;
+        size_t start = 0;
+        while (true) {
+            size_t end = str.find(separator, start);
+            parts.push_back(trim(str.substr(start, end - start)));
+            if (end == std::string::npos)
+                return parts;
+            start = end + 1;
+        }
+    }
+
+    // Parses a window bits parameter value, which may be quoted. Returns 0 if it's invalid.
+    static int parseWindowBits(std::string value) {
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+            value = value.substr(1, value.size() - 2);
+        if (value.empty() || value.size() > 2 || value.find_first_not_of("0123456789") != std::string::npos)
+            return 0;
+        int bits = atoi(value.c_str());
+        return (bits >= 8 && bits <= DeflateParams::kMaxWindowBits) ? bits : 0;
+    }
+
+
+    bool parseDeflateExtensionResponse(const std::string &header, int windowBits,
+                                       DeflateParams &params)
+    {
+        std::vector<std::string> extensions = split(header, ',');
+        if (extensions.size() != 1)
+            return false;       // Only one extension was offered
+
+        std::vector<std::string> items = split(extensions[0], ';');
+        if (strcasecmp(items[0].c_str(), "permessage-deflate") != 0)
+            return false;
+
+        DeflateParams result;
+        result.level = params.level;
+        result.clientMaxWindowBits = windowBitsInRange(windowBits);
+        bool seenServerBits = false, seenClientBits = false;
+        for (size_t i = 1; i < items.size(); ++i) {
+            std::string name = items[i], value;
+            bool hasValue = false;
+            size_t eq = name.find('=');
+            if (eq != std::string::npos) {
+                value = trim(name.substr(eq + 1));
+                name = trim(name.substr(0, eq));
+                hasValue = true;
+            }
+
+            if (strcasecmp(name.c_str(), "server_no_context_takeover") == 0) {
+                if (hasValue || result.serverNoContextTakeover)
+                    return false;
+                result.serverNoContextTakeover = true;
+            } else if (strcasecmp(name.c_str(), "client_no_context_takeover") == 0) {
+                if (hasValue || result.clientNoContextTakeover)
+                    return false;
+                result.clientNoContextTakeover = true;
+            } else if (strcasecmp(name.c_str(), "server_max_window_bits") == 0) {
+                int bits = parseWindowBits(value);
+                if (bits == 0 || seenServerBits)
+                    return false;
+                result.serverMaxWindowBits = bits;
+                seenServerBits = true;
+            } else if (strcasecmp(name.c_str(), "client_max_window_bits") == 0) {
+                int bits = parseWindowBits(value);
+                if (bits == 0 || seenClientBits)
+                    return false;
+                if (bits < result.clientMaxWindowBits)
+                    result.clientMaxWindowBits = windowBitsInRange(bits);
+                seenClientBits = true;
+            } else {
+                return false;
+            }
+        }
+        params = result;
+        return true;
+    }
+
+
+#pragma mark - FRAMES:
+
+
+    struct WebSocketDeflate::Frame {
+        const uint8_t* start;               // The whole frame
+        size_t size;
+        bool fin;
+        uint8_t reserved;
+        uint8_t opcode;
+        const uint8_t* mask;                // The masking key, or null
+        const uint8_t* payload;
+        size_t payloadSize;
+
+        bool isControl() const              {return (opcode & 0x08) != 0;}
+    };
+
+    static constexpr size_t kIncompleteFrame = 0, kInvalidFrame = SIZE_MAX;
+
+    // Parses the frame at the start of the data. Returns its size, kIncompleteFrame if the data
+    // doesn't contain all of it, or kInvalidFrame if it's too large.
+    static size_t parseFrame(const uint8_t* data, size_t size, WebSocketDeflate::Frame &f) {
+        if (size < 2)
+            return kIncompleteFrame;
+        size_t headerSize = 2;
+        uint64_t length = data[1] & 0x7F;
+        if (length == 126) {
+            headerSize += 2;
+            if (size < headerSize)
+                return kIncompleteFrame;
+            length = (uint64_t(data[2]) << 8) | data[3];
+        } else if (length == 127) {
+            headerSize += 8;
+            if (size < headerSize)
+                return kIncompleteFrame;
+            length = 0;
+            for (int i = 2; i < 10; ++i)
+                length = (length << 8) | data[i];
+        }
+        if (length > kMaxPayloadSize)
+            return kInvalidFrame;
+        bool masked = (data[1] & kMaskBit) != 0;
+        if (masked)
+            headerSize += 4;
+        if (size < headerSize + length)
+            return kIncompleteFrame;
+
+        f.start = data;
+        f.size = headerSize + (size_t)length;
+        f.fin = (data[0] & kFinBit) != 0;
+        f.reserved = data[0] & kReservedBits;
+        f.opcode = data[0] & 0x0F;
+        f.mask = masked ? data + headerSize - 4 : nullptr;
+        f.payload = data + headerSize;
+        f.payloadSize = (size_t)length;
+        return f.size;
+    }
+
+    static void appendHeader(std::vector<uint8_t> &out, uint8_t firstByte, size_t length,
+                             const uint8_t* mask)
+    {
+        uint8_t maskBit = mask ? kMaskBit : 0;
+        out.push_back(firstByte);
+        if (length < 126) {
+            out.push_back(maskBit | (uint8_t)length);
+        } else if (length <= 0xFFFF) {
+            out.push_back(maskBit | 126);
+            out.push_back((uint8_t)(length >> 8));
+            out.push_back((uint8_t)length);
+        } else {
+            out.push_back(maskBit | 127);
+            for (int shift = 56; shift >= 0; shift -= 8)
+                out.push_back((uint8_t)((uint64_t)length >> shift));
+        }
+        if (mask)
+            out.insert(out.end(), mask, mask + 4);
+    }
+
+    // Masking is its own inverse, so this also unmasks.
+    static void appendPayload(std::vector<uint8_t> &out, const uint8_t* payload, size_t size,
+                              const uint8_t* mask)
+    {
+        size_t pos = out.size();
+        out.insert(out.end(), payload, payload + size);
+        if (mask) {
+            uint8_t* dst = out.data() + pos;
+            for (size_t i = 0; i < size; ++i)
+                dst[i] ^= mask[i & 3];
+        }
+    }
+
+
+#pragma mark - WEBSOCKETDEFLATE:
+
+
+    WebSocketDeflate::WebSocketDeflate(const DeflateParams &params) {
+        int level = params.level;
+        if (level < Z_NO_COMPRESSION || level > Z_BEST_COMPRESSION)
+            level = Z_DEFAULT_COMPRESSION;
+        _deflater.ok = deflateInit2(&_deflater.z, level, Z_DEFLATED,
+                                    -windowBitsInRange(params.clientMaxWindowBits),
+                                    8, Z_DEFAULT_STRATEGY) == Z_OK;
+        _deflater.noContextTakeover = params.clientNoContextTakeover;
+        _inflater.ok = inflateInit2(&_inflater.z,
+                                    -windowBitsInRange(params.serverMaxWindowBits)) == Z_OK;
+        _inflater.noContextTakeover = params.serverNoContextTakeover;
+    }
+
+    WebSocketDeflate::~WebSocketDeflate() {
+        if (_deflater.ok)
+            deflateEnd(&_deflater.z);
+        if (_inflater.ok)
+            inflateEnd(&_inflater.z);
+    }
+
+    bool WebSocketDeflate::fail(const char* message) {
+        _error = message;
+        return false;
+    }
+
+    bool WebSocketDeflate::compress(const void* data, size_t size, std::vector<uint8_t> &out) {
+        if (!_deflater.ok)
+            return fail("Couldn't initialize compression");
+        return process(_deflater, &WebSocketDeflate::compressFrame, data, size, out);
+    }
+
+    bool WebSocketDeflate::decompress(const void* data, size_t size, std::vector<uint8_t> &out) {
+        if (!_inflater.ok)
+            return fail("Couldn't initialize decompression");
+        return process(_inflater, &WebSocketDeflate::decompressFrame, data, size, out);
+    }
+
+    // Splits the data, after any incomplete frame left from the last call, into frames and
+    // calls the handler on each. Keeps the incomplete frame at the end for the next call.
+    bool WebSocketDeflate::process(Direction &dir, FrameHandler handler,
+                                   const void* data, size_t size, std::vector<uint8_t> &out)
+    {
+        dir.bytesIn += size;
+        size_t outStart = out.size();
+        auto bytes = (const uint8_t*)data;
+        bool buffered = !dir.partial.empty();
+        if (buffered) {
+            dir.partial.insert(dir.partial.end(), bytes, bytes + size);
+            bytes = dir.partial.data();
+            size = dir.partial.size();
+        }
+
+        size_t used = 0;
+        Frame frame;
+        while (used < size) {
+            size_t frameSize = parseFrame(bytes + used, size - used, frame);
+            if (frameSize == kIncompleteFrame)
+                break;
+            if (frameSize == kInvalidFrame)
+                return fail("WebSocket frame is too large");
+            if (!(this->*handler)(frame, out))
+                return false;
+            used += frameSize;
+        }
+
+        if (buffered)
+            dir.partial.erase(dir.partial.begin(), dir.partial.begin() + used);
+        else
+            dir.partial.assign(bytes + used, bytes + size);
+        dir.bytesOut += out.size() - outStart;
+        return true;
+    }
+
+
+    // Runs the data through deflate or inflate, appending the output to `_buffer`.
+    // Returns false on a zlib error, or if the output grows larger than kMaxPayloadSize.
+    template <class ZFunc>
+    static bool runZlib(z_stream &z, ZFunc zfunc, const uint8_t* data, size_t size,
+                        std::vector<uint8_t> &buffer)
+    {
+        z.next_in = (Bytef*)data;
+        z.avail_in = (uInt)size;
+        do {
+            size_t pos = buffer.size();
+            buffer.resize(pos + size + 1024);
+            z.next_out = buffer.data() + pos;
+            z.avail_out = (uInt)(buffer.size() - pos);
+            int err = zfunc(&z, Z_SYNC_FLUSH);
+            buffer.resize(buffer.size() - z.avail_out);
+            if (err == Z_STREAM_END)
+                inflateReset(&z);   // The sender ended the stream with a final block
+            else if (err == Z_BUF_ERROR)
+                break;              // No progress possible; all the output has been flushed
+            else if (err != Z_OK)
+                return false;
+            if (buffer.size() > kMaxPayloadSize)
+                return false;
+        } while (z.avail_in > 0 || z.avail_out == 0);
+        return true;
+    }
+
+    // Returns the frame's unmasked payload.
+    static const uint8_t* unmaskedPayload(const WebSocketDeflate::Frame &f,
+                                          std::vector<uint8_t> &buffer)
+    {
+        if (!f.mask)
+            return f.payload;
+        buffer.clear();
+        appendPayload(buffer, f.payload, f.payloadSize, f.mask);
+        return buffer.data();
+    }
+
+
+    bool WebSocketDeflate::compressFrame(const Frame &f, std::vector<uint8_t> &out) {
+        Direction &dir = _deflater;
+        if (f.reserved)
+            return fail("Outgoing WebSocket frame has reserved bits set");
+        if (f.isControl()) {
+            out.insert(out.end(), f.start, f.start + f.size);
+            return true;
+        }
+        if (f.opcode != 0) {
+            if (dir.inMessage)
+                return fail("Outgoing WebSocket message interrupts another");
+            dir.transforming = !f.fin || f.payloadSize >= kMinCompressSize;
+        } else if (!dir.inMessage) {
+            return fail("Unexpected outgoing WebSocket continuation frame");
+        }
+        dir.inMessage = !f.fin;
+
+        if (!dir.transforming) {
+            out.insert(out.end(), f.start, f.start + f.size);
+            return true;
+        }
+
+        _buffer.clear();
+        if (!runZlib(dir.z, deflate, unmaskedPayload(f, _payload), f.payloadSize, _buffer))
+            return fail("Compression failed");
+        if (f.fin) {
+            if (_buffer.empty()) {
+                // Nothing was flushed since the previous frame; send an empty block header,
+                // which the tail the receiver adds completes (RFC 7692, section 7.2.3.6):
+                _buffer.push_back(0x00);
+            } else {
+                if (_buffer.size() < 4 || memcmp(&_buffer[_buffer.size() - 4], kMessageTail, 4) != 0)
+                    return fail("Compression failed");
+                _buffer.resize(_buffer.size() - 4);
+            }
+            if (dir.noContextTakeover)
+                deflateReset(&dir.z);
+        }
+
+        uint8_t firstByte = (f.fin ? kFinBit : 0) | (f.opcode != 0 ? kCompressedBit : 0) | f.opcode;
+        appendHeader(out, firstByte, _buffer.size(), f.mask);
+        appendPayload(out, _buffer.data(), _buffer.size(), f.mask);
+        return true;
+    }
+
+
+    bool WebSocketDeflate::decompressFrame(const Frame &f, std::vector<uint8_t> &out) {
+        Direction &dir = _inflater;
+        if (f.reserved & ~kCompressedBit)
+            return fail("WebSocket frame has unknown reserved bits set");
+        if (f.isControl()) {
+            if (f.reserved)
+                return fail("WebSocket control frame is compressed");
+            out.insert(out.end(), f.start, f.start + f.size);
+            return true;
+        }
+        if (f.opcode != 0) {
+            if (dir.inMessage)
+                return fail("WebSocket message interrupts another");
+            dir.transforming = (f.reserved & kCompressedBit) != 0;
+        } else if (!dir.inMessage) {
+            return fail("Unexpected WebSocket continuation frame");
+        } else if (f.reserved) {
+            return fail("WebSocket continuation frame has reserved bits set");
+        }
+        dir.inMessage = !f.fin;
+
+        if (!dir.transforming) {
+            out.insert(out.end(), f.start, f.start + f.size);
+            return true;
+        }
+
+        _buffer.clear();
+        if (!runZlib(dir.z, inflate, unmaskedPayload(f, _payload), f.payloadSize, _buffer))
+            return fail("Invalid compressed WebSocket message");
+        if (f.fin) {
+            if (!runZlib(dir.z, inflate, kMessageTail, sizeof(kMessageTail), _buffer))
+                return fail("Invalid compressed WebSocket message");
+            if (dir.noContextTakeover)
+                inflateReset(&dir.z);
+        }
+
+        appendHeader(out, (f.fin ? kFinBit : 0) | f.opcode, _buffer.size(), f.mask);
+        appendPayload(out, _buffer.data(), _buffer.size(), f.mask);
+        return true;
+    }
+
+}
@@ -0,0 +1,116 @@
+//
+//  CBLWebSocketDeflate.hh
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+namespace cbl {
+
+    /** Parameters of the permessage-deflate WebSocket extension (RFC 7692). */
+    struct DeflateParams {
+        static constexpr int kMinWindowBits = 9;    // zlib's smallest raw deflate window
+        static constexpr int kMaxWindowBits = 15;
+        static constexpr int kDefaultLevel = 6;
+
+        int clientMaxWindowBits {kMaxWindowBits};   // Window of the messages the client sends
+        int serverMaxWindowBits {kMaxWindowBits};   // Window of the messages the server sends
+        bool clientNoContextTakeover {false};
+        bool serverNoContextTakeover {false};
+        int level {kDefaultLevel};                  // Compression level; not negotiated
+    };
+
+    /** Returns the Sec-WebSocket-Extensions request header value offering permessage-deflate
+        with the client's window bits. If they're less than 15 the server is asked to use the
+        same window, with a fallback offer in case it doesn't support that. */
+    std::string deflateExtensionOffer(int windowBits);
+
+    /** Parses the server's Sec-WebSocket-Extensions response header, and sets `params` to the
+        accepted parameters, limited by the client's `windowBits`. Returns false if the header
+        is invalid or names an extension that wasn't offered. */
+    bool parseDeflateExtensionResponse(const std::string &header, int windowBits,
+                                       DeflateParams &params);
+
+
+    /** Applies permessage-deflate to a WebSocket connection whose framing is done by LiteCore:
+        it rewrites the frames LiteCore sends, compressing their messages, and the frames
+        received from the server, decompressing them.
+        Frames may be split across calls; incomplete frames are kept until the rest arrives.
+        Masked frames stay masked with the same key. Control frames pass unchanged, as do
+        messages too small to be worth compressing. Not thread-safe. */
+    class WebSocketDeflate {
+    public:
+        /** Messages smaller than this are sent uncompressed. */
+        static constexpr size_t kMinCompressSize = 64;
+
+        explicit WebSocketDeflate(const DeflateParams &params);
+        ~WebSocketDeflate();
+
+        /** Compresses the messages of the outgoing frames in `data`, appending the frames to
+            `out`. Returns false on error. */
+        bool compress(const void* data, size_t size, std::vector<uint8_t> &out);
+
+        /** Decompresses the messages of the incoming frames in `data`, appending the frames to
+            `out`. Returns false if the data is invalid. */
+        bool decompress(const void* data, size_t size, std::vector<uint8_t> &out);
+
+        /** The reason the last call failed. */
+        const std::string& errorMessage() const     {return _error;}
+
+        /** Totals of the frame bytes before and after compression or decompression. */
+        uint64_t bytesCompressedIn() const          {return _deflater.bytesIn;}
+        uint64_t bytesCompressedOut() const         {return _deflater.bytesOut;}
+        uint64_t bytesDecompressedIn() const        {return _inflater.bytesIn;}
+        uint64_t bytesDecompressedOut() const       {return _inflater.bytesOut;}
+
+        struct Frame;
+
+        WebSocketDeflate(const WebSocketDeflate&) = delete;
+        WebSocketDeflate& operator=(const WebSocketDeflate&) = delete;
+
+    private:
+        // The state of one direction of the connection:
+        struct Direction {
+            z_stream z {};
+            bool ok {false};                    // True if the zlib stream is initialized
+            bool noContextTakeover {false};
+            bool inMessage {false};             // Between the first and final frame of a message
+            bool transforming {false};          // The current message is (de)compressed
+            std::vector<uint8_t> partial;       // Start of an incomplete frame
+            uint64_t bytesIn {0}, bytesOut {0};
+        };
+
+        using FrameHandler = bool (WebSocketDeflate::*)(const Frame&, std::vector<uint8_t>&);
+
+        bool process(Direction&, FrameHandler, const void* data, size_t size,
+                     std::vector<uint8_t> &out);
+        bool compressFrame(const Frame&, std::vector<uint8_t> &out);
+        bool decompressFrame(const Frame&, std::vector<uint8_t> &out);
+        bool fail(const char* message);
+
+        Direction _deflater, _inflater;
+        std::vector<uint8_t> _payload;          // Unmasked payload of the current frame
+        std::vector<uint8_t> _buffer;           // (De)compressed payload of the current frame
+        std::string _error;
+    };
+
+}
@@ -0,0 +1,204 @@
+//
+//  CBLWebSocketHandshake.cc
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include "CBLWebSocketHandshake.hh"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+namespace cbl {
+
+    // Max size of a response's status line and headers; a larger response is invalid.
+    static constexpr size_t kMaxHeadersSize = 64 * 1024;
+
+
+    std::string base64Encode(const void* data, size_t size) {
+        static const char kChars[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        auto bytes = (const uint8_t*)data;
+        std::string result;
+        result.reserve((size + 2) / 3 * 4);
+        for (size_t i = 0; i < size; i += 3) {
+            uint32_t n = bytes[i] << 16;
+            if (i + 1 < size) n |= bytes[i + 1] << 8;
+            if (i + 2 < size) n |= bytes[i + 2];
+            result += kChars[(n >> 18) & 0x3F];
+            result += kChars[(n >> 12) & 0x3F];
+            result += (i + 1 < size) ? kChars[(n >> 6) & 0x3F] : '=';
+            result += (i + 2 < size) ? kChars[n & 0x3F] : '=';
+        }
+        return result;
+    }
+
+
+#pragma mark - SHA-1:
+
+    // SHA-1 is only used for the WebSocket handshake, which isn't a security measure, so a
+    // small portable implementation is enough.
+    static void sha1(const void* data, size_t size, uint8_t digest[20]) {
+        uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+        auto rotl = [](uint32_t x, int n) {return (x << n) | (x >> (32 - n));};
+
+        // Append the padding and the length in bits:
+        std::vector<uint8_t> msg((const uint8_t*)data, (const uint8_t*)data + size);
+        msg.push_back(0x80);
+        while (msg.size() % 64 != 56)
+            msg.push_back(0);
+        uint64_t bits = (uint64_t)size * 8;
+        for (int i = 7; i >= 0; --i)
+            msg.push_back((uint8_t)(bits >> (i * 8)));
+
+        for (size_t chunk = 0; chunk < msg.size(); chunk += 64) {
+            uint32_t w[80];
+            for (int i = 0; i < 16; ++i) {
+                const uint8_t* p = &msg[chunk + 4 * i];
+                w[i] = (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+            }
+            for (int i = 16; i < 80; ++i)
+                w[i] = rotl(w[i-3] ^ w[i-8] ^ w[i-14] ^ w[i-16], 1);
+
+            uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+            for (int i = 0; i < 80; ++i) {
+                uint32_t f, k;
+                if (i < 20)      {f = (b & c) | (~b & d);           k = 0x5A827999;}
+                else if (i < 40) {f = b ^ c ^ d;                    k = 0x6ED9EBA1;}
+                else if (i < 60) {f = (b & c) | (b & d) | (c & d);  k = 0x8F1BBCDC;}
+                else             {f = b ^ c ^ d;                    k = 0xCA62C1D6;}
+                uint32_t t = rotl(a, 5) + f + e + k + w[i];
+                e = d; d = c; c = rotl(b, 30); b = a; a = t;
+            }
+            h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+        }
+        for (int i = 0; i < 5; ++i)
+            for (int j = 0; j < 4; ++j)
+                digest[4 * i + j] = (uint8_t)(h[i] >> (24 - 8 * j));
+    }
+
+
+    std::string webSocketAcceptKey(const std::string &nonceKey) {
+        std::string key = nonceKey + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+        uint8_t digest[20];
+        sha1(key.data(), key.size(), digest);
+        return base64Encode(digest, sizeof(digest));
+    }
+
+
+#pragma mark - REQUEST:
+
+    std::string webSocketUpgradeRequest(const std::string &host, uint16_t port, bool tls,
+                                        const std::string &path, const std::string &nonceKey,
+                                        const HTTPHeaders &headers)
+    {
+        std::string request = "GET " + (path.empty() ? std::string("/") : path) + " HTTP/1.1\r\n";
+        request += "Host: " + host;
+        if (port != (tls ? 443 : 80))
+            request += ":" + std::to_string(port);
+        request += "\r\n";
+        for (auto &header : headers)
+            request += header.first + ": " + header.second + "\r\n";
+        request += "Connection: Upgrade\r\n"
+                   "Upgrade: websocket\r\n"
+                   "Sec-WebSocket-Version: 13\r\n"
+                   "Sec-WebSocket-Key: " + nonceKey + "\r\n"
+                   "\r\n";
+        return request;
+    }
+
+
+#pragma mark - RESPONSE:
+
+    HTTPResponseParser::State HTTPResponseParser::parse(const void* data, size_t size,
+                                                        size_t &outUsed)
+    {
+        outUsed = 0;
+        auto chars = (const char*)data;
+        while (_state == kIncomplete && outUsed < size) {
+            auto eol = (const char*)memchr(chars + outUsed, '\n', size - outUsed);
+            size_t n = (eol ? eol + 1 - chars : size) - outUsed;
+            _line.append(chars + outUsed, n);
+            outUsed += n;
+            _totalSize += n;
+            if (_totalSize > kMaxHeadersSize) {
+                _state = kInvalid;
+            } else if (eol) {
+                _line.resize(_line.size() - 1);                 // Remove the LF...
+                if (!_line.empty() && _line.back() == '\r')
+                    _line.resize(_line.size() - 1);             // ...and the CR
+                if (!parseLine(_line))
+                    _state = kInvalid;
+                _line.clear();
+            }
+        }
+        return _state;
+    }
+
+
+    bool HTTPResponseParser::parseLine(const std::string &line) {
+        if (_status == 0) {
+            // Status line, e.g. "HTTP/1.1 101 Switching Protocols":
+            if (line.compare(0, 5, "HTTP/") != 0)
+                return false;
+            size_t space = line.find(' ');
+            if (space == std::string::npos)
+                return false;
+            char* end;
+            long status = strtol(line.c_str() + space + 1, &end, 10);
+            if (status < 100 || status > 999 || (*end != ' ' && *end != '\0'))
+                return false;
+            _status = (int)status;
+            _statusMessage = (*end == ' ') ? std::string(end + 1) : std::string();
+        } else if (line.empty()) {
+            _state = kComplete;
+        } else {
+            size_t colon = line.find(':');
+            if (colon == std::string::npos || colon == 0)
+                return false;
+            size_t start = line.find_first_not_of(" \t", colon + 1);
+            size_t end = line.find_last_not_of(" \t");
+            std::string value = (start == std::string::npos) ? std::string()
+                                                              : line.substr(start, end + 1 - start);
+            _headers.emplace_back(line.substr(0, colon), value);
+        }
+        return true;
+    }
+
+
+    const std::string* HTTPResponseParser::header(const char* name) const {
+        for (auto &header : _headers) {
+            if (strcasecmp(header.first.c_str(), name) == 0)
+                return &header.second;
+        }
+        return nullptr;
+    }
+
+
+    bool HTTPResponseParser::headerIs(const char* name, const std::string &value,
+                                      bool caseSensitive) const
+    {
+        const std::string* actual = header(name);
+        if (!actual)
+            return false;
+        else if (caseSensitive)
+            return *actual == value;
+        else
+            return strcasecmp(actual->c_str(), value.c_str()) == 0;
+    }
+
+}
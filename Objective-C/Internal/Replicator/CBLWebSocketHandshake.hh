@@ -0,0 +1,83 @@
+//
+//  CBLWebSocketHandshake.hh
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cbl {
+
+    /** HTTP header fields, in the order they appear. A name may appear more than once. */
+    using HTTPHeaders = std::vector<std::pair<std::string, std::string>>;
+
+    /** Returns the Base64 encoding of the data, with padding. */
+    std::string base64Encode(const void* data, size_t size);
+
+    /** Returns the Sec-WebSocket-Accept value the server must respond with for a
+        Sec-WebSocket-Key (RFC 6455, section 4.2.2). */
+    std::string webSocketAcceptKey(const std::string &nonceKey);
+
+    /** Returns the HTTP request that upgrades a connection to a WebSocket. The Host, Connection,
+        Upgrade, Sec-WebSocket-Version and Sec-WebSocket-Key headers are added to `headers`. */
+    std::string webSocketUpgradeRequest(const std::string &host, uint16_t port, bool tls,
+                                        const std::string &path, const std::string &nonceKey,
+                                        const HTTPHeaders &headers);
+
+    /** Incrementally parses an HTTP response's status line and headers. */
+    class HTTPResponseParser {
+    public:
+        enum State {
+            kIncomplete,                    // Needs more data
+            kComplete,                      // The headers have been parsed
+            kInvalid,                       // The response is malformed or too large
+        };
+
+        /** Parses the next bytes of the response. When the headers are complete, `outUsed` is
+            set to the number of bytes of `data` that belong to them; the rest follow the
+            response, e.g. the first WebSocket frames. */
+        State parse(const void* data, size_t size, size_t &outUsed);
+
+        State state() const                             {return _state;}
+        int status() const                              {return _status;}
+        const std::string& statusMessage() const        {return _statusMessage;}
+        const HTTPHeaders& headers() const              {return _headers;}
+
+        /** Returns the first value of a header, matching its name case-insensitively,
+            or null if it's missing. */
+        const std::string* header(const char* name) const;
+
+        /** Returns true if the header's value equals `value`, case-insensitively unless
+            `caseSensitive` is set. */
+        bool headerIs(const char* name, const std::string &value, bool caseSensitive =false) const;
+
+    private:
+        bool parseLine(const std::string &line);
+
+        State _state {kIncomplete};
+        std::string _line;                  // The current, incomplete line
+        size_t _totalSize {0};
+        int _status {0};
+        std::string _statusMessage;
+        HTTPHeaders _headers;
+    };
+
+}
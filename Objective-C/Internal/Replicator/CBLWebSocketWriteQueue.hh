@@ -0,0 +1,85 @@
+//
+//  CBLWebSocketWriteQueue.hh
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#pragma once
+#import <Foundation/Foundation.h>
+#import <vector>
+
+NS_ASSUME_NONNULL_BEGIN
+
+namespace cbl {
+
+    /** The queue of data waiting to be written to a WebSocket's output stream.
+        The queue is a ring buffer, so removing the written data doesn't move the rest. Small
+        writes at the head of the queue are gathered into one buffer, up to the gather budget,
+        and written with a single stream write instead of one write per frame.
+        Not thread-safe; used on the WebSocket's queue. */
+    class WebSocketWriteQueue {
+    public:
+        static constexpr size_t kDefaultGatherBudget = 64 * 1024;
+
+        /** A gather budget of 0 writes each buffer separately. */
+        explicit WebSocketWriteQueue(size_t gatherBudget = kDefaultGatherBudget);
+
+        /** Adds data to write. `reportedSize` is the size `write` reports once the data is
+            completely written: the size of the WebSocket frames LiteCore sent, which differs from
+            the data's if they were compressed, or 0 for other data like the HTTP request.
+            Empty data is ignored, as there's nothing to write. */
+        void push(NSData* data, size_t reportedSize);
+
+        bool empty() const                  {return _count == 0;}
+        size_t count() const                {return _count;}
+        size_t bytesQueued() const          {return _bytesQueued;}
+
+        /** Removes all the data. */
+        void clear();
+
+        /** Writes as much of the queued data as the stream accepts, up to `maxBytes`. Returns
+            the total reported size of the data completely written, and sets `outFrameBytes` to
+            its actual size, not counting data with no reported size. Sets `outBlocked` if the
+            stream didn't accept all data. */
+        size_t write(NSOutputStream* out, bool &outBlocked, size_t &outFrameBytes,
+                     size_t maxBytes = SIZE_MAX);
+
+    private:
+        struct Entry {
+            NSData* data;
+            size_t written;
+            size_t reportedSize;
+
+            size_t remaining() const        {return data.length - written;}
+            const uint8_t* next() const     {return (const uint8_t*)data.bytes + written;}
+        };
+
+        Entry& at(size_t i)                 {return _ring[(_head + i) & (_ring.size() - 1)];}
+        void grow();
+        void pop();
+        size_t gather(size_t &outEntries);
+        size_t advance(size_t nBytes, size_t &outFrameBytes);
+
+        std::vector<Entry> _ring;           // Capacity is a power of 2
+        size_t _head {0}, _count {0};
+        size_t _bytesQueued {0};
+        size_t const _gatherBudget;
+        std::vector<uint8_t> _gatherBuffer;
+    };
+
+}
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,142 @@
+//
+//  CBLWebSocketWriteQueue.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CBLWebSocketWriteQueue.hh"
+#import <algorithm>
+
+namespace cbl {
+
+    static constexpr size_t kInitialCapacity = 16;
+
+    WebSocketWriteQueue::WebSocketWriteQueue(size_t gatherBudget)
+    :_ring(kInitialCapacity)
+    ,_gatherBudget(gatherBudget)
+    { }
+
+    void WebSocketWriteQueue::push(NSData* data, size_t reportedSize) {
+        // An empty entry would never be written, so it would never be removed:
+        if (data.length == 0)
+            return;
+        if (_count == _ring.size())
+            grow();
+        at(_count) = {data, 0, reportedSize};
+        ++_count;
+        _bytesQueued += data.length;
+    }
+
+    void WebSocketWriteQueue::grow() {
+        // Unwrap the entries into a ring twice as large:
+        std::vector<Entry> ring(_ring.size() * 2);
+        for (size_t i = 0; i < _count; ++i)
+            ring[i] = std::move(at(i));
+        _ring.swap(ring);
+        _head = 0;
+    }
+
+    void WebSocketWriteQueue::pop() {
+        at(0).data = nil;
+        _head = (_head + 1) & (_ring.size() - 1);
+        --_count;
+    }
+
+    void WebSocketWriteQueue::clear() {
+        while (_count > 0)
+            pop();
+        _head = 0;
+        _bytesQueued = 0;
+    }
+
+    // Copies the remaining bytes of the entries at the head into the gather buffer, as long as
+    // they fit in the budget. Returns the number of bytes gathered.
+    size_t WebSocketWriteQueue::gather(size_t &outEntries) {
+        size_t size = 0, n = 0;
+        while (n < _count && size + at(n).remaining() <= _gatherBudget) {
+            size += at(n).remaining();
+            ++n;
+        }
+        outEntries = n;
+        if (n < 2)
+            return 0;
+
+        if (_gatherBuffer.size() < size)
+            _gatherBuffer.resize(_gatherBudget);
+        uint8_t* dst = _gatherBuffer.data();
+        for (size_t i = 0; i < n; ++i) {
+            Entry &e = at(i);
+            memcpy(dst, e.next(), e.remaining());
+            dst += e.remaining();
+        }
+        return size;
+    }
+
+    // Marks `nBytes` as written, removing the completed entries. Returns their reported size,
+    // and adds the actual size of the ones with a reported size to `outFrameBytes`.
+    size_t WebSocketWriteQueue::advance(size_t nBytes, size_t &outFrameBytes) {
+        size_t completed = 0;
+        _bytesQueued -= nBytes;
+        while (nBytes > 0) {
+            Entry &e = at(0);
+            size_t n = std::min(nBytes, e.remaining());
+            e.written += n;
+            nBytes -= n;
+            if (e.remaining() == 0) {
+                if (e.reportedSize > 0) {
+                    completed += e.reportedSize;
+                    outFrameBytes += e.data.length;
+                }
+                pop();
+            }
+        }
+        return completed;
+    }
+
+    size_t WebSocketWriteQueue::write(NSOutputStream* out, bool &outBlocked,
+                                      size_t &outFrameBytes, size_t maxBytes)
+    {
+        size_t completed = 0;
+        outBlocked = false;
+        outFrameBytes = 0;
+        while (_count > 0 && maxBytes > 0) {
+            size_t nEntries;
+            size_t size = gather(nEntries);
+            const uint8_t* bytes;
+            if (size > 0) {
+                bytes = _gatherBuffer.data();
+            } else {
+                bytes = at(0).next();
+                size = at(0).remaining();
+            }
+            size = std::min(size, maxBytes);
+
+            NSInteger nBytes = [out write: bytes maxLength: size];
+            if (nBytes <= 0) {
+                outBlocked = true;
+                break;
+            }
+            maxBytes -= (size_t)nBytes;
+            completed += advance((size_t)nBytes, outFrameBytes);
+            if ((size_t)nBytes < size) {
+                outBlocked = true;
+                break;
+            }
+        }
+        return completed;
+    }
+
+}
@@ -0,0 +1,127 @@
+//
+//  BlobIngestPerfTest.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+
+#import "BlobIngestPerfTest.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+
+static constexpr size_t kFileSize = 64 * 1024 * 1024;
+static constexpr size_t kMB = 1024 * 1024;
+
+
+@implementation BlobIngestPerfTest
+{
+    NSURL* _fileURL;
+}
+
+
+- (void) setUp {
+    [super setUp];
+    // Write a file of non-repeating bytes to make the blob from:
+    std::vector<uint8_t> chunk(kMB);
+    uint32_t x = 2463534242u;
+    NSMutableData* data = [NSMutableData dataWithCapacity: kFileSize];
+    while (data.length < kFileSize) {
+        for (auto &byte : chunk) {
+            x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+            byte = (uint8_t)x;
+        }
+        [data appendBytes: chunk.data() length: chunk.size()];
+    }
+    NSString* path = [NSTemporaryDirectory() stringByAppendingPathComponent: @"BlobIngestPerfTest.bin"];
+    _fileURL = [NSURL fileURLWithPath: path];
+    NSError* error;
+    Assert([data writeToURL: _fileURL options: 0 error: &error],
+           @"Couldn't write %@: %@", path, error);
+}
+
+
+- (void) test {
+    NSLog(@"--- Saving documents with a %zu MB file blob ---", kFileSize / kMB);
+    for (size_t bufferSize : {(size_t)8 * 1024, (size_t)64 * 1024, kMB, 4 * kMB}) {
+        NSLog(@"--- Blob buffer size %zu KB ---", bufferSize / 1024);
+        CBLDatabaseConfiguration* config = [[CBLDatabaseConfiguration alloc] init];
+        config.directory = self.db.config.directory;
+        config.blobBufferSize = bufferSize;
+        NSError* error;
+        CBLDatabase* db = [[CBLDatabase alloc] initWithName: @"blobingest" config: config error: &error];
+        Assert(db, @"Couldn't open db: %@", error);
+        CBLCollection* collection = [db defaultCollection: &error];
+        Assert(collection, @"Couldn't get the default collection: %@", error);
+
+        __block double seconds = 0, maxStall = 0;
+        __block int runs = 0;
+        [self measureAtScale: kFileSize / kMB unit: @"MB" block:^{
+            double stall;
+            seconds += [self saveBlobInCollection: collection writerStall: &stall];
+            maxStall = std::max(maxStall, stall);
+            ++runs;
+        }];
+        NSLog(@"Saving %.1f MB/s; concurrent writer stalled up to %.1f ms",
+              runs * kFileSize / seconds / 1.0e6, maxStall * 1.0e3);
+
+        Assert([db delete: &error], @"Couldn't delete db: %@", error);
+    }
+    [[NSFileManager defaultManager] removeItemAtURL: _fileURL error: nullptr];
+}
+
+
+// Saves a document with a blob of the file, while another thread keeps saving small documents.
+// Returns the time the save took, and the longest time one of the small saves took.
+- (double) saveBlobInCollection: (CBLCollection*)collection writerStall: (double*)outStall {
+    std::atomic<bool> stop {false};
+    double stall = 0;
+    std::thread writer([&] {
+        NSUInteger n = 0;
+        while (!stop) {
+            @autoreleasepool {
+                CBLMutableDocument* doc = [[CBLMutableDocument alloc] init];
+                [doc setInteger: (NSInteger)++n forKey: @"n"];
+                auto start = steady_clock::now();
+                NSError* error;
+                Assert([collection saveDocument: doc error: &error], @"Save failed: %@", error);
+                stall = std::max(stall, duration<double>(steady_clock::now() - start).count());
+            }
+        }
+    });
+
+    NSError* error;
+    CBLBlob* blob = [[CBLBlob alloc] initWithContentType: @"application/octet-stream"
+                                                 fileURL: _fileURL error: &error];
+    Assert(blob, @"Couldn't create blob: %@", error);
+    CBLMutableDocument* doc = [[CBLMutableDocument alloc] init];
+    [doc setBlob: blob forKey: @"video"];
+    auto start = steady_clock::now();
+    Assert([collection saveDocument: doc error: &error], @"Save failed: %@", error);
+    double seconds = duration<double>(steady_clock::now() - start).count();
+    Assert(blob.length == kFileSize, @"Wrong blob length %llu", blob.length);
+
+    stop = true;
+    writer.join();
+    *outStall = stall;
+    return seconds;
+}
+
+@end
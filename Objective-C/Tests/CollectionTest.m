@@ -819,6 +819,57 @@
     AssertEqual(changeListenerFired, 0);
 }
 
+- (void) testCollectionDocumentChangeListenerManyDocuments {
+    NSError* error = nil;
+    CBLCollection* col = [self.db createCollectionWithName: @"colA" scope: @"scopeA" error: &error];
+    AssertNotNil(col);
+    
+    const NSInteger kNumDocs = 100;
+    dispatch_queue_t queue = dispatch_queue_create("doc-change-listeners", DISPATCH_QUEUE_SERIAL);
+    NSMutableDictionary<NSString*, NSNumber*>* counts = [NSMutableDictionary dictionary];
+    NSMutableArray* tokens = [NSMutableArray array];
+    XCTestExpectation* exp1 = [self expectationWithDescription: @"doc change listeners"];
+    exp1.expectedFulfillmentCount = kNumDocs;
+    XCTestExpectation* exp2 = [self expectationWithDescription: @"remaining doc change listeners"];
+    exp2.expectedFulfillmentCount = kNumDocs / 2;
+    for (NSInteger i = 0; i < kNumDocs; i++) {
+        NSString* docID = [NSString stringWithFormat: @"doc%ld", (long)i];
+        id token = [col addDocumentChangeListenerWithID: docID queue: queue
+                                               listener: ^(CBLDocumentChange* change)
+        {
+            AssertEqualObjects(change.documentID, docID);
+            NSInteger count = counts[docID].integerValue + 1;
+            counts[docID] = @(count);
+            if (count == 2)
+                [exp1 fulfill];
+            else if (count == 3)
+                [exp2 fulfill];
+        }];
+        [tokens addObject: token];
+    }
+    
+    // Each document is saved twice; the documents without listeners are ignored:
+    [self createDocNumbered: col start: 0 num: kNumDocs + 10];
+    [self createDocNumbered: col start: 0 num: kNumDocs];
+    [self waitForExpectations: @[exp1] timeout: kExpTimeout];
+    
+    // Remove every other listener and save all documents again:
+    for (NSInteger i = 0; i < kNumDocs; i += 2)
+        [tokens[i] remove];
+    [self createDocNumbered: col start: 0 num: kNumDocs];
+    [self waitForExpectations: @[exp2] timeout: kExpTimeout];
+    
+    dispatch_sync(queue, ^{
+        for (NSInteger i = 0; i < kNumDocs; i++) {
+            NSString* docID = [NSString stringWithFormat: @"doc%ld", (long)i];
+            AssertEqual(counts[docID].integerValue, (i % 2 == 0) ? 2 : 3);
+        }
+    });
+    
+    for (NSInteger i = 1; i < kNumDocs; i += 2)
+        [tokens[i] remove];
+}
+
 /** Test that there is no collection or c4 object leak when the listener token is not removed.
     The actual check for the object leak is in the test's tear down. */
 - (void) testCollectionDocumentChangeListenerWithoutRemoveToken {
@@ -840,6 +891,96 @@
     }
 }
 
+- (void) testCollectionChangeListenerWithOptions {
+    NSError* error = nil;
+    CBLCollection* col = [self.db createCollectionWithName: @"colA" scope: @"scopeA" error: &error];
+    AssertNotNil(col);
+    
+    CBLCollectionChangeListenerOptions* options = [[CBLCollectionChangeListenerOptions alloc] init];
+    options.maxBatchSize = 4;
+    options.maxDelay = 0.5;
+    
+    XCTestExpectation* exp = [self expectationWithDescription: @"change listener"];
+    dispatch_queue_t queue = dispatch_queue_create("change-listener-options", DISPATCH_QUEUE_SERIAL);
+    NSMutableArray<NSNumber*>* batchSizes = [NSMutableArray array];
+    NSMutableArray<NSString*>* docIDs = [NSMutableArray array];
+    id token = [col addChangeListenerWithQueue: queue options: options listener: ^(CBLCollectionChange* change) {
+        AssertEqual(change.count, change.documentIDs.count);
+        AssertEqual(change.sequences.count, change.documentIDs.count);
+        [batchSizes addObject: @(change.count)];
+        [docIDs addObjectsFromArray: change.documentIDs];
+        if (docIDs.count == 10)
+            [exp fulfill];
+    }];
+    
+    // One change of 10 docs is split into batches of at most 4 docs:
+    [self.db inBatch: &error usingBlock: ^{
+        [self createDocNumbered: col start: 0 num: 10];
+    }];
+    [self waitForExpectations: @[exp] timeout: kExpTimeout];
+    
+    dispatch_sync(queue, ^{
+        AssertEqualObjects(batchSizes, (@[@4, @4, @2]));
+        AssertEqual([NSSet setWithArray: docIDs].count, 10u);
+    });
+    [token remove];
+}
+
+#pragma mark - Change Feed
+
+- (void) testCollectionChangeCursor {
+    NSError* error = nil;
+    CBLCollection* col = [self.db createCollectionWithName: @"colA" scope: @"scopeA" error: &error];
+    AssertNotNil(col);
+    [self createDocNumbered: col start: 0 num: 10];
+    
+    CBLCollectionChangeCursor* cursor = [col changesSinceSequence: 0 limit: 4 error: &error];
+    AssertNotNil(cursor);
+    NSMutableArray<NSString*>* docIDs = [NSMutableArray array];
+    NSMutableArray<NSNumber*>* batchSizes = [NSMutableArray array];
+    uint64_t lastSequence = 0;
+    NSArray<CBLChangedDocument*>* batch;
+    do {
+        batch = [cursor nextBatch: &error];
+        AssertNotNil(batch);
+        [batchSizes addObject: @(batch.count)];
+        for (CBLChangedDocument* change in batch) {
+            Assert(change.sequence > lastSequence);
+            lastSequence = change.sequence;
+            AssertNotNil(change.revisionID);
+            AssertEqual(change.flags, 0u);
+            [docIDs addObject: change.documentID];
+        }
+    } while (batch.count > 0);
+    AssertEqualObjects(batchSizes, (@[@4, @4, @2, @0]));
+    AssertEqual(docIDs.count, 10u);
+    AssertEqual(cursor.lastSequence, lastSequence);
+    
+    // The cursor sees the changes made after it's been caught up:
+    CBLMutableDocument* doc = [[col documentWithID: @"doc3" error: &error] toMutable];
+    [doc setString: @"updated" forKey: @"key"];
+    Assert([col saveDocument: doc error: &error]);
+    batch = [cursor nextBatch: &error];
+    AssertEqual(batch.count, 1u);
+    AssertEqualObjects(batch[0].documentID, @"doc3");
+    
+    // Resume from a persisted sequence with a new cursor, deleted docs are included:
+    uint64_t persisted = cursor.lastSequence;
+    Assert([col deleteDocument: [col documentWithID: @"doc5" error: &error] error: &error]);
+    cursor = [col changesSinceSequence: persisted limit: 100 error: &error];
+    batch = [cursor nextBatch: &error];
+    AssertEqual(batch.count, 1u);
+    AssertEqualObjects(batch[0].documentID, @"doc5");
+    AssertEqual(batch[0].flags, kCBLDocumentFlagsDeleted);
+    Assert(batch[0].sequence > persisted);
+    
+    // Invalid collection:
+    Assert([self.db deleteCollectionWithName: @"colA" scope: @"scopeA" error: &error]);
+    [self expectError: CBLErrorDomain code: CBLErrorNotOpen in: ^BOOL(NSError** err) {
+        return [cursor nextBatch: err] != nil;
+    }];
+}
+
 #pragma mark - 8.5-6 Use collection APIs on deleted/closed scenarios
 
 - (void) testUseCollectionAPIOnDeletedCollection {
@@ -0,0 +1,113 @@
+//
+//  ConflictPerfTest.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "ConflictPerfTest.h"
+#import "Benchmark.hh"
+
+static constexpr unsigned kNumDocs = 5000;
+static constexpr int kReps = 5;
+
+
+@implementation ConflictPerfTest
+
+
+- (void) test {
+#ifdef COUCHBASE_ENTERPRISE
+    NSLog(@"--- Resolving %u conflicts pulled from a local database ---", kNumDocs);
+    Benchmark b;
+    for (int i = 0; i < kReps; i++) {
+        [self eraseDB];
+        CBLDatabase* otherDB = [self createConflicts];
+        b.start();
+        [self pullFrom: otherDB];
+        double t = b.stop();
+        fprintf(stderr, "%.03g  ", t);
+        
+        NSError* error;
+        Assert([otherDB delete: &error], @"Couldn't delete other db: %@", error);
+    }
+    fprintf(stderr, "\n");
+    b.printReport();
+    b.printReport(1.0/kNumDocs, "conflict");
+#else
+    NSLog(@"--- Skipped: requires CBLDatabaseEndpoint (Enterprise Edition) ---");
+#endif
+}
+
+
+#ifdef COUCHBASE_ENTERPRISE
+
+// Saves a different revision of the same documents in the local and other database:
+- (CBLDatabase*) createConflicts {
+    NSError* error;
+    CBLDatabaseConfiguration* config = [[CBLDatabaseConfiguration alloc] init];
+    config.directory = self.db.config.directory;
+    [CBLDatabase deleteDatabase: @"perfdb-other" inDirectory: config.directory error: nil];
+    CBLDatabase* otherDB = [[CBLDatabase alloc] initWithName: @"perfdb-other" config: config error: &error];
+    Assert(otherDB, @"Couldn't open other db: %@", error);
+    
+    for (CBLDatabase* db in @[self.db, otherDB]) {
+        CBLCollection* collection = [db defaultCollection: &error];
+        Assert(collection);
+        BOOL ok = [db inBatch: &error usingBlock: ^{
+            for (unsigned i = 0; i < kNumDocs; i++) {
+                @autoreleasepool {
+                    NSString* docID = [NSString stringWithFormat: @"doc-%u", i];
+                    CBLMutableDocument* doc = [CBLMutableDocument documentWithID: docID];
+                    [doc setValue: db.name forKey: @"db"];
+                    [doc setValue: @(i) forKey: @"count"];
+                    NSError* error2;
+                    Assert([collection saveDocument: doc error: &error2], @"Save failed: %@", error2);
+                }
+            }
+        }];
+        Assert(ok, @"Couldn't create docs: %@", error);
+    }
+    return otherDB;
+}
+
+
+// Runs a one-shot pull until the replicator has stopped, which it doesn't until all the
+// conflicts have been resolved:
+- (void) pullFrom: (CBLDatabase*)otherDB {
+    NSError* error;
+    CBLCollection* collection = [self.db defaultCollection: &error];
+    CBLDatabaseEndpoint* target = [[CBLDatabaseEndpoint alloc] initWithDatabase: otherDB];
+    CBLCollectionConfiguration* colConfig = [[CBLCollectionConfiguration alloc] initWithCollection: collection];
+    CBLReplicatorConfiguration* config =
+        [[CBLReplicatorConfiguration alloc] initWithCollections: @[colConfig] target: target];
+    config.replicatorType = kCBLReplicatorTypePull;
+    
+    CBLReplicator* replicator = [[CBLReplicator alloc] initWithConfig: config];
+    dispatch_semaphore_t stopped = dispatch_semaphore_create(0);
+    id token = [replicator addChangeListener: ^(CBLReplicatorChange* change) {
+        if (change.status.activity == kCBLReplicatorStopped) {
+            Assert(!change.status.error, @"Replication failed: %@", change.status.error);
+            dispatch_semaphore_signal(stopped);
+        }
+    }];
+    [replicator start];
+    dispatch_semaphore_wait(stopped, DISPATCH_TIME_FOREVER);
+    [token remove];
+    Assert(collection.count == kNumDocs);
+}
+
+#endif
+
+@end
@@ -23,6 +23,58 @@
 #define kDocumentTestDate @"2017-01-01T00:00:00.000Z"
 #define kDocumentTestBlob @"i'm blob"
 
+// Delivers its data a few KB at a time, after a delay, and tells when it's first read.
+@interface SlowInputStream : NSInputStream
+- (instancetype) initWithData: (NSData*)data readDelay: (NSTimeInterval)delay;
+@property (nonatomic, copy) void (^onFirstRead)(void);
+@property (atomic) NSUInteger offset;          // The number of bytes read
+@end
+
+@implementation SlowInputStream {
+    NSData* _data;
+    NSTimeInterval _delay;
+    NSStreamStatus _status;
+}
+
+@synthesize onFirstRead=_onFirstRead, offset=_offset;
+
+- (instancetype) initWithData: (NSData*)data readDelay: (NSTimeInterval)delay {
+    self = [super init];
+    if (self) {
+        _data = data;
+        _delay = delay;
+        _status = NSStreamStatusNotOpen;
+    }
+    return self;
+}
+
+- (void) open                       {_status = NSStreamStatusOpen;}
+- (void) close                      {_status = NSStreamStatusClosed;}
+- (NSStreamStatus) streamStatus     {return _status;}
+- (NSError*) streamError            {return nil;}
+- (BOOL) hasBytesAvailable          {return self.offset < _data.length;}
+
+- (BOOL) getBuffer: (uint8_t**)buffer length: (NSUInteger*)len {
+    return NO;
+}
+
+- (NSInteger) read: (uint8_t*)buffer maxLength: (NSUInteger)len {
+    if (_onFirstRead) {
+        _onFirstRead();
+        _onFirstRead = nil;
+    }
+    [NSThread sleepForTimeInterval: _delay];
+    NSUInteger offset = self.offset;
+    NSUInteger n = MIN(MIN(len, (NSUInteger)4096), _data.length - offset);
+    memcpy(buffer, (const uint8_t*)_data.bytes + offset, n);
+    self.offset = offset + n;
+    if (offset + n == _data.length)
+        _status = NSStreamStatusAtEnd;
+    return (NSInteger)n;
+}
+
+@end
+
 @interface DocumentTest : CBLTestCase
 
 @end
@@ -1747,6 +1799,115 @@
     }
 }
 
+- (void) testBlobStreamWithBufferSize {
+    // Content spanning several buffers, with a partial last buffer:
+    NSMutableData* content = [NSMutableData dataWithLength: 100 * 1024 + 7];
+    uint8_t* bytes = (uint8_t*)content.mutableBytes;
+    for (NSUInteger i = 0; i < content.length; ++i)
+        bytes[i] = (uint8_t)(i * 31);
+    
+    CBLDatabaseConfiguration* config = [[CBLDatabaseConfiguration alloc] init];
+    AssertEqual(config.blobBufferSize, 0u);
+    config.directory = self.directory;
+    config.blobBufferSize = 1;          // Raised to the minimum size
+    NSError* error;
+    CBLDatabase* db = [[CBLDatabase alloc] initWithName: @"blobbufferdb" config: config error: &error];
+    AssertNotNil(db, @"Couldn't open db: %@", error);
+    AssertEqual(db.config.blobBufferSize, 1u);
+    CBLCollection* collection = [db defaultCollection: &error];
+    AssertNotNil(collection, @"Couldn't get the default collection: %@", error);
+    
+    // Blobs nested in a dictionary and an array are installed before the document is saved:
+    CBLBlob* blob1 = [[CBLBlob alloc] initWithContentType: @"application/octet-stream"
+                                            contentStream: [NSInputStream inputStreamWithData: content]];
+    CBLBlob* blob2 = [[CBLBlob alloc] initWithContentType: @"application/octet-stream"
+                                                     data: content];
+    CBLMutableDocument* doc = [self createDocument: @"doc1"];
+    [doc setValue: @{@"blob": blob1} forKey: @"dict"];
+    [doc setValue: @[blob2] forKey: @"array"];
+    Assert([collection saveDocument: doc error: &error], @"Saving error: %@", error);
+    AssertEqual(blob1.length, content.length);
+    AssertNotNil(blob1.digest);
+    AssertEqualObjects(blob1.digest, blob2.digest);
+    
+    CBLDocument* savedDoc = [collection documentWithID: doc.id error: &error];
+    CBLBlob* savedBlob1 = [[savedDoc dictionaryForKey: @"dict"] blobForKey: @"blob"];
+    CBLBlob* savedBlob2 = [[savedDoc arrayForKey: @"array"] blobAtIndex: 0];
+    AssertEqual(savedBlob1.length, content.length);
+    AssertEqualObjects(savedBlob1.content, content);
+    AssertEqualObjects(savedBlob2.content, content);
+    
+    // Changing the configuration doesn't change the database's:
+    config.blobBufferSize = 4 * 1024 * 1024;
+    AssertEqual(db.config.blobBufferSize, 1u);
+    [self expectException: @"NSInternalInconsistencyException" in: ^{
+        db.config.blobBufferSize = 0;
+    }];
+    [self closeDatabase: db];
+}
+
+- (void) testCloseWaitsForBlobInstall {
+    NSError* error;
+    CBLDatabaseConfiguration* config = [[CBLDatabaseConfiguration alloc] init];
+    config.directory = self.directory;
+    CBLDatabase* db = [[CBLDatabase alloc] initWithName: @"blobclosedb" config: config error: &error];
+    AssertNotNil(db, @"Couldn't open db: %@", error);
+    CBLCollection* collection = [db defaultCollection: &error];
+    AssertNotNil(collection, @"Couldn't get the default collection: %@", error);
+    
+    // A blob whose content takes about half a second to read:
+    NSMutableData* content = [NSMutableData dataWithLength: 400 * 1024];
+    SlowInputStream* stream = [[SlowInputStream alloc] initWithData: content readDelay: 0.005];
+    dispatch_semaphore_t reading = dispatch_semaphore_create(0);
+    stream.onFirstRead = ^{
+        dispatch_semaphore_signal(reading);
+    };
+    CBLMutableDocument* doc = [self createDocument: @"doc1"];
+    [doc setBlob: [[CBLBlob alloc] initWithContentType: @"application/octet-stream"
+                                         contentStream: stream]
+          forKey: @"blob"];
+    
+    XCTestExpectation* x = [self expectationWithDescription: @"Saved"];
+    __block BOOL saved = NO;
+    __block NSError* saveError;
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        NSError* err;
+        saved = [collection saveDocument: doc error: &err];
+        saveError = err;
+        [x fulfill];
+    });
+    
+    // Closing waits for the blob to be copied into the blob store:
+    AssertEqual(dispatch_semaphore_wait(reading, dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC)), 0);
+    Assert([db close: &error], @"Couldn't close db: %@", error);
+    AssertEqual(stream.offset, content.length);
+    
+    // The save itself may come after the close:
+    [self waitForExpectations: @[x] timeout: kExpTimeout];
+    if (!saved)
+        AssertEqual(saveError.code, CBLErrorNotOpen);
+}
+
+- (void) testSaveBlobInClosedDatabase {
+    NSError* error;
+    CBLDatabaseConfiguration* config = [[CBLDatabaseConfiguration alloc] init];
+    config.directory = self.directory;
+    CBLDatabase* db = [[CBLDatabase alloc] initWithName: @"blobcloseddb" config: config error: &error];
+    AssertNotNil(db, @"Couldn't open db: %@", error);
+    CBLCollection* collection = [db defaultCollection: &error];
+    AssertNotNil(collection, @"Couldn't get the default collection: %@", error);
+    [self closeDatabase: db];
+    
+    // The usual error, rather than an exception from installing the blob:
+    NSData* content = [kDocumentTestBlob dataUsingEncoding: NSUTF8StringEncoding];
+    CBLMutableDocument* doc = [self createDocument: @"doc1"];
+    [doc setBlob: [[CBLBlob alloc] initWithContentType: @"text/plain"
+                                         contentStream: [NSInputStream inputStreamWithData: content]]
+          forKey: @"blob"];
+    AssertFalse([collection saveDocument: doc error: &error]);
+    AssertEqual(error.code, CBLErrorNotOpen);
+}
+
 - (void)testMultipleBlobRead {
     NSData* content = [kDocumentTestBlob dataUsingEncoding:NSUTF8StringEncoding];
     NSError *error;
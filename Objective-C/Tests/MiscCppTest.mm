@@ -26,11 +26,50 @@
 #endif
 
 #import "CBLStatus.h"
+#import "CBLReceiveWindow.hh"
+#import "CBLWebSocketHandshake.hh"
+#import "CBLWebSocketDeflate.hh"
+#import "CBLHostAddressCache.hh"
+#import "CBLSocketOptions.hh"
+#import "CBLTokenBucket.hh"
+#import "CBLWebSocketWriteQueue.hh"
+#import <netinet/in.h>
+#import <netinet/tcp.h>
 
 @interface MiscCppTest : CBLTestCase
 
 @end
 
+// An output stream that accepts a limited number of bytes, like a socket with a full buffer.
+@interface LimitedOutputStream : NSOutputStream
+@property (nonatomic) NSUInteger capacity;
+@property (readonly, nonatomic) NSMutableData* written;
+@end
+
+@implementation LimitedOutputStream
+
+@synthesize capacity=_capacity, written=_written;
+
+- (instancetype) init {
+    self = [super init];
+    if (self)
+        _written = [NSMutableData data];
+    return self;
+}
+
+- (NSInteger) write: (const uint8_t*)buffer maxLength: (NSUInteger)len {
+    NSUInteger n = MIN(len, _capacity);
+    [_written appendBytes: buffer length: n];
+    _capacity -= n;
+    return (NSInteger)n;
+}
+
+- (BOOL) hasSpaceAvailable {
+    return _capacity > 0;
+}
+
+@end
+
 @implementation MiscCppTest
 
 #pragma mark - CBLStatus
@@ -103,4 +142,389 @@
     AssertEqual(c4Error.domain, FleeceDomain);
 }
 
+#pragma mark - ReceiveWindow
+
+static constexpr uint64_t kMillisecond = 1000000;
+
+- (void) testReceiveWindowBounds {
+    cbl::ReceiveWindow window;
+    AssertEqual(window.minSize(), cbl::ReceiveWindow::kDefaultMinSize);
+    AssertEqual(window.maxSize(), cbl::ReceiveWindow::kDefaultMaxSize);
+    AssertEqual(window.size(), cbl::ReceiveWindow::kInitialSize);
+    
+    cbl::ReceiveWindow small(8 * 1024, 32 * 1024);
+    AssertEqual(small.size(), 32u * 1024);
+    AssertEqual(small.readSize(), 8u * 1024);
+    
+    cbl::ReceiveWindow fixed(64 * 1024, 1024);
+    AssertEqual(fixed.maxSize(), 64u * 1024);
+    AssertEqual(fixed.size(), 64u * 1024);
+}
+
+- (void) testReceiveWindowThrottle {
+    cbl::ReceiveWindow window(0, 64 * 1024);
+    window.received(60 * 1024);
+    AssertFalse(window.throttled());
+    window.received(8 * 1024);
+    Assert(window.throttled());
+    window.consumed(8 * 1024, 1);
+    AssertFalse(window.throttled());
+    AssertEqual(window.pending(), 60u * 1024);
+}
+
+- (void) testReceiveWindowAdapts {
+    // A fast consumer on a long link grows the window to twice the bandwidth-delay product:
+    cbl::ReceiveWindow window;
+    window.setRTT(200 * kMillisecond);
+    uint64_t now = 1;
+    window.consumed(0, now);
+    for (int i = 0; i < 50; i++) {
+        now += 100 * kMillisecond;
+        window.received(500 * 1024);
+        window.consumed(500 * 1024, now);
+    }
+    // 500KB per 100ms * 200ms * 2:
+    AssertEqual(window.size(), 2u * 500 * 1024 * 2);
+    AssertEqual(window.readSize(), cbl::ReceiveWindow::kMaxReadSize);
+    
+    // A slow consumer on a short link shrinks it down to the minimum:
+    window.setRTT(10 * kMillisecond);
+    for (int i = 0; i < 50; i++) {
+        now += 100 * kMillisecond;
+        window.received(1024);
+        window.consumed(1024, now);
+    }
+    AssertEqual(window.size(), cbl::ReceiveWindow::kDefaultMinSize);
+    AssertEqual(window.readSize(), cbl::ReceiveWindow::kMinReadSize);
+}
+
+#pragma mark - WebSocket Handshake
+
+- (void) testWebSocketAcceptKey {
+    // The example from RFC 6455:
+    std::string accept = cbl::webSocketAcceptKey("dGhlIHNhbXBsZSBub25jZQ==");
+    Assert(accept == "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+    
+    Assert(cbl::base64Encode("f", 1) == "Zg==");
+    Assert(cbl::base64Encode("fo", 2) == "Zm8=");
+    Assert(cbl::base64Encode("foo", 3) == "Zm9v");
+}
+
+- (void) testWebSocketUpgradeRequest {
+    std::string request = cbl::webSocketUpgradeRequest("example.com", 4984, false, "/db/_blipsync",
+                                                       "KEY", {{"User-Agent", "CBL"}});
+    Assert(request == "GET /db/_blipsync HTTP/1.1\r\n"
+                      "Host: example.com:4984\r\n"
+                      "User-Agent: CBL\r\n"
+                      "Connection: Upgrade\r\n"
+                      "Upgrade: websocket\r\n"
+                      "Sec-WebSocket-Version: 13\r\n"
+                      "Sec-WebSocket-Key: KEY\r\n\r\n");
+    
+    request = cbl::webSocketUpgradeRequest("example.com", 443, true, "", "KEY", {});
+    Assert(request.find("GET / HTTP/1.1\r\nHost: example.com\r\n") == 0);
+}
+
+- (void) testHTTPResponseParser {
+    // The response arrives in two parts, the second followed by a WebSocket frame:
+    const char* part1 = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConn";
+    const char* part2 = "ection: Upgrade\r\nSet-Cookie: a=1\r\nSet-Cookie: b=2\r\n\r\nFRAME";
+    
+    cbl::HTTPResponseParser parser;
+    size_t used;
+    AssertEqual(parser.parse(part1, strlen(part1), used), cbl::HTTPResponseParser::kIncomplete);
+    AssertEqual(used, strlen(part1));
+    AssertEqual(parser.parse(part2, strlen(part2), used), cbl::HTTPResponseParser::kComplete);
+    AssertEqual(used, strlen(part2) - strlen("FRAME"));
+    
+    AssertEqual(parser.status(), 101);
+    Assert(parser.statusMessage() == "Switching Protocols");
+    AssertEqual(parser.headers().size(), 4u);
+    Assert(parser.headerIs("connection", "upgrade"));
+    AssertFalse(parser.headerIs("Upgrade", "WebSocket", true));
+    Assert(*parser.header("set-cookie") == "a=1");
+    Assert(parser.header("Sec-WebSocket-Accept") == nullptr);
+    
+    cbl::HTTPResponseParser invalid;
+    AssertEqual(invalid.parse("FOO 200\r\n", 9, used), cbl::HTTPResponseParser::kInvalid);
+}
+
+#pragma mark - WebSocket Compression
+
+// Appends a WebSocket frame with the payload, masked if `mask` is given.
+static void appendFrame(std::vector<uint8_t> &out, uint8_t opcode, bool fin,
+                        const std::string &payload, const uint8_t* mask = nullptr)
+{
+    out.push_back((fin ? 0x80 : 0) | opcode);
+    uint8_t maskBit = mask ? 0x80 : 0;
+    if (payload.size() < 126) {
+        out.push_back(maskBit | (uint8_t)payload.size());
+    } else {
+        out.push_back(maskBit | 126);
+        out.push_back((uint8_t)(payload.size() >> 8));
+        out.push_back((uint8_t)payload.size());
+    }
+    if (mask)
+        out.insert(out.end(), mask, mask + 4);
+    for (size_t i = 0; i < payload.size(); ++i)
+        out.push_back(payload[i] ^ (mask ? mask[i & 3] : 0));
+}
+
+- (void) testDeflateExtensionNegotiation {
+    Assert(cbl::deflateExtensionOffer(15) == "permessage-deflate; client_max_window_bits");
+    Assert(cbl::deflateExtensionOffer(10) == "permessage-deflate; client_max_window_bits=10; "
+           "server_max_window_bits=10, permessage-deflate; client_max_window_bits=10");
+    
+    cbl::DeflateParams params;
+    Assert(cbl::parseDeflateExtensionResponse("permessage-deflate", 12, params));
+    AssertEqual(params.clientMaxWindowBits, 12);
+    AssertEqual(params.serverMaxWindowBits, 15);
+    
+    Assert(cbl::parseDeflateExtensionResponse("permessage-deflate; client_max_window_bits=10; "
+                                              "server_max_window_bits=\"11\"; "
+                                              "server_no_context_takeover", 15, params));
+    AssertEqual(params.clientMaxWindowBits, 10);
+    AssertEqual(params.serverMaxWindowBits, 11);
+    Assert(params.serverNoContextTakeover);
+    AssertFalse(params.clientNoContextTakeover);
+    
+    // Extensions that weren't offered, and invalid parameters:
+    AssertFalse(cbl::parseDeflateExtensionResponse("x-webkit-deflate-frame", 15, params));
+    AssertFalse(cbl::parseDeflateExtensionResponse("permessage-deflate, permessage-deflate",
+                                                   15, params));
+    AssertFalse(cbl::parseDeflateExtensionResponse("permessage-deflate; client_max_window_bits",
+                                                   15, params));
+    AssertFalse(cbl::parseDeflateExtensionResponse("permessage-deflate; server_max_window_bits=16",
+                                                   15, params));
+    AssertFalse(cbl::parseDeflateExtensionResponse("permessage-deflate; foo", 15, params));
+}
+
+- (void) testWebSocketDeflate {
+    std::string body;
+    for (int i = 0; i < 200; ++i)
+        body += "{\"_id\":\"doc-" + std::to_string(i) + "\",\"type\":\"reading\",\"value\":42},";
+    const uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+    
+    std::vector<uint8_t> frames;
+    appendFrame(frames, 0x2, true, body, mask);                 // Compressed
+    appendFrame(frames, 0x9, true, "ping", mask);               // Control frame, unchanged
+    appendFrame(frames, 0x2, true, "tiny", mask);               // Too small to compress
+    appendFrame(frames, 0x1, false, body.substr(0, 1000), mask);  // Fragmented message
+    appendFrame(frames, 0x0, false, body.substr(1000, 10), mask);
+    appendFrame(frames, 0x0, true, "", mask);
+    appendFrame(frames, 0x2, true, body, mask);                 // Uses the previous context
+    
+    for (int noContextTakeover = 0; noContextTakeover <= 1; ++noContextTakeover) {
+        cbl::DeflateParams params;
+        params.clientNoContextTakeover = params.serverNoContextTakeover = noContextTakeover;
+        cbl::WebSocketDeflate client(params), server(params);
+        
+        // Split the data at arbitrary points, so frames arrive in pieces:
+        std::vector<uint8_t> wire, result;
+        for (size_t i = 0; i < frames.size(); i += 100)
+            Assert(client.compress(&frames[i], std::min<size_t>(100, frames.size() - i), wire));
+        Assert(wire.size() < frames.size() / 4);
+        AssertEqual(wire[0], 0xC2);                             // FIN + RSV1 + binary
+        for (size_t i = 0; i < wire.size(); i += 7)
+            Assert(server.decompress(&wire[i], std::min<size_t>(7, wire.size() - i), result));
+        Assert(result == frames);
+        AssertEqual(client.bytesCompressedIn(), frames.size());
+        AssertEqual(server.bytesDecompressedOut(), frames.size());
+    }
+    
+    // A compressed message with invalid data:
+    cbl::WebSocketDeflate deflate({});
+    std::vector<uint8_t> invalid = {0xC2, 0x04, 0xFF, 0xFF, 0xFF, 0xFF}, result;
+    AssertFalse(deflate.decompress(invalid.data(), invalid.size(), result));
+    Assert(deflate.errorMessage() == "Invalid compressed WebSocket message");
+}
+
+
+#pragma mark - HostAddressCache
+
+- (void) testHostAddressCache {
+    const uint64_t kSecond = 1000000000;
+    cbl::HostAddressCache::Address address {};
+    auto addrIn = (sockaddr_in*)&address.storage;
+    addrIn->sin_family = AF_INET;
+    addrIn->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.length = sizeof(sockaddr_in);
+    
+    cbl::HostAddressCache cache;
+    std::vector<cbl::HostAddressCache::Address> found;
+    AssertFalse(cache.lookup("example.com", 0, 0, found));
+    
+    // A TTL shorter than the minimum is raised to it. Host names are case-insensitive, and
+    // addresses resolved on an interface are separate:
+    cache.insert("example.com", 0, {address}, 1, 0);
+    Assert(cache.lookup("EXAMPLE.com", 0, 4 * kSecond, found));
+    AssertEqual(found.size(), 1u);
+    AssertFalse(cache.lookup("example.com", 1, 4 * kSecond, found));
+    AssertFalse(cache.lookup("example.com", 0, 5 * kSecond, found));
+    
+    // A TTL longer than the maximum is lowered to it:
+    cache.insert("example.com", 0, {address}, 86400, 0);
+    Assert(cache.lookup("example.com", 0, 299 * kSecond, found));
+    AssertFalse(cache.lookup("example.com", 0, 300 * kSecond, found));
+    
+    // Failing to connect invalidates the entry:
+    cache.insert("example.com", 0, {address}, 60, 0);
+    cache.invalidate("example.com", 0);
+    AssertFalse(cache.lookup("example.com", 0, 1, found));
+    
+    auto stats = cache.stats();
+    AssertEqual(stats.hits, 2u);
+    AssertEqual(stats.misses, 5u);
+    AssertEqual(stats.invalidations, 1u);
+    XCTAssertEqualWithAccuracy(stats.hitRate(), 2.0 / 7.0, 0.001);
+    
+    // The number of entries is bounded:
+    for (int i = 0; i < 300; i++)
+        cache.insert("host" + std::to_string(i), 0, {address}, 60, i);
+    AssertEqual(cache.count(), cbl::HostAddressCache::kMaxEntries);
+    
+    // A maximum TTL of 0 disables the cache:
+    cache.setMaxTTL(0);
+    AssertEqual(cache.count(), 0u);
+    cache.insert("example.com", 0, {address}, 60, 0);
+    AssertFalse(cache.lookup("example.com", 0, 1, found));
+}
+
+
+#pragma mark - SocketOptions
+
+- (void) testSocketOptions {
+    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    Assert(sockfd >= 0);
+    auto get = [&](int level, int name) {
+        int value = 0;
+        socklen_t len = sizeof(value);
+        getsockopt(sockfd, level, name, &value, &len);
+        return value;
+    };
+    
+    cbl::SocketOptions options;
+    Assert(options.empty());
+    AssertEqual(options.apply(sockfd), 0);
+    AssertEqual(get(IPPROTO_TCP, TCP_NODELAY), 0);
+    AssertEqual(get(SOL_SOCKET, SO_KEEPALIVE), 0);
+    
+    options.noDelay = true;
+    options.keepAliveIdle = 30;
+    options.keepAliveInterval = 5;
+    options.keepAliveCount = 3;
+    options.sendBufferSize = 256 * 1024;
+    options.receiveBufferSize = 256 * 1024;
+    AssertFalse(options.empty());
+    AssertEqual(options.apply(sockfd), 0);
+    Assert(get(IPPROTO_TCP, TCP_NODELAY) != 0);
+    Assert(get(SOL_SOCKET, SO_KEEPALIVE) != 0);
+    AssertEqual(get(IPPROTO_TCP, TCP_KEEPINTVL), 5);
+    AssertEqual(get(IPPROTO_TCP, TCP_KEEPCNT), 3);
+    Assert(get(SOL_SOCKET, SO_SNDBUF) >= 256 * 1024);
+    Assert(get(SOL_SOCKET, SO_RCVBUF) >= 256 * 1024);
+    close(sockfd);
+}
+
+
+#pragma mark - TokenBucket
+
+- (void) testTokenBucket {
+    const uint64_t kSecond = 1000000000, kMillisecond = 1000000;
+    cbl::TokenBucket bucket(1000000);
+    AssertEqual(bucket.burst(), 50000u);
+    
+    // The bucket starts full, and refills at the rate:
+    AssertEqual(bucket.available(kSecond), 50000u);
+    bucket.consume(50000);
+    AssertEqual(bucket.available(kSecond), 0u);
+    AssertEqual(bucket.delay(10000, kSecond), 10 * kMillisecond);
+    AssertEqual(bucket.available(kSecond + 10 * kMillisecond), 10000u);
+    
+    // Tokens accumulate up to the burst size, which also bounds the delay:
+    AssertEqual(bucket.available(2 * kSecond), 50000u);
+    AssertEqual(bucket.delay(1000000, 2 * kSecond), 0u);
+    
+    // Taking more than is available goes into debt:
+    bucket.consume(60000);
+    AssertEqual(bucket.available(2 * kSecond), 0u);
+    AssertEqual(bucket.delay(1, 2 * kSecond), 10001000u);
+    
+    // The rate can be changed; 0 is unlimited:
+    bucket.setRate(100000);
+    AssertEqual(bucket.burst(), cbl::TokenBucket::kMinBurst);
+    AssertEqual(bucket.delay(1, 2 * kSecond), 100010000u);
+    bucket.setRate(0);
+    AssertEqual(bucket.available(2 * kSecond), SIZE_MAX);
+    AssertEqual(bucket.delay(1000000, 2 * kSecond), 0u);
+    
+    bucket.addShapedTime(kSecond);
+    bucket.addShapedTime(kSecond);
+    AssertEqual(bucket.shapedTime(), 2 * kSecond);
+}
+
+
+
+#pragma mark - WebSocketWriteQueue
+
+- (void) testWebSocketWriteQueueEmptyData {
+    cbl::WebSocketWriteQueue queue;
+    queue.push([NSData data], 0);
+    AssertEqual(queue.count(), 0u);
+    
+    queue.push([@"abc" dataUsingEncoding: NSUTF8StringEncoding], 3);
+    queue.push([NSData data], 0);
+    queue.push([@"de" dataUsingEncoding: NSUTF8StringEncoding], 2);
+    AssertEqual(queue.count(), 2u);
+    
+    LimitedOutputStream* out = [[LimitedOutputStream alloc] init];
+    out.capacity = 100;
+    bool blocked;
+    size_t frameBytes;
+    AssertEqual(queue.write(out, blocked, frameBytes), 5u);
+    AssertFalse(blocked);
+    Assert(queue.empty());
+    AssertEqualObjects(out.written, [@"abcde" dataUsingEncoding: NSUTF8StringEncoding]);
+}
+
+
+- (void) testWebSocketWriteQueueMaxBytes {
+    cbl::WebSocketWriteQueue queue;
+    auto data = [](NSString* str) {return [str dataUsingEncoding: NSUTF8StringEncoding];};
+    queue.push(data(@"aaaaaaaaaa"), 10);
+    queue.push(data(@"bbbbbbbbbb"), 12);        // Compressed frames report LiteCore's size
+    queue.push(data(@"cccccccccc"), 0);         // Not a frame
+    
+    // The gathered write is cut short by the limit, in the middle of the second entry:
+    LimitedOutputStream* out = [[LimitedOutputStream alloc] init];
+    out.capacity = 100;
+    bool blocked;
+    size_t frameBytes;
+    AssertEqual(queue.write(out, blocked, frameBytes, 15), 10u);
+    AssertFalse(blocked);
+    AssertEqual(frameBytes, 10u);
+    AssertEqual(queue.count(), 2u);
+    AssertEqual(queue.bytesQueued(), 15u);
+    AssertEqual(out.written.length, 15u);
+    
+    // The stream accepting less than the limit blocks the queue:
+    out.capacity = 3;
+    AssertEqual(queue.write(out, blocked, frameBytes, 100), 0u);
+    Assert(blocked);
+    AssertEqual(frameBytes, 0u);
+    AssertEqual(queue.bytesQueued(), 12u);
+    
+    // A limit of 0 writes nothing:
+    out.capacity = 100;
+    AssertEqual(queue.write(out, blocked, frameBytes, 0), 0u);
+    AssertFalse(blocked);
+    AssertEqual(queue.bytesQueued(), 12u);
+    
+    AssertEqual(queue.write(out, blocked, frameBytes), 12u);
+    AssertFalse(blocked);
+    AssertEqual(frameBytes, 10u);
+    Assert(queue.empty());
+    AssertEqualObjects(out.written, data(@"aaaaaaaaaabbbbbbbbbbcccccccccc"));
+}
+
 @end
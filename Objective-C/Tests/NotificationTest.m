@@ -145,4 +145,34 @@
     [listener1 remove];
 }
 
+- (void) testChangeListenersOrderOnSameQueue {
+    dispatch_queue_t queue = dispatch_queue_create("NotificationTest", DISPATCH_QUEUE_SERIAL);
+    XCTestExpectation* x = [self expectationWithDescription: @"collection change"];
+    NSMutableArray<NSNumber*>* calls = [NSMutableArray array];
+    
+    // Add listeners on the same queue, with one listener removed in between:
+    NSMutableArray* tokens = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 10; i++) {
+        id token = [self.defaultCollection addChangeListenerWithQueue: queue
+                                                             listener: ^(CBLCollectionChange* change) {
+            [calls addObject: @(i)];
+            if (i == 9)
+                [x fulfill];
+        }];
+        [tokens addObject: token];
+    }
+    [tokens[5] remove];
+    
+    [self saveDocument: [self createDocument: @"doc1"] collection: self.defaultCollection];
+    [self waitForExpectationsWithTimeout: kExpTimeout handler: NULL];
+    
+    // The listeners are called in the order they were added:
+    dispatch_sync(queue, ^{
+        AssertEqualObjects(calls, (@[@0, @1, @2, @3, @4, @6, @7, @8, @9]));
+    });
+    
+    for (id token in tokens)
+        [token remove];
+}
+
 @end
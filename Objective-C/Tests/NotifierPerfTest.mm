@@ -0,0 +1,111 @@
+//
+//  NotifierPerfTest.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "NotifierPerfTest.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+static constexpr unsigned kNumListeners = 100;
+static constexpr unsigned kNumQueues = 4;
+static constexpr unsigned kNumDocs = 1000;
+
+
+@implementation NotifierPerfTest
+{
+    std::atomic<uint64_t> _received;
+    std::atomic<bool> _churning;
+    NSArray<dispatch_queue_t>* _queues;
+    NSMutableArray<id<CBLListenerToken>>* _tokens;
+}
+
+
+- (void) setUp {
+    [super setUp];
+    NSMutableArray* queues = [NSMutableArray array];
+    for (unsigned i = 0; i < kNumQueues; i++) {
+        NSString* label = [NSString stringWithFormat: @"NotifierPerfTest-%u", i];
+        [queues addObject: dispatch_queue_create(label.UTF8String, DISPATCH_QUEUE_SERIAL)];
+    }
+    _queues = queues;
+    
+    _tokens = [NSMutableArray array];
+    for (unsigned i = 0; i < kNumListeners; i++) {
+        id token = [self.defaultCollection addChangeListenerWithQueue: _queues[i % kNumQueues]
+                                                             listener: ^(CBLCollectionChange* change) {
+            self->_received += change.documentIDs.count;
+        }];
+        [_tokens addObject: token];
+    }
+}
+
+
+- (void) tearDown {
+    for (id<CBLListenerToken> token in _tokens)
+        [token remove];
+    [super tearDown];
+}
+
+
+- (void) test {
+    __block unsigned iteration = 0;
+    NSLog(@"--- Posting %u doc changes to %u listeners ---", kNumDocs, kNumListeners);
+    [self measureAtScale: kNumDocs * kNumListeners unit: @"notification" block:^{
+        [self postChanges: iteration++];
+    }];
+}
+
+
+- (void) postChanges: (unsigned)iteration {
+    _received = 0;
+    
+    // Churn: keep adding and removing listeners while the changes are being delivered:
+    _churning = true;
+    dispatch_group_t churn = dispatch_group_create();
+    dispatch_group_async(churn, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        while (self->_churning) {
+            id token = [self.defaultCollection addChangeListenerWithQueue: self->_queues[0]
+                                                                 listener: ^(CBLCollectionChange* change) { }];
+            [token remove];
+        }
+    });
+    
+    for (unsigned i = 0; i < kNumDocs; i++) {
+        @autoreleasepool {
+            NSString* docID = [NSString stringWithFormat: @"doc-%u-%u", iteration, i];
+            CBLMutableDocument* doc = [CBLMutableDocument documentWithID: docID];
+            [doc setValue: @(i) forKey: @"count"];
+            NSError* error;
+            Assert([self.defaultCollection saveDocument: doc error: &error], @"Save failed: %@", error);
+        }
+    }
+    
+    // Wait until every listener has received every change:
+    const uint64_t expected = (uint64_t)kNumDocs * kNumListeners;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (_received < expected && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    
+    _churning = false;
+    dispatch_group_wait(churn, DISPATCH_TIME_FOREVER);
+    Assert(_received == expected, @"Received %llu of %llu notifications",
+           (unsigned long long)_received, (unsigned long long)expected);
+}
+
+@end
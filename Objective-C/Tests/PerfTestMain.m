@@ -18,8 +18,14 @@
 //
 
 #import <CouchbaseLite/CouchbaseLite.h>
+#import "ConflictPerfTest.h"
 #import "DocPerfTest.h"
+#import "NotifierPerfTest.h"
 #import "TunesPerfTest.h"
+#import "WebSocketWritePerfTest.h"
+#import "WebSocketDeflatePerfTest.h"
+#import "SocketLatencyPerfTest.h"
+#import "BlobIngestPerfTest.h"
 
 #define kDatabaseName @"perfdb"
 
@@ -34,7 +40,13 @@ int main(int argc, const char * argv[]) {
 
         NSLog(@"Starting test...");
         [DocPerfTest runWithConfig: config];
+        [ConflictPerfTest runWithConfig: config];
+        [NotifierPerfTest runWithConfig: config];
         [TunesPerfTest runWithConfig: config];
+        [WebSocketWritePerfTest runWithConfig: config];
+        [WebSocketDeflatePerfTest runWithConfig: config];
+        [SocketLatencyPerfTest runWithConfig: config];
+        [BlobIngestPerfTest runWithConfig: config];
     }
     return 0;
 }
@@ -19,7 +19,9 @@
 
 #import "QueryTest.h"
 #import "CBLJSONUtil.h"
+#import "CBLTestCustomLogSink.h"
 #ifndef CBL_BINARY_TEST
+#import "CBLContextManager.h"
 #import "CBLQuery+Internal.h"
 #import "CBLQuery+JSON.h"
 #import "CBLQueryResultArray.h"
@@ -1600,6 +1602,41 @@
     AssertEqualObjects([CBLJSONUtil jsonObjectFromString: [r toJSON]], temp);
 }
 
+- (void) testQueryWriteJSONLines {
+    [self loadJSONResource: @"names_100"];
+    
+    NSError* error;
+    CBLQuery* q = [self.db createQuery: @"SELECT meta().id, name, gender, missing FROM _ ORDER BY meta().id"
+                                 error: &error];
+    AssertNotNil(q, @"Failed to create query: %@", error);
+    
+    NSArray<CBLQueryResult*>* expected = [q execute: &error].allResults;
+    AssertEqual(expected.count, 100u);
+    
+    CBLQueryResultSet* rs = [q execute: &error];
+    NSOutputStream* stream = [NSOutputStream outputStreamToMemory];
+    [stream open];
+    Assert([rs writeJSONLinesToStream: stream error: &error], @"Failed to write: %@", error);
+    NSData* data = [stream propertyForKey: NSStreamDataWrittenToMemoryStreamKey];
+    [stream close];
+    
+    NSString* output = [[NSString alloc] initWithData: data encoding: NSUTF8StringEncoding];
+    Assert([output hasSuffix: @"\n"]);
+    NSArray<NSString*>* lines = [[output substringToIndex: output.length - 1]
+                                 componentsSeparatedByString: @"\n"];
+    AssertEqual(lines.count, expected.count);
+    for (NSUInteger i = 0; i < lines.count; i++) {
+        NSDictionary* row = [CBLJSONUtil jsonObjectFromString: lines[i]];
+        AssertEqualObjects(row, [CBLJSONUtil jsonObjectFromString: [expected[i] toJSON]]);
+        AssertNil(row[@"missing"]);
+    }
+    
+    // The result set is fully enumerated:
+    AssertNil([rs nextObject]);
+    AssertEqual(rs.stats.rowCount, 100u);
+    Assert(rs.stats.complete);
+}
+
 #pragma mark - Value Expression
 
 
@@ -1646,6 +1683,71 @@
     AssertEqualObjects([result[1] stringForKey: @"lastName"], @"Ice Cream");
 }
 
+#pragma mark - Stats
+
+- (void) testQueryStats {
+    [self loadJSONResource: @"names_100"];
+    
+    NSError* error;
+    CBLQuery* q = [self.db createQuery: @"SELECT name.first FROM _ WHERE gender = 'female'" error: &error];
+    AssertNotNil(q, @"Failed to create query: %@", error);
+    
+    CBLQueryResultSet* rs = [q execute: &error];
+    AssertNotNil(rs, @"Failed to execute query: %@", error);
+    
+    CBLQueryStats* stats = rs.stats;
+    AssertFalse(stats.complete);
+    AssertEqual(stats.rowCount, 0u);
+    
+    NSUInteger count = rs.allResults.count;
+    Assert(count > 0);
+    
+    stats = rs.stats;
+    Assert(stats.complete);
+    AssertEqual(stats.rowCount, count);
+    Assert(stats.compileTime > 0);
+    Assert(stats.firstRowLatency > 0);
+    Assert(stats.enumerationTime >= stats.firstRowLatency);
+    Assert(stats.fullScan);
+    
+    // Stats are frozen once the result set is fully enumerated:
+    AssertEqual(rs.stats.enumerationTime, stats.enumerationTime);
+    
+    // With an index, the query plan doesn't do a full scan:
+    CBLValueIndexConfiguration* config = [[CBLValueIndexConfiguration alloc] initWithExpression: @[@"gender"]];
+    Assert([self.defaultCollection createIndexWithName: @"gender" config: config error: &error]);
+    q = [self.db createQuery: @"SELECT name.first FROM _ WHERE gender = 'female'" error: &error];
+    rs = [q execute: &error];
+    AssertEqual(rs.allResults.count, count);
+    AssertFalse(rs.stats.fullScan);
+}
+
+- (void) testSlowQueryLog {
+    CBLDatabaseConfiguration* config = [[CBLDatabaseConfiguration alloc] init];
+    config.directory = self.directory;
+    config.slowQueryThreshold = 1e-9;
+    
+    NSError* error;
+    CBLDatabase* db = [[CBLDatabase alloc] initWithName: @"slowquerydb" config: config error: &error];
+    AssertNotNil(db, @"Failed to open db: %@", error);
+    AssertEqual(db.config.slowQueryThreshold, 1e-9);
+    
+    CBLTestCustomLogSink* logSink = [[CBLTestCustomLogSink alloc] init];
+    CBLLogSinks.custom = [[CBLCustomLogSink alloc] initWithLevel: kCBLLogLevelWarning logSink: logSink];
+    
+    NSString* n1ql = @"SELECT * FROM _ WHERE type = 'slow'";
+    CBLQuery* q = [db createQuery: n1ql error: &error];
+    AssertNotNil(q, @"Failed to create query: %@", error);
+    
+    CBLQueryResultSet* rs = [q execute: &error];
+    AssertEqual(rs.allResults.count, 0u);
+    Assert([logSink containsString: @"Slow query"]);
+    Assert([logSink containsString: n1ql]);
+    
+    CBLLogSinks.custom = nil;
+    Assert([db delete: &error], @"Failed to delete db: %@", error);
+}
+
 #pragma mark - LiveQuery
 
 - (void) testLiveQuery {
@@ -2061,6 +2163,40 @@
                 [[allObjects objectAtIndex: 4] valueForKey: @"id"]);
 }
 
+- (void) testContextManagerHandles {
+    CBLContextManager* manager = [CBLContextManager shared];
+    NSUInteger count = manager.count;
+    
+    NSObject* obj1 = [[NSObject alloc] init];
+    void* ctx1 = [manager registerObject: obj1];
+    Assert(ctx1 != NULL);
+    AssertEqual([manager objectForPointer: ctx1], obj1);
+    AssertEqual(manager.count, count + 1);
+    
+    [manager unregisterObjectForPointer: ctx1];
+    AssertNil([manager objectForPointer: ctx1]);
+    AssertEqual(manager.count, count);
+    
+    // A stale handle doesn't resolve to the objects registered later, even when they reuse its slot:
+    NSMutableArray* objects = [NSMutableArray array];
+    void* contexts[100];
+    for (int i = 0; i < 100; i++) {
+        NSObject* obj = [[NSObject alloc] init];
+        [objects addObject: obj];
+        contexts[i] = [manager registerObject: obj];
+        Assert(contexts[i] != ctx1);
+    }
+    AssertNil([manager objectForPointer: ctx1]);
+    [manager unregisterObjectForPointer: ctx1];
+    AssertEqual(manager.count, count + 100);
+    
+    for (int i = 0; i < 100; i++) {
+        AssertEqual([manager objectForPointer: contexts[i]], objects[i]);
+        [manager unregisterObjectForPointer: contexts[i]];
+    }
+    AssertEqual(manager.count, count);
+}
+
 - (void) testValueExpressionUnsupportedValueType {
     NSData* data = [[NSData alloc] init];
     [self expectException: NSInternalInconsistencyException in:^{
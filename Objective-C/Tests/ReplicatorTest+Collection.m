@@ -636,6 +636,111 @@
     AssertEqual(col2b.count, 10);
 }
 
+- (void) testCollectionPushAndPullFilterExpressions {
+    NSError* error = nil;
+    CBLCollection* col1a = [self.db createCollectionWithName: @"colA"
+                                                       scope: @"scopeA" error: &error];
+    AssertNotNil(col1a);
+    AssertNil(error);
+    
+    CBLCollection* col2a = [self.otherDB createCollectionWithName: @"colA"
+                                                            scope: @"scopeA" error: &error];
+    AssertNotNil(col2a);
+    AssertNil(error);
+    
+    [self createDocNumbered: col1a start: 0 num: 10];
+    [self createDocNumbered: col2a start: 10 num: 10];
+    
+    id target = [[CBLDatabaseEndpoint alloc] initWithDatabase: self.otherDB];
+    
+    CBLQueryExpression* number1 = [CBLQueryExpression property: @"number1"];
+    CBLQueryParameters* params = [[CBLQueryParameters alloc] init];
+    [params setInteger: 5 forName: @"max"];
+    
+    CBLCollectionConfiguration* colConfig = [[CBLCollectionConfiguration alloc] initWithCollection: col1a];
+    // Pushes doc0 ... doc4, and doc7:
+    colConfig.pushFilterExpression =
+        [[number1 lessThan: [CBLQueryExpression parameterNamed: @"max"]]
+            orExpression: [[CBLQueryMeta id] equalTo: [CBLQueryExpression string: @"doc7"]]];
+    // Pulls doc12 ... doc14, and doc19:
+    colConfig.pullFilterExpression =
+        [[number1 between: [CBLQueryExpression integer: 12] and: [CBLQueryExpression integer: 14]]
+            orExpression: [number1 in: @[[CBLQueryExpression integer: 19],
+                                         [CBLQueryExpression string: @"19"]]]];
+    colConfig.filterParameters = params;
+    
+    CBLReplicatorConfiguration* config = [self configWithCollectionConfigs: @[colConfig]
+                                                                    target: target
+                                                                      type: kCBLReplicatorTypePushAndPull
+                                                                continuous: NO];
+    [self run: config errorCode: 0 errorDomain: nil];
+    
+    AssertEqual(col1a.count, 14);
+    AssertEqual(col2a.count, 16);
+    AssertNotNil([col2a documentWithID: @"doc7" error: &error]);
+    AssertNil([col2a documentWithID: @"doc6" error: &error]);
+    AssertNotNil([col1a documentWithID: @"doc19" error: &error]);
+    AssertNil([col1a documentWithID: @"doc15" error: &error]);
+}
+
+- (void) testCollectionFilterExpressionWithFilterFunction {
+    NSError* error = nil;
+    CBLCollection* col1a = [self.db createCollectionWithName: @"colA"
+                                                       scope: @"scopeA" error: &error];
+    AssertNotNil(col1a);
+    AssertNil(error);
+    
+    CBLCollection* col2a = [self.otherDB createCollectionWithName: @"colA"
+                                                            scope: @"scopeA" error: &error];
+    AssertNotNil(col2a);
+    AssertNil(error);
+    
+    [self createDocNumbered: col1a start: 0 num: 10];
+    
+    id target = [[CBLDatabaseEndpoint alloc] initWithDatabase: self.otherDB];
+    
+    // The function is only called for the documents matching the expression:
+    __block NSInteger calls = 0;
+    CBLCollectionConfiguration* colConfig = [[CBLCollectionConfiguration alloc] initWithCollection: col1a];
+    colConfig.pushFilterExpression = [[CBLQueryExpression property: @"number1"]
+                                        greaterThanOrEqualTo: [CBLQueryExpression integer: 6]];
+    colConfig.pushFilter = ^BOOL(CBLDocument* document, CBLDocumentFlags flags) {
+        calls++;
+        return [document integerForKey: @"number1"] % 2 == 0;
+    };
+    
+    CBLReplicatorConfiguration* config = [self configWithCollectionConfigs: @[colConfig]
+                                                                    target: target
+                                                                      type: kCBLReplicatorTypePush
+                                                                continuous: NO];
+    [self run: config errorCode: 0 errorDomain: nil];
+    
+    AssertEqual(calls, 4);
+    AssertEqual(col2a.count, 2);
+}
+
+- (void) testCollectionUnsupportedFilterExpression {
+    NSError* error = nil;
+    CBLCollection* col1a = [self.db createCollectionWithName: @"colA"
+                                                       scope: @"scopeA" error: &error];
+    AssertNotNil(col1a);
+    AssertNil(error);
+    
+    id target = [[CBLDatabaseEndpoint alloc] initWithDatabase: self.otherDB];
+    
+    CBLCollectionConfiguration* colConfig = [[CBLCollectionConfiguration alloc] initWithCollection: col1a];
+    colConfig.pullFilterExpression = [[CBLQueryExpression property: @"name"]
+                                        like: [CBLQueryExpression string: @"a%"]];
+    
+    CBLReplicatorConfiguration* config = [self configWithCollectionConfigs: @[colConfig]
+                                                                    target: target
+                                                                      type: kCBLReplicatorTypePull
+                                                                continuous: NO];
+    [self expectException: NSInvalidArgumentException in: ^{
+        (void)[[CBLReplicator alloc] initWithConfig: config];
+    }];
+}
+
 - (void) testCollectionDocumentIDsPushFilter {
     NSError* error = nil;
     CBLCollection* col1a = [self.db createCollectionWithName: @"colA"
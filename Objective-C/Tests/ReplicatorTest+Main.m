@@ -19,11 +19,16 @@
 
 #import "ReplicatorTest.h"
 #ifndef CBL_BINARY_TEST
+#import "CBLCookieJar.h"
+#import "CBLDatabase+Internal.h"
+#import "CBLDNSService.h"
 #import "CBLDocumentReplication+Internal.h"
+#import "CBLSocketConnector.h"
 #import "CBLWebSocket.h"
 #import <ifaddrs.h>
 #import <arpa/inet.h>
 #import <netdb.h>
+#import <poll.h>
 #endif
 #import "CBLBlockConflictResolver.h"
 
@@ -35,6 +40,96 @@
 @interface ReplicatorTest_Main : ReplicatorTest
 @end
 
+#ifndef CBL_BINARY_TEST
+// Reports the result of a CBLDNSService to a block.
+@interface DNSServiceResult : NSObject <DNSServiceDelegate>
+@property (nonatomic, copy) void (^completion)(NSArray<AddressInfo*>* __nullable, NSError* __nullable);
+@end
+
+@implementation DNSServiceResult
+@synthesize completion=_completion;
+
+- (void) didResolveSuccessWithAddresses: (NSArray<AddressInfo*>*)addresses {
+    _completion(addresses, nil);
+}
+
+- (void) didResolveFailWithError: (NSError*)error {
+    _completion(nil, error);
+}
+
+@end
+
+static struct sockaddr_in loopbackSockaddr(UInt16 port) {
+    struct sockaddr_in addr = {};
+    addr.sin_len = sizeof(addr);
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    return addr;
+}
+
+static AddressInfo* loopbackAddress(UInt16 port) {
+    struct sockaddr_in addr = loopbackSockaddr(port);
+    return [[AddressInfo alloc] initWithAddress: (const struct sockaddr*)&addr
+                                        addrstr: @"127.0.0.1"
+                                           type: kIPv4
+                                           host: @"localhost"
+                                           port: port
+                                      interface: 0];
+}
+
+// Returns a socket listening on a free loopback port, or -1.
+static int listenOnLoopback(int backlog, UInt16* outPort) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = loopbackSockaddr(0);
+    socklen_t len = sizeof(addr);
+    if (fd < 0 || bind(fd, (struct sockaddr*)&addr, len) < 0 || listen(fd, backlog) < 0 ||
+        getsockname(fd, (struct sockaddr*)&addr, &len) < 0) {
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    *outPort = ntohs(addr.sin_port);
+    return fd;
+}
+
+// Returns a loopback port that refuses connections.
+static UInt16 refusingPort(void) {
+    UInt16 port = 0;
+    int fd = listenOnLoopback(1, &port);
+    if (fd >= 0)
+        close(fd);
+    return port;
+}
+
+// Returns a loopback port whose accept queue is full, so that connecting to it hangs, or 0 if the
+// system keeps accepting connections. The sockets to close are added to `fds`.
+static UInt16 unresponsivePort(NSMutableArray<NSNumber*>* fds) {
+    UInt16 port = 0;
+    int listener = listenOnLoopback(1, &port);
+    if (listener < 0)
+        return 0;
+    [fds addObject: @(listener)];
+    
+    for (int i = 0; i < 16; i++) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0)
+            return 0;
+        [fds addObject: @(fd)];
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        struct sockaddr_in addr = loopbackSockaddr(port);
+        if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0)
+            continue;
+        if (errno != EINPROGRESS)
+            return 0;
+        struct pollfd pfd = {fd, POLLOUT, 0};
+        if (poll(&pfd, 1, 200) == 0)
+            return port;
+    }
+    return 0;
+}
+#endif
+
 @implementation ReplicatorTest_Main {
     id _target;
 }
@@ -293,6 +388,46 @@
     AssertEqual(docs.count, 3u);
 }
 
+- (void) testReplicatorMetrics {
+    NSError* error;
+    for (NSUInteger i = 0; i < 10; i++) {
+        CBLMutableDocument* doc = [[CBLMutableDocument alloc] initWithID: $sprintf(@"doc%lu", (unsigned long)i)];
+        [doc setInteger: i forKey: @"number"];
+        Assert([self.defaultCollection saveDocument: doc error: &error]);
+    }
+    
+    id config = [self configWithTarget: _target type: kCBLReplicatorTypePush continuous: NO];
+    
+    __block CBLReplicator* replicator;
+    __block id<CBLListenerToken> token;
+    __block NSUInteger calls = 0;
+    [self run: config reset: NO errorCode: 0 errorDomain: nil onReplicatorReady: ^(CBLReplicator* r) {
+        replicator = r;
+        token = [r addMetricsListenerWithInterval: 0.01 queue: nil listener: ^(CBLReplicatorMetrics* metrics) {
+            Assert(metrics.interval > 0);
+            calls++;
+        }];
+    }];
+    
+    CBLReplicatorMetrics* metrics = replicator.metrics;
+    AssertEqual(metrics.documentsPushed, 10u);
+    AssertEqual(metrics.documentsPulled, 0u);
+    AssertEqual(metrics.conflictCount, 0u);
+    Assert(metrics.elapsedTime > 0);
+    AssertEqual(metrics.interval, metrics.elapsedTime);
+    Assert(metrics.documentsPushedPerSecond > 0);
+    
+    // The listener stops being called after being removed:
+    [token remove];
+    NSUInteger callsAfterRemoval = calls;
+    [[NSRunLoop currentRunLoop] runUntilDate: [NSDate dateWithTimeIntervalSinceNow: 0.1]];
+    AssertEqual(calls, callsAfterRemoval);
+    
+    [self expectException: NSInvalidArgumentException in: ^{
+        [replicator addMetricsListenerWithInterval: 0 queue: nil listener: ^(CBLReplicatorMetrics* m) { }];
+    }];
+}
+
 - (void) testDocumentReplicationEventAfterReplicatorStops {
     // --- 1. Create a continuous push-pull (or push only) replicator
     XCTestExpectation* xc1 = [self expectationWithDescription: @"stop1"];
@@ -1127,6 +1262,72 @@
     }];
 }
 
+- (void) testInvalidCompressionSettings {
+    CBLReplicatorConfiguration* config = [self configWithTarget: kDummyTarget
+                                                           type: kCBLReplicatorTypePush
+                                                     continuous: NO];
+    config.enableCompression = YES;
+    config.compressionLevel = 9;
+    config.compressionWindowBits = 9;
+    AssertEqual(config.compressionLevel, 9u);
+    AssertEqual(config.compressionWindowBits, 9u);
+    
+    [self expectException: @"NSInvalidArgumentException" in:^{
+        config.compressionLevel = 10;
+    }];
+    [self expectException: @"NSInvalidArgumentException" in:^{
+        config.compressionWindowBits = 8;
+    }];
+    [self expectException: @"NSInvalidArgumentException" in:^{
+        config.compressionWindowBits = 16;
+    }];
+}
+
+- (void) testDNSCacheSettings {
+    AssertEqual(CBLDNSCache.minimumTTL, 5.0);
+    AssertEqual(CBLDNSCache.maximumTTL, 300.0);
+    
+    CBLDNSCache.minimumTTL = 30;
+    CBLDNSCache.maximumTTL = 0;
+    AssertEqual(CBLDNSCache.minimumTTL, 30.0);
+    AssertEqual(CBLDNSCache.maximumTTL, 0.0);
+    
+    [self expectException: @"NSInvalidArgumentException" in:^{
+        CBLDNSCache.minimumTTL = -1;
+    }];
+    [self expectException: @"NSInvalidArgumentException" in:^{
+        CBLDNSCache.maximumTTL = -1;
+    }];
+    
+    CBLDNSCache.minimumTTL = 5;
+    CBLDNSCache.maximumTTL = 300;
+    [CBLDNSCache clear];
+    AssertEqual(CBLDNSCache.hitCount, 0u);
+    AssertEqual(CBLDNSCache.missCount, 0u);
+    AssertEqual(CBLDNSCache.hitRate, 0.0);
+}
+
+- (void) testBandwidthLimiter {
+    CBLBandwidthLimiter* limiter = [[CBLBandwidthLimiter alloc] initWithBytesPerSecond: 100000];
+    AssertEqual(limiter.bytesPerSecond, 100000u);
+    AssertEqual(limiter.shapedTime, 0.0);
+    limiter.bytesPerSecond = 0;
+    AssertEqual(limiter.bytesPerSecond, 0u);
+    
+    CBLReplicatorConfiguration* config = [self configWithTarget: kDummyTarget
+                                                           type: kCBLReplicatorTypePushAndPull
+                                                     continuous: YES];
+    AssertNil(config.sendBandwidthLimiter);
+    AssertNil(config.receiveBandwidthLimiter);
+    config.sendBandwidthLimiter = limiter;
+    config.receiveBandwidthLimiter = limiter;
+    
+    // The copy shares the limiter:
+    CBLReplicatorConfiguration* copy = [[CBLReplicatorConfiguration alloc] initWithConfig: config];
+    Assert(copy.sendBandwidthLimiter == limiter);
+    Assert(copy.receiveBandwidthLimiter == limiter);
+}
+
 - (void) testMaxAttemptWaitTimeOfReplicator {
     XCTestExpectation* exp = [self expectationWithDescription: @"replicator finish"];
     CBLReplicatorConfiguration* config = [self configWithTarget: kConnRefusedTarget
@@ -1249,6 +1450,71 @@
     }
 }
 
+- (void) testCookieJar {
+    NSURL* url = [NSURL URLWithString: @"wss://sg.example.com:4984/db/_blipsync"];
+    CBLCookieJar* jar = self.db.cookieJar;
+    AssertNil([jar getCookies: url error: nil]);
+    AssertEqual(jar.missCount, 1u);
+    
+    // Saved cookies are served from memory:
+    Assert([jar saveCookie: @"a=1" url: url acceptParentDomain: NO error: nil]);
+    Assert([jar saveCookie: @"b=2; Path=/db; Secure" url: url acceptParentDomain: NO error: nil]);
+    Assert([jar saveCookie: @"c=3; Path=/other" url: url acceptParentDomain: NO error: nil]);
+    AssertEqualObjects([jar getCookies: url error: nil], @"a=1; b=2");
+    AssertEqual(jar.hitCount, 1u);
+    
+    // Secure cookies aren't sent over plain connections:
+    NSURL* plainURL = [NSURL URLWithString: @"ws://sg.example.com:4984/db/_blipsync"];
+    AssertEqualObjects([jar getCookies: plainURL error: nil], @"a=1");
+    
+    // Parent domains are only accepted when allowed:
+    NSError* error;
+    AssertFalse([jar saveCookie: @"d=4; Domain=example.com" url: url acceptParentDomain: NO
+                          error: &error]);
+    AssertEqual(error.code, CBLErrorInvalidParameter);
+    AssertFalse([jar saveCookie: @"d=4; Domain=other.com" url: url acceptParentDomain: YES
+                          error: nil]);
+    Assert([jar saveCookie: @"d=4; Domain=example.com" url: url acceptParentDomain: YES error: nil]);
+    AssertEqualObjects([jar getCookies: url error: nil], @"a=1; b=2; d=4");
+    
+    // Expired cookies are removed in memory:
+    Assert([jar saveCookie: @"a=1; Max-Age=0" url: url acceptParentDomain: NO error: nil]);
+    Assert([jar saveCookie: @"b=2; Path=/db; Expires=Sun, 06 Nov 1994 08:49:37 GMT"
+                       url: url acceptParentDomain: NO error: nil]);
+    AssertEqualObjects([jar getCookies: url error: nil], @"d=4");
+    
+    // The cookies are persisted to the database:
+    [jar flush];
+    CBLCookieJar* reloaded = [[CBLCookieJar alloc] initWithStore: self.db];
+    AssertEqualObjects([reloaded getCookies: url error: nil], @"d=4");
+    AssertEqual(reloaded.missCount, 1u);
+    AssertEqual(reloaded.hitCount, 0u);
+}
+
+- (void) testCookieJarDeletePersistedCookie {
+    NSURL* url = [NSURL URLWithString: @"wss://sg.example.com:4984/db/_blipsync"];
+    CBLCookieJar* jar = self.db.cookieJar;
+    Assert([jar saveCookie: @"session=abc; Max-Age=3600" url: url acceptParentDomain: NO error: nil]);
+    Assert([jar saveCookie: @"other=xyz; Max-Age=3600" url: url acceptParentDomain: NO error: nil]);
+    [jar flush];
+    
+    // A jar that read the cookies from the store, e.g. after a restart:
+    CBLCookieJar* loaded = [[CBLCookieJar alloc] initWithStore: self.db];
+    AssertEqualObjects([loaded getCookies: url error: nil], @"session=abc; other=xyz");
+    
+    // The server deletes the cookies:
+    Assert([loaded saveCookie: @"session=; Max-Age=0" url: url acceptParentDomain: NO error: nil]);
+    AssertEqualObjects([loaded getCookies: url error: nil], @"other=xyz");
+    Assert([loaded saveCookie: @"other=; Expires=Sun, 06 Nov 1994 08:49:37 GMT"
+                          url: url acceptParentDomain: NO error: nil]);
+    AssertNil([loaded getCookies: url error: nil]);
+    
+    // Still deleted once the store has deleted them, and in the store:
+    [loaded flush];
+    AssertNil([loaded getCookies: url error: nil]);
+    AssertNil([[[CBLCookieJar alloc] initWithStore: self.db] getCookies: url error: nil]);
+}
+
 - (void) testNetworkInterfaceName {
     AssertEqualObjects([CBLWebSocket getNetworkInterfaceName: @"en0" error: nil], @"en0");
     
@@ -1294,6 +1560,213 @@
     freeifaddrs(ifaddrs);
 }
 
+// Runs a CBLSocketConnector on the addresses, and returns the connected socket or -1.
+- (int) connectTo: (NSArray<AddressInfo*>*)addresses
+     attemptDelay: (NSTimeInterval)attemptDelay
+          timeout: (NSTimeInterval)timeout
+          address: (AddressInfo**)outAddress
+         attempts: (NSUInteger*)outAttempts
+            error: (NSError**)outError
+{
+    dispatch_queue_t queue = dispatch_queue_create("SocketConnectorTest", DISPATCH_QUEUE_SERIAL);
+    CBLSocketConnector* connector = [[CBLSocketConnector alloc] initWithAddresses: addresses
+                                                                            queue: queue];
+    connector.attemptDelay = attemptDelay;
+    connector.timeout = timeout;
+    
+    XCTestExpectation* x = [self expectationWithDescription: @"Connected"];
+    __block int result = -1;
+    __block AddressInfo* resultAddress;
+    __block NSError* resultError;
+    dispatch_async(queue, ^{
+        [connector connect: ^(int sockfd, AddressInfo* address, NSError* error) {
+            result = sockfd;
+            resultAddress = address;
+            resultError = error;
+            [x fulfill];
+        }];
+    });
+    [self waitForExpectations: @[x] timeout: timeout + 5.0];
+    
+    dispatch_sync(queue, ^{
+        *outAttempts = connector.attempts;
+    });
+    *outAddress = resultAddress;
+    *outError = resultError;
+    return result;
+}
+
+- (void) testSocketConnectorSkipsRefusedAddress {
+    UInt16 port = 0;
+    int listener = listenOnLoopback(1, &port);
+    Assert(listener >= 0);
+    
+    // The next attempt starts as soon as an attempt fails, without waiting for the delay:
+    AddressInfo* address;
+    NSUInteger attempts;
+    NSError* error;
+    NSDate* start = [NSDate date];
+    int sockfd = [self connectTo: @[loopbackAddress(refusingPort()), loopbackAddress(port)]
+                    attemptDelay: 10.0 timeout: 15.0
+                         address: &address attempts: &attempts error: &error];
+    Assert(sockfd >= 0);
+    AssertNil(error);
+    AssertEqual(address.port, port);
+    AssertEqual(attempts, 2u);
+    Assert([[NSDate date] timeIntervalSinceDate: start] < 5.0);
+    
+    close(sockfd);
+    close(listener);
+}
+
+- (void) testSocketConnectorAttemptDelay {
+    NSMutableArray<NSNumber*>* fds = [NSMutableArray array];
+    UInt16 hangingPort = unresponsivePort(fds);
+    UInt16 port = 0;
+    int listener = listenOnLoopback(1, &port);
+    Assert(listener >= 0);
+    
+    @try {
+        if (hangingPort == 0)
+            XCTSkip(@"Connections to a full accept queue don't hang on this system");
+        
+        // The second attempt starts after the delay, while the first one is still pending:
+        AddressInfo* address;
+        NSUInteger attempts;
+        NSError* error;
+        NSDate* start = [NSDate date];
+        int sockfd = [self connectTo: @[loopbackAddress(hangingPort), loopbackAddress(port)]
+                        attemptDelay: 0.25 timeout: 15.0
+                             address: &address attempts: &attempts error: &error];
+        NSTimeInterval elapsed = [[NSDate date] timeIntervalSinceDate: start];
+        Assert(sockfd >= 0);
+        AssertEqual(address.port, port);
+        AssertEqual(attempts, 2u);
+        Assert(elapsed >= 0.25, @"Connected after %.3f sec", elapsed);
+        Assert(elapsed < 5.0, @"Connected after %.3f sec", elapsed);
+        close(sockfd);
+    } @finally {
+        close(listener);
+        for (NSNumber* fd in fds)
+            close(fd.intValue);
+    }
+}
+
+- (void) testSocketConnectorTimeout {
+    NSMutableArray<NSNumber*>* fds = [NSMutableArray array];
+    UInt16 hangingPort = unresponsivePort(fds);
+    @try {
+        if (hangingPort == 0)
+            XCTSkip(@"Connections to a full accept queue don't hang on this system");
+        
+        AddressInfo* address;
+        NSUInteger attempts;
+        NSError* error;
+        int sockfd = [self connectTo: @[loopbackAddress(hangingPort)]
+                        attemptDelay: 0.25 timeout: 0.5
+                             address: &address attempts: &attempts error: &error];
+        AssertEqual(sockfd, -1);
+        AssertNil(address);
+        AssertEqual(attempts, 1u);
+        AssertEqualObjects(error.domain, NSPOSIXErrorDomain);
+        AssertEqual(error.code, ETIMEDOUT);
+    } @finally {
+        for (NSNumber* fd in fds)
+            close(fd.intValue);
+    }
+}
+
+- (void) testSocketConnectorAllAddressesFail {
+    AddressInfo* address;
+    NSUInteger attempts;
+    NSError* error;
+    int sockfd = [self connectTo: @[loopbackAddress(refusingPort()), loopbackAddress(refusingPort())]
+                    attemptDelay: 0.25 timeout: 15.0
+                         address: &address attempts: &attempts error: &error];
+    AssertEqual(sockfd, -1);
+    AssertNil(address);
+    AssertEqual(attempts, 2u);
+    AssertEqualObjects(error.domain, NSPOSIXErrorDomain);
+    AssertEqual(error.code, ECONNREFUSED);
+}
+
+- (void) testDNSServiceInterleaveAddresses {
+    NSMutableArray<AddressInfo*>* ipv6 = [NSMutableArray array];
+    for (int i = 1; i <= 3; i++) {
+        struct sockaddr_in6 addr = {};
+        addr.sin6_len = sizeof(addr);
+        addr.sin6_family = AF_INET6;
+        addr.sin6_addr.s6_addr[15] = (uint8_t)i;
+        [ipv6 addObject: [[AddressInfo alloc] initWithAddress: (const struct sockaddr*)&addr
+                                                      addrstr: [NSString stringWithFormat: @"::%d", i]
+                                                         type: kIPv6
+                                                         host: @"example.com"
+                                                         port: 4984
+                                                    interface: 0]];
+    }
+    NSArray<AddressInfo*>* ipv4 = @[loopbackAddress(4984)];
+    
+    // IPv6 first, alternating while both families have addresses left:
+    NSArray* addresses = [CBLDNSService interleaveIPv6: ipv6 IPv4: ipv4];
+    AssertEqualObjects([addresses valueForKey: @"addrstr"], (@[@"::1", @"127.0.0.1", @"::2", @"::3"]));
+    addresses = [CBLDNSService interleaveIPv6: @[] IPv4: ipv4];
+    AssertEqualObjects([addresses valueForKey: @"addrstr"], @[@"127.0.0.1"]);
+    
+    // The port is set on the copied address:
+    AddressInfo* info = ipv6[0];
+    AssertEqual(ntohs(info.addrIn6->sin6_port), 4984);
+}
+
+- (NSArray<AddressInfo*>*) resolveHost: (NSString*)host error: (NSError**)outError {
+    XCTestExpectation* x = [self expectationWithDescription: @"Resolved"];
+    __block NSArray<AddressInfo*>* result;
+    __block NSError* resultError;
+    DNSServiceResult* delegate = [[DNSServiceResult alloc] init];
+    delegate.completion = ^(NSArray<AddressInfo*>* addresses, NSError* error) {
+        result = addresses;
+        resultError = error;
+        [x fulfill];
+    };
+    CBLDNSService* service = [[CBLDNSService alloc] initWithHost: host interface: 0 port: 4984
+                                                        delegate: delegate];
+    [service start];
+    [self waitForExpectations: @[x] timeout: kExpTimeout];
+    [service stop];
+    if (outError)
+        *outError = resultError;
+    return result;
+}
+
+- (void) testDNSServiceIPLiterals {
+    NSDictionary<NSString*, NSString*>* hosts = @{@"127.0.0.1": @"127.0.0.1",
+                                                   @"::1": @"::1",
+                                                   @"[::1]": @"::1"};
+    for (NSString* host in hosts) {
+        NSArray<AddressInfo*>* addresses = [self resolveHost: host error: nil];
+        AssertEqual(addresses.count, 1u);
+        AssertEqualObjects(addresses[0].addrstr, hosts[host]);
+        AssertEqual(addresses[0].type, ([host isEqualToString: @"127.0.0.1"] ? kIPv4 : kIPv6));
+        AssertEqual(addresses[0].port, 4984);
+    }
+}
+
+- (void) testDNSServiceResolveLocalhost {
+    NSError* error;
+    NSArray<AddressInfo*>* addresses = [self resolveHost: @"localhost" error: &error];
+    AssertNil(error);
+    Assert(addresses.count > 0);
+    
+    // The families alternate, starting with IPv6:
+    NSUInteger ipv6Count = 0;
+    for (AddressInfo* info in addresses) {
+        if (info.type == kIPv6)
+            ipv6Count++;
+    }
+    NSUInteger ipv4Count = addresses.count - ipv6Count;
+    for (NSUInteger i = 0; i < 2 * MIN(ipv6Count, ipv4Count); i++)
+        AssertEqual(addresses[i].type, (i % 2 == 0 ? kIPv6 : kIPv4));
+}
+
 - (void) testCreateDocumentReplicator {
     id target = [[CBLURLEndpoint alloc] initWithURL:[NSURL URLWithString:@"ws://foo.couchbase.com/db"]];
     CBLReplicatorConfiguration* config = [self configWithTarget: target
@@ -1335,6 +1808,41 @@
     AssertNil(replicatedDoc.error);
 }
 
+- (void) testReplicatedDocumentBatch {
+    C4DocumentEnded ends[3] = {};
+    const C4DocumentEnded* endPtrs[3] = {&ends[0], &ends[1], &ends[2]};
+    const char* docIDs[3] = {"doc1", "doc2", "doc3"};
+    for (int i = 0; i < 3; i++) {
+        ends[i].docID = c4str(docIDs[i]);
+        ends[i].collectionSpec = kC4DefaultCollectionSpec;
+    }
+    ends[1].error = c4error_make(LiteCoreDomain, kC4ErrorConflict, kC4SliceNull);
+    ends[2].error = c4error_make(WebSocketDomain, 503, kC4SliceNull);
+    
+    CBLReplicatedDocumentBatch* batch = [[CBLReplicatedDocumentBatch alloc] initWithDocuments: endPtrs
+                                                                                        count: 3
+                                                                                   errorsOnly: NO];
+    AssertEqual(batch.count, 3u);
+    AssertEqual([batch c4ErrorAtIndex: 1].code, kC4ErrorConflict);
+    AssertEqualObjects(batch[0].id, @"doc1");
+    AssertEqualObjects(batch[0].collection, kCBLDefaultCollectionName);
+    AssertNil(batch[0].error);
+    Assert(batch[2] == batch[2]);       // Created once
+    AssertEqual(batch[2].c4Error.code, 503);
+    
+    CBLReplicatedDocumentBatch* posts = [batch batchExcludingConflicts];
+    AssertEqual(posts.count, 2u);
+    AssertEqualObjects(posts[0].id, @"doc1");
+    AssertEqualObjects(posts[1].id, @"doc3");
+    
+    CBLReplicatedDocumentBatch* errors = [[CBLReplicatedDocumentBatch alloc] initWithDocuments: endPtrs
+                                                                                         count: 3
+                                                                                    errorsOnly: YES];
+    AssertEqual(errors.count, 2u);
+    AssertEqualObjects(errors[0].id, @"doc2");
+    AssertEqualObjects(errors[1].id, @"doc3");
+}
+
 #endif
 
 @end
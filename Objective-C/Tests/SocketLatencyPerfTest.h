@@ -0,0 +1,28 @@
+//
+//  SocketLatencyPerfTest.h
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "PerfTest.h"
+
+
+/** Measures the round-trip time of small request/acknowledgement exchanges over a loopback TCP
+    connection, with the socket options at the system defaults and with the replicator's socket
+    options (TCP_NODELAY, keepalive, buffer sizes) set. Each request is written in two parts,
+    like a BLIP frame header and body, which is the pattern Nagle's algorithm delays. */
+@interface SocketLatencyPerfTest : PerfTest
+@end
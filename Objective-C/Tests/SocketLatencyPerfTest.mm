@@ -0,0 +1,119 @@
+//
+//  SocketLatencyPerfTest.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "SocketLatencyPerfTest.h"
+#import "CBLSocketOptions.hh"
+#include <arpa/inet.h>
+#include <chrono>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace std::chrono;
+
+static constexpr NSUInteger kRoundTrips = 200;
+static constexpr size_t kHeaderSize = 8;            // Written separately from the body
+static constexpr size_t kBodySize = 120;
+static constexpr size_t kAckSize = 16;
+
+
+@implementation SocketLatencyPerfTest
+
+
+static bool readFully(int sockfd, void* buf, size_t size) {
+    auto dst = (uint8_t*)buf;
+    while (size > 0) {
+        ssize_t n = read(sockfd, dst, size);
+        if (n <= 0)
+            return false;
+        dst += n;
+        size -= n;
+    }
+    return true;
+}
+
+
+- (void) test {
+    cbl::SocketOptions defaults;
+    cbl::SocketOptions tuned;
+    tuned.noDelay = true;
+    tuned.keepAliveIdle = 30;
+    tuned.keepAliveInterval = 5;
+    tuned.keepAliveCount = 3;
+    tuned.sendBufferSize = tuned.receiveBufferSize = 256 * 1024;
+
+    NSLog(@"--- Default socket options ---");
+    double defaultRTT = [self measureWithOptions: defaults];
+    NSLog(@"--- TCP_NODELAY, keepalive, 256KB buffers ---");
+    double tunedRTT = [self measureWithOptions: tuned];
+    NSLog(@"Average round trip: %.1f us with default options, %.1f us with tuned options",
+          defaultRTT * 1.0e6, tunedRTT * 1.0e6);
+}
+
+
+// Runs the round trips over a new loopback connection, with the options set on both ends.
+// Returns the average round-trip time in seconds.
+- (double) measureWithOptions: (const cbl::SocketOptions&)options {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    Assert(bind(listener, (sockaddr*)&addr, len) == 0, @"bind failed: errno %d", errno);
+    Assert(listen(listener, 1) == 0, @"listen failed: errno %d", errno);
+    getsockname(listener, (sockaddr*)&addr, &len);
+
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    options.apply(client);
+    Assert(connect(client, (sockaddr*)&addr, len) == 0, @"connect failed: errno %d", errno);
+    int server = accept(listener, nullptr, nullptr);
+    close(listener);
+    options.apply(server);
+
+    // The server acknowledges each request once it has read all of it:
+    std::thread serverThread([server] {
+        uint8_t request[kHeaderSize + kBodySize], ack[kAckSize] = {};
+        while (readFully(server, request, sizeof(request))) {
+            if (write(server, ack, sizeof(ack)) != (ssize_t)sizeof(ack))
+                break;
+        }
+        close(server);
+    });
+
+    __block double seconds = 0;
+    __block NSUInteger count = 0;
+    [self measureAtScale: kRoundTrips unit: @"round trip" block:^{
+        uint8_t header[kHeaderSize] = {}, body[kBodySize] = {}, ack[kAckSize];
+        auto start = steady_clock::now();
+        for (NSUInteger i = 0; i < kRoundTrips; ++i) {
+            write(client, header, sizeof(header));
+            write(client, body, sizeof(body));
+            Assert(readFully(client, ack, sizeof(ack)), @"Connection closed");
+        }
+        seconds += duration<double>(steady_clock::now() - start).count();
+        count += kRoundTrips;
+    }];
+
+    close(client);
+    serverThread.join();
+    return seconds / count;
+}
+
+@end
@@ -26,6 +26,7 @@
 #endif
 
 #import "CBLTrustCheck.h"
+#import "CBLTrustCache.h"
 
 @interface TrustCheckTest : CBLTestCase
 
@@ -284,4 +285,38 @@
     CFRelease(secCert3);
 }
 
+- (void) testTrustCache {
+    SecCertificateRef cert = [self getSelfSignedCertificate];
+    NSString* key = [CBLTrustCache keyForHost: @"Example.com" port: 4984 certificate: cert policy: nil];
+    AssertEqualObjects(key, [CBLTrustCache keyForHost: @"example.com" port: 4984 certificate: cert policy: nil]);
+    AssertFalse([key isEqualToString: [CBLTrustCache keyForHost: @"example.com" port: 443
+                                                    certificate: cert policy: nil]]);
+    AssertFalse([key isEqualToString: [CBLTrustCache keyForHost: @"example.com" port: 4984
+                                                    certificate: cert policy: @"selfSigned"]]);
+    
+    CBLTrustCache* cache = [[CBLTrustCache alloc] initWithCapacity: 2 lifetime: 60];
+    AssertFalse([cache containsKey: key]);
+    [cache addKey: key];
+    Assert([cache containsKey: key]);
+    AssertEqual(cache.hitCount, 1u);
+    AssertEqual(cache.missCount, 1u);
+    
+    // The oldest decision is removed to make room:
+    [cache addKey: @"b"];
+    [cache addKey: @"c"];
+    AssertEqual(cache.count, 2u);
+    AssertFalse([cache containsKey: key]);
+    Assert([cache containsKey: @"c"]);
+    
+    // Decisions expire:
+    CBLTrustCache* expired = [[CBLTrustCache alloc] initWithCapacity: 2 lifetime: 0];
+    [expired addKey: key];
+    AssertFalse([expired containsKey: key]);
+    
+    // Changing the anchor certificates clears the shared cache:
+    [[CBLTrustCache sharedCache] addKey: key];
+    [CBLTrustCheck setAnchorCerts: [self getAnchorCerts] onlyThese: NO];
+    AssertEqual([CBLTrustCache sharedCache].count, 0u);
+}
+
 @end
@@ -19,6 +19,7 @@
 
 #import "URLEndpointListenerTest.h"
 #ifndef CBL_BINARY_TEST
+#import "CBLReplicator+Internal.h"
 #import "CBLURLEndpointListener+Internal.h"
 #endif
 #import "CollectionUtils.h"
@@ -1512,6 +1513,71 @@
     return count;
 }
 
+#pragma mark - Bandwidth Limiter
+
+// Saves a document with a 1 MB blob that doesn't compress. Returns the blob's content.
+- (NSData*) saveDocWithLargeBlob: (NSString*)docID inCollection: (CBLCollection*)collection {
+    NSMutableData* content = [NSMutableData dataWithLength: 1024 * 1024];
+    uint32_t x = 2463534242u;
+    uint8_t* bytes = (uint8_t*)content.mutableBytes;
+    for (NSUInteger i = 0; i < content.length; ++i) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        bytes[i] = (uint8_t)x;
+    }
+    NSError* err;
+    CBLMutableDocument* doc = [self createDocument: docID];
+    [doc setBlob: [[CBLBlob alloc] initWithContentType: @"application/octet-stream" data: content]
+          forKey: @"blob"];
+    Assert([collection saveDocument: doc error: &err], @"Fail to save db %@", err);
+    return content;
+}
+
+// Runs the replication with the limiter, checking that the blob took about as long as the
+// limiter's rate allows and that the time spent waiting for the limiter was counted.
+- (void) runBandwidthLimited: (CBLReplicatorType)type limiter: (CBLBandwidthLimiter*)limiter {
+    Listener* listener = [self listenWithTLS: NO];
+    CBLReplicatorConfiguration* config = [self configWithTarget: listener.localEndpoint
+                                                           type: type
+                                                     continuous: NO];
+    if (type == kCBLReplicatorTypePush)
+        config.sendBandwidthLimiter = limiter;
+    else
+        config.receiveBandwidthLimiter = limiter;
+    
+    // Transferring the blob at 256 KB/s takes about 4 seconds:
+    __block CBLReplicator* replicator;
+    NSDate* start = [NSDate date];
+    [self run: config reset: NO errorCode: 0 errorDomain: nil onReplicatorReady: ^(CBLReplicator* r) {
+        replicator = r;
+    }];
+    NSTimeInterval elapsed = -start.timeIntervalSinceNow;
+    Assert(elapsed >= 3.5 && elapsed < 10.0, @"Replication took %.1f seconds", elapsed);
+    Assert(replicator.metrics.shapedTime > 0);
+    Assert(limiter.shapedTime > 0);
+    
+    [self stopListen];
+}
+
+- (void) testBandwidthLimitedPush {
+    NSData* content = [self saveDocWithLargeBlob: @"doc1" inCollection: self.defaultCollection];
+    CBLBandwidthLimiter* limiter = [[CBLBandwidthLimiter alloc] initWithBytesPerSecond: 256 * 1024];
+    [self runBandwidthLimited: kCBLReplicatorTypePush limiter: limiter];
+    
+    NSError* err;
+    CBLDocument* doc = [self.otherDBDefaultCollection documentWithID: @"doc1" error: &err];
+    AssertEqualObjects([doc blobForKey: @"blob"].content, content);
+}
+
+- (void) testBandwidthLimitedPull {
+    NSData* content = [self saveDocWithLargeBlob: @"doc1" inCollection: self.otherDBDefaultCollection];
+    CBLBandwidthLimiter* limiter = [[CBLBandwidthLimiter alloc] initWithBytesPerSecond: 256 * 1024];
+    [self runBandwidthLimited: kCBLReplicatorTypePull limiter: limiter];
+    
+    NSError* err;
+    CBLDocument* doc = [self.defaultCollection documentWithID: @"doc1" error: &err];
+    AssertEqualObjects([doc blobForKey: @"blob"].content, content);
+}
+
 #pragma mark - Internal
 
 // White-box tests that verify internal state; excluded from the binary tests.
@@ -1533,6 +1599,42 @@
     }
 }
 
+- (void) testPOSIXWebSocketReplication {
+    NSError* err;
+    for (int i = 0; i < 10; i++) {
+        CBLMutableDocument* doc = [self createDocument: [NSString stringWithFormat: @"doc-%d", i]];
+        [doc setInteger: i forKey: @"index"];
+        Assert([self.defaultCollection saveDocument: doc error: &err], @"Fail to save db %@", err);
+        
+        CBLMutableDocument* other = [self createDocument: [NSString stringWithFormat: @"other-%d", i]];
+        [other setInteger: i forKey: @"index"];
+        Assert([self.otherDBDefaultCollection saveDocument: other error: &err], @"Fail to save db %@", err);
+    }
+    // The blob's messages are larger than the socket buffers:
+    NSData* content = [self saveDocWithLargeBlob: @"blob" inCollection: self.defaultCollection];
+    
+    Listener* listener = [self listenWithTLS: NO];
+    CBLReplicatorConfiguration* config = [self configWithTarget: listener.localEndpoint
+                                                           type: kCBLReplicatorTypePushAndPull
+                                                     continuous: NO];
+    config.usePOSIXWebSocket = YES;
+    
+    __block CBLReplicator* replicator;
+    [self run: config reset: NO errorCode: 0 errorDomain: nil onReplicatorReady: ^(CBLReplicator* r) {
+        replicator = r;
+    }];
+    AssertEqual(self.defaultCollection.count, 21u);
+    AssertEqual(self.otherDBDefaultCollection.count, 21u);
+    CBLDocument* doc = [self.otherDBDefaultCollection documentWithID: @"blob" error: &err];
+    AssertEqualObjects([doc blobForKey: @"blob"].content, content);
+    
+    // The POSIX transport made the connection:
+    AssertEqual(replicator.metrics.connectCount, 1u);
+    Assert(replicator.metrics.bytesSent > content.length);
+    
+    [self stopListen];
+}
+
 #endif
 
 @end
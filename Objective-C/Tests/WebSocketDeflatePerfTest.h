@@ -0,0 +1,27 @@
+//
+//  WebSocketDeflatePerfTest.h
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "PerfTest.h"
+
+
+/** Measures permessage-deflate compression of replication traffic: the bytes on the wire and
+    the CPU time, compressing and decompressing a batch of revision messages with the bodies of
+    the iTunes library documents, at several compression levels and window sizes. */
+@interface WebSocketDeflatePerfTest : PerfTest
+@end
@@ -0,0 +1,151 @@
+//
+//  WebSocketDeflatePerfTest.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "WebSocketDeflatePerfTest.h"
+#import "CBLWebSocketDeflate.hh"
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace std::chrono;
+
+static constexpr size_t kWriteSize = 16 * 1024;     // Data passed to the codec per call
+
+
+@implementation WebSocketDeflatePerfTest
+{
+    std::vector<uint8_t> _frames;       // Masked WebSocket frames of "rev" messages
+    std::vector<uint8_t> _compressed;
+    NSUInteger _revCount;
+}
+
+
+// Appends a masked binary WebSocket frame, as LiteCore sends it.
+static void appendFrame(std::vector<uint8_t> &out, const std::string &payload) {
+    static const uint8_t kMask[4] = {0x37, 0xFA, 0x21, 0x3D};
+    size_t size = payload.size();
+    out.push_back(0x82);
+    if (size < 126) {
+        out.push_back(0x80 | (uint8_t)size);
+    } else {
+        out.push_back(0x80 | 126);
+        out.push_back((uint8_t)(size >> 8));
+        out.push_back((uint8_t)size);
+    }
+    out.insert(out.end(), kMask, kMask + 4);
+    for (size_t i = 0; i < size; ++i)
+        out.push_back(payload[i] ^ kMask[i & 3]);
+}
+
+
+- (void) setUp {
+    [super setUp];
+    // Each line of the file is a document body; send each as a "rev" message, with properties
+    // like the ones the replicator sends:
+    NSData *jsonData = [self dataFromResource: @"iTunesMusicLibrary" ofType: @"json"];
+    NSString* json = [[NSString alloc] initWithData: jsonData encoding: NSUTF8StringEncoding];
+    __block NSUInteger n = 0;
+    [json enumerateLinesUsingBlock:^(NSString *line, BOOL *stop) {
+        ++n;
+        std::string message;
+        auto addProperty = [&](const std::string &key, const std::string &value) {
+            message += key;
+            message += '\0';
+            message += value;
+            message += '\0';
+        };
+        addProperty("Profile", "rev");
+        addProperty("id", "track-" + std::to_string(n));
+        addProperty("rev", "1-" + std::to_string(n * 2654435761u % 99991));
+        addProperty("sequence", std::to_string(n));
+        message += line.UTF8String;
+        appendFrame(self->_frames, message);
+    }];
+    _revCount = n;
+}
+
+
+- (void) test {
+    NSLog(@"--- %lu revision messages, %.1f MB ---", (unsigned long)_revCount, _frames.size() / 1.0e6);
+
+    const int kConfigs[][2] = {{1, 15}, {6, 15}, {9, 15}, {6, 12}, {6, 9}};    // Level, bits
+    for (auto &config : kConfigs) {
+        cbl::DeflateParams params;
+        params.level = config[0];
+        params.clientMaxWindowBits = config[1];
+        NSLog(@"--- Compressing, level %d, window bits %d ---", config[0], config[1]);
+        __block double seconds = 0;
+        __block int runs = 0;
+        [self measureAtScale: _revCount unit: @"revision" block:^{
+            seconds += [self compressWithParams: params];
+            ++runs;
+        }];
+        NSLog(@"Bytes on wire: %zu of %zu (%.1f%% saved); compressing %.1f MB/s",
+              _compressed.size(), _frames.size(),
+              100.0 * (1.0 - (double)_compressed.size() / _frames.size()),
+              runs * _frames.size() / seconds / 1.0e6);
+    }
+
+    // Decompress the data compressed with the last configuration:
+    cbl::DeflateParams params;
+    params.serverMaxWindowBits = 9;
+    NSLog(@"--- Decompressing, window bits 9 ---");
+    __block double seconds = 0;
+    __block int runs = 0;
+    [self measureAtScale: _revCount unit: @"revision" block:^{
+        seconds += [self decompressWithParams: params];
+        ++runs;
+    }];
+    NSLog(@"Decompressing %.1f MB/s", runs * _frames.size() / seconds / 1.0e6);
+}
+
+
+// Compresses all the frames into `_compressed`, returning the time it took.
+- (double) compressWithParams: (const cbl::DeflateParams&)params {
+    cbl::WebSocketDeflate deflate(params);
+    _compressed.clear();
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < _frames.size(); i += kWriteSize) {
+        size_t size = std::min(kWriteSize, _frames.size() - i);
+        Assert(deflate.compress(&_frames[i], size, _compressed),
+               @"Compression failed: %s", deflate.errorMessage().c_str());
+    }
+    return duration<double>(steady_clock::now() - start).count();
+}
+
+
+// Decompresses `_compressed`, checking that the result is the original frames.
+// Returns the time it took.
+- (double) decompressWithParams: (const cbl::DeflateParams&)params {
+    cbl::WebSocketDeflate deflate(params);
+    std::vector<uint8_t> frames;
+    frames.reserve(_frames.size());
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < _compressed.size(); i += kWriteSize) {
+        size_t size = std::min(kWriteSize, _compressed.size() - i);
+        Assert(deflate.decompress(&_compressed[i], size, frames),
+               @"Decompression failed: %s", deflate.errorMessage().c_str());
+    }
+    double seconds = duration<double>(steady_clock::now() - start).count();
+    Assert(frames == _frames, @"Decompressed frames don't match");
+    return seconds;
+}
+
+@end
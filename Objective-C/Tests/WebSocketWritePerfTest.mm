@@ -0,0 +1,93 @@
+//
+//  WebSocketWritePerfTest.mm
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "WebSocketWritePerfTest.h"
+#import "CBLWebSocketWriteQueue.hh"
+#include <atomic>
+#include <thread>
+
+static constexpr size_t kFrameSize = 64;
+static constexpr unsigned kNumFrames = 200000;
+static constexpr unsigned kFramesPerBurst = 100;    // Frames queued between writes
+static constexpr CFIndex kStreamBufferSize = 64 * 1024;
+
+
+@implementation WebSocketWritePerfTest
+
+
+- (void) test {
+    NSLog(@"--- Writing %u frames of %zu bytes, one write per frame ---", kNumFrames, kFrameSize);
+    [self measureAtScale: kNumFrames unit: @"frame" block:^{
+        [self writeFramesWithGatherBudget: 0];
+    }];
+
+    NSLog(@"--- Writing %u frames of %zu bytes, gathered writes ---", kNumFrames, kFrameSize);
+    [self measureAtScale: kNumFrames unit: @"frame" block:^{
+        [self writeFramesWithGatherBudget: cbl::WebSocketWriteQueue::kDefaultGatherBudget];
+    }];
+}
+
+
+- (void) writeFramesWithGatherBudget: (size_t)gatherBudget {
+    CFReadStreamRef readStream;
+    CFWriteStreamRef writeStream;
+    CFStreamCreateBoundPair(kCFAllocatorDefault, &readStream, &writeStream, kStreamBufferSize);
+    NSInputStream* in = CFBridgingRelease(readStream);
+    NSOutputStream* out = CFBridgingRelease(writeStream);
+    [in open];
+    [out open];
+
+    // The peer, reading everything on another thread:
+    std::atomic<uint64_t> bytesRead {0};
+    std::thread reader([&] {
+        uint8_t buffer[32 * 1024];
+        NSInteger n;
+        while ((n = [in read: buffer maxLength: sizeof(buffer)]) > 0)
+            bytesRead += n;
+    });
+
+    cbl::WebSocketWriteQueue queue(gatherBudget);
+    uint8_t frame[kFrameSize] = {};
+    size_t bytesCompleted = 0;
+    for (unsigned i = 0; i < kNumFrames; i += kFramesPerBurst) {
+        @autoreleasepool {
+            for (unsigned j = 0; j < kFramesPerBurst; j++)
+                queue.push([NSData dataWithBytes: frame length: sizeof(frame)], sizeof(frame));
+            while (!queue.empty()) {
+                bool blocked;
+                size_t frameBytes;
+                bytesCompleted += queue.write(out, blocked, frameBytes);
+                if (blocked)
+                    std::this_thread::yield();
+            }
+        }
+    }
+
+    [out close];
+    reader.join();
+    [in close];
+
+    const uint64_t expected = (uint64_t)kNumFrames * kFrameSize;
+    Assert(bytesCompleted == expected, @"Completed %zu of %llu bytes",
+           bytesCompleted, (unsigned long long)expected);
+    Assert(bytesRead == expected, @"Read %llu of %llu bytes",
+           (unsigned long long)bytesRead, (unsigned long long)expected);
+}
+
+@end
@@ -403,6 +403,20 @@ public final class Collection: CollectionChangeObservable, Indexable, Equatable,
         return date
     }
     
+    // MARK: Change Feed
+    
+    /// Create a cursor for pulling the changes made to the collection after the given sequence,
+    /// in sequence order. Pass 0 to read all changes, or a persisted `CollectionChangeCursor.lastSequence`
+    /// to resume where a previous cursor stopped. Each `nextBatch()` call returns at most `limit` changes.
+    ///
+    /// Throws an NSError with the CBLError.notOpen code, if the collection is deleted or
+    /// the database is closed.
+    public func changes(sinceSequence sequence: UInt64, limit: Int) throws -> CollectionChangeCursor {
+        precondition(limit > 0, "limit must be > 0")
+        let cursor = try impl.changesSinceSequence(sequence, limit: UInt(limit))
+        return CollectionChangeCursor(cursor, collection: self)
+    }
+    
     // MARK: Document Change Publisher
     
     /// Add a change listener to listen to change events occurring to a document of the given document id.
@@ -450,8 +464,21 @@ public final class Collection: CollectionChangeObservable, Indexable, Equatable,
     @discardableResult public func addChangeListener(queue: DispatchQueue?,
                                                      listener: @escaping (CollectionChange) -> Void) -> ListenerToken
     {
-        let token = impl.addChangeListener(with: queue) { [unowned self] change in
-            listener(CollectionChange(collection: self, documentIDs: change.documentIDs))
+        return addChangeListener(queue: queue, options: nil, listener: listener)
+    }
+    
+    /// Add a change listener to listen to change events occurring to any documents in the collection,
+    /// with options for batching the change events delivered to the listener.
+    /// If a dispatch queue is given, the events will be posted on the dispatch queue.
+    /// To remove the listener, call remove() function on the returned listener token.
+    ///
+    /// If the collection is deleted or the database is closed, a warning message will be logged.
+    @discardableResult public func addChangeListener(queue: DispatchQueue?,
+                                                     options: CollectionChangeListenerOptions?,
+                                                     listener: @escaping (CollectionChange) -> Void) -> ListenerToken
+    {
+        let token = impl.addChangeListener(with: queue, options: options?.toImpl()) { [unowned self] change in
+            listener(CollectionChange(collection: self, impl: change))
         }
         
         return ListenerToken(token)
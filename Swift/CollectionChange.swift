@@ -18,12 +18,29 @@
 //
 
 import Foundation
+import CouchbaseLiteSwift_Private
 
 /// The collection change event
 public struct CollectionChange {
     /// The collection
     public let collection: Collection
  
-    /// The IDs of the documents that changed.
-    public let documentIDs: Array<String>
+    /// The IDs of the documents that changed. The IDs are converted to strings when first accessed.
+    public var documentIDs: Array<String> {
+        return impl.documentIDs
+    }
+    
+    /// The sequence numbers of the changed documents, in the same order as the documentIDs.
+    public var sequences: Array<UInt64> {
+        return impl.sequences.map { $0.uint64Value }
+    }
+    
+    /// The number of documents that changed.
+    public var count: Int {
+        return Int(impl.count)
+    }
+    
+    // MARK: Internal
+    
+    let impl: CBLCollectionChange
 }
@@ -0,0 +1,81 @@
+//
+//  CollectionChangeCursor.swift
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+import Foundation
+import CouchbaseLiteSwift_Private
+
+/// A pull-based cursor over the changes made to a collection, in sequence order. Each `nextBatch()`
+/// call reads at most `limit` changes after `lastSequence`, so a consumer can pull at its own rate
+/// with bounded memory. Only the latest change of each document is visible.
+///
+/// To resume after a restart, persist `lastSequence` after processing a batch and pass it to
+/// `Collection.changes(sinceSequence:limit:)`.
+public final class CollectionChangeCursor {
+    
+    /// The collection.
+    public let collection: Collection
+    
+    /// The maximum number of changes returned by each `nextBatch()` call.
+    public var limit: Int {
+        return Int(impl.limit)
+    }
+    
+    /// The sequence of the last change returned by `nextBatch()`, or the starting sequence
+    /// if no changes have been returned yet.
+    public var lastSequence: UInt64 {
+        return impl.lastSequence
+    }
+    
+    /// Returns the next batch of changes and advances `lastSequence` past them. Returns an empty
+    /// array when there are no more changes; calling it again later returns the changes made since then.
+    public func nextBatch() throws -> [ChangedDocument] {
+        return try impl.nextBatch().map {
+            ChangedDocument(documentID: $0.documentID,
+                            sequence: $0.sequence,
+                            revisionID: $0.revisionID,
+                            flags: DocumentFlags(rawValue: Int($0.flags.rawValue)))
+        }
+    }
+    
+    // MARK: Internal
+    
+    init(_ impl: CBLCollectionChangeCursor, collection: Collection) {
+        self.impl = impl
+        self.collection = collection
+    }
+    
+    let impl: CBLCollectionChangeCursor
+}
+
+/// ChangedDocument describes a document change returned by a `CollectionChangeCursor`.
+public struct ChangedDocument {
+    
+    /// The document ID.
+    public let documentID: String
+    
+    /// The sequence of the change.
+    public let sequence: UInt64
+    
+    /// The revision ID of the document after the change.
+    public let revisionID: String
+    
+    /// The flags describing the document.
+    public let flags: DocumentFlags
+    
+}
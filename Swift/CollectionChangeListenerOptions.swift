@@ -0,0 +1,51 @@
+//
+//  CollectionChangeListenerOptions.swift
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+import Foundation
+import CouchbaseLiteSwift_Private
+
+/// Options for batching the collection change events delivered to a change listener.
+/// By default, each change event is delivered as soon as it is available.
+public struct CollectionChangeListenerOptions {
+    
+    /// The maximum number of changed documents in a single change event. Larger changes are split
+    /// into multiple events. The default value is 0, which means no limit.
+    public var maxBatchSize: Int = 0
+    
+    /// The maximum time in seconds that a change may be held back so that it can be delivered
+    /// together with the following changes in a single event. An event is delivered once the delay
+    /// has passed or once it reaches the maxBatchSize. The default value is 0, which means the
+    /// changes are delivered without delay.
+    public var maxDelay: TimeInterval = 0
+    
+    /// Initializes the options with the given maximum batch size and delay.
+    public init(maxBatchSize: Int = 0, maxDelay: TimeInterval = 0) {
+        self.maxBatchSize = maxBatchSize
+        self.maxDelay = maxDelay
+    }
+    
+    // MARK: Internal
+    
+    func toImpl() -> CBLCollectionChangeListenerOptions {
+        let options = CBLCollectionChangeListenerOptions()
+        options.maxBatchSize = UInt(max(maxBatchSize, 0))
+        options.maxDelay = maxDelay
+        return options
+    }
+}
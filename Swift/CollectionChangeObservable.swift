@@ -35,4 +35,14 @@ public protocol CollectionChangeObservable {
     /// If the collection is deleted or the database is closed, a warning message will be logged.
     func addChangeListener(queue: DispatchQueue?,
                            listener: @escaping (CollectionChange) -> Void) -> ListenerToken
+    
+    /// Add a change listener to listen to change events occurring to any documents in the collection,
+    /// with options for batching the change events delivered to the listener.
+    /// If a dispatch queue is given, the events will be posted on the dispatch queue.
+    /// To remove the listener, call remove() function on the returned listener token.
+    ///
+    /// If the collection is deleted or the database is closed, a warning message will be logged.
+    func addChangeListener(queue: DispatchQueue?,
+                           options: CollectionChangeListenerOptions?,
+                           listener: @escaping (CollectionChange) -> Void) -> ListenerToken
 }
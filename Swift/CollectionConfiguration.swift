@@ -36,6 +36,23 @@ public struct CollectionConfiguration {
     /// Only documents of which the function returns true are replicated.
     public var pullFilter: ReplicationFilter?
     
+    /// Declarative filter for the documents that can be pushed to the remote endpoint. Only documents
+    /// whose properties match the expression are replicated. Unlike the push filter function, the expression
+    /// is evaluated directly on the encoded revision body without creating a Document.
+    ///
+    /// The expression may use properties, the document ID (`Meta.id`), parameters, literals, AND/OR/NOT,
+    /// the comparison operators, IS [NOT] NULL/MISSING, IS VALUED, IN and BETWEEN. Deleted documents and
+    /// documents whose access was removed are not evaluated by the expression. If the push filter function
+    /// is also set, it is called only for the documents that match the expression.
+    public var pushFilterExpression: ExpressionProtocol?
+    
+    /// Declarative filter for the documents that can be pulled from the remote endpoint.
+    /// See `pushFilterExpression` for the supported expressions.
+    public var pullFilterExpression: ExpressionProtocol?
+    
+    /// Parameter values for the parameters referenced by the push and pull filter expressions.
+    public var filterParameters: Parameters?
+    
     /// Channels filter for specifying the channels for the pull the replicator will pull from. For any
     /// collections that do not have the channels filter specified, all accessible channels will be pulled. Push
     /// replicator will ignore this filter.
@@ -86,6 +103,10 @@ public struct CollectionConfiguration {
             }
         }
         
+        config.pushFilterExpression = self.pushFilterExpression?.toImpl()
+        config.pullFilterExpression = self.pullFilterExpression?.toImpl()
+        config.filterParameters = self.filterParameters?.toImpl()
+        
         if let resolver = self.conflictResolver {
             config.setConflictResolverUsing { (conflict) -> CBLDocument? in
                 return resolver.resolve(conflict: Conflict(impl: conflict, collection: collection))?.impl
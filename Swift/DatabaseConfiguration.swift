@@ -38,6 +38,20 @@ public struct DatabaseConfiguration {
     /// is very safe but it is also dramatically slower.
     public var fullSync: Bool = defaultFullSync
     
+    /// The threshold in seconds above which a query execution is reported as a slow query.
+    /// When a query result set has been fully enumerated and the time from the start of the
+    /// execution exceeds the threshold, a warning containing the query's N1QL or JSON text and
+    /// its QueryStats is logged to the query domain of the log sinks. The default value
+    /// is zero, which disables the slow query log.
+    public var slowQueryThreshold: TimeInterval = 0
+    
+    /// The maximum size in bytes of the buffers used to copy a blob's content stream into the
+    /// database. The stream is read into one buffer while the other is written; the buffers start
+    /// small and grow up to this size while the stream fills them, so larger buffers speed up
+    /// copying large blobs at the expense of memory. The default value, zero, means 1 MB; values
+    /// smaller than 8 KB are raised to 8 KB.
+    public var blobBufferSize: UInt = 0
+    
     #if COUCHBASE_ENTERPRISE
     /// The key to encrypt the database with.
     public var encryptionKey: EncryptionKey?
@@ -53,6 +67,8 @@ public struct DatabaseConfiguration {
         if let c = config {
             self.directory = c.directory
             self.fullSync = c.fullSync
+            self.slowQueryThreshold = c.slowQueryThreshold
+            self.blobBufferSize = c.blobBufferSize
             
             #if COUCHBASE_ENTERPRISE
             self.encryptionKey = c.encryptionKey
@@ -66,6 +82,8 @@ public struct DatabaseConfiguration {
         let config = CBLDatabaseConfiguration()
         config.directory = self.directory
         config.fullSync = self.fullSync
+        config.slowQueryThreshold = self.slowQueryThreshold
+        config.blobBufferSize = self.blobBufferSize
         
         #if COUCHBASE_ENTERPRISE
         config.encryptionKey = self.encryptionKey?.impl
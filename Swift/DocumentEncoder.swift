@@ -85,9 +85,95 @@ private class DocumentEncodingContainer<Key: CodingKey>: KeyedEncodingContainerP
         try encoder._encoder.writeValue(value)
         codingPath.append(key)
     }
+
+    // Typed overloads, which write the values without going through the generic writeValue
+    
+    func encode(_ value: Bool, forKey key: Key) throws {
+        try encoder._encoder.writeKey(key)
+        try encoder._encoder.writeBool(value)
+        codingPath.append(key)
+    }
+    
+    func encode(_ value: String, forKey key: Key) throws {
+        try encoder._encoder.writeKey(key)
+        try encoder._encoder.writeString(value)
+        codingPath.append(key)
+    }
+    
+    func encode(_ value: Double, forKey key: Key) throws {
+        try encoder._encoder.writeKey(key)
+        try encoder._encoder.writeDouble(value)
+        codingPath.append(key)
+    }
+    
+    func encode(_ value: Float, forKey key: Key) throws {
+        try encoder._encoder.writeKey(key)
+        try encoder._encoder.writeFloat(value)
+        codingPath.append(key)
+    }
+    
+    func encode(_ value: Int, forKey key: Key) throws {
+        try encoder._encoder.writeKey(key)
+        try encoder._encoder.writeInt(Int64(value))
+        codingPath.append(key)
+    }
+    
+    func encode(_ value: Int8, forKey key: Key) throws {
+        try encoder._encoder.writeKey(key)
+        try encoder._encoder.writeInt(Int64(value))
+        codingPath.append(key)
+    }
+    
+    func encode(_ value: Int16, forKey key: Key) throws {
+        try encoder._encoder.writeKey(key)
+        try encoder._encoder.writeInt(Int64(value))
+        codingPath.append(key)
+    }
+    
+    func encode(_ value: Int32, forKey key: Key) throws {
+        try encoder._encoder.writeKey(key)
+        try encoder._encoder.writeInt(Int64(value))
+        codingPath.append(key)
+    }
+    
+    func encode(_ value: Int64, forKey key: Key) throws {
+        try encoder._encoder.writeKey(key)
+        try encoder._encoder.writeInt(value)
+        codingPath.append(key)
+    }
+    
+    func encode(_ value: UInt, forKey key: Key) throws {
+        try encoder._encoder.writeKey(key)
+        try encoder._encoder.writeUInt(UInt64(value))
+        codingPath.append(key)
+    }
+    
+    func encode(_ value: UInt8, forKey key: Key) throws {
+        try encoder._encoder.writeKey(key)
+        try encoder._encoder.writeUInt(UInt64(value))
+        codingPath.append(key)
+    }
+    
+    func encode(_ value: UInt16, forKey key: Key) throws {
+        try encoder._encoder.writeKey(key)
+        try encoder._encoder.writeUInt(UInt64(value))
+        codingPath.append(key)
+    }
+    
+    func encode(_ value: UInt32, forKey key: Key) throws {
+        try encoder._encoder.writeKey(key)
+        try encoder._encoder.writeUInt(UInt64(value))
+        codingPath.append(key)
+    }
+    
+    func encode(_ value: UInt64, forKey key: Key) throws {
+        try encoder._encoder.writeKey(key)
+        try encoder._encoder.writeUInt(value)
+        codingPath.append(key)
+    }
     
     func encodeIfPresent<T>(_ value: T?, forKey key: Key) throws where T : Encodable {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -97,7 +183,7 @@ private class DocumentEncodingContainer<Key: CodingKey>: KeyedEncodingContainerP
     // For some reason we have to override every overload of encodeIfPresent
     
     func encodeIfPresent(_ value: Bool?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -105,7 +191,7 @@ private class DocumentEncodingContainer<Key: CodingKey>: KeyedEncodingContainerP
     }
     
     func encodeIfPresent(_ value: String?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -113,7 +199,7 @@ private class DocumentEncodingContainer<Key: CodingKey>: KeyedEncodingContainerP
     }
     
     func encodeIfPresent(_ value: Double?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -121,7 +207,7 @@ private class DocumentEncodingContainer<Key: CodingKey>: KeyedEncodingContainerP
     }
     
     func encodeIfPresent(_ value: Float?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -129,7 +215,7 @@ private class DocumentEncodingContainer<Key: CodingKey>: KeyedEncodingContainerP
     }
     
     func encodeIfPresent(_ value: Int?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -137,7 +223,7 @@ private class DocumentEncodingContainer<Key: CodingKey>: KeyedEncodingContainerP
     }
     
     func encodeIfPresent(_ value: Int8?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -145,7 +231,7 @@ private class DocumentEncodingContainer<Key: CodingKey>: KeyedEncodingContainerP
     }
     
     func encodeIfPresent(_ value: Int16?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -153,7 +239,7 @@ private class DocumentEncodingContainer<Key: CodingKey>: KeyedEncodingContainerP
     }
     
     func encodeIfPresent(_ value: Int32?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -161,7 +247,7 @@ private class DocumentEncodingContainer<Key: CodingKey>: KeyedEncodingContainerP
     }
     
     func encodeIfPresent(_ value: Int64?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -169,7 +255,7 @@ private class DocumentEncodingContainer<Key: CodingKey>: KeyedEncodingContainerP
     }
     
     func encodeIfPresent(_ value: UInt?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -177,7 +263,7 @@ private class DocumentEncodingContainer<Key: CodingKey>: KeyedEncodingContainerP
     }
     
     func encodeIfPresent(_ value: UInt8?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -185,7 +271,7 @@ private class DocumentEncodingContainer<Key: CodingKey>: KeyedEncodingContainerP
     }
     
     func encodeIfPresent(_ value: UInt16?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -193,7 +279,7 @@ private class DocumentEncodingContainer<Key: CodingKey>: KeyedEncodingContainerP
     }
     
     func encodeIfPresent(_ value: UInt32?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -201,7 +287,7 @@ private class DocumentEncodingContainer<Key: CodingKey>: KeyedEncodingContainerP
     }
     
     func encodeIfPresent(_ value: UInt64?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -278,7 +364,7 @@ private struct ImpossibleKeyedContainer<Key: CodingKey>: KeyedEncodingContainerP
     }
     
     func encodeIfPresent<T>(_ value: T?, forKey key: Key) throws where T : Encodable {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
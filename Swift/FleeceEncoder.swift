@@ -50,26 +50,41 @@ internal class FleeceEncoder : Encoder {
     }
     
     func writeKey(_ key: String) throws {
-        if !_encoder.writeKey(key) {
-            let errorMsg = _encoder.getError() ?? "Failed to write key"
-            throw CBLError.create(CBLError.encodingError, description: errorMsg)
-        }
+        var key = key
+        let ok = key.withUTF8 { _encoder.writeKeyUTF8($0.baseAddress, length: UInt($0.count)) }
+        try _check(ok, "Failed to write key")
     }
     
     func writeValue<T>(_ value: T) throws where T: Encodable {
         switch value {
-        case is Bool:
-            try _writeNSObject(NSNumber(booleanLiteral: value as! Bool))
-        case is Int:
-            try _writeNSObject(NSNumber(value: value as! Int))
-        case is UInt:
-            try _writeNSObject(value as! UInt as NSNumber)
-        case is Float:
-            try _writeNSObject(value as! Float as NSNumber)
-        case is Double:
-            try _writeNSObject(value as! Double as NSNumber)
-        case is String:
-            try _writeNSObject(value as! String as NSString)
+        case let value as Bool:
+            try writeBool(value)
+        case let value as Int:
+            try writeInt(Int64(value))
+        case let value as Int8:
+            try writeInt(Int64(value))
+        case let value as Int16:
+            try writeInt(Int64(value))
+        case let value as Int32:
+            try writeInt(Int64(value))
+        case let value as Int64:
+            try writeInt(value)
+        case let value as UInt:
+            try writeUInt(UInt64(value))
+        case let value as UInt8:
+            try writeUInt(UInt64(value))
+        case let value as UInt16:
+            try writeUInt(UInt64(value))
+        case let value as UInt32:
+            try writeUInt(UInt64(value))
+        case let value as UInt64:
+            try writeUInt(value)
+        case let value as Float:
+            try writeFloat(value)
+        case let value as Double:
+            try writeDouble(value)
+        case let value as String:
+            try writeString(value)
         case is Data:
             throw CBLError.create(CBLError.encodingError, description: "Cannot encode raw Data, use Blob instead")
         case is Array<any Encodable>:
@@ -89,9 +104,8 @@ internal class FleeceEncoder : Encoder {
             try endDict()
         case is Blob:
             try _writeNSObject((value as! Blob).impl)
-        case is Date:
-            let string = ISO8601DateFormatter.couchbase.string(from: value as! Date)
-            try _writeNSObject(string as NSString)
+        case let value as Date:
+            try writeDate(value)
         case is NSObject:
             try _writeNSObject(value as! NSObject)
         default:
@@ -100,7 +114,38 @@ internal class FleeceEncoder : Encoder {
     }
     
     func writeNil() throws {
-        try _writeNSObject(NSNull())
+        try _check(_encoder.writeNull(), "Failed to write null")
+    }
+    
+    func writeBool(_ value: Bool) throws {
+        try _check(_encoder.writeBool(value), "Failed to write \(value)")
+    }
+    
+    func writeInt(_ value: Int64) throws {
+        try _check(_encoder.writeInt64(value), "Failed to write \(value)")
+    }
+    
+    func writeUInt(_ value: UInt64) throws {
+        try _check(_encoder.writeUInt64(value), "Failed to write \(value)")
+    }
+    
+    func writeFloat(_ value: Float) throws {
+        try _check(_encoder.writeFloat(value), "Failed to write \(value)")
+    }
+    
+    func writeDouble(_ value: Double) throws {
+        try _check(_encoder.writeDouble(value), "Failed to write \(value)")
+    }
+    
+    func writeString(_ value: String) throws {
+        var value = value
+        let ok = value.withUTF8 { _encoder.writeUTF8($0.baseAddress, length: UInt($0.count)) }
+        try _check(ok, "Failed to write string")
+    }
+    
+    /// Dates are written as ISO-8601 strings in the same format as `ISO8601DateFormatter.couchbase`.
+    func writeDate(_ value: Date) throws {
+        try _check(_encoder.writeDate(value.timeIntervalSince1970), "Failed to write date \(value)")
     }
 
     func beginArray(reserve: Int = 10) throws {
@@ -137,6 +182,13 @@ internal class FleeceEncoder : Encoder {
             throw CBLError.create(CBLError.encodingError, description: errorMsg)
         }
     }
+    
+    private func _check(_ ok: Bool, _ description: @autoclosure () -> String) throws {
+        if !ok {
+            let errorMsg = _encoder.getError() ?? description()
+            throw CBLError.create(CBLError.encodingError, description: errorMsg)
+        }
+    }
 }
 
 
@@ -177,6 +229,78 @@ internal class ArrayEncodingContainer: UnkeyedEncodingContainer {
         count += 1
         try encoder.writeValue(value)
     }
+
+    // Typed overloads, which write the values without going through the generic writeValue
+    
+    func encode(_ value: Bool) throws {
+        count += 1
+        try encoder.writeBool(value)
+    }
+    
+    func encode(_ value: String) throws {
+        count += 1
+        try encoder.writeString(value)
+    }
+    
+    func encode(_ value: Double) throws {
+        count += 1
+        try encoder.writeDouble(value)
+    }
+    
+    func encode(_ value: Float) throws {
+        count += 1
+        try encoder.writeFloat(value)
+    }
+    
+    func encode(_ value: Int) throws {
+        count += 1
+        try encoder.writeInt(Int64(value))
+    }
+    
+    func encode(_ value: Int8) throws {
+        count += 1
+        try encoder.writeInt(Int64(value))
+    }
+    
+    func encode(_ value: Int16) throws {
+        count += 1
+        try encoder.writeInt(Int64(value))
+    }
+    
+    func encode(_ value: Int32) throws {
+        count += 1
+        try encoder.writeInt(Int64(value))
+    }
+    
+    func encode(_ value: Int64) throws {
+        count += 1
+        try encoder.writeInt(value)
+    }
+    
+    func encode(_ value: UInt) throws {
+        count += 1
+        try encoder.writeUInt(UInt64(value))
+    }
+    
+    func encode(_ value: UInt8) throws {
+        count += 1
+        try encoder.writeUInt(UInt64(value))
+    }
+    
+    func encode(_ value: UInt16) throws {
+        count += 1
+        try encoder.writeUInt(UInt64(value))
+    }
+    
+    func encode(_ value: UInt32) throws {
+        count += 1
+        try encoder.writeUInt(UInt64(value))
+    }
+    
+    func encode(_ value: UInt64) throws {
+        count += 1
+        try encoder.writeUInt(value)
+    }
 }
 
 internal class DictEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProtocol {
@@ -201,9 +325,81 @@ internal class DictEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProt
         try encoder.writeKey(key)
         try encoder.writeValue(value)
     }
+
+    // Typed overloads, which write the values without going through the generic writeValue
+    
+    func encode(_ value: Bool, forKey key: Key) throws {
+        try encoder.writeKey(key)
+        try encoder.writeBool(value)
+    }
+    
+    func encode(_ value: String, forKey key: Key) throws {
+        try encoder.writeKey(key)
+        try encoder.writeString(value)
+    }
+    
+    func encode(_ value: Double, forKey key: Key) throws {
+        try encoder.writeKey(key)
+        try encoder.writeDouble(value)
+    }
+    
+    func encode(_ value: Float, forKey key: Key) throws {
+        try encoder.writeKey(key)
+        try encoder.writeFloat(value)
+    }
+    
+    func encode(_ value: Int, forKey key: Key) throws {
+        try encoder.writeKey(key)
+        try encoder.writeInt(Int64(value))
+    }
+    
+    func encode(_ value: Int8, forKey key: Key) throws {
+        try encoder.writeKey(key)
+        try encoder.writeInt(Int64(value))
+    }
+    
+    func encode(_ value: Int16, forKey key: Key) throws {
+        try encoder.writeKey(key)
+        try encoder.writeInt(Int64(value))
+    }
+    
+    func encode(_ value: Int32, forKey key: Key) throws {
+        try encoder.writeKey(key)
+        try encoder.writeInt(Int64(value))
+    }
+    
+    func encode(_ value: Int64, forKey key: Key) throws {
+        try encoder.writeKey(key)
+        try encoder.writeInt(value)
+    }
+    
+    func encode(_ value: UInt, forKey key: Key) throws {
+        try encoder.writeKey(key)
+        try encoder.writeUInt(UInt64(value))
+    }
+    
+    func encode(_ value: UInt8, forKey key: Key) throws {
+        try encoder.writeKey(key)
+        try encoder.writeUInt(UInt64(value))
+    }
+    
+    func encode(_ value: UInt16, forKey key: Key) throws {
+        try encoder.writeKey(key)
+        try encoder.writeUInt(UInt64(value))
+    }
+    
+    func encode(_ value: UInt32, forKey key: Key) throws {
+        try encoder.writeKey(key)
+        try encoder.writeUInt(UInt64(value))
+    }
+    
+    func encode(_ value: UInt64, forKey key: Key) throws {
+        try encoder.writeKey(key)
+        try encoder.writeUInt(value)
+    }
     
     func encodeIfPresent<T>(_ value: T?, forKey key: Key) throws where T : Encodable {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -213,7 +409,7 @@ internal class DictEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProt
     // For some reason we have to override every overload of encodeIfPresent
     
     func encodeIfPresent(_ value: Bool?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -221,7 +417,7 @@ internal class DictEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProt
     }
     
     func encodeIfPresent(_ value: String?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -229,7 +425,7 @@ internal class DictEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProt
     }
     
     func encodeIfPresent(_ value: Double?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -237,7 +433,7 @@ internal class DictEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProt
     }
     
     func encodeIfPresent(_ value: Float?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -245,7 +441,7 @@ internal class DictEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProt
     }
     
     func encodeIfPresent(_ value: Int?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -253,7 +449,7 @@ internal class DictEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProt
     }
     
     func encodeIfPresent(_ value: Int8?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -261,7 +457,7 @@ internal class DictEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProt
     }
     
     func encodeIfPresent(_ value: Int16?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -269,7 +465,7 @@ internal class DictEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProt
     }
     
     func encodeIfPresent(_ value: Int32?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -277,7 +473,7 @@ internal class DictEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProt
     }
     
     func encodeIfPresent(_ value: Int64?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -285,7 +481,7 @@ internal class DictEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProt
     }
     
     func encodeIfPresent(_ value: UInt?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -293,7 +489,7 @@ internal class DictEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProt
     }
     
     func encodeIfPresent(_ value: UInt8?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -301,7 +497,7 @@ internal class DictEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProt
     }
     
     func encodeIfPresent(_ value: UInt16?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -309,7 +505,7 @@ internal class DictEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProt
     }
     
     func encodeIfPresent(_ value: UInt32?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -317,7 +513,7 @@ internal class DictEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProt
     }
     
     func encodeIfPresent(_ value: UInt64?, forKey key: Key) throws {
-        if value != nil {
+        if let value {
             try encode(value, forKey: key)
         } else {
             try encodeNil(forKey: key)
@@ -358,4 +554,62 @@ internal struct FleeceSingleValueEncodingContainer: SingleValueEncodingContainer
     func encode<T>(_ value: T) throws where T: Encodable {
         try encoder.writeValue(value)
     }
+
+    // Typed overloads, which write the values without going through the generic writeValue
+    
+    func encode(_ value: Bool) throws {
+        try encoder.writeBool(value)
+    }
+    
+    func encode(_ value: String) throws {
+        try encoder.writeString(value)
+    }
+    
+    func encode(_ value: Double) throws {
+        try encoder.writeDouble(value)
+    }
+    
+    func encode(_ value: Float) throws {
+        try encoder.writeFloat(value)
+    }
+    
+    func encode(_ value: Int) throws {
+        try encoder.writeInt(Int64(value))
+    }
+    
+    func encode(_ value: Int8) throws {
+        try encoder.writeInt(Int64(value))
+    }
+    
+    func encode(_ value: Int16) throws {
+        try encoder.writeInt(Int64(value))
+    }
+    
+    func encode(_ value: Int32) throws {
+        try encoder.writeInt(Int64(value))
+    }
+    
+    func encode(_ value: Int64) throws {
+        try encoder.writeInt(value)
+    }
+    
+    func encode(_ value: UInt) throws {
+        try encoder.writeUInt(UInt64(value))
+    }
+    
+    func encode(_ value: UInt8) throws {
+        try encoder.writeUInt(UInt64(value))
+    }
+    
+    func encode(_ value: UInt16) throws {
+        try encoder.writeUInt(UInt64(value))
+    }
+    
+    func encode(_ value: UInt32) throws {
+        try encoder.writeUInt(UInt64(value))
+    }
+    
+    func encode(_ value: UInt64) throws {
+        try encoder.writeUInt(value)
+    }
 }
@@ -17,78 +17,519 @@
 //  limitations under the License.
 //
 
+import Foundation
 import CouchbaseLiteSwift_Private
 
+// The ResultSet decoder reads the Fleece values of each row directly, without creating Result,
+// DictionaryObject or ArrayObject objects for the rows. Only Blobs and values of types that
+// cannot be read directly fall back to the object conversion used by QueryResultDecoder.
 internal struct QueryResultSetDecoder: Decoder {
-    let resultSet: ResultSet
+    let resultSet: CBLQueryResultSet
     let dataKey: String?
-    
-    init(resultSet: ResultSet, dataKey: String? = nil) {
+
+    init(resultSet: CBLQueryResultSet, dataKey: String? = nil) {
         self.resultSet = resultSet
         self.dataKey = dataKey
     }
-    
+
     var codingPath: [any CodingKey] = []
-    
+
     public var userInfo: [CodingUserInfoKey : Any] { return [:] }
 
     func container<Key>(keyedBy type: Key.Type) throws -> KeyedDecodingContainer<Key> where Key : CodingKey {
         throw CBLError.create(CBLError.decodingError, description: "ResultSet decoding requires an unkeyed container")
     }
-    
+
     func unkeyedContainer() throws -> any UnkeyedDecodingContainer {
-        let first = resultSet.next()
-        return QueryResultSetDecodingContainer(resultSet: resultSet, dataKey: dataKey, next: first)
+        let context = RowDecodingContext(resultSet: resultSet, dataKey: dataKey)
+        return QueryResultSetDecodingContainer(context: context, hasRow: resultSet.advanceRow())
     }
-    
+
     func singleValueContainer() throws -> any SingleValueDecodingContainer {
         throw CBLError.create(CBLError.decodingError, description: "ResultSet decoding requires an unkeyed container")
     }
 }
 
-private struct QueryResultSetDecodingContainer : UnkeyedDecodingContainer {
-    let resultSet: ResultSet
+/// The state shared by all decoders of a ResultSet decoding: the column indexes and
+/// the dictionary keys, which are created once and reused for every row.
+private final class RowDecodingContext {
+    let resultSet: CBLQueryResultSet
+    let columns: [String: Int]
     let dataKey: String?
-    var next: Result?
-    
-    init(resultSet: ResultSet, dataKey: String?, next: Result?) {
+    private var keys: [String: CBLDecoderKey] = [:]
+
+    init(resultSet: CBLQueryResultSet, dataKey: String?) {
         self.resultSet = resultSet
         self.dataKey = dataKey
-        self.next = next
+        var columns: [String: Int] = [:]
+        for (name, index) in resultSet.columnIndexes() {
+            columns[name] = index.intValue
+        }
+        self.columns = columns
+    }
+
+    func key(_ name: String) -> CBLDecoderKey {
+        if let key = keys[name] {
+            return key
+        }
+        let key = CBLDecoderKey(name: name)
+        keys[name] = key
+        return key
+    }
+
+    func column(_ name: String) -> UnsafeRawPointer? {
+        guard let index = columns[name] else {
+            return nil
+        }
+        return resultSet.rowValue(at: UInt(index))
+    }
+
+    func decode<T: Decodable>(_ type: T.Type, from value: UnsafeRawPointer) throws -> T {
+        let decoder = RowValueDecoder(context: self, value: value)
+        // Override to avoid the default Date decode implementation, and to create Blobs directly
+        if type is Date.Type || type is Blob.Type {
+            return try RowValueSingleValueContainer(decoder: decoder).decode(type)
+        }
+        return try T(from: decoder)
+    }
+}
+
+private struct QueryResultSetDecodingContainer : UnkeyedDecodingContainer {
+    let context: RowDecodingContext
+    var hasRow: Bool
+
+    init(context: RowDecodingContext, hasRow: Bool) {
+        self.context = context
+        self.hasRow = hasRow
     }
-    
+
     var codingPath: [any CodingKey] = []
-    
+
     var count: Int? { return nil }
-    
-    var isAtEnd: Bool { return next == nil }
-    
+
+    var isAtEnd: Bool { return !hasRow }
+
     var currentIndex: Int = 0
-    
+
     func decodeNil() throws -> Bool {
         return false
     }
-    
+
     mutating func decode<T>(_ type: T.Type) throws -> T where T : Decodable {
-        guard let next = self.next else {
+        guard hasRow else {
             throw CBLError.create(CBLError.decodingError, description: "No value at index \(currentIndex) in ResultSet")
         }
-        let decoder = QueryResultDecoder(queryResult: next, dataKey: dataKey)
-        let val = try T.init(from: decoder)
+        // The row values are only valid until the next row, so the row is fully decoded first:
+        let val = try T.init(from: QueryRowDecoder(context: context))
         currentIndex += 1
-        self.next = resultSet.next()
+        hasRow = context.resultSet.advanceRow()
         return val
     }
-    
+
     mutating func nestedContainer<NestedKey>(keyedBy type: NestedKey.Type) throws -> KeyedDecodingContainer<NestedKey> where NestedKey : CodingKey {
         throw CBLError.create(CBLError.decodingError, description: "No nested container in ResultSet")
     }
-    
+
     mutating func nestedUnkeyedContainer() throws -> any UnkeyedDecodingContainer {
         throw CBLError.create(CBLError.decodingError, description: "No nested container in ResultSet")
     }
-    
+
     mutating func superDecoder() throws -> any Decoder {
         throw CBLError.create(CBLError.decodingError, description: "No nested container in ResultSet")
     }
 }
+
+// MARK: Row
+
+private struct QueryRowDecoder: Decoder {
+    let context: RowDecodingContext
+
+    var codingPath: [any CodingKey] = []
+
+    public var userInfo: [CodingUserInfoKey : Any] { [:] }
+
+    func container<Key>(keyedBy type: Key.Type) throws -> KeyedDecodingContainer<Key> where Key : CodingKey {
+        KeyedDecodingContainer(QueryRowDecodingContainer(context: context))
+    }
+
+    func unkeyedContainer() throws -> any UnkeyedDecodingContainer {
+        throw CBLError.create(CBLError.decodingError, description: "Result decoding requires a keyed container")
+    }
+
+    func singleValueContainer() throws -> any SingleValueDecodingContainer {
+        throw CBLError.create(CBLError.decodingError, description: "Result decoding requires a keyed container")
+    }
+}
+
+private struct QueryRowDecodingContainer<Key: CodingKey> : KeyedDecodingContainerProtocol {
+    let context: RowDecodingContext
+    let nestedDict: UnsafeRawPointer?
+
+    init(context: RowDecodingContext) {
+        self.context = context
+        // The actual document may be in a nested dictionary, if `SELECT id, *` was used
+        if let dataKey = context.dataKey, let value = context.column(dataKey),
+           CBLDecoder.valueType(value) == .dict {
+            self.nestedDict = value
+        } else {
+            self.nestedDict = nil
+        }
+    }
+
+    var codingPath: [any CodingKey] = []
+
+    var allKeys: [Key] {
+        var keys = context.columns.keys.filter { context.column($0) != nil }
+        if let nested = nestedDict {
+            for key in CBLDecoder.keys(ofDict: nested) where !keys.contains(key) {
+                keys.append(key)
+            }
+        }
+        return keys.compactMap { Key(stringValue: $0) }
+    }
+
+    private func value(forName name: String) -> UnsafeRawPointer? {
+        if let value = context.column(name) {
+            return value
+        }
+        if let nested = nestedDict {
+            return CBLDecoder.dict(nested, valueFor: context.key(name))
+        }
+        return nil
+    }
+
+    private func requiredValue(forName name: String) throws -> UnsafeRawPointer {
+        guard let value = value(forName: name) else {
+            throw CBLError.create(CBLErrorInvalidQuery, description: "Query is missing field '\(name)'")
+        }
+        return value
+    }
+
+    private func requiredValue(forKey key: Key) throws -> UnsafeRawPointer {
+        try requiredValue(forName: key.stringValue)
+    }
+
+    func contains(_ key: Key) -> Bool {
+        value(forName: key.stringValue) != nil
+    }
+
+    func decodeNil(forKey key: Key) throws -> Bool {
+        CBLDecoder.valueType(try requiredValue(forKey: key)) == .null
+    }
+
+    func decode<T>(_ type: T.Type, forKey key: Key) throws -> T where T : Decodable {
+        try context.decode(type, from: try requiredValue(forKey: key))
+    }
+
+    func nestedContainer<NestedKey>(keyedBy type: NestedKey.Type, forKey key: Key) throws -> KeyedDecodingContainer<NestedKey> where NestedKey : CodingKey {
+        let decoder = RowValueDecoder(context: context, value: try requiredValue(forKey: key))
+        return try decoder.container(keyedBy: type)
+    }
+
+    func nestedUnkeyedContainer(forKey key: Key) throws -> any UnkeyedDecodingContainer {
+        let decoder = RowValueDecoder(context: context, value: try requiredValue(forKey: key))
+        return try decoder.unkeyedContainer()
+    }
+
+    func superDecoder() throws -> any Decoder {
+        RowValueDecoder(context: context, value: try requiredValue(forName: "super"))
+    }
+
+    func superDecoder(forKey key: Key) throws -> any Decoder {
+        RowValueDecoder(context: context, value: try requiredValue(forKey: key))
+    }
+}
+
+// MARK: Value
+
+private struct RowValueDecoder: Decoder {
+    let context: RowDecodingContext
+    let value: UnsafeRawPointer
+
+    var codingPath: [any CodingKey] = []
+
+    public var userInfo: [CodingUserInfoKey : Any] { [:] }
+
+    var valueDescription: String {
+        String(describing: context.resultSet.object(forRowValue: value) ?? NSNull())
+    }
+
+    func container<Key>(keyedBy type: Key.Type) throws -> KeyedDecodingContainer<Key> where Key : CodingKey {
+        guard CBLDecoder.valueType(value) == .dict else {
+            throw CBLError.create(CBLError.decodingError, description: "Value \(valueDescription) is not a keyed container")
+        }
+        return KeyedDecodingContainer(RowValueDictDecodingContainer<Key>(context: context, dict: value))
+    }
+
+    func unkeyedContainer() throws -> any UnkeyedDecodingContainer {
+        guard CBLDecoder.valueType(value) == .array else {
+            throw CBLError.create(CBLError.decodingError, description: "Value \(valueDescription) is not an unkeyed container")
+        }
+        return RowValueArrayDecodingContainer(context: context, array: value)
+    }
+
+    func singleValueContainer() throws -> any SingleValueDecodingContainer {
+        switch CBLDecoder.valueType(value) {
+        case .array, .dict:
+            throw CBLError.create(CBLError.decodingError, description: "Value \(valueDescription) cannot be decoded as a single value")
+        default:
+            return RowValueSingleValueContainer(decoder: self)
+        }
+    }
+}
+
+private struct RowValueDictDecodingContainer<Key: CodingKey>: KeyedDecodingContainerProtocol {
+    let context: RowDecodingContext
+    let dict: UnsafeRawPointer
+
+    var codingPath: [CodingKey] = []
+
+    private func value(forKey key: Key) throws -> UnsafeRawPointer {
+        guard let value = CBLDecoder.dict(dict, valueFor: context.key(key.stringValue)) else {
+            throw CBLError.create(CBLError.decodingError, description: "Dictionary is missing key '\(key.stringValue)'")
+        }
+        return value
+    }
+
+    func contains(_ key: Key) -> Bool {
+        CBLDecoder.dict(dict, valueFor: context.key(key.stringValue)) != nil
+    }
+
+    var allKeys: [Key] {
+        CBLDecoder.keys(ofDict: dict).compactMap { Key(stringValue: $0) }
+    }
+
+    func decodeNil(forKey key: Key) throws -> Bool {
+        CBLDecoder.valueType(try value(forKey: key)) == .null
+    }
+
+    func decode<T>(_ type: T.Type, forKey key: Key) throws -> T where T: Decodable {
+        try context.decode(type, from: try value(forKey: key))
+    }
+
+    func nestedContainer<NestedKey>(keyedBy type: NestedKey.Type, forKey key: Key) throws -> KeyedDecodingContainer<NestedKey> where NestedKey: CodingKey {
+        try RowValueDecoder(context: context, value: try value(forKey: key)).container(keyedBy: type)
+    }
+
+    func nestedUnkeyedContainer(forKey key: Key) throws -> any UnkeyedDecodingContainer {
+        try RowValueDecoder(context: context, value: try value(forKey: key)).unkeyedContainer()
+    }
+
+    func superDecoder() throws -> any Decoder {
+        guard let value = CBLDecoder.dict(dict, valueFor: context.key("super")) else {
+            throw CBLError.create(CBLError.decodingError, description: "Dictionary is missing key 'super'")
+        }
+        return RowValueDecoder(context: context, value: value)
+    }
+
+    func superDecoder(forKey key: Key) throws -> any Decoder {
+        RowValueDecoder(context: context, value: try value(forKey: key))
+    }
+}
+
+private struct RowValueArrayDecodingContainer: UnkeyedDecodingContainer {
+    let context: RowDecodingContext
+    let array: UnsafeRawPointer
+    let arrayCount: Int
+
+    init(context: RowDecodingContext, array: UnsafeRawPointer) {
+        self.context = context
+        self.array = array
+        self.arrayCount = Int(CBLDecoder.count(array))
+    }
+
+    var codingPath: [any CodingKey] = []
+
+    var count: Int? { return arrayCount }
+
+    var isAtEnd: Bool { return currentIndex == arrayCount }
+
+    var currentIndex: Int = 0
+
+    private func currentValue() throws -> UnsafeRawPointer {
+        guard currentIndex < arrayCount, let value = CBLDecoder.array(array, valueAt: UInt(currentIndex)) else {
+            throw CBLError.create(CBLError.decodingError, description: "Array is missing index \(currentIndex)")
+        }
+        return value
+    }
+
+    mutating func decodeNil() throws -> Bool {
+        if CBLDecoder.valueType(try currentValue()) == .null {
+            currentIndex += 1
+            return true
+        }
+        return false
+    }
+
+    mutating func decode<T>(_ type: T.Type) throws -> T where T: Decodable {
+        let val = try context.decode(type, from: try currentValue())
+        currentIndex += 1
+        return val
+    }
+
+    mutating func nestedContainer<NestedKey>(keyedBy type: NestedKey.Type) throws -> KeyedDecodingContainer<NestedKey> where NestedKey: CodingKey {
+        let container = try RowValueDecoder(context: context, value: try currentValue()).container(keyedBy: type)
+        currentIndex += 1
+        return container
+    }
+
+    mutating func nestedUnkeyedContainer() throws -> any UnkeyedDecodingContainer {
+        let container = try RowValueDecoder(context: context, value: try currentValue()).unkeyedContainer()
+        currentIndex += 1
+        return container
+    }
+
+    mutating func superDecoder() throws -> any Decoder {
+        let decoder = RowValueDecoder(context: context, value: try currentValue())
+        currentIndex += 1
+        return decoder
+    }
+}
+
+private struct RowValueSingleValueContainer: SingleValueDecodingContainer {
+    let decoder: RowValueDecoder
+
+    var codingPath: [any CodingKey] { return decoder.codingPath }
+
+    private var value: UnsafeRawPointer { decoder.value }
+
+    private func mismatch(_ expected: String) -> Error {
+        CBLError.create(CBLError.decodingError, description: "Type mismatch: expected \(expected) but found \(decoder.valueDescription)")
+    }
+
+    func decodeNil() -> Bool {
+        CBLDecoder.valueType(value) == .null
+    }
+
+    func decode(_ type: Bool.Type) throws -> Bool {
+        switch CBLDecoder.valueType(value) {
+        case .boolean:
+            return CBLDecoder.boolValue(value)
+        case .number where CBLDecoder.isInteger(value):
+            // Booleans may be stored as the integers 0 and 1:
+            switch CBLDecoder.int64Value(value) {
+            case 0: return false
+            case 1: return true
+            default: throw mismatch("Bool")
+            }
+        default:
+            throw mismatch("Bool")
+        }
+    }
+
+    private func decodeInteger<T: FixedWidthInteger>(_ type: T.Type) throws -> T {
+        guard CBLDecoder.valueType(value) == .number else {
+            throw mismatch("\(T.self)")
+        }
+        let result: T?
+        if !CBLDecoder.isInteger(value) {
+            result = T(exactly: CBLDecoder.doubleValue(value))
+        } else if CBLDecoder.isUnsigned(value) {
+            result = T(exactly: CBLDecoder.uint64Value(value))
+        } else {
+            result = T(exactly: CBLDecoder.int64Value(value))
+        }
+        guard let result else {
+            throw mismatch("\(T.self)")
+        }
+        return result
+    }
+
+    func decode(_ type: Int.Type) throws -> Int { try decodeInteger(type) }
+    func decode(_ type: Int8.Type) throws -> Int8 { try decodeInteger(type) }
+    func decode(_ type: Int16.Type) throws -> Int16 { try decodeInteger(type) }
+    func decode(_ type: Int32.Type) throws -> Int32 { try decodeInteger(type) }
+    func decode(_ type: Int64.Type) throws -> Int64 { try decodeInteger(type) }
+    func decode(_ type: UInt.Type) throws -> UInt { try decodeInteger(type) }
+    func decode(_ type: UInt8.Type) throws -> UInt8 { try decodeInteger(type) }
+    func decode(_ type: UInt16.Type) throws -> UInt16 { try decodeInteger(type) }
+    func decode(_ type: UInt32.Type) throws -> UInt32 { try decodeInteger(type) }
+    func decode(_ type: UInt64.Type) throws -> UInt64 { try decodeInteger(type) }
+
+    func decode(_ type: Float.Type) throws -> Float {
+        guard CBLDecoder.valueType(value) == .number else {
+            throw mismatch("Float")
+        }
+        return Float(CBLDecoder.doubleValue(value))
+    }
+
+    func decode(_ type: Double.Type) throws -> Double {
+        guard CBLDecoder.valueType(value) == .number else {
+            throw mismatch("Double")
+        }
+        return CBLDecoder.doubleValue(value)
+    }
+
+    func decode(_ type: String.Type) throws -> String {
+        var length: UInt = 0
+        guard let bytes = CBLDecoder.stringBytes(value, length: &length) else {
+            throw mismatch("String")
+        }
+        return String(decoding: UnsafeRawBufferPointer(start: bytes, count: Int(length)), as: UTF8.self)
+    }
+
+    func decode(_ type: Date.Type) throws -> Date {
+        guard CBLDecoder.valueType(value) == .string else {
+            throw mismatch("Date encoded as String")
+        }
+        let string = try decode(String.self)
+        if let date = ISO8601DateFormatter.couchbase.date(from: string) {
+            return date
+        } else if let date = ISO8601DateFormatter().date(from: string) {
+            // CBL-7061: See FleeceDecoder.
+            return date
+        } else {
+            throw CBLError.create(CBLError.decodingError, description: "Failed to parse ISO8601 Date from '\(string)'")
+        }
+    }
+
+    func decode<T>(_ type: T.Type) throws -> T where T: Decodable {
+        switch type {
+        case is Bool.Type:
+            return try decode(Bool.self) as! T
+        case is Int.Type:
+            return try decode(Int.self) as! T
+        case is Int8.Type:
+            return try decode(Int8.self) as! T
+        case is Int16.Type:
+            return try decode(Int16.self) as! T
+        case is Int32.Type:
+            return try decode(Int32.self) as! T
+        case is Int64.Type:
+            return try decode(Int64.self) as! T
+        case is UInt.Type:
+            return try decode(UInt.self) as! T
+        case is UInt8.Type:
+            return try decode(UInt8.self) as! T
+        case is UInt16.Type:
+            return try decode(UInt16.self) as! T
+        case is UInt32.Type:
+            return try decode(UInt32.self) as! T
+        case is UInt64.Type:
+            return try decode(UInt64.self) as! T
+        case is Float.Type:
+            return try decode(Float.self) as! T
+        case is Double.Type:
+            return try decode(Double.self) as! T
+        case is String.Type:
+            return try decode(String.self) as! T
+        case is Date.Type:
+            return try decode(Date.self) as! T
+        default:
+            return try decodeObject(type)
+        }
+    }
+
+    // Blobs and any other types which can't be read from the Fleece value directly are decoded
+    // from the converted object, the same way as QueryResultDecoder does.
+    private func decodeObject<T>(_ type: T.Type) throws -> T where T: Decodable {
+        let object = DataConverter.convertGETValue(decoder.context.resultSet.object(forRowValue: value))
+        guard let object, let fleeceValue = FleeceValue(object, as: T.self) else {
+            throw mismatch("\(T.self)")
+        }
+        if case .blob(let blob) = fleeceValue, let blob = blob as? T {
+            return blob
+        }
+        return try T(from: FleeceDecoder(fleeceValue: fleeceValue))
+    }
+}
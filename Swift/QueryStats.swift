@@ -0,0 +1,57 @@
+//
+//  QueryStats.swift
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+import Foundation
+import CouchbaseLiteSwift_Private
+
+/// QueryStats contains the execution statistics of a query result set.
+/// The stats are a snapshot taken at the time they are requested from the result set;
+/// the timings of a result set that has not been fully enumerated are partial.
+public struct QueryStats {
+    
+    /// The time in seconds spent compiling the query.
+    public let compileTime: TimeInterval
+    
+    /// The time in seconds from starting the query execution until the first row was available.
+    public let firstRowLatency: TimeInterval
+    
+    /// The time in seconds from starting the query execution until the last row was enumerated.
+    public let enumerationTime: TimeInterval
+    
+    /// The number of rows enumerated so far.
+    public let rowCount: UInt64
+    
+    /// True if the query plan scans a whole collection instead of using an index.
+    public let fullScan: Bool
+    
+    /// True if the result set has been fully enumerated.
+    public let complete: Bool
+    
+    // MARK: Internal
+    
+    init(impl: CBLQueryStats) {
+        self.compileTime = impl.compileTime
+        self.firstRowLatency = impl.firstRowLatency
+        self.enumerationTime = impl.enumerationTime
+        self.rowCount = impl.rowCount
+        self.fullScan = impl.fullScan
+        self.complete = impl.complete
+    }
+    
+}
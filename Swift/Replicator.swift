@@ -105,6 +105,14 @@ public final class Replicator {
         return impl.correlationID
     }
     
+    /// A snapshot of the replicator's throughput and latency metrics. The rates of the snapshot
+    /// are averaged over the time since the replicator was first started.
+    /// The per-direction document counts are only collected while a metrics listener or a document
+    /// replication listener is registered; otherwise they stay zero.
+    public var metrics: ReplicatorMetrics {
+        return ReplicatorMetrics(impl: impl.metrics)
+    }
+    
     /// Starts the replicator. This method returns immediately; the replicator runs asynchronously
     /// and will report its progress through the replicator change notification.
     ///  - Note: This method MUST NOT be called within database's inBatch() block, as it will enter deadlock.
@@ -198,6 +206,26 @@ public final class Replicator {
         return ListenerToken(token)
     }
     
+    /// Adds a metrics listener that is called periodically with a snapshot of the replicator's
+    /// metrics, whose rates are measured over the time since the previous call. If the dispatch
+    /// queue is not specified, the metrics will be posted on the main queue.
+    ///
+    /// The per-direction document counts are collected while a metrics listener is registered; like
+    /// document replication listeners, the listener needs to be added before starting the replicator.
+    ///
+    /// - Parameters:
+    ///   - interval: The time in seconds between two calls; must be greater than zero.
+    ///   - queue: The dispatch queue.
+    ///   - listener: The listener to post the metrics.
+    /// - Returns: An opaque listener token object for removing the listener.
+    @discardableResult public func addMetricsListener(interval: TimeInterval, withQueue queue: DispatchQueue? = nil,
+        _ listener: @escaping (ReplicatorMetrics) -> Void) -> ListenerToken {
+        let token = impl.addMetricsListener(withInterval: interval, queue: queue, listener: { (metrics) in
+            listener(ReplicatorMetrics(impl: metrics))
+        })
+        return ListenerToken(token)
+    }
+    
     // MARK: Combine Publisher
     
     /// Returns a Combine publisher that emits `ReplicatorChange` events when
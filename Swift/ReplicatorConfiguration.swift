@@ -194,6 +194,112 @@ public struct ReplicatorConfiguration {
     /// - Note: Auto purge will not be performed when documentIDs filter is specified.
     public var enableAutoPurge: Bool = ReplicatorConfiguration.defaultEnableAutoPurge
     
+    /// The minimum size in bytes of the receive window: the amount of received data the replicator
+    /// holds in memory before it has processed it. When the window is full, the replicator stops
+    /// reading from the connection, which slows down the remote peer.
+    ///
+    /// The window adapts to the rate at which the replicator processes the received data and to
+    /// the round-trip time of the connection, between `minReceiveWindow` and `maxReceiveWindow`.
+    /// The default value, zero, means 16KB.
+    public var minReceiveWindow: UInt = 0
+    
+    /// The maximum size in bytes of the receive window. Lower it on memory-constrained devices;
+    /// raise it for high-bandwidth connections with a long round-trip time.
+    ///
+    /// The default value, zero, means 4MB. A value less than `minReceiveWindow` fixes the window
+    /// at `minReceiveWindow`.
+    public var maxReceiveWindow: UInt = 0
+    
+    /// Compresses the replication messages with the WebSocket permessage-deflate extension, if the
+    /// server supports it. Compression reduces the data sent over slow or metered connections, at
+    /// the cost of CPU time on both sides.
+    ///
+    /// The default value is false.
+    public var enableCompression: Bool = false
+    
+    /// The compression level, from 1 (fastest) to 9 (smallest). The default value, zero, means 6.
+    ///
+    /// Setting the compressionLevel to a value larger than 9 will result in
+    /// InvalidArgumentException being thrown.
+    public var compressionLevel: UInt = 0 {
+        willSet(newValue) {
+            guard newValue <= 9 else {
+                NSException(name: .invalidArgumentException,
+                            reason: "Attempt to store a value larger than 9 in compressionLevel",
+                            userInfo: nil).raise()
+                return
+            }
+        }
+    }
+    
+    /// The size of the compression window, as a power of two, from 9 (512 bytes) to 15 (32KB).
+    /// A smaller window uses less memory on both sides of the connection but compresses less.
+    /// The server is asked to use the same window. The default value, zero, means 15.
+    ///
+    /// Setting the compressionWindowBits to a non-zero value outside 9-15 will result in
+    /// InvalidArgumentException being thrown.
+    public var compressionWindowBits: UInt = 0 {
+        willSet(newValue) {
+            guard newValue == 0 || (9...15).contains(newValue) else {
+                NSException(name: .invalidArgumentException,
+                            reason: "Attempt to store a value outside 9-15 in compressionWindowBits",
+                            userInfo: nil).raise()
+                return
+            }
+        }
+    }
+    
+    /// Disables Nagle's algorithm on the connection, so that small messages such as acknowledgements
+    /// are sent at once instead of being held back to be combined with later data.
+    ///
+    /// The default value is false.
+    public var tcpNoDelay: Bool = false
+    
+    /// Enables TCP keepalive on the connection: after this many seconds without data, the connection
+    /// is probed, so that a dead connection is detected even while the replicator is idle.
+    ///
+    /// The default value, zero, leaves keepalive disabled.
+    public var tcpKeepAliveIdle: UInt = 0
+    
+    /// The time in seconds between TCP keepalive probes, when `tcpKeepAliveIdle` is set.
+    /// The default value, zero, uses the system's default.
+    public var tcpKeepAliveInterval: UInt = 0
+    
+    /// The number of unanswered TCP keepalive probes after which the connection is dropped, when
+    /// `tcpKeepAliveIdle` is set. The default value, zero, uses the system's default.
+    public var tcpKeepAliveCount: UInt = 0
+    
+    /// The size in bytes of the socket's send buffer. The default value, zero, uses the system's
+    /// default.
+    public var socketSendBufferSize: UInt = 0
+    
+    /// The size in bytes of the socket's receive buffer. Raise it for high-bandwidth connections with
+    /// a long round-trip time. The default value, zero, uses the system's default.
+    public var socketReceiveBufferSize: UInt = 0
+    
+    /// Connects by resolving the host and racing the connection attempts to its IPv6 and IPv4
+    /// addresses (RFC 8305, "Happy Eyeballs"), instead of letting the system connect to the host.
+    /// This avoids long stalls when one address family is broken on the network.
+    ///
+    /// The connection is made with BSD sockets, which unlike the system's host connections don't
+    /// turn on the cellular radio or connect an on-demand VPN. It isn't used through a SOCKS proxy.
+    ///
+    /// The default value is false.
+    public var raceConnectionAttempts: Bool = false
+    
+    /// Limits the rate at which the replicator sends data. Set the same limiter on several
+    /// configurations to share the bandwidth among their replicators.
+    ///
+    /// The default value is nil, meaning no limit.
+    public var sendBandwidthLimiter: BandwidthLimiter?
+    
+    /// Limits the rate at which the replicator reads data from the connection; once the limit is
+    /// reached the server is held back by TCP flow control. Set the same limiter on several
+    /// configurations to share the bandwidth among their replicators.
+    ///
+    /// The default value is nil, meaning no limit.
+    public var receiveBandwidthLimiter: BandwidthLimiter?
+    
     /// Initializes a `ReplicatorConfiguration` with the specified collection configurations and target's endpoint.
     ///
     /// Each `CollectionConfiguration` in the collections array must be initialized using `init(collections:)`.
@@ -234,6 +340,20 @@ public struct ReplicatorConfiguration {
         self.maxAttempts = config.maxAttempts
         self.maxAttemptWaitTime = config.maxAttemptWaitTime
         self.enableAutoPurge = config.enableAutoPurge
+        self.minReceiveWindow = config.minReceiveWindow
+        self.maxReceiveWindow = config.maxReceiveWindow
+        self.enableCompression = config.enableCompression
+        self.compressionLevel = config.compressionLevel
+        self.compressionWindowBits = config.compressionWindowBits
+        self.tcpNoDelay = config.tcpNoDelay
+        self.tcpKeepAliveIdle = config.tcpKeepAliveIdle
+        self.tcpKeepAliveInterval = config.tcpKeepAliveInterval
+        self.tcpKeepAliveCount = config.tcpKeepAliveCount
+        self.socketSendBufferSize = config.socketSendBufferSize
+        self.socketReceiveBufferSize = config.socketReceiveBufferSize
+        self.raceConnectionAttempts = config.raceConnectionAttempts
+        self.sendBandwidthLimiter = config.sendBandwidthLimiter
+        self.receiveBandwidthLimiter = config.receiveBandwidthLimiter
         self.collectionConfigMap = config.collectionConfigMap
         
         #if os(iOS)
@@ -267,6 +387,20 @@ public struct ReplicatorConfiguration {
         c.maxAttempts = self.maxAttempts
         c.maxAttemptWaitTime = self.maxAttemptWaitTime
         c.enableAutoPurge = self.enableAutoPurge
+        c.minReceiveWindow = self.minReceiveWindow
+        c.maxReceiveWindow = self.maxReceiveWindow
+        c.enableCompression = self.enableCompression
+        c.compressionLevel = self.compressionLevel
+        c.compressionWindowBits = self.compressionWindowBits
+        c.tcpNoDelay = self.tcpNoDelay
+        c.tcpKeepAliveIdle = self.tcpKeepAliveIdle
+        c.tcpKeepAliveInterval = self.tcpKeepAliveInterval
+        c.tcpKeepAliveCount = self.tcpKeepAliveCount
+        c.socketSendBufferSize = self.socketSendBufferSize
+        c.socketReceiveBufferSize = self.socketReceiveBufferSize
+        c.raceConnectionAttempts = self.raceConnectionAttempts
+        c.sendBandwidthLimiter = self.sendBandwidthLimiter?.impl
+        c.receiveBandwidthLimiter = self.receiveBandwidthLimiter?.impl
         
         #if os(iOS)
         c.allowReplicatingInBackground = self.allowReplicatingInBackground
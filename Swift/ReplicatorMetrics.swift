@@ -0,0 +1,125 @@
+//
+//  ReplicatorMetrics.swift
+//  CouchbaseLite
+//
+//  Copyright (c) 2026 Couchbase, Inc All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+import Foundation
+import CouchbaseLiteSwift_Private
+
+/// ReplicatorMetrics is a snapshot of a replicator's throughput and latency counters.
+/// The counters accumulate from the first time the replicator is started. The rates are averaged
+/// over the `interval` of the snapshot: the replicator's whole run for a snapshot read from the
+/// replicator's metrics property, or the time since the previous call for a snapshot posted to
+/// a metrics listener.
+///
+/// The document counts are only collected while a metrics listener or a document replication
+/// listener is registered. The byte counts are only collected by replicators with a URL endpoint.
+public struct ReplicatorMetrics {
+    
+    /// The time in seconds since the replicator was first started.
+    public let elapsedTime: TimeInterval
+    
+    /// The time in seconds over which the rates of this snapshot are measured.
+    public let interval: TimeInterval
+    
+    /// The number of documents pushed.
+    public let documentsPushed: UInt64
+    
+    /// The number of documents pulled, including the documents whose conflicts were resolved.
+    public let documentsPulled: UInt64
+    
+    /// The number of documents pushed per second.
+    public let documentsPushedPerSecond: Double
+    
+    /// The number of documents pulled per second.
+    public let documentsPulledPerSecond: Double
+    
+    /// The number of bytes written to the WebSocket connection.
+    public let bytesSent: UInt64
+    
+    /// The number of bytes read from the WebSocket connection.
+    public let bytesReceived: UInt64
+    
+    /// The number of bytes written to the WebSocket connection per second.
+    public let bytesSentPerSecond: Double
+    
+    /// The number of bytes read from the WebSocket connection per second.
+    public let bytesReceivedPerSecond: Double
+    
+    /// The number of pulled documents that were in conflict.
+    public let conflictCount: UInt64
+    
+    /// The number of conflicts resolved.
+    public let resolvedConflictCount: UInt64
+    
+    /// The average time in seconds from pulling a conflict until it was resolved.
+    public let averageConflictResolutionLatency: TimeInterval
+    
+    /// The longest time in seconds from pulling a conflict until it was resolved.
+    public let maxConflictResolutionLatency: TimeInterval
+    
+    /// The time in seconds the WebSocket stopped reading because too much received data was pending.
+    public let throttledTime: TimeInterval
+    
+    /// The number of times the WebSocket stopped reading because its receive window was full.
+    public let throttleCount: UInt64
+    
+    /// The number of times the replicator reconnected after going offline.
+    public let reconnectCount: UInt64
+    
+    /// The number of TCP connections the WebSocket made to the server.
+    public let connectCount: UInt64
+    
+    /// The number of TCP connection attempts. It's only above connectCount with
+    /// raceConnectionAttempts, when the first address tried, or the first address family, was slow
+    /// or unreachable.
+    public let connectAttemptCount: UInt64
+    
+    /// The average time in seconds to resolve the server's address and connect to it.
+    public let averageConnectTime: TimeInterval
+    
+    /// The time in seconds the WebSocket waited to send or read data because of the configured
+    /// bandwidth limiters.
+    public let shapedTime: TimeInterval
+    
+    // MARK: Internal
+    
+    init(impl: CBLReplicatorMetrics) {
+        self.elapsedTime = impl.elapsedTime
+        self.interval = impl.interval
+        self.documentsPushed = impl.documentsPushed
+        self.documentsPulled = impl.documentsPulled
+        self.documentsPushedPerSecond = impl.documentsPushedPerSecond
+        self.documentsPulledPerSecond = impl.documentsPulledPerSecond
+        self.bytesSent = impl.bytesSent
+        self.bytesReceived = impl.bytesReceived
+        self.bytesSentPerSecond = impl.bytesSentPerSecond
+        self.bytesReceivedPerSecond = impl.bytesReceivedPerSecond
+        self.conflictCount = impl.conflictCount
+        self.resolvedConflictCount = impl.resolvedConflictCount
+        self.averageConflictResolutionLatency = impl.averageConflictResolutionLatency
+        self.maxConflictResolutionLatency = impl.maxConflictResolutionLatency
+        self.throttledTime = impl.throttledTime
+        self.throttleCount = impl.throttleCount
+        self.reconnectCount = impl.reconnectCount
+        self.connectCount = impl.connectCount
+        self.connectAttemptCount = impl.connectAttemptCount
+        self.averageConnectTime = impl.averageConnectTime
+        self.shapedTime = impl.shapedTime
+    }
+    
+}
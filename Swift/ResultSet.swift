@@ -49,10 +49,28 @@ public final class ResultSet : Sequence, IteratorProtocol {
     /// @warning This function may take a long time and consume a large amount of memory
     /// depending on the data size and the number of results.
     public func data<T: Decodable>(as type: T.Type, dataKey: String? = nil) throws -> Array<T> {
-        let decoder = QueryResultSetDecoder(resultSet: self, dataKey: dataKey)
+        let decoder = QueryResultSetDecoder(resultSet: impl, dataKey: dataKey)
         return try Array<T>.init(from: decoder)
     }
     
+    /// Writes all unenumerated results to the output stream as newline-delimited JSON (NDJSON),
+    /// one JSON object per row. The rows are encoded directly from the query's Fleece data without
+    /// creating Result objects, and are written in bounded chunks so that the memory used is
+    /// independent of the number of rows. The stream must be opened by the caller and is not closed.
+    ///
+    /// - Parameter stream: The opened output stream to write to.
+    /// - Throws: An error if the query enumeration or writing to the stream failed.
+    public func writeJSONLines(to stream: OutputStream) throws {
+        try impl.writeJSONLines(to: stream)
+    }
+    
+    /// The execution statistics of the query result set, including the compile time, the first row
+    /// latency, the total enumeration time, the number of rows enumerated, and whether the query
+    /// plan uses a full scan. The stats are final once the result set has been fully enumerated.
+    public var stats: QueryStats {
+        return QueryStats(impl: impl.stats)
+    }
+    
     // MARK: Internal
     
     private let impl: CBLQueryResultSet
@@ -870,6 +870,79 @@ class CodableTest: CBLTestCase {
         let favouritesDoc = try defaultCollection!.document(id: favourites.id!)!
         XCTAssert(favourites == favouritesDoc)
     }
+
+    func testQueryResultSetDecodeMatchesResultDecode() throws {
+        try loadJSONResource("profiles_100", collection: defaultCollection!, limit: 100, idKey: "pid")
+        let query = try db.createQuery("SELECT meta().id AS pid, * FROM _ ORDER BY meta().id")
+
+        let profiles = try query.execute().data(as: Profile.self, dataKey: "_")
+        let expected = try query.execute().map { try $0.data(as: Profile.self, dataKey: "_") }
+        XCTAssertEqual(profiles.count, 100)
+        XCTAssertEqual(profiles, expected)
+    }
+
+    func testQueryResultSetDecodeMismatchIntSizes() throws {
+        let largeCalc = LargeCalculation(inputA: Int64.max, inputB: Int64.min, op: "add", output: 0)
+        try defaultCollection!.save(from: largeCalc)
+        let query = try db.createQuery("SELECT meta().id AS id, * FROM _")
+        expectError(domain: CBLError.domain, code: CBLError.decodingError) {
+            let _ = try query.execute().data(as: Calculation.self, dataKey: "_")
+        }
+    }
+
+    func testCollectionEncodeDateFormat() throws {
+        let formatter = ISO8601DateFormatter()
+        formatter.formatOptions = [.withInternetDateTime, .withFractionalSeconds]
+        let body = Blob(contentType: "text/plain", data: Data("Hello, World!".utf8))
+        for time in [1700000000.125, 0.0, -1.5] {
+            let date = Date(timeIntervalSince1970: time)
+            let reportFile = ReportFile(dateFiled: date, report: Report(title: "My Report", filed: false, body: body))
+            try defaultCollection!.save(from: reportFile)
+            // The encoder must write the same string as the Couchbase ISO-8601 formatter
+            let doc = try defaultCollection!.document(id: reportFile.id!)!
+            XCTAssertEqual(doc.string(forKey: "dateFiled"), formatter.string(from: date))
+            XCTAssertEqual(doc.date(forKey: "dateFiled"), date)
+        }
+    }
+
+    // MARK: Performance
+
+    func testPerfCollectionSaveCodable() throws {
+        let profiles = try decodeFromJSONResource("profiles_100", as: Profile.self, limit: 100)
+        measure {
+            try! db.inBatch {
+                for _ in 0..<10 {
+                    for profile in profiles {
+                        let copy = Profile(name: profile.name, contacts: profile.contacts, likes: profile.likes)
+                        try defaultCollection!.save(from: copy)
+                    }
+                }
+            }
+        }
+    }
+
+    func testPerfQueryResultSetDecode() throws {
+        try loadJSONResource("profiles_100", collection: defaultCollection!, limit: 100, idKey: "pid")
+        let query = try db.createQuery("SELECT meta().id AS pid, name, contacts, likes FROM _")
+        measure {
+            for _ in 0..<20 {
+                let profiles = try! query.execute().data(as: Profile.self)
+                XCTAssertEqual(profiles.count, 100)
+            }
+        }
+    }
+
+    // Baseline for testPerfQueryResultSetDecode: decodes each Result separately.
+    func testPerfQueryResultDecode() throws {
+        try loadJSONResource("profiles_100", collection: defaultCollection!, limit: 100, idKey: "pid")
+        let query = try db.createQuery("SELECT meta().id AS pid, name, contacts, likes FROM _")
+        measure {
+            for _ in 0..<20 {
+                let profiles = try! query.execute().map { try $0.data(as: Profile.self) }
+                XCTAssertEqual(profiles.count, 100)
+            }
+        }
+    }
 }
 
 extension Profile : DictionaryEquatable {
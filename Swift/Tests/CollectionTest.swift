@@ -732,6 +732,35 @@ class CollectionTest: CBLTestCase {
         XCTAssertEqual(try collection.indexes(), ["index1", "index2", "index3", "index4", "index5"])
     }
     
+    // MARK: Change Feed
+    
+    func testCollectionChangeCursor() throws {
+        let col = try db.createCollection(name: "colA", scope: "scopeA")
+        try createDocNumbered(col, start: 0, num: 10)
+        
+        let cursor = try col.changes(sinceSequence: 0, limit: 4)
+        var batchSizes = [Int]()
+        var docIDs = Set<String>()
+        var batch: [ChangedDocument]
+        repeat {
+            batch = try cursor.nextBatch()
+            batchSizes.append(batch.count)
+            docIDs.formUnion(batch.map { $0.documentID })
+        } while !batch.isEmpty
+        XCTAssertEqual(batchSizes, [4, 4, 2, 0])
+        XCTAssertEqual(docIDs.count, 10)
+        
+        // Resume from the persisted sequence:
+        let persisted = cursor.lastSequence
+        try col.delete(document: try col.document(id: "doc5")!)
+        let resumed = try col.changes(sinceSequence: persisted, limit: 100)
+        batch = try resumed.nextBatch()
+        XCTAssertEqual(batch.count, 1)
+        XCTAssertEqual(batch[0].documentID, "doc5")
+        XCTAssertEqual(batch[0].flags, .deleted)
+        XCTAssertEqual(resumed.lastSequence, batch[0].sequence)
+    }
+    
     // MARK: 8.5-6 Use collection APIs on deleted/closed scenarios
     
     func testUseCollectionAPIOnDeletedCollection() throws {
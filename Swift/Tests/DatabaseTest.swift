@@ -1586,4 +1586,27 @@ class DatabaseTest: CBLTestCase {
         db = try Database(name: dbName, config: config)
         XCTAssert(db.config.fullSync)
     }
+    
+    func testBlobBufferSizeConfig() throws {
+        let dbName = "blobbufferdb"
+        try deleteDB(name: dbName)
+        
+        var config = DatabaseConfiguration()
+        XCTAssertEqual(config.blobBufferSize, 0)
+        config.directory = self.directory
+        config.blobBufferSize = 64 * 1024
+        db = try Database(name: dbName, config: config)
+        XCTAssertEqual(db.config.blobBufferSize, 64 * 1024)
+        
+        // A stream blob larger than the buffers is copied completely:
+        let content = Data((0..<(200 * 1024 + 3)).map { UInt8(truncatingIfNeeded: $0 * 31) })
+        let blob = Blob(contentType: "application/octet-stream", contentStream: InputStream(data: content))
+        let doc = MutableDocument(id: "doc1")
+        doc.setBlob(blob, forKey: "blob")
+        try db.defaultCollection().save(document: doc)
+        XCTAssertEqual(blob.length, UInt64(content.count))
+        
+        let savedDoc = try db.defaultCollection().document(id: "doc1")!
+        XCTAssertEqual(savedDoc.blob(forKey: "blob")!.content, content)
+    }
 }
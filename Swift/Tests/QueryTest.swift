@@ -1822,6 +1822,26 @@ class QueryTest: CBLTestCase {
         XCTAssertEqual(results.count, 1)
     }
     
+    // MARK: Stats
+    
+    func testQueryStats() throws {
+        try loadJSONResource(name: "names_100")
+        
+        let q = try self.db.createQuery("SELECT name.first FROM _ WHERE gender = 'female'")
+        let rs = try q.execute()
+        XCTAssertFalse(rs.stats.complete)
+        
+        let count = rs.allResults().count
+        XCTAssert(count > 0)
+        
+        let stats = rs.stats
+        XCTAssert(stats.complete)
+        XCTAssertEqual(stats.rowCount, UInt64(count))
+        XCTAssert(stats.compileTime > 0)
+        XCTAssert(stats.enumerationTime >= stats.firstRowLatency)
+        XCTAssert(stats.fullScan)
+    }
+    
     // MARK: -- LiveQuery
     
     func testJSONLiveQuery() throws {
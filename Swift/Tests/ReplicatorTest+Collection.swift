@@ -418,6 +418,30 @@ class ReplicatorTest_Collection: ReplicatorTest {
         XCTAssertEqual(col2b.count, 10)
     }
     
+    func testCollectionPushAndPullFilterExpressions() throws {
+        let col1a = try self.db.createCollection(name: "colA", scope: "scopeA")
+        let col2a = try otherDB!.createCollection(name: "colA", scope: "scopeA")
+        
+        try createDocNumbered(col1a, start: 0, num: 10)
+        try createDocNumbered(col2a, start: 10, num: 10)
+        
+        let number1 = Expression.property("number1")
+        var colConfig = CollectionConfiguration(collection: col1a)
+        colConfig.pushFilterExpression = number1.lessThan(Expression.parameter("max"))
+            .or(Meta.id.equalTo(Expression.string("doc7")))
+        colConfig.pullFilterExpression = number1.between(Expression.int(12), and: Expression.int(14))
+        colConfig.filterParameters = Parameters().setInt(5, forName: "max")
+        
+        let target = DatabaseEndpoint(database: otherDB!)
+        let config = self.config(configs: [colConfig], target: target, type: .pushAndPull, continuous: false)
+        run(config: config, expectedError: nil)
+        
+        XCTAssertEqual(col1a.count, 13)
+        XCTAssertEqual(col2a.count, 16)
+        XCTAssertNotNil(try col2a.document(id: "doc7"))
+        XCTAssertNil(try col2a.document(id: "doc6"))
+    }
+    
     func testCollectionDocumentIDsPushFilter() throws {
         let col1a = try self.db.createCollection(name: "colA", scope: "scopeA")
         let col1b = try self.db.createCollection(name: "colB", scope: "scopeA")